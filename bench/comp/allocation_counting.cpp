@@ -0,0 +1,25 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <cstdlib>
+#include <new>
+#include <lesfl/frontend/stats.hpp>
+
+using namespace std;
+
+// The global operator new is replaced so that phases of the frontend have
+// allocation counts.
+
+void *operator new(size_t size)
+{
+  lesfl::frontend::FrontendStats::count_allocation();
+  void *ptr = malloc(size != 0 ? size : 1);
+  if(ptr == nullptr) throw bad_alloc();
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
@@ -0,0 +1,53 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _BENCH_HPP
+#define _BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <string>
+
+namespace lesfl
+{
+  namespace bench
+  {
+    struct BenchmarkResult
+    {
+      std::string name;
+      std::size_t iteration_count;
+      double seconds;
+      std::size_t byte_count;
+      std::size_t allocation_count;
+
+      BenchmarkResult(const std::string &name, std::size_t iteration_count, double seconds, std::size_t byte_count, std::size_t allocation_count = 0) :
+        name(name), iteration_count(iteration_count), seconds(seconds), byte_count(byte_count), allocation_count(allocation_count) {}
+    };
+
+    const std::size_t min_iteration_count = 3;
+    const double min_seconds = 1.0;
+
+    template<typename _Fun>
+    bool run_benchmark(const std::string &name, std::size_t byte_count, _Fun fun, std::list<BenchmarkResult> &results)
+    {
+      std::size_t iteration_count = 0;
+      double seconds = 0.0;
+      while(iteration_count < min_iteration_count || seconds < min_seconds) {
+        auto start = std::chrono::steady_clock::now();
+        if(!fun()) return false;
+        auto end = std::chrono::steady_clock::now();
+        seconds += std::chrono::duration<double>(end - start).count();
+        iteration_count++;
+      }
+      results.push_back(BenchmarkResult(name, iteration_count, seconds, byte_count));
+      return true;
+    }
+  }
+}
+
+#endif
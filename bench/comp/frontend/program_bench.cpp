@@ -0,0 +1,119 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <lesfl/frontend.hpp>
+#include "frontend/program_bench.hpp"
+#include "frontend/program_generator.hpp"
+
+using namespace std;
+using namespace lesfl::bench;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace bench
+    {
+      namespace
+      {
+        struct PhaseTotal
+        {
+          string name;
+          double seconds;
+          size_t allocation_count;
+
+          PhaseTotal(const string &name) : name(name), seconds(0.0), allocation_count(0) {}
+        };
+      }
+
+      // Static inline functions and static functions.
+
+      static void add_phase_time(vector<PhaseTotal> &totals, const string &name, double seconds, size_t allocation_count)
+      {
+        auto iter = totals.begin();
+        for(; iter != totals.end(); iter++) {
+          if(iter->name == name) break;
+        }
+        if(iter == totals.end()) iter = totals.insert(totals.end(), PhaseTotal(name));
+        iter->seconds += seconds;
+        iter->allocation_count += allocation_count;
+      }
+
+      static bool compile_program(const string &source, vector<PhaseTotal> &totals)
+      {
+        istringstream iss(source);
+        BuiltinTypeAdder builtin_type_adder;
+        Parser parser;
+        Resolver resolver;
+        unique_ptr<Tree> tree(new Tree());
+        list<Error> errors;
+        FrontendStats stats;
+        FrontendOptions options;
+        options.stats = &stats;
+        bool is_success = builtin_type_adder.add_builtin_types(*tree, options);
+        is_success = is_success && parser.parse(Source("program.lesfl", iss), *tree, errors, options);
+        is_success = is_success && resolver.resolve(*tree, errors, options);
+        if(!is_success) {
+          for(auto &error : errors)
+            cerr << error.pos().source().file_name() << ":" << error.pos().line() << ":" << error.pos().column() << ": " << error.msg() << endl;
+          return false;
+        }
+        size_t start_allocation_count = FrontendStats::allocation_count();
+        auto start = chrono::steady_clock::now();
+        tree.reset();
+        auto end = chrono::steady_clock::now();
+        stats.add_phase_stats(PhaseStats("tree teardown", chrono::duration_cast<chrono::nanoseconds>(end - start).count(), FrontendStats::allocation_count() - start_allocation_count));
+        for(auto &phase_stats : stats.phase_stats()) {
+          // Sources are lexed while they are parsed, so the parse phase
+          // includes lexing.
+          string name = (phase_stats.name() == "parse program.lesfl" ? string("lex and parse") : phase_stats.name());
+          add_phase_time(totals, name, phase_stats.nanoseconds() / 1e9, phase_stats.allocation_count());
+        }
+        return true;
+      }
+
+      bool run_program_benchmarks(list<BenchmarkResult> &results, bool is_smoke_run)
+      {
+        vector<pair<string, ProgramParameters>> programs;
+        if(is_smoke_run) {
+          programs.push_back(make_pair("tiny", ProgramParameters(2, 2, 2, 1, 4, 1)));
+        } else {
+          programs.push_back(make_pair("small", ProgramParameters(10, 20, 4, 2, 100, 2)));
+          programs.push_back(make_pair("medium", ProgramParameters(50, 50, 8, 4, 1000, 5)));
+          programs.push_back(make_pair("large", ProgramParameters(200, 100, 16, 8, 10000, 10)));
+        }
+        // A smoke run compiles a program once.
+        size_t program_min_iteration_count = (is_smoke_run ? 1 : min_iteration_count);
+        double program_min_seconds = (is_smoke_run ? 0.0 : min_seconds);
+        for(auto &program : programs) {
+          string source = generate_program(program.second);
+          vector<PhaseTotal> totals;
+          size_t iteration_count = 0;
+          double seconds = 0.0;
+          while(iteration_count < program_min_iteration_count || seconds < program_min_seconds) {
+            auto start = chrono::steady_clock::now();
+            if(!compile_program(source, totals)) return false;
+            auto end = chrono::steady_clock::now();
+            seconds += chrono::duration<double>(end - start).count();
+            iteration_count++;
+          }
+          for(auto &total : totals) {
+            string name = "frontend/program/" + program.first + "/" + total.name;
+            results.push_back(BenchmarkResult(name, iteration_count, total.seconds, source.length(), total.allocation_count));
+          }
+        }
+        return true;
+      }
+    }
+  }
+}
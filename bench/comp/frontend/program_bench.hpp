@@ -0,0 +1,25 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_PROGRAM_BENCH_HPP
+#define _FRONTEND_PROGRAM_BENCH_HPP
+
+#include <list>
+#include "bench.hpp"
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace bench
+    {
+      bool run_program_benchmarks(std::list<lesfl::bench::BenchmarkResult> &results, bool is_smoke_run = false);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <cstdint>
+#include "frontend/program_generator.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace bench
+    {
+      // Static inline functions and static functions.
+
+      static inline uint32_t next_random(uint32_t &state)
+      {
+        state = state * 1664525 + 1013904223;
+        return state >> 8;
+      }
+
+      static inline string fun_ident(size_t module_index, size_t def_index)
+      { return "f" + to_string(module_index) + "_" + to_string(def_index); }
+
+      static inline string template_ident(size_t module_index, size_t inst_index)
+      { return "tid" + to_string(module_index) + "_" + to_string(inst_index); }
+
+      static void generate_leaf(const ProgramParameters &params, size_t module_index, size_t def_index, uint32_t &state, string &str)
+      {
+        size_t import_count = (module_index < params.import_count ? module_index : params.import_count);
+        if(import_count > 0) {
+          size_t imported_module_index = module_index - 1 - next_random(state) % import_count;
+          str += fun_ident(imported_module_index, next_random(state) % params.def_count) + "(x)";
+        } else if(def_index > 0)
+          str += fun_ident(module_index, next_random(state) % def_index) + "(x)";
+        else
+          str += "x";
+      }
+
+      string generate_program(const ProgramParameters &params)
+      {
+        string str;
+        uint32_t state = 1;
+        for(size_t i = 0; i < params.module_count; i++) {
+          str += "module m" + to_string(i) + " {\n";
+          for(size_t j = 1; j <= params.import_count && j <= i; j++) {
+            str += "  import .m" + to_string(i - j) + "\n";
+          }
+          if(params.literal_count > 0) {
+            str += "\n  table = [";
+            for(size_t j = 0; j < params.literal_count; j++) {
+              if(j > 0) str += ", ";
+              str += to_string(next_random(state) % 1000);
+            }
+            str += "]\n";
+          }
+          for(size_t j = 0; j < params.inst_count; j++) {
+            str += "\n  template(t)\n";
+            str += "  " + template_ident(i, j) + "(x: t): t\n";
+            str += "\n  instance\n";
+            str += "  " + template_ident(i, j) + "(x) = x\n";
+          }
+          for(size_t j = 0; j < params.def_count; j++) {
+            str += "\n  " + fun_ident(i, j) + "(x) = ";
+            size_t paren_count = 0;
+            if(params.inst_count > 0) {
+              str += template_ident(i, j % params.inst_count) + "(";
+              paren_count++;
+            }
+            for(size_t k = 0; k < params.expr_depth; k++) {
+              str += "#iadd(x, ";
+              paren_count++;
+            }
+            generate_leaf(params, i, j, state, str);
+            str += string(paren_count, ')');
+            str += "\n";
+          }
+          str += "}\n\n";
+        }
+        return str;
+      }
+    }
+  }
+}
@@ -0,0 +1,42 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_PROGRAM_GENERATOR_HPP
+#define _FRONTEND_PROGRAM_GENERATOR_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace bench
+    {
+      struct ProgramParameters
+      {
+        std::size_t module_count;
+        std::size_t def_count;
+        std::size_t expr_depth;
+        std::size_t import_count;
+        std::size_t literal_count;
+        std::size_t inst_count;
+
+        ProgramParameters(std::size_t module_count, std::size_t def_count, std::size_t expr_depth, std::size_t import_count, std::size_t literal_count, std::size_t inst_count) :
+          module_count(module_count), def_count(def_count), expr_depth(expr_depth), import_count(import_count), literal_count(literal_count), inst_count(inst_count) {}
+      };
+
+      // Generates the same program for the same parameters. Each module
+      // imports up to import_count previous modules and has a literal table,
+      // inst_count function templates with instances and def_count functions
+      // which call functions from the imported modules.
+      std::string generate_program(const ProgramParameters &params);
+    }
+  }
+}
+
+#endif
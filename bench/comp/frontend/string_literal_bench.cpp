@@ -0,0 +1,80 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <lesfl/frontend.hpp>
+#include "frontend/string_literal_bench.hpp"
+
+using namespace std;
+using namespace lesfl::bench;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace bench
+    {
+      // Static inline functions and static functions.
+
+      static string make_string_literal_source(const string &prefix, size_t byte_count, size_t &string_length)
+      {
+        // Each escape sequence in the line is two characters long and stands for one character.
+        static const string line = "<p class=\\\"greeting\\\">Hello, {name}! You have {count} new messages.</p>\\n";
+        size_t line_length = line.length() - count(line.begin(), line.end(), '\\');
+        string source = "s = " + prefix + "\"";
+        string_length = 0;
+        while(source.length() < byte_count) {
+          source += line;
+          string_length += line_length;
+        }
+        source += "\"\n";
+        return source;
+      }
+
+      static bool parse_string_literal_source(const string &source, size_t string_length, bool is_wide)
+      {
+        istringstream iss(source);
+        Parser parser;
+        Tree tree;
+        list<Error> errors;
+        if(!parser.parse(Source("string_literal.lesfl", iss), tree, errors)) {
+          for(auto &error : errors)
+            cerr << error.pos().source().file_name() << ":" << error.pos().line() << ":" << error.pos().column() << ": " << error.msg() << endl;
+          return false;
+        }
+        VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(tree.defs().front()->front().get());
+        UserDefinedVariable *var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+        VariableLiteralValue *value = dynamic_cast<VariableLiteralValue *>(var->value());
+        if(is_wide) {
+          WideStringValue *string_value = dynamic_cast<WideStringValue *>(value->literal_value());
+          return string_value != nullptr && string_value->string().length() == string_length;
+        } else {
+          StringValue *string_value = dynamic_cast<StringValue *>(value->literal_value());
+          return string_value != nullptr && string_value->string().length() == string_length;
+        }
+      }
+
+      bool run_string_literal_benchmarks(list<BenchmarkResult> &results)
+      {
+        for(size_t mib_count : { 1, 4, 16 }) {
+          for(bool is_wide : { false, true }) {
+            size_t string_length;
+            string source = make_string_literal_source(is_wide ? "w" : "", mib_count << 20, string_length);
+            string name = string("frontend/") + (is_wide ? "wide_string_literal/" : "string_literal/") + to_string(mib_count) + "MiB";
+            bool is_success = run_benchmark(name, source.length(), [&]() {
+              return parse_string_literal_source(source, string_length, is_wide);
+            }, results);
+            if(!is_success) return false;
+          }
+        }
+        return true;
+      }
+    }
+  }
+}
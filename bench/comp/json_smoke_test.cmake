@@ -0,0 +1,32 @@
+# Runs benchcomp once on a tiny generated program and checks that the JSON
+# output parses and has results for all phases of the frontend.
+cmake_minimum_required(VERSION 3.19)
+
+execute_process(COMMAND "${BENCHCOMP}" --json --smoke
+	OUTPUT_VARIABLE output
+	RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "benchcomp failed: ${result}")
+endif(NOT result EQUAL 0)
+
+string(JSON result_count ERROR_VARIABLE error LENGTH "${output}" results)
+if(error)
+	message(FATAL_ERROR "Could not parse JSON output: ${error}")
+endif(error)
+if(result_count EQUAL 0)
+	message(FATAL_ERROR "JSON output has no results")
+endif(result_count EQUAL 0)
+
+set(names "")
+math(EXPR last_index "${result_count} - 1")
+foreach(i RANGE ${last_index})
+	string(JSON name GET "${output}" results ${i} name)
+	list(APPEND names "${name}")
+endforeach(i)
+
+foreach(phase "lex and parse" "add builtin types" "add definitions" "resolve aliases" "resolve definitions" "tree teardown")
+	list(FIND names "frontend/program/tiny/${phase}" index)
+	if(index EQUAL -1)
+		message(FATAL_ERROR "JSON output has no result for phase: ${phase}")
+	endif(index EQUAL -1)
+endforeach(phase)
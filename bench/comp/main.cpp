@@ -0,0 +1,63 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <cstring>
+#include <iostream>
+#include <list>
+#include "frontend/program_bench.hpp"
+#include "frontend/string_literal_bench.hpp"
+#include "bench.hpp"
+
+using namespace std;
+using namespace lesfl::bench;
+
+static void write_json(ostream &os, const list<BenchmarkResult> &results)
+{
+  os << "{\"results\": [";
+  bool is_first = true;
+  for(auto &result : results) {
+    os << (is_first ? "\n" : ",\n");
+    os << "  {\"name\": \"" << result.name << "\"";
+    os << ", \"iterations\": " << result.iteration_count;
+    os << ", \"seconds\": " << result.seconds;
+    os << ", \"bytes\": " << result.byte_count;
+    os << ", \"allocations\": " << result.allocation_count << "}";
+    is_first = false;
+  }
+  os << (is_first ? "]}" : "\n]}") << endl;
+}
+
+int main(int argc, char **argv)
+{
+  // The --smoke option runs the program benchmark once on a tiny program,
+  // so a test can check the output quickly.
+  bool is_json = false;
+  bool is_smoke_run = false;
+  for(int i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "--json") == 0)
+      is_json = true;
+    else if(strcmp(argv[i], "--smoke") == 0)
+      is_smoke_run = true;
+  }
+  (is_json ? cerr : cout) << "Benchmarking lesfl library ..." << endl;
+  list<BenchmarkResult> results;
+  bool is_success = is_smoke_run || lesfl::frontend::bench::run_string_literal_benchmarks(results);
+  is_success = is_success && lesfl::frontend::bench::run_program_benchmarks(results, is_smoke_run);
+  if(is_json) {
+    write_json(cout, results);
+  } else {
+    for(auto &result : results) {
+      cout << result.name << ":";
+      cout << " iterations=" << result.iteration_count;
+      cout << " seconds=" << result.seconds;
+      cout << " mib_per_second=" << (result.byte_count * result.iteration_count) / (result.seconds * (1 << 20));
+      cout << " allocations_per_iteration=" << result.allocation_count / result.iteration_count << endl;
+    }
+  }
+  if(!is_success) cerr << "benchmark failed" << endl;
+  return is_success ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Derives a deterministic LALR(1) variant of the grammar of the frontend and
+# compares it with the GLR grammar. See lalr1_evaluation.txt for the results.
+#
+# Usage: lalr1_evaluation.sh [<output directory>]
+
+top_dir="$(cd "$(dirname "$0")/.." && pwd)"
+out_dir="${1:-lalr1_evaluation}"
+bison="${BISON:-bison}"
+
+mkdir -p "$out_dir" || exit 1
+
+# The LALR(1) variant differs only in the skeleton. Bison rejects %dprec and
+# %merge without %glr-parser, so they are removed with the directive.
+sed -e 's/^%skeleton "glr.cc"/%skeleton "lalr1.cc"/' \
+	-e '/^%glr-parser/d' \
+	-e 's/%dprec [0-9]*//' \
+	-e 's/%merge <[A-Za-z_]*>//' \
+	"$top_dir/comp/frontend/bison_parser.ypp" > "$out_dir/lalr1_parser.ypp" || exit 1
+cp "$top_dir/comp/frontend/bison_parser.ypp" "$out_dir/glr_parser.ypp" || exit 1
+
+for name in glr_parser lalr1_parser; do
+	echo "$name:"
+	"$bison" -Wno-counterexamples -Wno-deprecated -d -L c++ -r all -o "$out_dir/$name.cpp" "$out_dir/$name.ypp" 2>&1 | \
+		sed -n -e 's/^.*warning: \([0-9]* [a-z/]* conflicts\).*$/  \1/p'
+done
+
+state_count="$(grep -c -e '^State [0-9]*$' "$out_dir/lalr1_parser.output")"
+conflict_state_count="$(grep -c -e '^State [0-9]* conflicts:' "$out_dir/lalr1_parser.output")"
+echo "lalr1_parser states with conflicts: $conflict_state_count of $state_count"
+
+# The first definition of a source is read in the state after the leading
+# newlines. A conflict in this state means that the LALR(1) parser resolves a
+# conflict statically before it reads any source.
+state="$(sed -n -e '/^State 0$/,/^State 1$/s/^ *onl *go to state \([0-9]*\)$/\1/p' "$out_dir/lalr1_parser.output")"
+echo "lalr1_parser state $state:"
+sed -n -e "/^State $state\$/,/^State $((state + 1))\$/p" "$out_dir/lalr1_parser.output" | \
+	grep -e '\[reduce using rule' | sed -e 's/^ */  /'
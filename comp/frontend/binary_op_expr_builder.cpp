@@ -0,0 +1,78 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include "frontend/binary_op_expr_builder.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // Static inline functions and static functions.
+
+      static Expression *make_binary_op_expr(Expression *expr1, const string &ident, Expression *expr2, const Position &pos, const Position &ident_pos)
+      {
+        NodeList<Expression> *args = new NodeList<Expression>();
+        args->push_back(unique_ptr<Expression>(expr1));
+        args->push_back(unique_ptr<Expression>(expr2));
+        return new NonUniqueApplication(new VariableExpression(new RelativeIdentifier(ident), ident_pos), FunctionModifier::NONE, args, pos);
+      }
+
+      //
+      // A BinaryOpExpressionBuilder class.
+      //
+
+      BinaryOpExpressionBuilder::BinaryOpExpressionBuilder(Expression *expr, const Position &pos)
+      { _M_operands.push_back(BinaryOpExpressionOperand(expr, pos)); }
+
+      BinaryOpExpressionBuilder::~BinaryOpExpressionBuilder() {}
+
+      void BinaryOpExpressionBuilder::add_op(const string &ident, unsigned prec, bool is_right_assoc, const Position &ident_pos, Expression *expr, const Position &pos)
+      {
+        _M_ops.push_back(BinaryOpExpressionOperator(ident, prec, is_right_assoc, ident_pos));
+        _M_operands.push_back(BinaryOpExpressionOperand(expr, pos));
+      }
+
+      Expression *BinaryOpExpressionBuilder::build_expr()
+      {
+        // The operand stack and the operator stack are explicit, so a long
+        // operator expression doesn't overflow the call stack. A binary
+        // operator expression has the position of its left operand.
+        vector<BinaryOpExpressionOperand> operand_stack;
+        vector<size_t> op_index_stack;
+        auto reduce = [&]() {
+          BinaryOpExpressionOperator &op = _M_ops[op_index_stack.back()];
+          op_index_stack.pop_back();
+          Expression *expr2 = operand_stack.back().expr.release();
+          operand_stack.pop_back();
+          BinaryOpExpressionOperand &operand1 = operand_stack.back();
+          operand1.expr.reset(make_binary_op_expr(operand1.expr.release(), op.ident, expr2, operand1.pos, op.pos));
+        };
+        operand_stack.reserve(_M_operands.size());
+        op_index_stack.reserve(_M_ops.size());
+        operand_stack.push_back(std::move(_M_operands.front()));
+        for(size_t i = 0; i < _M_ops.size(); i++) {
+          BinaryOpExpressionOperator &op = _M_ops[i];
+          while(!op_index_stack.empty()) {
+            BinaryOpExpressionOperator &prev_op = _M_ops[op_index_stack.back()];
+            if(prev_op.prec < op.prec || (prev_op.prec == op.prec && op.is_right_assoc)) break;
+            reduce();
+          }
+          op_index_stack.push_back(i);
+          operand_stack.push_back(std::move(_M_operands[i + 1]));
+        }
+        while(!op_index_stack.empty()) reduce();
+        _M_operands.clear();
+        _M_ops.clear();
+        return operand_stack.front().expr.release();
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_BINARY_OP_EXPR_BUILDER_HPP
+#define _FRONTEND_BINARY_OP_EXPR_BUILDER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <lesfl/frontend/tree.hpp>
+#include <lesfl/comp.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      struct BinaryOpExpressionOperand
+      {
+        std::unique_ptr<Expression> expr;
+        Position pos;
+
+        BinaryOpExpressionOperand(Expression *expr, const Position &pos) :
+          expr(expr), pos(pos) {}
+      };
+
+      struct BinaryOpExpressionOperator
+      {
+        std::string ident;
+        unsigned prec;
+        bool is_right_assoc;
+        Position pos;
+
+        BinaryOpExpressionOperator(const std::string &ident, unsigned prec, bool is_right_assoc, const Position &pos) :
+          ident(ident), prec(prec), is_right_assoc(is_right_assoc), pos(pos) {}
+      };
+
+      // The parser collects operands and operators of a binary operator
+      // expression in one flat list. The expression is built by precedence
+      // climbing, so it has the same tree as an expression from one grammar
+      // rule for each precedence level.
+      class BinaryOpExpressionBuilder
+      {
+        std::vector<BinaryOpExpressionOperand> _M_operands;
+        std::vector<BinaryOpExpressionOperator> _M_ops;
+      public:
+        BinaryOpExpressionBuilder(Expression *expr, const Position &pos);
+
+        ~BinaryOpExpressionBuilder();
+
+        void add_op(const std::string &ident, unsigned prec, bool is_right_assoc, const Position &ident_pos, Expression *expr, const Position &pos);
+
+        Expression *build_expr();
+      };
+    }
+  }
+}
+
+#endif
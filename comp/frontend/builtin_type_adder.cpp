@@ -7,6 +7,7 @@
  ****************************************************************************/
 #include <vector>
 #include <lesfl/frontend.hpp>
+#include "frontend/stats_collector.hpp"
 
 using namespace std;
 
@@ -16,7 +17,7 @@ namespace lesfl
   {
     BuiltinTypeAdder::~BuiltinTypeAdder() {}
 
-    bool BuiltinTypeAdder::add_builtin_types(Tree &tree)
+    bool BuiltinTypeAdder::add_types(Tree &tree)
     {
       static vector<pair<string, BuiltinType>> builtin_types {
         make_pair("Char", BuiltinType::CHAR),
@@ -58,5 +59,13 @@ namespace lesfl
       }
       return true;
     }
+
+    bool BuiltinTypeAdder::add_builtin_types(Tree &tree, const FrontendOptions &options)
+    {
+      if(options.stats == nullptr) return add_types(tree);
+      priv::StatsCollector collector(*(options.stats));
+      priv::PhaseTimer timer(options.stats, "add builtin types");
+      return add_types(tree);
+    }
   }
 }
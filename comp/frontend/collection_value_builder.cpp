@@ -0,0 +1,170 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include "frontend/collection_value_builder.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // Static inline functions and static functions.
+
+      static PackedElementType int_type_to_packed_elem_type(IntType int_type)
+      {
+        switch(int_type) {
+          case IntType::INT8:
+            return PackedElementType::INT8;
+          case IntType::INT16:
+            return PackedElementType::INT16;
+          case IntType::INT32:
+            return PackedElementType::INT32;
+          default:
+            return PackedElementType::INT64;
+        }
+      }
+
+      static bool get_packed_elem_type(Value *value, PackedElementType &elem_type)
+      {
+        VariableLiteralValue *literal_value = dynamic_cast<VariableLiteralValue *>(value);
+        if(literal_value == nullptr) return false;
+        return dynamic_match(literal_value->literal_value(),
+        [](NonUniqueLiteralValue *value) -> bool {
+          return false;
+        },
+        [&elem_type](CharValue *value) -> bool {
+          elem_type = PackedElementType::CHAR;
+          return true;
+        },
+        [&elem_type](IntValue *value) -> bool {
+          elem_type = int_type_to_packed_elem_type(value->int_type());
+          return true;
+        },
+        [&elem_type](FloatValue *value) -> bool {
+          elem_type = (value->float_type() == FloatType::SINGLE ? PackedElementType::SINGLE_FLOAT : PackedElementType::DOUBLE_FLOAT);
+          return true;
+        });
+      }
+
+      //
+      // A CollectionValueBuilder class.
+      //
+
+      CollectionValueBuilder::~CollectionValueBuilder() {}
+
+      void CollectionValueBuilder::add_value(Value *value)
+      {
+        PackedElementType elem_type;
+        if(get_packed_elem_type(value, elem_type)) {
+          if(prepare_packed_elem(elem_type)) {
+            VariableLiteralValue *literal_value = static_cast<VariableLiteralValue *>(value);
+            dynamic_match(literal_value->literal_value(),
+            [](NonUniqueLiteralValue *value) {},
+            [this](CharValue *value) {
+              _M_packed_elems->add_char_elem(value->c());
+            },
+            [this](IntValue *value) {
+              _M_packed_elems->add_int_elem(value->i());
+            },
+            [this](FloatValue *value) {
+              _M_packed_elems->add_float_elem(value->f());
+            });
+            add_packed_elem_pos(value->pos());
+            delete value;
+            return;
+          }
+        } else if(_M_packed_elems.get() != nullptr)
+          unpack_elems();
+        _M_elems->push_back(unique_ptr<Value>(value));
+      }
+
+      void CollectionValueBuilder::add_char_elem(char c, const Position &pos)
+      {
+        if(prepare_packed_elem(PackedElementType::CHAR)) {
+          _M_packed_elems->add_char_elem(c);
+          add_packed_elem_pos(pos);
+        } else
+          _M_elems->push_back(unique_ptr<Value>(new VariableLiteralValue(new CharValue(c), pos)));
+      }
+
+      void CollectionValueBuilder::add_int_elem(IntType int_type, int64_t i, const Position &pos)
+      {
+        if(prepare_packed_elem(int_type_to_packed_elem_type(int_type))) {
+          _M_packed_elems->add_int_elem(i);
+          add_packed_elem_pos(pos);
+        } else
+          _M_elems->push_back(unique_ptr<Value>(new VariableLiteralValue(new IntValue(int_type, i), pos)));
+      }
+
+      void CollectionValueBuilder::add_float_elem(FloatType float_type, double f, const Position &pos)
+      {
+        if(prepare_packed_elem(float_type == FloatType::SINGLE ? PackedElementType::SINGLE_FLOAT : PackedElementType::DOUBLE_FLOAT)) {
+          _M_packed_elems->add_float_elem(f);
+          add_packed_elem_pos(pos);
+        } else
+          _M_elems->push_back(unique_ptr<Value>(new VariableLiteralValue(new FloatValue(float_type, f), pos)));
+      }
+
+      Value *CollectionValueBuilder::build_list_value(const Position &pos)
+      {
+        build_elems();
+        if(_M_packed_elems.get() != nullptr)
+          return new PackedListValue(_M_packed_elems.release(), pos);
+        else
+          return new ListValue(_M_elems.release(), pos);
+      }
+
+      Value *CollectionValueBuilder::build_array_value(const Position &pos)
+      {
+        build_elems();
+        if(_M_packed_elems.get() != nullptr)
+          return new PackedArrayValue(_M_packed_elems.release(), pos);
+        else
+          return new ArrayValue(_M_elems.release(), pos);
+      }
+
+      bool CollectionValueBuilder::prepare_packed_elem(PackedElementType elem_type)
+      {
+        // Elements are packed from the first element until an element can't
+        // be packed.
+        if(_M_packed_elems.get() != nullptr) {
+          if(_M_packed_elems->elem_type() == elem_type) return true;
+          unpack_elems();
+          return false;
+        }
+        if(!_M_elems->empty()) return false;
+        _M_packed_elems = unique_ptr<PackedElements>(new PackedElements(elem_type));
+        return true;
+      }
+
+      void CollectionValueBuilder::add_packed_elem_pos(const Position &pos)
+      { _M_packed_elem_lines_and_columns.push_back(make_pair(pos.line(), pos.column())); }
+
+      void CollectionValueBuilder::build_elems()
+      {
+        if(_M_packed_elems.get() != nullptr && _M_packed_elems->size() < _S_min_packed_elem_count)
+          unpack_elems();
+      }
+
+      void CollectionValueBuilder::unpack_elems()
+      {
+        for(size_t i = 0; i < _M_packed_elems->size(); i++) {
+          auto &line_and_column = _M_packed_elem_lines_and_columns[i];
+          Position pos(_M_source, line_and_column.first, line_and_column.second);
+          _M_elems->push_back(unique_ptr<Value>(new VariableLiteralValue(_M_packed_elems->make_literal_value(i), pos)));
+        }
+        _M_packed_elems.reset();
+        _M_packed_elem_lines_and_columns.clear();
+      }
+    }
+  }
+}
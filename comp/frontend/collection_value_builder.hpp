@@ -0,0 +1,68 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_COLLECTION_VALUE_BUILDER_HPP
+#define _FRONTEND_COLLECTION_VALUE_BUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <lesfl/frontend/tree.hpp>
+#include <lesfl/comp.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // The parser packs simple literals of a collection value directly in a
+      // CollectionValueBuilder object, so they have no value nodes. The
+      // packed elements are unpacked if they are too few or an element has a
+      // different type.
+      class CollectionValueBuilder
+      {
+        static const std::size_t _S_min_packed_elem_count = 16;
+
+        Source _M_source;
+        std::unique_ptr<NodeList<Value>> _M_elems;
+        std::unique_ptr<PackedElements> _M_packed_elems;
+        std::vector<std::pair<std::size_t, std::size_t>> _M_packed_elem_lines_and_columns;
+      public:
+        CollectionValueBuilder(const Source &source) :
+          _M_source(source), _M_elems(new NodeList<Value>()) {}
+
+        ~CollectionValueBuilder();
+
+        void add_value(Value *value);
+
+        void add_char_elem(char c, const Position &pos);
+
+        void add_int_elem(IntType int_type, std::int64_t i, const Position &pos);
+
+        void add_float_elem(FloatType float_type, double f, const Position &pos);
+
+        Value *build_list_value(const Position &pos);
+
+        Value *build_array_value(const Position &pos);
+      private:
+        bool prepare_packed_elem(PackedElementType elem_type);
+
+        void add_packed_elem_pos(const Position &pos);
+
+        void build_elems();
+
+        void unpack_elems();
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_DEFERRED_BODY_HPP
+#define _FRONTEND_DEFERRED_BODY_HPP
+
+#include <memory>
+#include <vector>
+#include <lesfl/frontend/tree.hpp>
+#include <lesfl/comp.hpp>
+#include "frontend/bison_parser.hpp"
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      struct DeferredToken
+      {
+        int token;
+        BisonParser::semantic_type value;
+        BisonParser::location_type loc;
+      };
+
+      class DeferredTokens
+      {
+        BisonParser::location_type _M_start_loc;
+        std::vector<DeferredToken> _M_tokens;
+      public:
+        // The start location is an empty location at the end of the token
+        // before the body, so the body is parsed with the same locations as
+        // without deferring.
+        DeferredTokens(const BisonParser::location_type &start_loc) : _M_start_loc(start_loc) {}
+
+        ~DeferredTokens();
+
+        const BisonParser::location_type &start_loc() const { return _M_start_loc; }
+
+        std::vector<DeferredToken> &tokens() { return _M_tokens; }
+
+        const std::vector<DeferredToken> &tokens() const { return _M_tokens; }
+
+        void add_token(const DeferredToken &token) { _M_tokens.push_back(token); }
+
+        static void delete_value(DeferredToken &token);
+
+        static void release_value(DeferredToken &token);
+      };
+
+      class TokenDeferredBody : public DeferredBody
+      {
+        Source _M_source;
+        Position _M_pos;
+        std::unique_ptr<DeferredTokens> _M_tokens;
+        bool _M_is_parsed;
+        bool _M_is_success;
+        std::list<Error> _M_errors;
+      public:
+        TokenDeferredBody(const Source &source, DeferredTokens *tokens) :
+          _M_source(source),
+          _M_pos(source, tokens->tokens().front().loc.begin.line, tokens->tokens().front().loc.begin.column),
+          _M_tokens(tokens), _M_is_parsed(false), _M_is_success(false) {}
+
+        ~TokenDeferredBody();
+
+        // The tokens are parsed only once. The parsed expression is passed to
+        // the caller, so a next call after success reports an internal error
+        // instead of returning the expression again. A next call after failure
+        // reports the same errors.
+        Expression *parse(std::list<Error> &errors);
+      };
+    }
+  }
+}
+
+#endif
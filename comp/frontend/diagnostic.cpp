@@ -0,0 +1,86 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <lesfl/frontend/diagnostic.hpp>
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // Static inline functions and static functions.
+
+      static const Identifier *copy_ident(const Identifier *ident)
+      {
+        const AbsoluteIdentifier *abs_ident = dynamic_cast<const AbsoluteIdentifier *>(ident);
+        if(abs_ident != nullptr) return new AbsoluteIdentifier(*abs_ident);
+        const RelativeIdentifier *rel_ident = dynamic_cast<const RelativeIdentifier *>(ident);
+        if(rel_ident != nullptr) return new RelativeIdentifier(*rel_ident);
+        return nullptr;
+      }
+    }
+
+    //
+    // A Diagnostic class.
+    //
+
+    Diagnostic::Diagnostic(DiagnosticCode code, const Position &pos, const Identifier *ident) :
+      _M_code(code), _M_pos(pos), _M_ident(priv::copy_ident(ident)) {}
+
+    string Diagnostic::msg(const AbsoluteIdentifierTable &table) const
+    {
+      string key_ident_str;
+      if(_M_ident == nullptr && _M_code != DiagnosticCode::MESSAGE) {
+        const AbsoluteIdentifier *abs_ident = table.ident(_M_key_ident);
+        key_ident_str = (abs_ident != nullptr ? abs_ident->to_string() : string("?"));
+      }
+      switch(_M_code) {
+        case DiagnosticCode::MESSAGE:
+          return _M_error->msg();
+        case DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED:
+          return "variable " + key_ident_str + " is already defined";
+        case DiagnosticCode::TYPE_IS_ALREADY_DEFINED:
+          return "type " + key_ident_str + " is already defined";
+        case DiagnosticCode::TYPE_TEMPLATE_IS_ALREADY_DEFINED:
+          return "type template " + key_ident_str + " is already defined";
+        case DiagnosticCode::MODULE_IS_PRIVATE:
+          return "module " + key_ident_str + " is private";
+        case DiagnosticCode::MODULE_IS_UNDEFINED:
+          return "module " + _M_ident->to_string() + " is undefined";
+        case DiagnosticCode::VARIABLE_IS_PRIVATE:
+          return "variable " + key_ident_str + " is private";
+        case DiagnosticCode::VARIABLE_IS_UNDEFINED:
+          return "variable " + _M_ident->to_string() + " is undefined";
+        case DiagnosticCode::TYPE_IS_PRIVATE:
+          return "type " + key_ident_str + " is private";
+        case DiagnosticCode::TYPE_IS_UNDEFINED:
+          return "type " + _M_ident->to_string() + " is undefined";
+        case DiagnosticCode::TYPE_TEMPLATE_IS_PRIVATE:
+          return "type template " + key_ident_str + " is private";
+        case DiagnosticCode::TYPE_TEMPLATE_IS_UNDEFINED:
+          return "type template " + _M_ident->to_string() + " is undefined";
+        case DiagnosticCode::ALIAS_REFERS_TO_UNDEFINED_VARIABLE:
+          return "alias variable " + key_ident_str + " refers to undefined variable";
+        case DiagnosticCode::ALIAS_REFERS_TO_ALIAS_CYCLE:
+          return "alias variable " + key_ident_str + " refers to alias cycle";
+      }
+      return string();
+    }
+
+    //
+    // A DiagnosticList class.
+    //
+
+    const size_t DiagnosticList::unlimited;
+
+    void DiagnosticList::append_errors(list<Error> &errors, const AbsoluteIdentifierTable &table) const
+    { for(auto &diag : _M_diags) errors.push_back(diag.to_error(table)); }
+  }
+}
@@ -8,6 +8,7 @@
 #ifndef _FRONTEND_DRIVER_HPP
 #define _FRONTEND_DRIVER_HPP
 
+#include <functional>
 #include <lesfl/frontend/tree.hpp>
 #include <lesfl/comp.hpp>
 
@@ -20,16 +21,41 @@ namespace lesfl
       class Driver
       {
         const Source &_M_source;
-        Tree &_M_tree;
+        Tree *_M_tree;
+        std::function<void (std::unique_ptr<Definition>)> _M_def_fun;
+        std::unique_ptr<Expression> _M_expr;
         std::list<Error> &_M_errors;
       public:
         Driver(const Source &source, Tree &tree, std::list<Error> &errors) :
-          _M_source(source), _M_tree(tree), _M_errors(errors) {}
+          _M_source(source), _M_tree(&tree), _M_errors(errors) {}
+
+        Driver(const Source &source, const std::function<void (std::unique_ptr<Definition>)> &def_fun, std::list<Error> &errors) :
+          _M_source(source), _M_tree(nullptr), _M_def_fun(def_fun), _M_errors(errors) {}
+
+        Driver(const Source &source, std::list<Error> &errors) :
+          _M_source(source), _M_tree(nullptr), _M_errors(errors) {}
 
         const Source &source() const { return _M_source; }
 
-        void add_defs(const std::list<std::unique_ptr<Definition>> *defs)
-        { _M_tree.add_defs(defs); }
+        void add_defs(const NodeList<Definition> *defs)
+        {
+          if(_M_tree != nullptr)
+            _M_tree->add_defs(defs);
+          else
+            delete defs;
+        }
+
+        void add_top_def(NodeList<Definition> *defs, Definition *def)
+        {
+          if(_M_def_fun)
+            _M_def_fun(std::unique_ptr<Definition>(def));
+          else
+            defs->push_back(std::unique_ptr<Definition>(def));
+        }
+
+        void set_expr(Expression *expr) { _M_expr.reset(expr); }
+
+        Expression *release_expr() { return _M_expr.release(); }
 
         void add_error(const Error &error) { _M_errors.push_back(error); }
       };
@@ -0,0 +1,1056 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <lesfl/frontend.hpp>
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace
+    {
+      struct FingerprinterContext
+      {
+        const Tree &tree;
+        string *str;
+        bool is_success;
+
+        FingerprinterContext(const Tree &tree) : tree(tree), str(nullptr), is_success(true) {}
+      };
+
+      // Each node is appended as a tag with scalar fields and numbers of
+      // children before the children and as a closing parenthesis after the
+      // children, so a string of nodes is unambiguous.
+      class FingerprinterVisitor : public priv::NodeVisitor
+      {
+        FingerprinterContext &_M_context;
+        priv::NodeWalker _M_walker;
+      public:
+        FingerprinterVisitor(FingerprinterContext &context) : _M_context(context), _M_walker(*this) {}
+
+        priv::NodeWalker &walker() { return _M_walker; }
+
+        bool enter_var(Variable *var);
+
+        void leave_var(Variable *var) { close(); }
+
+        bool enter_fun(Function *fun);
+
+        void leave_fun(Function *fun) { close(); }
+
+        bool enter_inst(Instance *inst);
+
+        void leave_inst(Instance *inst) { close(); }
+
+        bool enter_type_var(TypeVariable *var);
+
+        void leave_type_var(TypeVariable *var) { close(); }
+
+        bool enter_type_fun(TypeFunction *fun);
+
+        void leave_type_fun(TypeFunction *fun) { close(); }
+
+        bool enter_type_fun_inst(TypeFunctionInstance *inst);
+
+        void leave_type_fun_inst(TypeFunctionInstance *inst) { close(); }
+
+        bool enter_datatype(Datatype *datatype);
+
+        void leave_datatype(Datatype *datatype) { close(); }
+
+        bool enter_constr(Constructor *constr);
+
+        void leave_constr(Constructor *constr) { close(); }
+
+        bool enter_type_named_field_pair(TypeNamedFieldPair *pair);
+
+        void leave_type_named_field_pair(TypeNamedFieldPair *pair) { close(); }
+
+        bool enter_arg(Argument *arg);
+
+        void leave_arg(Argument *arg) { close(); }
+
+        bool enter_type_expr(TypeExpression *expr);
+
+        void leave_type_expr(TypeExpression *expr) { close(); }
+
+        bool enter_expr(Expression *expr);
+
+        void leave_expr(Expression *expr);
+
+        bool enter_expr_named_field_pair(ExpressionNamedFieldPair *pair);
+
+        void leave_expr_named_field_pair(ExpressionNamedFieldPair *pair) { close(); }
+
+        bool enter_binding(Binding *bind);
+
+        void leave_binding(Binding *bind) { close(); }
+
+        bool enter_case(Case *caze);
+
+        void leave_case(Case *caze) { close(); }
+
+        bool enter_pattern(Pattern *pattern);
+
+        void leave_pattern(Pattern *pattern);
+
+        bool enter_pattern_named_field_pair(PatternNamedFieldPair *pair);
+
+        void leave_pattern_named_field_pair(PatternNamedFieldPair *pair) { close(); }
+
+        bool enter_literal_value(LiteralValue *value);
+
+        void leave_literal_value(LiteralValue *value) { close(); }
+
+        bool enter_value(Value *value);
+
+        void leave_value(Value *value);
+
+        bool enter_value_named_field_pair(ValueNamedFieldPair *pair);
+
+        void leave_value_named_field_pair(ValueNamedFieldPair *pair) { close(); }
+      private:
+        void close() { *(_M_context.str) += ')'; }
+      };
+    }
+
+    //
+    // Static inline functions and static functions.
+    //
+
+    static inline void append_string(string &str, const string &s)
+    {
+      str += to_string(s.length());
+      str += ':';
+      str += s;
+    }
+
+    static inline void append_int(string &str, int64_t i)
+    {
+      str += to_string(i);
+      str += ';';
+    }
+
+    static void append_ident(string &str, const Tree &tree, const Identifier *ident)
+    {
+      if(ident->has_key_ident()) {
+        const AbsoluteIdentifier *abs_ident = ident->abs_ident(*(tree.ident_table()));
+        if(abs_ident != nullptr) {
+          str += 'K';
+          append_string(str, abs_ident->to_string());
+          return;
+        }
+      }
+      str += 'I';
+      append_string(str, ident->to_string());
+    }
+
+    static inline void append_count(string &str, size_t count)
+    { append_int(str, static_cast<int64_t>(count)); }
+
+    static inline void append_flag(string &str, bool flag)
+    { str += (flag ? '1' : '0'); }
+
+    static void append_annotations(string &str, const NodeList<Annotation> &annotations)
+    {
+      str += '(';
+      for(auto &annotation : annotations) append_string(str, annotation->ident());
+      str += ')';
+    }
+
+    static void append_type_params(string &str, const NodeList<TypeParameter> &params)
+    {
+      str += '(';
+      for(auto &param : params) append_string(str, param->ident());
+      str += ')';
+    }
+
+    static void append_char_value(string &str, char c)
+    {
+      str += "(char";
+      append_int(str, c);
+      str += ')';
+    }
+
+    static void append_int_value(string &str, IntType int_type, int64_t i)
+    {
+      str += "(int";
+      append_int(str, static_cast<int64_t>(int_type));
+      append_int(str, i);
+      str += ')';
+    }
+
+    static void append_float_value(string &str, FloatType float_type, double f)
+    {
+      str += "(float";
+      append_int(str, static_cast<int64_t>(float_type));
+      uint64_t bits;
+      memcpy(&bits, &f, sizeof(bits));
+      append_string(str, to_string(bits));
+      str += ')';
+    }
+
+    static void append_packed_elems(string &str, const PackedElements &elems)
+    {
+      // Packed elements are appended like literal values of a collection
+      // value, so packing doesn't change a fingerprint.
+      append_count(str, elems.size());
+      for(size_t i = 0; i < elems.size(); i++) {
+        switch(elems.elem_type()) {
+          case PackedElementType::CHAR:
+            append_char_value(str, elems.char_elem(i));
+            break;
+          case PackedElementType::INT8:
+            append_int_value(str, IntType::INT8, elems.int_elem(i));
+            break;
+          case PackedElementType::INT16:
+            append_int_value(str, IntType::INT16, elems.int_elem(i));
+            break;
+          case PackedElementType::INT32:
+            append_int_value(str, IntType::INT32, elems.int_elem(i));
+            break;
+          case PackedElementType::INT64:
+            append_int_value(str, IntType::INT64, elems.int_elem(i));
+            break;
+          case PackedElementType::SINGLE_FLOAT:
+            append_float_value(str, FloatType::SINGLE, elems.float_elem(i));
+            break;
+          case PackedElementType::DOUBLE_FLOAT:
+            append_float_value(str, FloatType::DOUBLE, elems.float_elem(i));
+            break;
+        }
+      }
+    }
+
+    static bool parse_body(FingerprinterContext &context, Bodied *bodied)
+    {
+      list<Error> errors;
+      if(!bodied->parse_body(errors)) {
+        context.is_success = false;
+        return false;
+      }
+      return true;
+    }
+
+    static uint64_t hash_string(const string &str)
+    {
+      // The 64-bit version of the FNV-1a algorithm.
+      uint64_t h = 0xcbf29ce484222325ULL;
+      for(char c : str) {
+        h ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
+        h *= 0x100000001b3ULL;
+      }
+      return h;
+    }
+
+    static bool get_module_key_ident(const Tree &tree, KeyIdentifier key_ident, KeyIdentifier &module_key_ident)
+    {
+      const AbsoluteIdentifier *abs_ident = tree.ident_table()->ident(key_ident);
+      if(abs_ident == nullptr) return false;
+      AbsoluteIdentifier module_abs_ident;
+      if(!abs_ident->get_module_ident(module_abs_ident)) return false;
+      if(!module_abs_ident.set_key_ident(*(tree.ident_table()))) return false;
+      module_key_ident = module_abs_ident.key_ident();
+      return true;
+    }
+
+    static void add_entry(unordered_map<KeyIdentifier, vector<pair<string, string>>> &entries, const Tree &tree, KeyIdentifier key_ident, char kind, const string &str)
+    {
+      KeyIdentifier module_key_ident;
+      if(!get_module_key_ident(tree, key_ident, module_key_ident)) return;
+      string name(1, kind);
+      name += tree.ident_table()->ident(key_ident)->to_string();
+      entries[module_key_ident].push_back(make_pair(name, str));
+    }
+
+    //
+    // A FingerprinterVisitor class.
+    //
+
+    bool FingerprinterVisitor::enter_var(Variable *var)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(var,
+      [&](Variable *var) {
+        str += '?';
+        return false;
+      },
+      [&](UserDefinedVariable *var) {
+        str += "(uvar";
+        if(var->is_template()) append_type_params(str, var->inst_type_params());
+        // Values of variables without types and variable templates are
+        // visible to importers.
+        bool is_visible = (var->value() != nullptr && (var->type_expr() == nullptr || var->is_template()));
+        append_flag(str, var->type_expr() != nullptr);
+        append_flag(str, is_visible);
+        _M_walker.walk_opt(var->type_expr());
+        if(is_visible) _M_walker.walk(var->value());
+        close();
+        return false;
+      },
+      [&](ExternalVariable *var) {
+        str += "(evar";
+        append_flag(str, var->type_expr() != nullptr);
+        append_string(str, var->external_var_ident());
+        return true;
+      },
+      [&](AliasVariable *var) {
+        str += "(avar";
+        if(var->is_template()) append_type_params(str, var->inst_type_params());
+        append_flag(str, var->type_expr() != nullptr);
+        append_ident(str, _M_context.tree, var->ident());
+        return true;
+      },
+      [&](FunctionVariable *var) {
+        str += "(fvar";
+        return true;
+      },
+      [&](ConstructorVariable *var) {
+        str += "(constrvar";
+        return true;
+      },
+      [&](LibraryVariable *var) {
+        str += "(lvar)";
+        return false;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_fun(Function *fun)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(fun,
+      [&](Function *fun) {
+        str += '?';
+        return false;
+      },
+      [&](UserDefinedFunction *fun) {
+        str += "(ufun";
+        if(fun->is_template()) append_type_params(str, fun->inst_type_params());
+        append_annotations(str, fun->annotations());
+        append_int(str, static_cast<int64_t>(fun->inline_modifier()));
+        append_int(str, static_cast<int64_t>(fun->fun_modifier()));
+        append_count(str, fun->args().size());
+        // Bodies of inline functions, function templates and functions without
+        // full typing are visible to importers.
+        bool is_visible = (fun->inline_modifier() == InlineModifier::INLINE || fun->is_template() || fun->result_type_expr() == nullptr);
+        for(auto &arg : fun->args()) is_visible |= (arg->type_expr() == nullptr);
+        append_flag(str, fun->result_type_expr() != nullptr);
+        append_flag(str, is_visible);
+        for(auto &arg : fun->args()) _M_walker.walk(arg.get());
+        _M_walker.walk_opt(fun->result_type_expr());
+        // A visible body is parsed if it is deferred, so a fingerprint
+        // doesn't depend on deferred parsing.
+        if(is_visible) {
+          if(parse_body(_M_context, fun))
+            _M_walker.walk_opt(fun->body());
+        }
+        close();
+        return false;
+      },
+      [&](ExternalFunction *fun) {
+        str += "(efun";
+        append_int(str, static_cast<int64_t>(fun->fun_modifier()));
+        append_count(str, fun->args().size());
+        append_flag(str, fun->result_type_expr() != nullptr);
+        append_string(str, fun->external_fun_ident());
+        return true;
+      },
+      [&](NativeFunction *fun) {
+        str += "(nfun";
+        append_annotations(str, fun->annotations());
+        append_int(str, static_cast<int64_t>(fun->inline_modifier()));
+        append_int(str, static_cast<int64_t>(fun->fun_modifier()));
+        append_count(str, fun->args().size());
+        append_flag(str, fun->result_type_expr() != nullptr);
+        append_string(str, fun->native_fun_ident());
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_inst(Instance *inst)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(inst,
+      [&](Instance *inst) {
+        str += '?';
+        return false;
+      },
+      [&](VariableInstance *inst) {
+        str += "(vinst";
+        return true;
+      },
+      [&](FunctionInstance *inst) {
+        str += "(finst";
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_type_var(TypeVariable *var)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(var,
+      [&](TypeVariable *var) {
+        str += '?';
+        return false;
+      },
+      [&](TypeSynonymVariable *var) {
+        str += "(tsvar";
+        return true;
+      },
+      [&](DatatypeVariable *var) {
+        str += "(dtvar";
+        return true;
+      },
+      [&](BuiltinTypeVariable *var) {
+        str += "(btvar";
+        append_int(str, static_cast<int64_t>(var->builtin_type()));
+        close();
+        return false;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_type_fun(TypeFunction *fun)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(fun,
+      [&](TypeFunction *fun) {
+        str += '?';
+        return false;
+      },
+      [&](TypeSynonymFunction *fun) {
+        str += "(tsfun";
+        append_type_params(str, fun->inst_type_params());
+        append_int(str, static_cast<int64_t>(fun->arg_count()));
+        for(auto &arg : fun->args()) append_string(str, arg->ident());
+        append_flag(str, fun->body() != nullptr);
+        return true;
+      },
+      [&](DatatypeFunction *fun) {
+        str += "(dtfun";
+        append_type_params(str, fun->inst_type_params());
+        append_int(str, static_cast<int64_t>(fun->arg_count()));
+        for(auto &arg : fun->args()) append_string(str, arg->ident());
+        return true;
+      },
+      [&](BuiltinTypeFunction *fun) {
+        str += "(btfun";
+        append_int(str, static_cast<int64_t>(fun->arg_count()));
+        append_int(str, static_cast<int64_t>(fun->builtin_type_template()));
+        close();
+        return false;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_type_fun_inst(TypeFunctionInstance *inst)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(inst,
+      [&](TypeFunctionInstance *inst) {
+        str += '?';
+        return false;
+      },
+      [&](TypeSynonymFunctionInstance *inst) {
+        str += "(tsinst";
+        append_int(str, inst->is_template() ? 1 : 0);
+        append_count(str, inst->args().size());
+        return true;
+      },
+      [&](DatatypeFunctionInstance *inst) {
+        str += "(dtinst";
+        append_int(str, inst->is_template() ? 1 : 0);
+        append_count(str, inst->args().size());
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_datatype(Datatype *datatype)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(datatype,
+      [&](Datatype *datatype) {
+        str += '?';
+        return false;
+      },
+      [&](NonUniqueDatatype *datatype) {
+        str += "(datatype";
+        append_count(str, datatype->constrs().size());
+        return true;
+      },
+      [&](UniqueDatatype *datatype) {
+        str += "(udatatype";
+        append_count(str, datatype->constrs().size());
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_constr(Constructor *constr)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(constr,
+      [&](Constructor *constr) {
+        str += '?';
+        return false;
+      },
+      [&](VariableConstructor *constr) {
+        str += "(vconstr";
+        append_int(str, static_cast<int64_t>(constr->access_modifier()));
+        append_string(str, constr->ident());
+        close();
+        return false;
+      },
+      [&](UnnamedFieldConstructor *constr) {
+        str += "(fconstr";
+        append_annotations(str, constr->annotations());
+        append_int(str, static_cast<int64_t>(constr->access_modifier()));
+        append_int(str, static_cast<int64_t>(constr->inline_modifier()));
+        append_string(str, constr->ident());
+        append_count(str, constr->field_types().size());
+        return true;
+      },
+      [&](NamedFieldConstructor *constr) {
+        str += "(nfconstr";
+        append_annotations(str, constr->annotations());
+        append_int(str, static_cast<int64_t>(constr->access_modifier()));
+        append_int(str, static_cast<int64_t>(constr->inline_modifier()));
+        append_string(str, constr->ident());
+        append_count(str, constr->field_types().size());
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_type_named_field_pair(TypeNamedFieldPair *pair)
+    {
+      string &str = *(_M_context.str);
+      str += "(tfield";
+      append_string(str, pair->ident());
+      return true;
+    }
+
+    bool FingerprinterVisitor::enter_arg(Argument *arg)
+    {
+      string &str = *(_M_context.str);
+      str += "(arg";
+      append_string(str, arg->ident());
+      append_flag(str, arg->type_expr() != nullptr);
+      return true;
+    }
+
+    bool FingerprinterVisitor::enter_type_expr(TypeExpression *expr)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(expr,
+      [&](TypeExpression *expr) {
+        str += '?';
+        return false;
+      },
+      [&](With *with) {
+        str += "(with";
+        return true;
+      },
+      [&](TypeVariableExpression *type_var_expr) {
+        str += "(tvar";
+        append_ident(str, _M_context.tree, type_var_expr->ident());
+        close();
+        return false;
+      },
+      [&](TypeParameterExpression *type_param_expr) {
+        str += "(tparam";
+        append_string(str, type_param_expr->ident());
+        close();
+        return false;
+      },
+      [&](NonUniqueTupleType *tuple_type) {
+        str += "(ttuple";
+        append_count(str, tuple_type->field_types().size());
+        return true;
+      },
+      [&](UniqueTupleType *tuple_type) {
+        str += "(tutuple";
+        append_count(str, tuple_type->field_types().size());
+        return true;
+      },
+      [&](NonUniqueFunctionType *fun_type) {
+        str += "(tfun";
+        append_int(str, static_cast<int64_t>(fun_type->fun_modifier()));
+        append_count(str, fun_type->arg_types().size());
+        return true;
+      },
+      [&](UniqueFunctionType *fun_type) {
+        str += "(tufun";
+        append_count(str, fun_type->arg_types().size());
+        return true;
+      },
+      [&](TypeApplication *type_app) {
+        str += "(tapp";
+        append_ident(str, _M_context.tree, type_app->fun_ident());
+        append_count(str, type_app->args().size());
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_expr(Expression *expr)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(expr,
+      [&](Expression *expr) {
+        str += '?';
+        return false;
+      },
+      [&](DeferredExpression *deferred_expr) {
+        // Deferred bodies are parsed before they are walked.
+        _M_context.is_success = false;
+        return false;
+      },
+      [&](Literal *literal) {
+        return true;
+      },
+      [&](List *list) {
+        str += "(list";
+        append_count(str, list->elems().size());
+        return true;
+      },
+      [&](NonUniqueArray *array) {
+        str += "(array";
+        append_count(str, array->elems().size());
+        return true;
+      },
+      [&](UniqueArray *array) {
+        str += "(uarray";
+        append_count(str, array->elems().size());
+        return true;
+      },
+      [&](NonUniqueTuple *tuple) {
+        str += "(tuple";
+        append_count(str, tuple->fields().size());
+        return true;
+      },
+      [&](UniqueTuple *tuple) {
+        str += "(utuple";
+        append_count(str, tuple->fields().size());
+        return true;
+      },
+      [&](VariableExpression *var_expr) {
+        str += "(var";
+        append_ident(str, _M_context.tree, var_expr->ident());
+        close();
+        return false;
+      },
+      [&](NamedFieldConstructorApplication *app) {
+        str += "(capp";
+        append_ident(str, _M_context.tree, app->constr_ident());
+        append_count(str, app->fields().size());
+        return true;
+      },
+      [&](NonUniqueApplication *app) {
+        str += "(app";
+        append_int(str, static_cast<int64_t>(app->fun_modifier()));
+        append_count(str, app->args().size());
+        return true;
+      },
+      [&](UniqueApplication *app) {
+        str += "(uapp";
+        append_count(str, app->args().size());
+        return true;
+      },
+      [&](BuiltinApplication *app) {
+        str += "(bapp";
+        append_int(str, static_cast<int64_t>(app->fun()));
+        append_count(str, app->args().size());
+        return true;
+      },
+      [&](Field *field) {
+        str += "(field";
+        append_int(str, field->i());
+        return true;
+      },
+      [&](UniqueField *field) {
+        str += "(ufield";
+        append_int(str, field->i());
+        return true;
+      },
+      [&](SetUniqueField *set_field) {
+        str += "(setufield";
+        append_int(str, set_field->i());
+        return true;
+      },
+      [&](NamedField *field) {
+        str += "(nfield";
+        append_string(str, field->ident());
+        return true;
+      },
+      [&](UniqueNamedField *field) {
+        str += "(unfield";
+        append_string(str, field->ident());
+        return true;
+      },
+      [&](SetUniqueNamedField *set_field) {
+        str += "(setunfield";
+        append_string(str, set_field->ident());
+        return true;
+      },
+      [&](TypedExpression *typed_expr) {
+        str += "(typed";
+        return true;
+      },
+      [&](Let *let) {
+        str += "(let";
+        append_count(str, let->binds().size());
+        return true;
+      },
+      [&](Match *match) {
+        str += "(match";
+        append_count(str, match->cases().size());
+        return true;
+      },
+      [&](Throw *throv) {
+        str += "(throw";
+        return true;
+      });
+    }
+
+    void FingerprinterVisitor::leave_expr(Expression *expr)
+    {
+      // A literal is appended as its literal value.
+      if(dynamic_cast<Literal *>(expr) == nullptr) close();
+    }
+
+    bool FingerprinterVisitor::enter_expr_named_field_pair(ExpressionNamedFieldPair *pair)
+    {
+      string &str = *(_M_context.str);
+      str += "(efield";
+      append_string(str, pair->ident());
+      return true;
+    }
+
+    bool FingerprinterVisitor::enter_binding(Binding *bind)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(bind,
+      [&](Binding *bind) {
+        str += '?';
+        return false;
+      },
+      [&](VariableBinding *bind) {
+        str += "(vbind";
+        append_string(str, bind->ident());
+        return true;
+      },
+      [&](TupleBinding *bind) {
+        str += "(tbind";
+        for(auto &var : bind->vars()) {
+          if(var.get() != nullptr)
+            append_string(str, var->ident());
+          else
+            str += '_';
+        }
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_case(Case *caze)
+    {
+      *(_M_context.str) += "(case";
+      return true;
+    }
+
+    bool FingerprinterVisitor::enter_pattern(Pattern *pattern)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(pattern,
+      [&](Pattern *pattern) {
+        str += '?';
+        return false;
+      },
+      [&](VariableConstructorPattern *pattern) {
+        str += "(cvar";
+        append_ident(str, _M_context.tree, pattern->constr_ident());
+        close();
+        return false;
+      },
+      [&](UnnamedFieldConstructorPattern *pattern) {
+        str += "(capp";
+        append_ident(str, _M_context.tree, pattern->constr_ident());
+        append_count(str, pattern->field_patterns().size());
+        return true;
+      },
+      [&](NamedFieldConstructorPattern *pattern) {
+        str += "(ncapp";
+        append_ident(str, _M_context.tree, pattern->constr_ident());
+        append_count(str, pattern->field_patterns().size());
+        return true;
+      },
+      [&](ListPattern *pattern) {
+        str += "(list";
+        append_count(str, pattern->elem_patterns().size());
+        return true;
+      },
+      [&](NonUniqueArrayPattern *pattern) {
+        str += "(array";
+        append_count(str, pattern->elem_patterns().size());
+        return true;
+      },
+      [&](UniqueArrayPattern *pattern) {
+        str += "(uarray";
+        append_count(str, pattern->elem_patterns().size());
+        return true;
+      },
+      [&](NonUniqueTuplePattern *pattern) {
+        str += "(tuple";
+        append_count(str, pattern->field_patterns().size());
+        return true;
+      },
+      [&](UniqueTuplePattern *pattern) {
+        str += "(utuple";
+        append_count(str, pattern->field_patterns().size());
+        return true;
+      },
+      [&](LiteralPattern *pattern) {
+        return true;
+      },
+      [&](VariablePattern *pattern) {
+        str += "(pvar";
+        append_string(str, pattern->ident());
+        close();
+        return false;
+      },
+      [&](AsPattern *pattern) {
+        str += "(as";
+        append_string(str, pattern->ident());
+        return true;
+      },
+      [&](WildcardPattern *pattern) {
+        str += '_';
+        return false;
+      },
+      [&](TypedPattern *pattern) {
+        str += "(typed";
+        return true;
+      });
+    }
+
+    void FingerprinterVisitor::leave_pattern(Pattern *pattern)
+    {
+      // A literal pattern is appended as its literal value.
+      if(dynamic_cast<LiteralPattern *>(pattern) == nullptr) close();
+    }
+
+    bool FingerprinterVisitor::enter_pattern_named_field_pair(PatternNamedFieldPair *pair)
+    {
+      string &str = *(_M_context.str);
+      str += "(pfield";
+      append_string(str, pair->ident());
+      return true;
+    }
+
+    bool FingerprinterVisitor::enter_literal_value(LiteralValue *value)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(value,
+      [&](LiteralValue *value) {
+        str += '?';
+        return false;
+      },
+      [&](CharValue *value) {
+        append_char_value(str, value->c());
+        return false;
+      },
+      [&](WideCharValue *value) {
+        str += "(wchar";
+        append_int(str, value->c());
+        close();
+        return false;
+      },
+      [&](IntValue *value) {
+        append_int_value(str, value->int_type(), value->i());
+        return false;
+      },
+      [&](FloatValue *value) {
+        append_float_value(str, value->float_type(), value->f());
+        return false;
+      },
+      [&](StringValue *value) {
+        str += "(string";
+        append_string(str, value->string());
+        close();
+        return false;
+      },
+      [&](WideStringValue *value) {
+        str += "(wstring";
+        for(wchar_t c : value->string()) append_int(str, c);
+        close();
+        return false;
+      },
+      [&](NonUniqueLambdaValue *value) {
+        if(!parse_body(_M_context, value)) return false;
+        str += "(lambda";
+        append_int(str, static_cast<int64_t>(value->inline_modifier()));
+        append_int(str, static_cast<int64_t>(value->fun_modifier()));
+        append_count(str, value->args().size());
+        append_flag(str, value->result_type_expr() != nullptr);
+        return true;
+      },
+      [&](UniqueLambdaValue *value) {
+        if(!parse_body(_M_context, value)) return false;
+        str += "(ulambda";
+        append_int(str, static_cast<int64_t>(value->inline_modifier()));
+        append_count(str, value->args().size());
+        append_flag(str, value->result_type_expr() != nullptr);
+        return true;
+      });
+    }
+
+    bool FingerprinterVisitor::enter_value(Value *value)
+    {
+      string &str = *(_M_context.str);
+      return dynamic_match(value,
+      [&](Value *value) {
+        str += '?';
+        return false;
+      },
+      [&](VariableLiteralValue *value) {
+        return true;
+      },
+      [&](ListValue *value) {
+        str += "(list";
+        append_count(str, value->elems().size());
+        return true;
+      },
+      [&](ArrayValue *value) {
+        str += "(array";
+        append_count(str, value->elems().size());
+        return true;
+      },
+      [&](PackedListValue *value) {
+        str += "(list";
+        append_packed_elems(str, value->elems());
+        close();
+        return false;
+      },
+      [&](PackedArrayValue *value) {
+        str += "(array";
+        append_packed_elems(str, value->elems());
+        close();
+        return false;
+      },
+      [&](TupleValue *value) {
+        str += "(tuple";
+        append_count(str, value->fields().size());
+        return true;
+      },
+      [&](VariableConstructorValue *value) {
+        str += "(cvar";
+        append_ident(str, _M_context.tree, value->constr_ident());
+        close();
+        return false;
+      },
+      [&](UnnamedFieldConstructorValue *value) {
+        str += "(capp";
+        append_ident(str, _M_context.tree, value->constr_ident());
+        append_count(str, value->fields().size());
+        return true;
+      },
+      [&](NamedFieldConstructorValue *value) {
+        str += "(ncapp";
+        append_ident(str, _M_context.tree, value->constr_ident());
+        append_count(str, value->fields().size());
+        return true;
+      },
+      [&](TypedValue *typed_value) {
+        str += "(typed";
+        return true;
+      });
+    }
+
+    void FingerprinterVisitor::leave_value(Value *value)
+    {
+      // A variable literal value is appended as its literal value.
+      if(dynamic_cast<VariableLiteralValue *>(value) == nullptr) close();
+    }
+
+    bool FingerprinterVisitor::enter_value_named_field_pair(ValueNamedFieldPair *pair)
+    {
+      string &str = *(_M_context.str);
+      str += "(vfield";
+      append_string(str, pair->ident());
+      return true;
+    }
+
+    //
+    // A Fingerprinter class.
+    //
+
+    Fingerprinter::~Fingerprinter() {}
+
+    bool Fingerprinter::fingerprint_modules(const Tree &tree, unordered_map<KeyIdentifier, uint64_t> &fingerprints)
+    {
+      FingerprinterContext context(tree);
+      FingerprinterVisitor visitor(context);
+      unordered_map<KeyIdentifier, vector<pair<string, string>>> entries;
+      for(auto &tmp_pair : tree.var_infos()) {
+        const VariableInfo &info = tmp_pair.second;
+        if(info.access_modifier() == AccessModifier::PRIVATE) continue;
+        string str;
+        context.str = &str;
+        visitor.walker().walk(info.var().get());
+        for(auto &inst : *(info.insts())) visitor.walker().walk(inst.get());
+        add_entry(entries, tree, tmp_pair.first, 'v', str);
+      }
+      for(auto &tmp_pair : tree.type_var_infos()) {
+        const TypeVariableInfo &info = tmp_pair.second;
+        if(info.access_modifier() == AccessModifier::PRIVATE) continue;
+        string str;
+        context.str = &str;
+        visitor.walker().walk(info.var().get());
+        add_entry(entries, tree, tmp_pair.first, 't', str);
+      }
+      for(auto &tmp_pair : tree.type_fun_infos()) {
+        const TypeFunctionInfo &info = tmp_pair.second;
+        if(info.access_modifier() == AccessModifier::PRIVATE) continue;
+        string str;
+        context.str = &str;
+        visitor.walker().walk(info.fun().get());
+        for(auto &inst : *(info.insts())) visitor.walker().walk(inst.get());
+        add_entry(entries, tree, tmp_pair.first, 'f', str);
+      }
+      if(!context.is_success) return false;
+      fingerprints.clear();
+      for(auto module_key_ident : tree.module_key_idents()) {
+        string str;
+        auto iter = entries.find(module_key_ident);
+        if(iter != entries.end()) {
+          sort(iter->second.begin(), iter->second.end());
+          for(auto &entry : iter->second) {
+            append_string(str, entry.first);
+            append_string(str, entry.second);
+          }
+        }
+        fingerprints.insert(make_pair(module_key_ident, hash_string(str)));
+      }
+      return true;
+    }
+
+    bool Fingerprinter::fingerprint_modules(const Tree &tree, Interface &iface)
+    {
+      unordered_map<KeyIdentifier, uint64_t> fingerprints;
+      if(!fingerprint_modules(tree, fingerprints)) return false;
+      for(auto &tmp_pair : fingerprints) {
+        const AbsoluteIdentifier *abs_ident = tree.ident_table()->ident(tmp_pair.first);
+        if(abs_ident == nullptr) return false;
+        iface.set_module_fingerprint(abs_ident->to_string(), tmp_pair.second);
+      }
+      return true;
+    }
+  }
+}
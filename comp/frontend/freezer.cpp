@@ -0,0 +1,985 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <lesfl/frontend.hpp>
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace
+    {
+      struct FreezerContext
+      {
+        const Tree &tree;
+        FrozenTree &frozen_tree;
+        list<Error> &errors;
+        unordered_map<string, uint32_t> string_indices;
+        bool is_success;
+        vector<uint32_t> nodes;
+        vector<size_t> child_starts;
+        FrozenNodeKind def_kind;
+        const Position *def_pos;
+        unordered_map<const Constructor *, KeyIdentifier> constr_key_idents;
+
+        FreezerContext(const Tree &tree, FrozenTree &frozen_tree, list<Error> &errors) :
+          tree(tree), frozen_tree(frozen_tree), errors(errors), is_success(true),
+          def_kind(FrozenNodeKind::VARIABLE), def_pos(nullptr) {}
+      };
+
+      class FreezerVisitor : public priv::NodeVisitor
+      {
+        FreezerContext &_M_context;
+      public:
+        FreezerVisitor(FreezerContext &context) : _M_context(context) {}
+
+        bool enter_var(Variable *var);
+
+        void leave_var(Variable *var);
+
+        bool enter_fun(Function *fun);
+
+        void leave_fun(Function *fun);
+
+        bool enter_type_var(TypeVariable *var);
+
+        void leave_type_var(TypeVariable *var);
+
+        bool enter_type_fun(TypeFunction *fun);
+
+        void leave_type_fun(TypeFunction *fun);
+
+        bool enter_type_fun_inst(TypeFunctionInstance *inst);
+
+        void leave_type_fun_inst(TypeFunctionInstance *inst);
+
+        bool enter_datatype(Datatype *datatype);
+
+        void leave_datatype(Datatype *datatype);
+
+        bool enter_constr(Constructor *constr);
+
+        void leave_constr(Constructor *constr);
+
+        bool enter_type_named_field_pair(TypeNamedFieldPair *pair);
+
+        void leave_type_named_field_pair(TypeNamedFieldPair *pair);
+
+        bool enter_arg(Argument *arg);
+
+        void leave_arg(Argument *arg);
+
+        bool enter_type_expr(TypeExpression *expr);
+
+        void leave_type_expr(TypeExpression *expr);
+
+        bool enter_expr(Expression *expr);
+
+        void leave_expr(Expression *expr);
+
+        bool enter_expr_named_field_pair(ExpressionNamedFieldPair *pair);
+
+        void leave_expr_named_field_pair(ExpressionNamedFieldPair *pair);
+
+        bool enter_binding(Binding *bind);
+
+        void leave_binding(Binding *bind);
+
+        bool enter_case(Case *caze);
+
+        void leave_case(Case *caze);
+
+        bool enter_pattern(Pattern *pattern);
+
+        void leave_pattern(Pattern *pattern);
+
+        bool enter_pattern_named_field_pair(PatternNamedFieldPair *pair);
+
+        void leave_pattern_named_field_pair(PatternNamedFieldPair *pair);
+
+        bool enter_value(Value *value);
+
+        void leave_value(Value *value);
+
+        bool enter_value_named_field_pair(ValueNamedFieldPair *pair);
+
+        void leave_value_named_field_pair(ValueNamedFieldPair *pair);
+      };
+    }
+
+    //
+    // Static inline functions and static functions.
+    //
+
+    static uint32_t add_string(FreezerContext &context, const string &str)
+    {
+      auto iter = context.string_indices.find(str);
+      if(iter != context.string_indices.end()) return iter->second;
+      uint32_t i = context.frozen_tree.add_string(str);
+      context.string_indices.insert(make_pair(str, i));
+      return i;
+    }
+
+    static uint32_t add_node(FreezerContext &context, FrozenNodeKind kind, uint8_t flags, uint64_t data, const vector<uint32_t> &children, const Position &pos)
+    {
+      if(context.frozen_tree.node_count() >= FrozenTree::null_node) {
+        if(context.is_success) context.errors.push_back(Error(pos, "too many nodes to freeze tree"));
+        context.is_success = false;
+        return FrozenTree::null_node;
+      }
+      uint32_t source_string_index = add_string(context, pos.source().file_name());
+      return context.frozen_tree.add_node(kind, flags, data, children.data(), children.size(), source_string_index, pos.line(), pos.column());
+    }
+
+    static inline uint32_t add_node(FreezerContext &context, FrozenNodeKind kind, uint64_t data, const Position &pos)
+    { return add_node(context, kind, 0, data, vector<uint32_t>(), pos); }
+
+    static uint64_t key_ident_data(FreezerContext &context, const Identifier *ident, const Position &pos)
+    {
+      if(!ident->has_key_ident()) {
+        context.errors.push_back(Error(pos, "identifier " + ident->to_string() + " is unresolved"));
+        context.is_success = false;
+        return 0;
+      }
+      return ident->key_ident().key();
+    }
+
+    static inline uint8_t inline_and_fun_modifier_flags(InlineModifier inline_modifier, FunctionModifier fun_modifier)
+    { return static_cast<uint8_t>(inline_modifier) | (static_cast<uint8_t>(fun_modifier) << 4); }
+
+    static inline void begin_node(FreezerContext &context)
+    { context.child_starts.push_back(context.nodes.size()); }
+
+    static inline void take_children(FreezerContext &context, vector<uint32_t> &children)
+    { children.assign(context.nodes.begin() + context.child_starts.back(), context.nodes.end()); }
+
+    static inline void end_node(FreezerContext &context, uint32_t node)
+    {
+      context.nodes.resize(context.child_starts.back());
+      context.child_starts.pop_back();
+      context.nodes.push_back(node);
+    }
+
+    static void take_fun_children(FreezerContext &context, const NodeList<Argument> &args, const TypeExpression *result_type_expr, const Bodied *bodied, const Position &pos, vector<uint32_t> &children)
+    {
+      // Absent children are null nodes, so children of a function are always
+      // arguments, a result type and a body.
+      take_children(context, children);
+      if(result_type_expr == nullptr) children.insert(children.begin() + args.size(), FrozenTree::null_node);
+      if(bodied->has_deferred_body()) {
+        context.errors.push_back(Error(pos, "body isn't parsed and resolved"));
+        context.is_success = false;
+      } else if(bodied->body() == nullptr)
+        children.push_back(FrozenTree::null_node);
+    }
+
+    static uint32_t freeze_literal_value(FreezerContext &context, LiteralValue *value, const Position &pos)
+    {
+      return dynamic_match(value,
+      [&](LiteralValue *value) -> uint32_t {
+        context.errors.push_back(Error(pos, "internal error: unknown literal value"));
+        context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](CharValue *value) -> uint32_t {
+        return add_node(context, FrozenNodeKind::CHAR, static_cast<unsigned char>(value->c()), pos);
+      },
+      [&](WideCharValue *value) -> uint32_t {
+        return add_node(context, FrozenNodeKind::WIDE_CHAR, static_cast<uint64_t>(value->c()), pos);
+      },
+      [&](IntValue *value) -> uint32_t {
+        return add_node(context, FrozenNodeKind::INT, static_cast<uint8_t>(value->int_type()), static_cast<uint64_t>(value->i()), vector<uint32_t>(), pos);
+      },
+      [&](FloatValue *value) -> uint32_t {
+        double f = value->f();
+        uint64_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return add_node(context, FrozenNodeKind::FLOAT, static_cast<uint8_t>(value->float_type()), bits, vector<uint32_t>(), pos);
+      },
+      [&](StringValue *value) -> uint32_t {
+        return add_node(context, FrozenNodeKind::STRING, add_string(context, value->string()), pos);
+      },
+      [&](WideStringValue *value) -> uint32_t {
+        return add_node(context, FrozenNodeKind::WIDE_STRING, context.frozen_tree.add_wstring(value->string()), pos);
+      },
+      [&](NonUniqueLambdaValue *value) -> uint32_t {
+        vector<uint32_t> children;
+        take_fun_children(context, value->args(), value->result_type_expr(), value, pos, children);
+        return add_node(context, FrozenNodeKind::NON_UNIQUE_LAMBDA, inline_and_fun_modifier_flags(value->inline_modifier(), value->fun_modifier()), 0, children, pos);
+      },
+      [&](UniqueLambdaValue *value) -> uint32_t {
+        vector<uint32_t> children;
+        take_fun_children(context, value->args(), value->result_type_expr(), value, pos, children);
+        return add_node(context, FrozenNodeKind::UNIQUE_LAMBDA, static_cast<uint8_t>(value->inline_modifier()), 0, children, pos);
+      });
+    }
+
+    static uint32_t freeze_packed_elems(FreezerContext &context, const PackedElements &elems)
+    {
+      // Elements are stored in their own width like in PackedElements.
+      vector<char> data;
+      size_t elem_size = PackedElements::elem_size(elems.elem_type());
+      data.resize(elems.size() * elem_size);
+      for(size_t i = 0; i < elems.size(); i++) {
+        char *elem_data = data.data() + i * elem_size;
+        switch(elems.elem_type()) {
+          case PackedElementType::CHAR:
+            *elem_data = elems.char_elem(i);
+            break;
+          case PackedElementType::INT8:
+          {
+            int8_t x = elems.int_elem(i);
+            memcpy(elem_data, &x, sizeof(x));
+            break;
+          }
+          case PackedElementType::INT16:
+          {
+            int16_t x = elems.int_elem(i);
+            memcpy(elem_data, &x, sizeof(x));
+            break;
+          }
+          case PackedElementType::INT32:
+          {
+            int32_t x = elems.int_elem(i);
+            memcpy(elem_data, &x, sizeof(x));
+            break;
+          }
+          case PackedElementType::INT64:
+          {
+            int64_t x = elems.int_elem(i);
+            memcpy(elem_data, &x, sizeof(x));
+            break;
+          }
+          case PackedElementType::SINGLE_FLOAT:
+          {
+            float x = elems.float_elem(i);
+            memcpy(elem_data, &x, sizeof(x));
+            break;
+          }
+          case PackedElementType::DOUBLE_FLOAT:
+          {
+            double x = elems.float_elem(i);
+            memcpy(elem_data, &x, sizeof(x));
+            break;
+          }
+        }
+      }
+      return context.frozen_tree.add_packed_elems(data.data(), data.size(), elems.size());
+    }
+
+    template<typename _T>
+    static inline uint64_t template_data(const _T *definable)
+    { return definable->is_template() ? 1 + definable->inst_type_params().size() : 0; }
+
+    static const Position *get_def_pos(const UserDefinedVariable *var)
+    {
+      if(var->value() != nullptr) return &(var->value()->pos());
+      if(var->type_expr() != nullptr) return &(var->type_expr()->pos());
+      return nullptr;
+    }
+
+    static const Position *get_def_pos(const UserDefinedFunction *fun)
+    {
+      if(!fun->args().empty()) return &(fun->args().front()->pos());
+      if(fun->result_type_expr() != nullptr) return &(fun->result_type_expr()->pos());
+      if(!fun->has_deferred_body() && fun->body() != nullptr) return &(fun->body()->pos());
+      return nullptr;
+    }
+
+    template<typename _T>
+    static uint32_t freeze_def(FreezerContext &context, priv::NodeWalker &walker, FrozenNodeKind kind, _T *definable, const Position &pos)
+    {
+      context.def_kind = kind;
+      context.def_pos = &pos;
+      walker.walk(definable);
+      uint32_t node = context.nodes.back();
+      context.nodes.pop_back();
+      return node;
+    }
+
+    static void freeze_var_info(FreezerContext &context, priv::NodeWalker &walker, KeyIdentifier key_ident, const VariableInfo &info)
+    {
+      Position no_pos(Source(), 0, 0);
+      dynamic_match(info.var().get(),
+      [&](Variable *var) {},
+      [&](UserDefinedVariable *var) {
+        const Position *pos = get_def_pos(var);
+        context.frozen_tree.add_def(key_ident, freeze_def(context, walker, FrozenNodeKind::VARIABLE, static_cast<Variable *>(var), pos != nullptr ? *pos : no_pos));
+      },
+      [&](FunctionVariable *var) {
+        UserDefinedFunction *fun = dynamic_cast<UserDefinedFunction *>(var->fun().get());
+        if(fun != nullptr) {
+          const Position *pos = get_def_pos(fun);
+          context.frozen_tree.add_def(key_ident, freeze_def(context, walker, FrozenNodeKind::FUNCTION, static_cast<Function *>(fun), pos != nullptr ? *pos : no_pos));
+        }
+      });
+      for(auto &inst : *(info.insts())) {
+        dynamic_match(inst.get(),
+        [&](Instance *inst) {},
+        [&](VariableInstance *inst) {
+          UserDefinedVariable *var = dynamic_cast<UserDefinedVariable *>(inst->var().get());
+          if(var != nullptr)
+            context.frozen_tree.add_def(key_ident, freeze_def(context, walker, FrozenNodeKind::VARIABLE_INSTANCE, static_cast<Variable *>(var), inst->pos()));
+        },
+        [&](FunctionInstance *inst) {
+          UserDefinedFunction *fun = dynamic_cast<UserDefinedFunction *>(inst->fun().get());
+          if(fun != nullptr)
+            context.frozen_tree.add_def(key_ident, freeze_def(context, walker, FrozenNodeKind::FUNCTION_INSTANCE, static_cast<Function *>(fun), inst->pos()));
+        });
+      }
+    }
+
+    static const Position *get_def_pos(Datatype *datatype)
+    {
+      return dynamic_match(datatype,
+      [](Datatype *datatype) -> const Position * {
+        return nullptr;
+      },
+      [](NonUniqueDatatype *datatype) -> const Position * {
+        return !datatype->constrs().empty() ? &(datatype->constrs().front()->pos()) : nullptr;
+      },
+      [](UniqueDatatype *datatype) -> const Position * {
+        return !datatype->constrs().empty() ? &(datatype->constrs().front()->pos()) : nullptr;
+      });
+    }
+
+    static const Position *get_def_pos(TypeVariable *var)
+    {
+      return dynamic_match(var,
+      [](TypeVariable *var) -> const Position * {
+        return nullptr;
+      },
+      [](TypeSynonymVariable *var) -> const Position * {
+        return &(var->expr()->pos());
+      },
+      [](DatatypeVariable *var) -> const Position * {
+        return get_def_pos(var->datatype());
+      });
+    }
+
+    static const Position *get_def_pos(const DefinableTypeFunction *fun)
+    { return !fun->args().empty() ? &(fun->args().front()->pos()) : nullptr; }
+
+    static void freeze_type_var_info(FreezerContext &context, priv::NodeWalker &walker, KeyIdentifier key_ident, const TypeVariableInfo &info)
+    {
+      Position no_pos(Source(), 0, 0);
+      dynamic_match(info.var().get(),
+      [&](TypeVariable *var) {},
+      [&](TypeSynonymVariable *var) {
+        const Position *pos = get_def_pos(var);
+        context.frozen_tree.add_type_def(key_ident, freeze_def(context, walker, FrozenNodeKind::TYPE_SYNONYM_VARIABLE, static_cast<TypeVariable *>(var), pos != nullptr ? *pos : no_pos));
+      },
+      [&](DatatypeVariable *var) {
+        const Position *pos = get_def_pos(var);
+        context.frozen_tree.add_type_def(key_ident, freeze_def(context, walker, FrozenNodeKind::DATATYPE_VARIABLE, static_cast<TypeVariable *>(var), pos != nullptr ? *pos : no_pos));
+      });
+    }
+
+    static void freeze_type_fun_info(FreezerContext &context, priv::NodeWalker &walker, KeyIdentifier key_ident, const TypeFunctionInfo &info)
+    {
+      Position no_pos(Source(), 0, 0);
+      dynamic_match(info.fun().get(),
+      [&](TypeFunction *fun) {},
+      [&](TypeSynonymFunction *fun) {
+        const Position *pos = get_def_pos(fun);
+        context.frozen_tree.add_type_def(key_ident, freeze_def(context, walker, FrozenNodeKind::TYPE_SYNONYM_FUNCTION, static_cast<TypeFunction *>(fun), pos != nullptr ? *pos : no_pos));
+      },
+      [&](DatatypeFunction *fun) {
+        const Position *pos = get_def_pos(fun);
+        context.frozen_tree.add_type_def(key_ident, freeze_def(context, walker, FrozenNodeKind::DATATYPE_FUNCTION, static_cast<TypeFunction *>(fun), pos != nullptr ? *pos : no_pos));
+      });
+      for(auto &inst : *(info.insts())) {
+        dynamic_match(inst.get(),
+        [&](TypeFunctionInstance *inst) {},
+        [&](TypeSynonymFunctionInstance *inst) {
+          context.frozen_tree.add_type_def(key_ident, freeze_def(context, walker, FrozenNodeKind::TYPE_SYNONYM_FUNCTION_INSTANCE, static_cast<TypeFunctionInstance *>(inst), inst->pos()));
+        },
+        [&](DatatypeFunctionInstance *inst) {
+          context.frozen_tree.add_type_def(key_ident, freeze_def(context, walker, FrozenNodeKind::DATATYPE_FUNCTION_INSTANCE, static_cast<TypeFunctionInstance *>(inst), inst->pos()));
+        });
+      }
+    }
+
+    template<typename _T>
+    static void get_sorted_key_idents(const unordered_map<KeyIdentifier, _T> &map, vector<KeyIdentifier> &key_idents)
+    {
+      // Key identifiers are sorted so that a frozen tree doesn't depend on an
+      // order of a hash table.
+      key_idents.clear();
+      key_idents.reserve(map.size());
+      for(auto &tmp_pair : map) key_idents.push_back(tmp_pair.first);
+      sort(key_idents.begin(), key_idents.end(), [](KeyIdentifier key_ident1, KeyIdentifier key_ident2) {
+        return key_ident1.key() < key_ident2.key();
+      });
+    }
+
+    static void freeze_idents(FreezerContext &context)
+    {
+      const AbsoluteIdentifierTable &ident_table = *(context.tree.ident_table());
+      vector<KeyIdentifier> key_idents;
+      get_sorted_key_idents(ident_table.ident_map(), key_idents);
+      vector<uint32_t> string_indices;
+      for(auto key_ident : key_idents) {
+        string_indices.clear();
+        for(auto &ident : ident_table.ident(key_ident)->idents())
+          string_indices.push_back(add_string(context, ident));
+        context.frozen_tree.add_ident(key_ident, string_indices.data(), string_indices.size());
+      }
+    }
+
+    //
+    // A FreezerVisitor class.
+    //
+
+    bool FreezerVisitor::enter_var(Variable *var)
+    {
+      if(dynamic_cast<UserDefinedVariable *>(var) == nullptr) return false;
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_var(Variable *var)
+    {
+      UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var);
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      if(user_defined_var->type_expr() == nullptr) children.insert(children.begin(), FrozenTree::null_node);
+      if(user_defined_var->value() == nullptr) children.push_back(FrozenTree::null_node);
+      end_node(_M_context, add_node(_M_context, _M_context.def_kind, 0, template_data(user_defined_var), children, *(_M_context.def_pos)));
+    }
+
+    bool FreezerVisitor::enter_fun(Function *fun)
+    {
+      if(dynamic_cast<UserDefinedFunction *>(fun) == nullptr) return false;
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_fun(Function *fun)
+    {
+      UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun);
+      const Position &pos = *(_M_context.def_pos);
+      vector<uint32_t> children;
+      take_fun_children(_M_context, user_defined_fun->args(), user_defined_fun->result_type_expr(), user_defined_fun, pos, children);
+      uint8_t flags = inline_and_fun_modifier_flags(user_defined_fun->inline_modifier(), user_defined_fun->fun_modifier());
+      end_node(_M_context, add_node(_M_context, _M_context.def_kind, flags, template_data(user_defined_fun), children, pos));
+    }
+
+    bool FreezerVisitor::enter_type_var(TypeVariable *var)
+    {
+      if(dynamic_cast<DefinableTypeVariable *>(var) == nullptr) return false;
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_type_var(TypeVariable *var)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, _M_context.def_kind, 0, 0, children, *(_M_context.def_pos)));
+    }
+
+    bool FreezerVisitor::enter_type_fun(TypeFunction *fun)
+    {
+      if(dynamic_cast<DefinableTypeFunction *>(fun) == nullptr) return false;
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_type_fun(TypeFunction *fun)
+    {
+      DefinableTypeFunction *definable_fun = dynamic_cast<DefinableTypeFunction *>(fun);
+      TypeSynonymFunction *type_synonym_fun = dynamic_cast<TypeSynonymFunction *>(fun);
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      if(type_synonym_fun != nullptr && type_synonym_fun->body() == nullptr) children.push_back(FrozenTree::null_node);
+      uint64_t data = definable_fun->args().size() | (static_cast<uint64_t>(definable_fun->inst_type_params().size()) << 32);
+      end_node(_M_context, add_node(_M_context, _M_context.def_kind, 0, data, children, *(_M_context.def_pos)));
+    }
+
+    bool FreezerVisitor::enter_type_fun_inst(TypeFunctionInstance *inst)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_type_fun_inst(TypeFunctionInstance *inst)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, _M_context.def_kind, (inst->is_template() ? 1 : 0), 0, children, inst->pos()));
+    }
+
+    bool FreezerVisitor::enter_datatype(Datatype *datatype)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_datatype(Datatype *datatype)
+    {
+      const Position &pos = *(_M_context.def_pos);
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, dynamic_match(datatype,
+      [&](Datatype *datatype) -> uint32_t {
+        _M_context.errors.push_back(Error(pos, "internal error: unknown datatype"));
+        _M_context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](NonUniqueDatatype *datatype) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_DATATYPE, 0, 0, children, pos);
+      },
+      [&](UniqueDatatype *datatype) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_DATATYPE, 0, 0, children, pos);
+      }));
+    }
+
+    bool FreezerVisitor::enter_constr(Constructor *constr)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_constr(Constructor *constr)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      uint64_t key = 0;
+      auto iter = _M_context.constr_key_idents.find(constr);
+      if(iter != _M_context.constr_key_idents.end()) {
+        key = iter->second.key();
+      } else {
+        _M_context.errors.push_back(Error(constr->pos(), "constructor " + constr->ident() + " isn't defined"));
+        _M_context.is_success = false;
+      }
+      end_node(_M_context, dynamic_match(constr,
+      [&](Constructor *constr) -> uint32_t {
+        _M_context.errors.push_back(Error(constr->pos(), "internal error: unknown constructor"));
+        _M_context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](VariableConstructor *constr) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::VARIABLE_CONSTRUCTOR, key, constr->pos());
+      },
+      [&](UnnamedFieldConstructor *constr) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNNAMED_FIELD_CONSTRUCTOR, static_cast<uint8_t>(constr->inline_modifier()), key, children, constr->pos());
+      },
+      [&](NamedFieldConstructor *constr) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NAMED_FIELD_CONSTRUCTOR, static_cast<uint8_t>(constr->inline_modifier()), key, children, constr->pos());
+      }));
+    }
+
+    bool FreezerVisitor::enter_type_named_field_pair(TypeNamedFieldPair *pair)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_type_named_field_pair(TypeNamedFieldPair *pair)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, FrozenNodeKind::TYPE_NAMED_FIELD, 0, add_string(_M_context, pair->ident()), children, pair->pos()));
+    }
+
+    bool FreezerVisitor::enter_arg(Argument *arg)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_arg(Argument *arg)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      if(arg->type_expr() == nullptr) children.push_back(FrozenTree::null_node);
+      end_node(_M_context, add_node(_M_context, FrozenNodeKind::ARGUMENT, 0, arg->index(), children, arg->pos()));
+    }
+
+    bool FreezerVisitor::enter_type_expr(TypeExpression *expr)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_type_expr(TypeExpression *expr)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, dynamic_match(expr,
+      [&](TypeExpression *expr) -> uint32_t {
+        _M_context.errors.push_back(Error(expr->pos(), "internal error: unknown type expression"));
+        _M_context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](With *with) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::WITH, 0, 0, children, with->pos());
+      },
+      [&](TypeVariableExpression *type_var_expr) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, type_var_expr->ident(), type_var_expr->pos());
+        return add_node(_M_context, FrozenNodeKind::TYPE_VARIABLE, key, type_var_expr->pos());
+      },
+      [&](TypeParameterExpression *type_param_expr) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::TYPE_PARAMETER, type_param_expr->index(), type_param_expr->pos());
+      },
+      [&](NonUniqueTupleType *tuple_type) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_TUPLE_TYPE, 0, 0, children, tuple_type->pos());
+      },
+      [&](UniqueTupleType *tuple_type) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_TUPLE_TYPE, 0, 0, children, tuple_type->pos());
+      },
+      [&](NonUniqueFunctionType *fun_type) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_FUNCTION_TYPE, static_cast<uint8_t>(fun_type->fun_modifier()), 0, children, fun_type->pos());
+      },
+      [&](UniqueFunctionType *fun_type) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_FUNCTION_TYPE, 0, 0, children, fun_type->pos());
+      },
+      [&](TypeApplication *type_app) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, type_app->fun_ident(), type_app->pos());
+        return add_node(_M_context, FrozenNodeKind::TYPE_APPLICATION, 0, key, children, type_app->pos());
+      }));
+    }
+
+    bool FreezerVisitor::enter_expr(Expression *expr)
+    {
+      // A deferred body is reported by a function or a lambda.
+      if(dynamic_cast<DeferredExpression *>(expr) != nullptr) {
+        _M_context.nodes.push_back(FrozenTree::null_node);
+        return false;
+      }
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_expr(Expression *expr)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, dynamic_match(expr,
+      [&](Expression *expr) -> uint32_t {
+        _M_context.errors.push_back(Error(expr->pos(), "internal error: unknown expression"));
+        _M_context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](Literal *literal) -> uint32_t {
+        return freeze_literal_value(_M_context, literal->literal_value(), literal->pos());
+      },
+      [&](List *list) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::LIST, 0, 0, children, list->pos());
+      },
+      [&](NonUniqueArray *array) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_ARRAY, 0, 0, children, array->pos());
+      },
+      [&](UniqueArray *array) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_ARRAY, 0, 0, children, array->pos());
+      },
+      [&](NonUniqueTuple *tuple) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_TUPLE, 0, 0, children, tuple->pos());
+      },
+      [&](UniqueTuple *tuple) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_TUPLE, 0, 0, children, tuple->pos());
+      },
+      [&](VariableExpression *var_expr) -> uint32_t {
+        Identifier *ident = var_expr->ident();
+        if(!ident->has_key_ident()) {
+          RelativeIdentifier *rel_ident = dynamic_cast<RelativeIdentifier *>(ident);
+          if(rel_ident != nullptr)
+            return add_node(_M_context, FrozenNodeKind::LOCAL_VARIABLE, rel_ident->index(), var_expr->pos());
+        }
+        uint64_t key = key_ident_data(_M_context, ident, var_expr->pos());
+        return add_node(_M_context, FrozenNodeKind::GLOBAL_VARIABLE, key, var_expr->pos());
+      },
+      [&](NamedFieldConstructorApplication *app) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, app->constr_ident(), app->pos());
+        return add_node(_M_context, FrozenNodeKind::NAMED_FIELD_CONSTRUCTOR_APPLICATION, 0, key, children, app->pos());
+      },
+      [&](NonUniqueApplication *app) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_APPLICATION, static_cast<uint8_t>(app->fun_modifier()), 0, children, app->pos());
+      },
+      [&](UniqueApplication *app) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_APPLICATION, 0, 0, children, app->pos());
+      },
+      [&](BuiltinApplication *app) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::BUILTIN_APPLICATION, 0, static_cast<uint64_t>(app->fun()), children, app->pos());
+      },
+      [&](Field *field) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::FIELD, 0, static_cast<uint64_t>(field->i()), children, field->pos());
+      },
+      [&](UniqueField *field) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_FIELD, 0, static_cast<uint64_t>(field->i()), children, field->pos());
+      },
+      [&](SetUniqueField *set_field) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::SET_UNIQUE_FIELD, 0, static_cast<uint64_t>(set_field->i()), children, set_field->pos());
+      },
+      [&](NamedField *field) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NAMED_FIELD, 0, add_string(_M_context, field->ident()), children, field->pos());
+      },
+      [&](UniqueNamedField *field) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_NAMED_FIELD, 0, add_string(_M_context, field->ident()), children, field->pos());
+      },
+      [&](SetUniqueNamedField *set_field) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::SET_UNIQUE_NAMED_FIELD, 0, add_string(_M_context, set_field->ident()), children, set_field->pos());
+      },
+      [&](TypedExpression *typed_expr) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::TYPED_EXPRESSION, 0, 0, children, typed_expr->pos());
+      },
+      [&](Let *let) -> uint32_t {
+        for(auto &bind : let->binds()) {
+          if(dynamic_cast<VariableBinding *>(bind.get()) == nullptr && dynamic_cast<TupleBinding *>(bind.get()) == nullptr) {
+            _M_context.errors.push_back(Error(let->pos(), "internal error: unknown binding"));
+            _M_context.is_success = false;
+          }
+        }
+        return add_node(_M_context, FrozenNodeKind::LET, 0, 0, children, let->pos());
+      },
+      [&](Match *match) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::MATCH, 0, 0, children, match->pos());
+      },
+      [&](Throw *throv) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::THROW, 0, 0, children, throv->pos());
+      }));
+    }
+
+    bool FreezerVisitor::enter_expr_named_field_pair(ExpressionNamedFieldPair *pair)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_expr_named_field_pair(ExpressionNamedFieldPair *pair)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, FrozenNodeKind::EXPRESSION_NAMED_FIELD, 0, pair->index(), children, pair->pos()));
+    }
+
+    bool FreezerVisitor::enter_binding(Binding *bind)
+    {
+      begin_node(_M_context);
+      // Variables of a tuple binding are frozen before an expression.
+      TupleBinding *tuple_bind = dynamic_cast<TupleBinding *>(bind);
+      if(tuple_bind != nullptr) {
+        for(auto &var : tuple_bind->vars()) {
+          if(var.get() != nullptr)
+            _M_context.nodes.push_back(add_node(_M_context, FrozenNodeKind::TUPLE_BINDING_VARIABLE, var->index(), var->pos()));
+          else
+            _M_context.nodes.push_back(FrozenTree::null_node);
+        }
+      }
+      return true;
+    }
+
+    void FreezerVisitor::leave_binding(Binding *bind)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, dynamic_match(bind,
+      [&](Binding *bind) -> uint32_t {
+        // An unknown binding is reported by a let expression.
+        return FrozenTree::null_node;
+      },
+      [&](VariableBinding *bind) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::VARIABLE_BINDING, 0, bind->index(), children, bind->pos());
+      },
+      [&](TupleBinding *bind) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::TUPLE_BINDING, 0, 0, children, bind->expr()->pos());
+      }));
+    }
+
+    bool FreezerVisitor::enter_case(Case *caze)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_case(Case *caze)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, FrozenNodeKind::CASE, 0, 0, children, caze->pattern()->pos()));
+    }
+
+    bool FreezerVisitor::enter_pattern(Pattern *pattern)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_pattern(Pattern *pattern)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, dynamic_match(pattern,
+      [&](Pattern *pattern) -> uint32_t {
+        _M_context.errors.push_back(Error(pattern->pos(), "internal error: unknown pattern"));
+        _M_context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](VariableConstructorPattern *pattern) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, pattern->constr_ident(), pattern->pos());
+        return add_node(_M_context, FrozenNodeKind::VARIABLE_CONSTRUCTOR_PATTERN, key, pattern->pos());
+      },
+      [&](UnnamedFieldConstructorPattern *pattern) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, pattern->constr_ident(), pattern->pos());
+        return add_node(_M_context, FrozenNodeKind::UNNAMED_FIELD_CONSTRUCTOR_PATTERN, 0, key, children, pattern->pos());
+      },
+      [&](NamedFieldConstructorPattern *pattern) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, pattern->constr_ident(), pattern->pos());
+        return add_node(_M_context, FrozenNodeKind::NAMED_FIELD_CONSTRUCTOR_PATTERN, 0, key, children, pattern->pos());
+      },
+      [&](ListPattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::LIST_PATTERN, 0, 0, children, pattern->pos());
+      },
+      [&](NonUniqueArrayPattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_ARRAY_PATTERN, 0, 0, children, pattern->pos());
+      },
+      [&](UniqueArrayPattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_ARRAY_PATTERN, 0, 0, children, pattern->pos());
+      },
+      [&](NonUniqueTuplePattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::NON_UNIQUE_TUPLE_PATTERN, 0, 0, children, pattern->pos());
+      },
+      [&](UniqueTuplePattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::UNIQUE_TUPLE_PATTERN, 0, 0, children, pattern->pos());
+      },
+      [&](LiteralPattern *pattern) -> uint32_t {
+        return freeze_literal_value(_M_context, pattern->literal_value(), pattern->pos());
+      },
+      [&](VariablePattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::VARIABLE_PATTERN, pattern->index(), pattern->pos());
+      },
+      [&](AsPattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::AS_PATTERN, 0, pattern->index(), children, pattern->pos());
+      },
+      [&](WildcardPattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::WILDCARD_PATTERN, 0, pattern->pos());
+      },
+      [&](TypedPattern *pattern) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::TYPED_PATTERN, 0, 0, children, pattern->pos());
+      }));
+    }
+
+    bool FreezerVisitor::enter_pattern_named_field_pair(PatternNamedFieldPair *pair)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_pattern_named_field_pair(PatternNamedFieldPair *pair)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, FrozenNodeKind::PATTERN_NAMED_FIELD, 0, pair->index(), children, pair->pos()));
+    }
+
+    bool FreezerVisitor::enter_value(Value *value)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_value(Value *value)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, dynamic_match(value,
+      [&](Value *value) -> uint32_t {
+        _M_context.errors.push_back(Error(value->pos(), "internal error: unknown value"));
+        _M_context.is_success = false;
+        return FrozenTree::null_node;
+      },
+      [&](VariableLiteralValue *value) -> uint32_t {
+        return freeze_literal_value(_M_context, value->literal_value(), value->pos());
+      },
+      [&](ListValue *value) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::LIST_VALUE, 0, 0, children, value->pos());
+      },
+      [&](ArrayValue *value) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::ARRAY_VALUE, 0, 0, children, value->pos());
+      },
+      [&](PackedListValue *value) -> uint32_t {
+        uint32_t i = freeze_packed_elems(_M_context, value->elems());
+        return add_node(_M_context, FrozenNodeKind::PACKED_LIST_VALUE, static_cast<uint8_t>(value->elems().elem_type()), i, vector<uint32_t>(), value->pos());
+      },
+      [&](PackedArrayValue *value) -> uint32_t {
+        uint32_t i = freeze_packed_elems(_M_context, value->elems());
+        return add_node(_M_context, FrozenNodeKind::PACKED_ARRAY_VALUE, static_cast<uint8_t>(value->elems().elem_type()), i, vector<uint32_t>(), value->pos());
+      },
+      [&](TupleValue *value) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::TUPLE_VALUE, 0, 0, children, value->pos());
+      },
+      [&](VariableConstructorValue *value) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, value->constr_ident(), value->pos());
+        return add_node(_M_context, FrozenNodeKind::VARIABLE_CONSTRUCTOR_VALUE, key, value->pos());
+      },
+      [&](UnnamedFieldConstructorValue *value) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, value->constr_ident(), value->pos());
+        return add_node(_M_context, FrozenNodeKind::UNNAMED_FIELD_CONSTRUCTOR_VALUE, 0, key, children, value->pos());
+      },
+      [&](NamedFieldConstructorValue *value) -> uint32_t {
+        uint64_t key = key_ident_data(_M_context, value->constr_ident(), value->pos());
+        return add_node(_M_context, FrozenNodeKind::NAMED_FIELD_CONSTRUCTOR_VALUE, 0, key, children, value->pos());
+      },
+      [&](TypedValue *typed_value) -> uint32_t {
+        return add_node(_M_context, FrozenNodeKind::TYPED_VALUE, 0, 0, children, typed_value->pos());
+      }));
+    }
+
+    bool FreezerVisitor::enter_value_named_field_pair(ValueNamedFieldPair *pair)
+    {
+      begin_node(_M_context);
+      return true;
+    }
+
+    void FreezerVisitor::leave_value_named_field_pair(ValueNamedFieldPair *pair)
+    {
+      vector<uint32_t> children;
+      take_children(_M_context, children);
+      end_node(_M_context, add_node(_M_context, FrozenNodeKind::VALUE_NAMED_FIELD, 0, pair->index(), children, pair->pos()));
+    }
+
+    //
+    // A Freezer class.
+    //
+
+    Freezer::~Freezer() {}
+
+    bool Freezer::freeze(const Tree &tree, FrozenTree &frozen_tree, list<Error> &errors)
+    {
+      frozen_tree.clear();
+      FreezerContext context(tree, frozen_tree, errors);
+      FreezerVisitor visitor(context);
+      priv::NodeWalker walker(visitor);
+      for(auto &tmp_pair : tree.var_infos()) {
+        ConstructorVariable *constr_var = dynamic_cast<ConstructorVariable *>(tmp_pair.second.var().get());
+        if(constr_var != nullptr) context.constr_key_idents.insert(make_pair(constr_var->constr().get(), tmp_pair.first));
+      }
+      freeze_idents(context);
+      vector<KeyIdentifier> key_idents;
+      get_sorted_key_idents(tree.var_infos(), key_idents);
+      for(auto key_ident : key_idents)
+        freeze_var_info(context, walker, key_ident, *(tree.var_info(key_ident)));
+      get_sorted_key_idents(tree.type_var_infos(), key_idents);
+      for(auto key_ident : key_idents)
+        freeze_type_var_info(context, walker, key_ident, *(tree.type_var_info(key_ident)));
+      get_sorted_key_idents(tree.type_fun_infos(), key_idents);
+      for(auto key_ident : key_idents)
+        freeze_type_fun_info(context, walker, key_ident, *(tree.type_fun_info(key_ident)));
+      if(!context.is_success) frozen_tree.clear();
+      return context.is_success;
+    }
+  }
+}
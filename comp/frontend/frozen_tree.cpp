@@ -0,0 +1,260 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <lesfl/frontend/frozen_tree.hpp>
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    // Static inline functions and static functions.
+
+    static const char frozen_tree_magic[8] = { 'L', 'E', 'S', 'F', 'L', 'F', 'T', '2' };
+
+    // Numbers are written in the byte order of a host, so a frozen tree can
+    // only be read on a host that has the same byte order.
+    static const uint32_t frozen_tree_byte_order_mark = 0x01020304;
+
+    template<typename _T>
+    static void write_vector(ostream &os, const vector<_T> &xs)
+    {
+      uint64_t size = xs.size();
+      os.write(reinterpret_cast<const char *>(&size), sizeof(size));
+      if(!xs.empty()) os.write(reinterpret_cast<const char *>(xs.data()), xs.size() * sizeof(_T));
+    }
+
+    template<typename _T>
+    static bool read_vector(istream &is, vector<_T> &xs)
+    {
+      uint64_t size;
+      if(!is.read(reinterpret_cast<char *>(&size), sizeof(size))) return false;
+      xs.clear();
+      // Elements are read in chunks so that a corrupted size doesn't allocate
+      // more memory than the stream has.
+      const uint64_t chunk_size = 65536;
+      while(size > 0) {
+        uint64_t count = (size < chunk_size ? size : chunk_size);
+        size_t old_size = xs.size();
+        xs.resize(old_size + count);
+        if(!is.read(reinterpret_cast<char *>(xs.data() + old_size), count * sizeof(_T))) return false;
+        size -= count;
+      }
+      return true;
+    }
+
+    template<typename _T>
+    static bool are_offsets_correct(const vector<uint32_t> &offsets, const vector<_T> &xs)
+    {
+      if(offsets.empty() || offsets.front() != 0 || offsets.back() != xs.size()) return false;
+      for(size_t i = 1; i < offsets.size(); i++) {
+        if(offsets[i - 1] > offsets[i]) return false;
+      }
+      return true;
+    }
+
+    //
+    // A FrozenTree class.
+    //
+
+    const uint32_t FrozenTree::null_node;
+
+    FrozenTree::~FrozenTree() {}
+
+    wstring FrozenTree::wstring(uint32_t i) const
+    {
+      std::wstring str;
+      str.reserve(_M_wstring_offsets[i + 1] - _M_wstring_offsets[i]);
+      for(uint32_t j = _M_wstring_offsets[i]; j < _M_wstring_offsets[i + 1]; j++)
+        str += static_cast<wchar_t>(_M_wstring_chars[j]);
+      return str;
+    }
+
+    AbsoluteIdentifier FrozenTree::ident(size_t i) const
+    {
+      list<std::string> idents;
+      for(uint32_t j = _M_ident_offsets[i]; j < _M_ident_offsets[i + 1]; j++)
+        idents.push_back(string(_M_ident_string_indices[j]));
+      AbsoluteIdentifier abs_ident(idents);
+      abs_ident.set_key_ident(KeyIdentifier(_M_ident_key_idents[i]));
+      return abs_ident;
+    }
+
+    bool FrozenTree::find_ident(KeyIdentifier key_ident, AbsoluteIdentifier &ident) const
+    {
+      auto iter = lower_bound(_M_ident_key_idents.begin(), _M_ident_key_idents.end(), static_cast<uint64_t>(key_ident.key()));
+      if(iter == _M_ident_key_idents.end() || *iter != key_ident.key()) return false;
+      ident = this->ident(iter - _M_ident_key_idents.begin());
+      return true;
+    }
+
+    uint32_t FrozenTree::add_node(FrozenNodeKind kind, uint8_t flags, uint64_t data, const uint32_t *children, uint32_t child_count, uint32_t source_string_index, uint32_t line, uint32_t column)
+    {
+      uint32_t node = _M_kinds.size();
+      _M_kinds.push_back(kind);
+      _M_flags.push_back(flags);
+      _M_data.push_back(data);
+      _M_first_child_indices.push_back(_M_children.size());
+      _M_child_counts.push_back(child_count);
+      _M_source_string_indices.push_back(source_string_index);
+      _M_lines.push_back(line);
+      _M_columns.push_back(column);
+      _M_children.insert(_M_children.end(), children, children + child_count);
+      return node;
+    }
+
+    void FrozenTree::add_ident(KeyIdentifier key_ident, const uint32_t *string_indices, uint32_t string_index_count)
+    {
+      _M_ident_key_idents.push_back(key_ident.key());
+      _M_ident_string_indices.insert(_M_ident_string_indices.end(), string_indices, string_indices + string_index_count);
+      _M_ident_offsets.push_back(_M_ident_string_indices.size());
+    }
+
+    uint32_t FrozenTree::add_string(const std::string &str)
+    {
+      _M_string_chars.insert(_M_string_chars.end(), str.begin(), str.end());
+      _M_string_offsets.push_back(_M_string_chars.size());
+      return _M_string_offsets.size() - 2;
+    }
+
+    uint32_t FrozenTree::add_wstring(const std::wstring &str)
+    {
+      for(wchar_t c : str) _M_wstring_chars.push_back(static_cast<uint32_t>(c));
+      _M_wstring_offsets.push_back(_M_wstring_chars.size());
+      return _M_wstring_offsets.size() - 2;
+    }
+
+    uint32_t FrozenTree::add_packed_elems(const char *data, size_t size, uint32_t elem_count)
+    {
+      _M_packed_elem_offsets.push_back(_M_packed_elem_data.size());
+      _M_packed_elem_counts.push_back(elem_count);
+      _M_packed_elem_data.insert(_M_packed_elem_data.end(), data, data + size);
+      return _M_packed_elem_offsets.size() - 1;
+    }
+
+    void FrozenTree::clear()
+    {
+      _M_kinds.clear();
+      _M_flags.clear();
+      _M_data.clear();
+      _M_first_child_indices.clear();
+      _M_child_counts.clear();
+      _M_source_string_indices.clear();
+      _M_lines.clear();
+      _M_columns.clear();
+      _M_children.clear();
+      _M_def_key_idents.clear();
+      _M_def_nodes.clear();
+      _M_type_def_key_idents.clear();
+      _M_type_def_nodes.clear();
+      _M_ident_key_idents.clear();
+      _M_ident_offsets.assign(1, 0);
+      _M_ident_string_indices.clear();
+      _M_string_offsets.assign(1, 0);
+      _M_string_chars.clear();
+      _M_wstring_offsets.assign(1, 0);
+      _M_wstring_chars.clear();
+      _M_packed_elem_offsets.clear();
+      _M_packed_elem_counts.clear();
+      _M_packed_elem_data.clear();
+    }
+
+    void FrozenTree::write(ostream &os) const
+    {
+      os.write(frozen_tree_magic, sizeof(frozen_tree_magic));
+      os.write(reinterpret_cast<const char *>(&frozen_tree_byte_order_mark), sizeof(frozen_tree_byte_order_mark));
+      write_vector(os, _M_kinds);
+      write_vector(os, _M_flags);
+      write_vector(os, _M_data);
+      write_vector(os, _M_first_child_indices);
+      write_vector(os, _M_child_counts);
+      write_vector(os, _M_source_string_indices);
+      write_vector(os, _M_lines);
+      write_vector(os, _M_columns);
+      write_vector(os, _M_children);
+      write_vector(os, _M_def_key_idents);
+      write_vector(os, _M_def_nodes);
+      write_vector(os, _M_type_def_key_idents);
+      write_vector(os, _M_type_def_nodes);
+      write_vector(os, _M_ident_key_idents);
+      write_vector(os, _M_ident_offsets);
+      write_vector(os, _M_ident_string_indices);
+      write_vector(os, _M_string_offsets);
+      write_vector(os, _M_string_chars);
+      write_vector(os, _M_wstring_offsets);
+      write_vector(os, _M_wstring_chars);
+      write_vector(os, _M_packed_elem_offsets);
+      write_vector(os, _M_packed_elem_counts);
+      write_vector(os, _M_packed_elem_data);
+    }
+
+    bool FrozenTree::read(istream &is)
+    {
+      char magic[sizeof(frozen_tree_magic)];
+      bool is_success = true;
+      is_success &= static_cast<bool>(is.read(magic, sizeof(magic)));
+      is_success = is_success && (memcmp(magic, frozen_tree_magic, sizeof(magic)) == 0);
+      uint32_t byte_order_mark;
+      is_success = is_success && is.read(reinterpret_cast<char *>(&byte_order_mark), sizeof(byte_order_mark));
+      is_success = is_success && (byte_order_mark == frozen_tree_byte_order_mark);
+      is_success = is_success && read_vector(is, _M_kinds);
+      is_success = is_success && read_vector(is, _M_flags);
+      is_success = is_success && read_vector(is, _M_data);
+      is_success = is_success && read_vector(is, _M_first_child_indices);
+      is_success = is_success && read_vector(is, _M_child_counts);
+      is_success = is_success && read_vector(is, _M_source_string_indices);
+      is_success = is_success && read_vector(is, _M_lines);
+      is_success = is_success && read_vector(is, _M_columns);
+      is_success = is_success && read_vector(is, _M_children);
+      is_success = is_success && read_vector(is, _M_def_key_idents);
+      is_success = is_success && read_vector(is, _M_def_nodes);
+      is_success = is_success && read_vector(is, _M_type_def_key_idents);
+      is_success = is_success && read_vector(is, _M_type_def_nodes);
+      is_success = is_success && read_vector(is, _M_ident_key_idents);
+      is_success = is_success && read_vector(is, _M_ident_offsets);
+      is_success = is_success && read_vector(is, _M_ident_string_indices);
+      is_success = is_success && read_vector(is, _M_string_offsets);
+      is_success = is_success && read_vector(is, _M_string_chars);
+      is_success = is_success && read_vector(is, _M_wstring_offsets);
+      is_success = is_success && read_vector(is, _M_wstring_chars);
+      is_success = is_success && read_vector(is, _M_packed_elem_offsets);
+      is_success = is_success && read_vector(is, _M_packed_elem_counts);
+      is_success = is_success && read_vector(is, _M_packed_elem_data);
+      if(is_success) {
+        size_t node_count = _M_kinds.size();
+        is_success &= (_M_flags.size() == node_count && _M_data.size() == node_count);
+        is_success &= (_M_first_child_indices.size() == node_count && _M_child_counts.size() == node_count);
+        is_success &= (_M_source_string_indices.size() == node_count);
+        is_success &= (_M_lines.size() == node_count && _M_columns.size() == node_count);
+        is_success &= (_M_def_key_idents.size() == _M_def_nodes.size());
+        is_success &= (_M_type_def_key_idents.size() == _M_type_def_nodes.size());
+        is_success &= (_M_ident_offsets.size() == _M_ident_key_idents.size() + 1);
+        is_success &= are_offsets_correct(_M_ident_offsets, _M_ident_string_indices);
+        is_success &= is_sorted(_M_ident_key_idents.begin(), _M_ident_key_idents.end());
+        is_success &= are_offsets_correct(_M_string_offsets, _M_string_chars);
+        is_success &= are_offsets_correct(_M_wstring_offsets, _M_wstring_chars);
+        is_success &= (_M_packed_elem_offsets.size() == _M_packed_elem_counts.size());
+      }
+      if(is_success) {
+        for(size_t node = 0; node < _M_kinds.size() && is_success; node++) {
+          is_success &= (static_cast<uint64_t>(_M_first_child_indices[node]) + _M_child_counts[node] <= _M_children.size());
+          is_success &= (_M_source_string_indices[node] < _M_string_offsets.size() - 1);
+        }
+        for(uint32_t child : _M_children) is_success &= (child == null_node || child < _M_kinds.size());
+        for(uint32_t node : _M_def_nodes) is_success &= (node < _M_kinds.size());
+        for(uint32_t node : _M_type_def_nodes) is_success &= (node < _M_kinds.size());
+        for(uint32_t i : _M_ident_string_indices) is_success &= (i < _M_string_offsets.size() - 1);
+        for(uint32_t offset : _M_packed_elem_offsets) is_success &= (offset <= _M_packed_elem_data.size());
+      }
+      if(!is_success) clear();
+      return is_success;
+    }
+  }
+}
@@ -8,8 +8,10 @@
 #include <algorithm>
 #include <iterator>
 #include <utility>
+#include <vector>
 #include <lesfl/frontend/ident.hpp>
 #include "frontend/ident.hpp"
+#include "frontend/stats_collector.hpp"
 
 using namespace std;
 
@@ -173,13 +175,19 @@ namespace lesfl
       if(orig_ident->has_key_ident()) {
         return ident(orig_ident->key_ident());
       } else {
+        priv::count_ident_table_probe();
         auto iter = _M_ident_set.find(orig_ident);
-        return iter != _M_ident_set.end() ? *iter : nullptr;
+        if(iter == _M_ident_set.end()) {
+          priv::count_ident_lookup_miss();
+          return nullptr;
+        }
+        return *iter;
       }
     }
 
     bool AbsoluteIdentifierTable::add_ident(AbsoluteIdentifier *ident, KeyIdentifier &key_ident)
     {
+      priv::count_ident_table_probe();
       if(_M_ident_set.find(ident) != _M_ident_set.end()) return false;
       key_ident = KeyIdentifier(_M_ident_set.size());
       auto pair1 = _M_ident_map.insert(make_pair(key_ident, unique_ptr<const AbsoluteIdentifier>(ident)));
@@ -190,6 +198,7 @@ namespace lesfl
         _M_ident_map.erase(key_ident);
         return false;
       }
+      priv::count_interned_ident();
       return true;
     }
 
@@ -206,5 +215,26 @@ namespace lesfl
       key_ident = ident->key_ident();
       return true;
     }
+
+    void AbsoluteIdentifierTable::renumber_idents(unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      vector<pair<KeyIdentifier, unique_ptr<const AbsoluteIdentifier>>> pairs;
+      pairs.reserve(_M_ident_map.size());
+      for(auto &tmp_pair : _M_ident_map) pairs.push_back(make_pair(tmp_pair.first, move(tmp_pair.second)));
+      sort(pairs.begin(), pairs.end(), [](const pair<KeyIdentifier, unique_ptr<const AbsoluteIdentifier>> &pair1, const pair<KeyIdentifier, unique_ptr<const AbsoluteIdentifier>> &pair2) {
+        const list<string> &idents1 = pair1.second->idents();
+        const list<string> &idents2 = pair2.second->idents();
+        return lexicographical_compare(idents1.begin(), idents1.end(), idents2.begin(), idents2.end());
+      });
+      key_ident_map.clear();
+      _M_ident_map.clear();
+      for(size_t i = 0; i < pairs.size(); i++) {
+        KeyIdentifier key_ident(i);
+        key_ident_map.insert(make_pair(pairs[i].first, key_ident));
+        // An identifier from the table is only modified by the table.
+        const_cast<AbsoluteIdentifier *>(pairs[i].second.get())->set_key_ident(key_ident);
+        _M_ident_map.insert(make_pair(key_ident, move(pairs[i].second)));
+      }
+    }
   }
 }
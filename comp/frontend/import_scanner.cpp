@@ -0,0 +1,387 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <lesfl/frontend.hpp>
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    //
+    // Static inline functions and static functions.
+    //
+
+    namespace
+    {
+      enum class ScannerToken
+      {
+        END,
+        IDENT,
+        IMPORT,
+        MODULE,
+        DOT,
+        LBRACE,
+        RBRACE,
+        NEWLINE,
+        OTHER
+      };
+
+      struct ScannerContext
+      {
+        const Source &source;
+        const char *ptr;
+        const char *end;
+        unsigned line;
+        unsigned column;
+        unsigned token_line;
+        unsigned token_column;
+
+        ScannerContext(const Source &source, const string &str) :
+          source(source), ptr(str.data()), end(str.data() + str.length()), line(1), column(1), token_line(1), token_column(1) {}
+      };
+
+      struct ScannerScope
+      {
+        AbsoluteIdentifier module_ident;
+        bool has_last_import;
+        size_t last_import_index;
+
+        ScannerScope(const AbsoluteIdentifier &module_ident) :
+          module_ident(module_ident), has_last_import(false), last_import_index(0) {}
+
+        ScannerScope(const AbsoluteIdentifier &module_ident, const ScannerScope &scope) :
+          module_ident(module_ident), has_last_import(scope.has_last_import), last_import_index(scope.last_import_index) {}
+      };
+    }
+
+    static inline bool is_ident_char(char c)
+    { return c == '_' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'); }
+
+    static inline void advance(ScannerContext &context)
+    {
+      if(*(context.ptr) == '\n') {
+        context.line++;
+        context.column = 1;
+      } else
+        context.column++;
+      context.ptr++;
+    }
+
+    static inline bool has_chars(const ScannerContext &context, const char *str, size_t n)
+    { return static_cast<size_t>(context.end - context.ptr) >= n && string(context.ptr, n) == str; }
+
+    static void skip_spaces_and_comments(ScannerContext &context, bool can_skip_newlines)
+    {
+      while(context.ptr != context.end) {
+        char c = *(context.ptr);
+        if(c == ' ' || c == '\t' || c == '\r' || (c == '\n' && can_skip_newlines)) {
+          advance(context);
+        } else if(has_chars(context, "//", 2)) {
+          while(context.ptr != context.end && *(context.ptr) != '\n') advance(context);
+        } else if(has_chars(context, "/*", 2)) {
+          size_t depth = 0;
+          do {
+            if(has_chars(context, "/*", 2)) {
+              advance(context);
+              depth++;
+            } else if(has_chars(context, "*/", 2)) {
+              advance(context);
+              depth--;
+            }
+            advance(context);
+          } while(context.ptr != context.end && depth > 0);
+        } else
+          break;
+      }
+    }
+
+    static void skip_literal(ScannerContext &context, char quote)
+    {
+      advance(context);
+      while(context.ptr != context.end && *(context.ptr) != quote && *(context.ptr) != '\n') {
+        if(*(context.ptr) == '\\' && context.ptr + 1 != context.end) advance(context);
+        advance(context);
+      }
+      if(context.ptr != context.end && *(context.ptr) == quote) advance(context);
+    }
+
+    static ScannerToken next_token(ScannerContext &context, string &ident, bool can_skip_newlines)
+    {
+      skip_spaces_and_comments(context, can_skip_newlines);
+      context.token_line = context.line;
+      context.token_column = context.column;
+      if(context.ptr == context.end) return ScannerToken::END;
+      char c = *(context.ptr);
+      if(c == '\n') {
+        advance(context);
+        return ScannerToken::NEWLINE;
+      } else if(c == '\"' || c == '\'') {
+        skip_literal(context, c);
+        return ScannerToken::OTHER;
+      } else if(c == 'w' && context.ptr + 1 != context.end && (context.ptr[1] == '\"' || context.ptr[1] == '\'')) {
+        advance(context);
+        skip_literal(context, *(context.ptr));
+        return ScannerToken::OTHER;
+      } else if(c >= '0' && c <= '9') {
+        while(context.ptr != context.end && (is_ident_char(*(context.ptr)) || *(context.ptr) == '.')) advance(context);
+        return ScannerToken::OTHER;
+      } else if(is_ident_char(c)) {
+        const char *begin = context.ptr;
+        while(context.ptr != context.end && is_ident_char(*(context.ptr))) advance(context);
+        ident.assign(begin, context.ptr);
+        if(ident == "import") return ScannerToken::IMPORT;
+        if(ident == "module") return ScannerToken::MODULE;
+        return ScannerToken::IDENT;
+      } else if(c == '`') {
+        bool is_double = has_chars(context, "``", 2);
+        advance(context);
+        if(is_double) advance(context);
+        const char *begin = context.ptr;
+        while(context.ptr != context.end && *(context.ptr) != '`' && *(context.ptr) != '\n') advance(context);
+        ident.assign(begin, context.ptr);
+        if(context.ptr != context.end && *(context.ptr) == '`') advance(context);
+        if(is_double && context.ptr != context.end && *(context.ptr) == '`') advance(context);
+        return ScannerToken::IDENT;
+      }
+      advance(context);
+      switch(c) {
+        case '.':
+          return ScannerToken::DOT;
+        case '{':
+          return ScannerToken::LBRACE;
+        case '}':
+          return ScannerToken::RBRACE;
+        default:
+          return ScannerToken::OTHER;
+      }
+    }
+
+    static bool scan_module_ident(ScannerContext &context, Identifier *&ident, string &ident_str, unsigned &line, unsigned &column, ScannerToken &token)
+    {
+      string tmp_ident;
+      list<string> idents;
+      token = next_token(context, tmp_ident, true);
+      line = context.token_line;
+      column = context.token_column;
+      bool is_abs = (token == ScannerToken::DOT);
+      if(is_abs) token = next_token(context, tmp_ident, true);
+      while(token == ScannerToken::IDENT) {
+        idents.push_back(tmp_ident);
+        token = next_token(context, tmp_ident, false);
+        if(token != ScannerToken::DOT) break;
+        token = next_token(context, tmp_ident, true);
+        if(token != ScannerToken::IDENT) return false;
+      }
+      if(!is_abs && idents.empty()) return false;
+      if(is_abs)
+        ident = new AbsoluteIdentifier(idents);
+      else
+        ident = new RelativeIdentifier(idents);
+      ident_str = ident->to_string();
+      return true;
+    }
+
+    static string join_module_idents(const string &module_ident, const string &rel_ident)
+    { return module_ident == "." ? module_ident + rel_ident : module_ident + "." + rel_ident; }
+
+    // The imports of a source are resolved in their order, so the previous
+    // imports of an import are already resolved. An import that isn't
+    // resolved has an empty module identifier.
+    static void resolve_imports(const ScannedSource &scanned_source, const unordered_map<string, vector<size_t>> &module_source_indices, vector<string> &module_idents)
+    {
+      auto has_module = [&module_source_indices](const string &module_ident) {
+        return module_source_indices.find(module_ident) != module_source_indices.end();
+      };
+      module_idents.clear();
+      for(auto &import : scanned_source.imports()) {
+        string module_ident;
+        if(import.is_abs_module_ident()) {
+          if(has_module(import.module_ident())) module_ident = import.module_ident();
+        } else {
+          string tmp_module_ident = join_module_idents(import.current_module_ident(), import.module_ident());
+          if(has_module(tmp_module_ident)) module_ident = tmp_module_ident;
+          bool has_prev_import = import.has_prev_import();
+          size_t prev_import_index = import.prev_import_index();
+          while(module_ident.empty() && has_prev_import) {
+            const string &prev_module_ident = module_idents[prev_import_index];
+            if(!prev_module_ident.empty()) {
+              tmp_module_ident = join_module_idents(prev_module_ident, import.module_ident());
+              if(has_module(tmp_module_ident)) module_ident = tmp_module_ident;
+            }
+            const ScannedImport &prev_import = scanned_source.imports()[prev_import_index];
+            has_prev_import = prev_import.has_prev_import();
+            prev_import_index = prev_import.prev_import_index();
+          }
+          if(module_ident.empty()) {
+            tmp_module_ident = join_module_idents(".predef", import.module_ident());
+            if(has_module(tmp_module_ident)) module_ident = tmp_module_ident;
+          }
+        }
+        module_idents.push_back(module_ident);
+      }
+    }
+
+    static void scan_source(ScannerContext &context, ScannedSource &scanned_source)
+    {
+      vector<ScannerScope> scopes;
+      scopes.push_back(ScannerScope(AbsoluteIdentifier()));
+      string ident;
+      ScannerToken token = next_token(context, ident, true);
+      while(token != ScannerToken::END) {
+        switch(token) {
+          case ScannerToken::IMPORT:
+          {
+            Identifier *tmp_ident;
+            string ident_str;
+            unsigned line, column;
+            if(scan_module_ident(context, tmp_ident, ident_str, line, column, token)) {
+              unique_ptr<Identifier> module_ident(tmp_ident);
+              Position pos(context.source, line, column);
+              ScannerScope &scope = scopes.back();
+              if(scope.has_last_import)
+                scanned_source.add_import(ScannedImport(ident_str, scope.module_ident.to_string(), scope.last_import_index, pos));
+              else
+                scanned_source.add_import(ScannedImport(ident_str, scope.module_ident.to_string(), pos));
+              scope.has_last_import = true;
+              scope.last_import_index = scanned_source.imports().size() - 1;
+            }
+            continue;
+          }
+          case ScannerToken::MODULE:
+          {
+            Identifier *tmp_ident;
+            string ident_str;
+            unsigned line, column;
+            if(scan_module_ident(context, tmp_ident, ident_str, line, column, token)) {
+              unique_ptr<Identifier> module_ident(tmp_ident);
+              while(token == ScannerToken::NEWLINE) token = next_token(context, ident, true);
+              if(token == ScannerToken::LBRACE) {
+                const RelativeIdentifier *rel_ident = dynamic_cast<const RelativeIdentifier *>(module_ident.get());
+                AbsoluteIdentifier abs_ident;
+                if(rel_ident != nullptr)
+                  abs_ident = AbsoluteIdentifier(scopes.back().module_ident, *rel_ident);
+                else
+                  abs_ident = AbsoluteIdentifier(module_ident->idents());
+                scanned_source.add_module_ident(abs_ident.to_string());
+                scopes.push_back(ScannerScope(abs_ident, scopes.back()));
+                token = next_token(context, ident, true);
+              }
+            }
+            continue;
+          }
+          case ScannerToken::LBRACE:
+            scopes.push_back(ScannerScope(scopes.back().module_ident, scopes.back()));
+            break;
+          case ScannerToken::RBRACE:
+            if(scopes.size() > 1) scopes.pop_back();
+            break;
+          default:
+            break;
+        }
+        token = next_token(context, ident, true);
+      }
+    }
+
+    static string escape_depfile_path(const string &path)
+    {
+      string str;
+      for(char c : path) {
+        switch(c) {
+          case ' ':
+          case '#':
+          case '\\':
+            str += '\\';
+            str += c;
+            break;
+          case '$':
+            str += "$$";
+            break;
+          default:
+            str += c;
+            break;
+        }
+      }
+      return str;
+    }
+
+    //
+    // An ImportScanner class.
+    //
+
+    ImportScanner::~ImportScanner() {}
+
+    bool ImportScanner::scan(const Source &source, ScannedSource &scanned_source, list<Error> &errors)
+    {
+      SourceStream ss = source.open();
+      if(!ss.istream().good()) {
+        errors.push_back(Error(Position(source, 1, 1), "can't open file"));
+        return false;
+      }
+      ostringstream oss;
+      oss << ss.istream().rdbuf();
+      string str = oss.str();
+      ScannerContext context(source, str);
+      scanned_source.clear();
+      scan_source(context, scanned_source);
+      return true;
+    }
+
+    bool ImportScanner::write_depfile(ostream &os, const string &target, const vector<Source> &sources, const vector<Source> &search_sources, list<Error> &errors)
+    {
+      bool is_success = true;
+      unordered_map<string, vector<size_t>> module_source_indices;
+      vector<ScannedSource> scanned_sources(search_sources.size());
+      for(size_t i = 0; i < search_sources.size(); i++) {
+        if(!scan(search_sources[i], scanned_sources[i], errors)) {
+          is_success = false;
+          continue;
+        }
+        for(auto &module_ident : scanned_sources[i].module_idents())
+          module_source_indices[module_ident].push_back(i);
+      }
+      if(!is_success) return false;
+      set<string> dep_file_names;
+      vector<size_t> source_indices;
+      vector<bool> are_visited(search_sources.size(), false);
+      for(auto &source : sources) {
+        dep_file_names.insert(source.file_name());
+        for(size_t i = 0; i < search_sources.size(); i++) {
+          if(!are_visited[i] && search_sources[i].file_name() == source.file_name()) {
+            are_visited[i] = true;
+            source_indices.push_back(i);
+          }
+        }
+      }
+      vector<string> imported_module_idents;
+      while(!source_indices.empty()) {
+        size_t i = source_indices.back();
+        source_indices.pop_back();
+        resolve_imports(scanned_sources[i], module_source_indices, imported_module_idents);
+        for(auto &imported_module_ident : imported_module_idents) {
+          if(imported_module_ident.empty()) continue;
+          for(auto j : module_source_indices.find(imported_module_ident)->second) {
+            dep_file_names.insert(search_sources[j].file_name());
+            if(!are_visited[j]) {
+              are_visited[j] = true;
+              source_indices.push_back(j);
+            }
+          }
+        }
+      }
+      os << escape_depfile_path(target) << ":";
+      for(auto &dep_file_name : dep_file_names)
+        os << " \\\n  " << escape_depfile_path(dep_file_name);
+      os << "\n";
+      return os.good();
+    }
+  }
+}
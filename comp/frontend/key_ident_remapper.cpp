@@ -0,0 +1,214 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <unordered_set>
+#include <lesfl/frontend.hpp>
+#include "frontend/key_ident_remapper.hpp"
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace
+    {
+      struct KeyIdentifierRemapperContext
+      {
+        const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map;
+        unordered_set<const void *> visited_objects;
+
+        KeyIdentifierRemapperContext(const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map) :
+          key_ident_map(key_ident_map) {}
+      };
+
+      class KeyIdentifierRemapperVisitor : public priv::NodeVisitor
+      {
+        KeyIdentifierRemapperContext &_M_context;
+      public:
+        KeyIdentifierRemapperVisitor(KeyIdentifierRemapperContext &context) : _M_context(context) {}
+
+        bool enter_def(Definition *def);
+
+        bool enter_var(Variable *var);
+
+        bool enter_fun(Function *fun);
+
+        bool enter_inst(Instance *inst);
+
+        bool enter_type_var(TypeVariable *var);
+
+        bool enter_type_fun(TypeFunction *fun);
+
+        bool enter_type_fun_inst(TypeFunctionInstance *inst);
+
+        bool enter_constr(Constructor *constr);
+
+        bool enter_type_expr(TypeExpression *expr);
+
+        bool enter_expr(Expression *expr);
+
+        bool enter_pattern(Pattern *pattern);
+
+        bool enter_value(Value *value);
+      };
+    }
+
+    //
+    // Static inline functions and static functions.
+    //
+
+    template<typename _T>
+    static inline bool visit(KeyIdentifierRemapperContext &context, const _T *object)
+    { return context.visited_objects.insert(dynamic_cast<const void *>(object)).second; }
+
+    static inline KeyIdentifier new_key_ident(KeyIdentifierRemapperContext &context, KeyIdentifier key_ident)
+    {
+      auto iter = context.key_ident_map.find(key_ident);
+      return iter != context.key_ident_map.end() ? iter->second : key_ident;
+    }
+
+    static inline void remap_ident(KeyIdentifierRemapperContext &context, Identifier *ident)
+    { if(ident->has_key_ident()) ident->set_key_ident(new_key_ident(context, ident->key_ident())); }
+
+    static void remap_infos(priv::NodeWalker &walker, const Tree &tree)
+    {
+      for(auto &tmp_pair : tree.var_infos()) {
+        const VariableInfo &info = tmp_pair.second;
+        walker.walk(info.var().get());
+        for(auto &inst : *(info.insts())) walker.walk(inst.get());
+      }
+      for(auto &tmp_pair : tree.type_var_infos())
+        walker.walk(tmp_pair.second.var().get());
+      for(auto &tmp_pair : tree.type_fun_infos()) {
+        const TypeFunctionInfo &info = tmp_pair.second;
+        walker.walk(info.fun().get());
+        for(auto &inst : *(info.insts())) walker.walk(inst.get());
+      }
+    }
+
+    //
+    // A KeyIdentifierRemapperVisitor class.
+    //
+
+    bool KeyIdentifierRemapperVisitor::enter_def(Definition *def)
+    {
+      dynamic_match(def,
+      [&](Definition *def) {},
+      [&](Import *import) {
+        remap_ident(_M_context, import->module_ident());
+      },
+      [&](ModuleDefinition *module_def) {
+        remap_ident(_M_context, module_def->ident());
+      });
+      return true;
+    }
+
+    bool KeyIdentifierRemapperVisitor::enter_var(Variable *var)
+    {
+      if(!visit(_M_context, var)) return false;
+      dynamic_match(var,
+      [&](Variable *var) {},
+      [&](AliasVariable *var) {
+        remap_ident(_M_context, var->ident());
+      });
+      return true;
+    }
+
+    bool KeyIdentifierRemapperVisitor::enter_fun(Function *fun)
+    { return visit(_M_context, fun); }
+
+    bool KeyIdentifierRemapperVisitor::enter_inst(Instance *inst)
+    { return visit(_M_context, inst); }
+
+    bool KeyIdentifierRemapperVisitor::enter_type_var(TypeVariable *var)
+    { return visit(_M_context, var); }
+
+    bool KeyIdentifierRemapperVisitor::enter_type_fun(TypeFunction *fun)
+    { return visit(_M_context, fun); }
+
+    bool KeyIdentifierRemapperVisitor::enter_type_fun_inst(TypeFunctionInstance *inst)
+    { return visit(_M_context, inst); }
+
+    bool KeyIdentifierRemapperVisitor::enter_constr(Constructor *constr)
+    {
+      if(!visit(_M_context, constr)) return false;
+      // A constructor of a type function instance doesn't have a datatype
+      // key identifier.
+      if(constr->datatype_fun_inst() == nullptr)
+        constr->set_datatype_key_ident(new_key_ident(_M_context, constr->datatype_key_ident()));
+      return true;
+    }
+
+    bool KeyIdentifierRemapperVisitor::enter_type_expr(TypeExpression *expr)
+    {
+      dynamic_match(expr,
+      [&](TypeExpression *expr) {},
+      [&](TypeVariableExpression *type_var_expr) {
+        remap_ident(_M_context, type_var_expr->ident());
+      },
+      [&](TypeApplication *type_app) {
+        remap_ident(_M_context, type_app->fun_ident());
+      });
+      return true;
+    }
+
+    bool KeyIdentifierRemapperVisitor::enter_expr(Expression *expr)
+    {
+      // A deferred body doesn't have resolved identifiers, so it is walked as
+      // an expression without identifiers.
+      dynamic_match(expr,
+      [&](Expression *expr) {},
+      [&](VariableExpression *var_expr) {
+        remap_ident(_M_context, var_expr->ident());
+      },
+      [&](NamedFieldConstructorApplication *app) {
+        remap_ident(_M_context, app->constr_ident());
+      });
+      return true;
+    }
+
+    bool KeyIdentifierRemapperVisitor::enter_pattern(Pattern *pattern)
+    {
+      dynamic_match(pattern,
+      [&](Pattern *pattern) {},
+      [&](ConstructorPattern *pattern) {
+        remap_ident(_M_context, pattern->constr_ident());
+      });
+      return true;
+    }
+
+    bool KeyIdentifierRemapperVisitor::enter_value(Value *value)
+    {
+      dynamic_match(value,
+      [&](Value *value) {},
+      [&](ConstructorValue *value) {
+        remap_ident(_M_context, value->constr_ident());
+      });
+      return true;
+    }
+
+    namespace priv
+    {
+      //
+      // Functions.
+      //
+
+      void remap_key_idents(const Tree &tree, const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+      {
+        KeyIdentifierRemapperContext context(key_ident_map);
+        KeyIdentifierRemapperVisitor visitor(context);
+        NodeWalker walker(visitor);
+        for(auto &defs : tree.defs()) walker.walk_defs(*defs);
+        remap_infos(walker, tree);
+      }
+    }
+  }
+}
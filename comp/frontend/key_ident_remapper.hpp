@@ -0,0 +1,29 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_KEY_IDENT_REMAPPER_HPP
+#define _FRONTEND_KEY_IDENT_REMAPPER_HPP
+
+#include <unordered_map>
+#include <lesfl/frontend/ident.hpp>
+#include <lesfl/frontend/tree.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // Replaces the key identifiers of the identifiers and the constructors
+      // that are reachable from the definitions and the information tables of
+      // the tree. The tables and the uncompiled definitions aren't changed.
+      void remap_key_idents(const Tree &tree, const std::unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <lesfl/frontend.hpp>
+#include "frontend/key_ident_remapper.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    //
+    // A KeyIdentifierRenumberer class.
+    //
+
+    KeyIdentifierRenumberer::~KeyIdentifierRenumberer() {}
+
+    bool KeyIdentifierRenumberer::renumber(Tree &tree, unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      // Key identifiers of other trees would be invalid after renumbering of
+      // a shared identifier table.
+      if(tree.ident_table().use_count() > 1) return false;
+      tree.ident_table()->renumber_idents(key_ident_map);
+      priv::remap_key_idents(tree, key_ident_map);
+      tree.renumber_key_idents(key_ident_map);
+      return true;
+    }
+  }
+}
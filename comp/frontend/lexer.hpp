@@ -13,7 +13,10 @@
 #define yyFlexLexer     LesflFrontendPrivFlexLexer
 #include <FlexLexer.h>
 #endif
+#include <cstddef>
+#include <deque>
 #include "frontend/bison_parser.hpp"
+#include "frontend/deferred_body.hpp"
 
 namespace lesfl
 {
@@ -31,19 +34,39 @@ namespace lesfl
         std::string buffer;
         std::wstring wbuffer;
         int tmp_state;
+        bool is_deferred_parsing;
+        bool is_body_start;
+        BisonParser::location_type last_loc;
+        std::deque<DeferredToken> pending_tokens;
+        DeferredTokens *replayed_tokens;
+        std::size_t replayed_token_index;
       public:
-        Lexer(std::istream *is) : LesflFrontendPrivFlexLexer(is), tmp_state(0) {}
+        Lexer(std::istream *is, bool is_deferred_parsing = false) :
+          LesflFrontendPrivFlexLexer(is), tmp_state(0), is_deferred_parsing(is_deferred_parsing),
+          is_body_start(false), replayed_tokens(nullptr), replayed_token_index(0) {}
+
+        Lexer(DeferredTokens *tokens) :
+          tmp_state(0), is_deferred_parsing(false), is_body_start(false),
+          replayed_tokens(tokens), replayed_token_index(0) {}
 
         virtual ~Lexer();
 
-        int lex(BisonParser::semantic_type *value, BisonParser::location_type *loc)
-        {
-          this->value = value;
-          this->loc = loc;
-          return yylex();
-        }
+        int lex(BisonParser::semantic_type *value, BisonParser::location_type *loc);
+
+        // The parser calls this method when it expects a body at the location.
+        // The body is captured only if the parser hasn't read any token of the
+        // body as a lookahead.
+        void start_body(const BisonParser::location_type &body_loc);
       private:
         int yylex();
+
+        int next_token(DeferredToken &token);
+
+        int replay_token(BisonParser::semantic_type *value, BisonParser::location_type *loc);
+
+        bool capture_body(DeferredToken &body_token);
+
+        bool decode_wbuffer();
       };
     }
   }
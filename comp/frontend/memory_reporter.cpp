@@ -0,0 +1,796 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <unordered_set>
+#include <lesfl/frontend.hpp>
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace
+    {
+      struct MemoryReporterContext
+      {
+        MemoryReport &report;
+        unordered_set<const void *> visited_objects;
+        size_t short_string_capacity;
+
+        MemoryReporterContext(MemoryReport &report) :
+          report(report), short_string_capacity(string().capacity()) {}
+      };
+
+      class MemoryReporterVisitor : public priv::NodeVisitor
+      {
+        MemoryReporterContext &_M_context;
+      public:
+        MemoryReporterVisitor(MemoryReporterContext &context) : _M_context(context) {}
+
+        bool enter_def(Definition *def);
+
+        bool enter_var(Variable *var);
+
+        bool enter_fun(Function *fun);
+
+        bool enter_inst(Instance *inst);
+
+        bool enter_type_var(TypeVariable *var);
+
+        bool enter_type_fun(TypeFunction *fun);
+
+        bool enter_type_fun_inst(TypeFunctionInstance *inst);
+
+        bool enter_datatype(Datatype *datatype);
+
+        bool enter_constr(Constructor *constr);
+
+        bool enter_type_named_field_pair(TypeNamedFieldPair *pair);
+
+        bool enter_arg(Argument *arg);
+
+        bool enter_type_expr(TypeExpression *expr);
+
+        bool enter_expr(Expression *expr);
+
+        bool enter_expr_named_field_pair(ExpressionNamedFieldPair *pair);
+
+        bool enter_binding(Binding *bind);
+
+        bool enter_case(Case *caze);
+
+        bool enter_pattern(Pattern *pattern);
+
+        bool enter_pattern_named_field_pair(PatternNamedFieldPair *pair);
+
+        bool enter_literal_value(LiteralValue *value);
+
+        bool enter_value(Value *value);
+
+        bool enter_value_named_field_pair(ValueNamedFieldPair *pair);
+      };
+    }
+
+    //
+    // Static inline functions and static functions.
+    //
+
+    static inline size_t string_bytes(MemoryReporterContext &context, const string &str)
+    { return str.capacity() > context.short_string_capacity ? str.capacity() + 1 : 0; }
+
+    template<typename _T>
+    static inline size_t list_bytes(const list<_T> &xs)
+    { return xs.size() * (sizeof(_T) + 2 * sizeof(void *)); }
+
+    template<typename _T>
+    static inline size_t vector_bytes(const vector<_T> &xs)
+    { return xs.capacity() * sizeof(_T); }
+
+    template<typename _Map>
+    static inline size_t hash_table_bytes(const _Map &map)
+    { return map.size() * (sizeof(typename _Map::value_type) + sizeof(void *)) + map.bucket_count() * sizeof(void *); }
+
+    template<typename _T>
+    static inline bool visit(MemoryReporterContext &context, const _T *object)
+    { return context.visited_objects.insert(dynamic_cast<const void *>(object)).second; }
+
+    template<typename _T>
+    static inline void add_object(MemoryReporterContext &context, const char *name, const _T *object)
+    { context.report.add(name, 1, sizeof(_T)); }
+
+    static inline void add_pos(MemoryReporterContext &context, const Position &pos)
+    { context.report.add("Position", 1, string_bytes(context, pos.source().file_name())); }
+
+    template<typename _T>
+    static inline void add_node(MemoryReporterContext &context, const char *name, const _T *node)
+    {
+      add_object(context, name, node);
+      add_pos(context, node->pos());
+    }
+
+    static inline void add_string(MemoryReporterContext &context, const string &str)
+    { context.report.add("string", 1, string_bytes(context, str)); }
+
+    static inline void add_wstring(MemoryReporterContext &context, const wstring &str)
+    { context.report.add("string", 1, str.capacity() > wstring().capacity() ? (str.capacity() + 1) * sizeof(wchar_t) : 0); }
+
+    template<typename _T, size_t _N>
+    static inline void add_node_list(MemoryReporterContext &context, const NodeList<_T, _N> &nodes)
+    { context.report.add("NodeList", 1, sizeof(NodeList<_T, _N>) + (nodes.capacity() > _N ? nodes.capacity() * sizeof(unique_ptr<_T>) : 0)); }
+
+    static size_t ident_bytes(MemoryReporterContext &context, const Identifier *ident)
+    {
+      size_t bytes = (dynamic_cast<const RelativeIdentifier *>(ident) != nullptr ? sizeof(RelativeIdentifier) : sizeof(AbsoluteIdentifier));
+      bytes += list_bytes(ident->idents());
+      for(auto &str : ident->idents()) bytes += string_bytes(context, str);
+      return bytes;
+    }
+
+    static inline void add_ident(MemoryReporterContext &context, const Identifier *ident)
+    { context.report.add("Identifier", 1, ident_bytes(context, ident)); }
+
+    template<typename _T, size_t _N>
+    static inline void add_named_nodes(MemoryReporterContext &context, const char *name, const NodeList<_T, _N> &nodes)
+    {
+      add_node_list(context, nodes);
+      for(auto &node : nodes) {
+        add_node(context, name, node.get());
+        add_string(context, node->ident());
+      }
+    }
+
+    static inline void add_packed_elems(MemoryReporterContext &context, const PackedElements &elems)
+    { context.report.add("PackedElements", 1, sizeof(PackedElements) + elems.size() * PackedElements::elem_size(elems.elem_type())); }
+
+    static void report_ident_table(MemoryReporterContext &context, const AbsoluteIdentifierTable &table)
+    {
+      const auto &ident_map = table.ident_map();
+      size_t bytes = sizeof(AbsoluteIdentifierTable) + hash_table_bytes(ident_map);
+      // An element of the identifier set has a pointer and a cached hash.
+      bytes += ident_map.size() * (2 * sizeof(void *) + sizeof(size_t)) + table.ident_set_bucket_count() * sizeof(void *);
+      for(auto &tmp_pair : ident_map) bytes += ident_bytes(context, tmp_pair.second.get());
+      context.report.add("AbsoluteIdentifierTable", ident_map.size(), bytes);
+    }
+
+    static void report_infos(MemoryReporterContext &context, priv::NodeWalker &walker, const Tree &tree)
+    {
+      size_t bytes = hash_table_bytes(tree.var_infos());
+      for(auto &tmp_pair : tree.var_infos()) {
+        const VariableInfo &info = tmp_pair.second;
+        bytes += sizeof(*(info.insts())) + list_bytes(*(info.insts()));
+        walker.walk(info.var().get());
+        for(auto &inst : *(info.insts())) walker.walk(inst.get());
+      }
+      context.report.add("VariableInfo", tree.var_infos().size(), bytes);
+      bytes = hash_table_bytes(tree.type_var_infos());
+      for(auto &tmp_pair : tree.type_var_infos())
+        walker.walk(tmp_pair.second.var().get());
+      context.report.add("TypeVariableInfo", tree.type_var_infos().size(), bytes);
+      bytes = hash_table_bytes(tree.type_fun_infos());
+      for(auto &tmp_pair : tree.type_fun_infos()) {
+        const TypeFunctionInfo &info = tmp_pair.second;
+        bytes += sizeof(*(info.insts())) + list_bytes(*(info.insts()));
+        walker.walk(info.fun().get());
+        for(auto &inst : *(info.insts())) walker.walk(inst.get());
+      }
+      context.report.add("TypeFunctionInfo", tree.type_fun_infos().size(), bytes);
+      context.report.add("module key identifiers", tree.module_key_idents().size(), hash_table_bytes(tree.module_key_idents()));
+      bytes = vector_bytes(tree.uncompiled_var_key_idents());
+      bytes += vector_bytes(tree.uncompiled_type_var_key_idents());
+      bytes += vector_bytes(tree.uncompiled_type_fun_key_idents());
+      bytes += vector_bytes(tree.uncompiled_inst_pairs());
+      bytes += vector_bytes(tree.uncompiled_type_fun_inst_pairs());
+      size_t count = tree.uncompiled_var_key_idents().size();
+      count += tree.uncompiled_type_var_key_idents().size();
+      count += tree.uncompiled_type_fun_key_idents().size();
+      count += tree.uncompiled_inst_pairs().size();
+      count += tree.uncompiled_type_fun_inst_pairs().size();
+      context.report.add("uncompiled definitions", count, bytes);
+    }
+
+    //
+    // A MemoryReporterVisitor class.
+    //
+
+    bool MemoryReporterVisitor::enter_def(Definition *def)
+    {
+      dynamic_match(def,
+      [&](Definition *def) {
+        add_node(_M_context, "Definition", def);
+      },
+      [&](Import *import) {
+        add_node(_M_context, "Import", import);
+        add_ident(_M_context, import->module_ident());
+      },
+      [&](ModuleDefinition *module_def) {
+        add_node(_M_context, "ModuleDefinition", module_def);
+        add_ident(_M_context, module_def->ident());
+        add_node_list(_M_context, module_def->defs());
+      },
+      [&](VariableDefinition *var_def) {
+        add_node(_M_context, "VariableDefinition", var_def);
+        add_string(_M_context, var_def->ident());
+      },
+      [&](VariableInstanceDefinition *var_inst_def) {
+        add_node(_M_context, "VariableInstanceDefinition", var_inst_def);
+        add_string(_M_context, var_inst_def->ident());
+      },
+      [&](FunctionDefinition *fun_def) {
+        add_node(_M_context, "FunctionDefinition", fun_def);
+        add_string(_M_context, fun_def->ident());
+      },
+      [&](FunctionInstanceDefinition *fun_inst_def) {
+        add_node(_M_context, "FunctionInstanceDefinition", fun_inst_def);
+        add_string(_M_context, fun_inst_def->ident());
+      },
+      [&](TypeVariableDefinition *type_var_def) {
+        add_node(_M_context, "TypeVariableDefinition", type_var_def);
+        add_string(_M_context, type_var_def->ident());
+      },
+      [&](TypeFunctionDefinition *type_fun_def) {
+        add_node(_M_context, "TypeFunctionDefinition", type_fun_def);
+        add_string(_M_context, type_fun_def->ident());
+      },
+      [&](TypeFunctionInstanceDefinition *type_fun_inst_def) {
+        add_node(_M_context, "TypeFunctionInstanceDefinition", type_fun_inst_def);
+        add_string(_M_context, type_fun_inst_def->ident());
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_var(Variable *var)
+    {
+      if(!visit(_M_context, var)) return false;
+      dynamic_match(var,
+      [&](Variable *var) {
+        add_object(_M_context, "Variable", var);
+      },
+      [&](UserDefinedVariable *var) {
+        add_object(_M_context, "UserDefinedVariable", var);
+        if(var->is_template()) add_named_nodes(_M_context, "TypeParameter", var->inst_type_params());
+      },
+      [&](ExternalVariable *var) {
+        add_object(_M_context, "ExternalVariable", var);
+        add_string(_M_context, var->external_var_ident());
+      },
+      [&](AliasVariable *var) {
+        add_node(_M_context, "AliasVariable", var);
+        if(var->is_template()) add_named_nodes(_M_context, "TypeParameter", var->inst_type_params());
+        add_ident(_M_context, var->ident());
+      },
+      [&](FunctionVariable *var) {
+        add_object(_M_context, "FunctionVariable", var);
+      },
+      [&](DefinedConstructorVariable *var) {
+        add_object(_M_context, "DefinedConstructorVariable", var);
+      },
+      [&](LibraryConstructorVariable *var) {
+        add_object(_M_context, "LibraryConstructorVariable", var);
+      },
+      [&](LibraryVariable *var) {
+        add_object(_M_context, "LibraryVariable", var);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_fun(Function *fun)
+    {
+      if(!visit(_M_context, fun)) return false;
+      dynamic_match(fun,
+      [&](Function *fun) {
+        add_object(_M_context, "Function", fun);
+      },
+      [&](UserDefinedFunction *fun) {
+        add_object(_M_context, "UserDefinedFunction", fun);
+        if(fun->is_template()) add_named_nodes(_M_context, "TypeParameter", fun->inst_type_params());
+        add_named_nodes(_M_context, "Annotation", fun->annotations());
+        add_node_list(_M_context, fun->args());
+      },
+      [&](ExternalFunction *fun) {
+        add_object(_M_context, "ExternalFunction", fun);
+        add_named_nodes(_M_context, "Annotation", fun->annotations());
+        add_node_list(_M_context, fun->args());
+        add_string(_M_context, fun->external_fun_ident());
+      },
+      [&](NativeFunction *fun) {
+        add_object(_M_context, "NativeFunction", fun);
+        add_named_nodes(_M_context, "Annotation", fun->annotations());
+        add_node_list(_M_context, fun->args());
+        add_string(_M_context, fun->native_fun_ident());
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_inst(Instance *inst)
+    {
+      if(!visit(_M_context, inst)) return false;
+      dynamic_match(inst,
+      [&](Instance *inst) {
+        add_node(_M_context, "Instance", inst);
+      },
+      [&](VariableInstance *inst) {
+        add_node(_M_context, "VariableInstance", inst);
+      },
+      [&](FunctionInstance *inst) {
+        add_node(_M_context, "FunctionInstance", inst);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_type_var(TypeVariable *var)
+    {
+      if(!visit(_M_context, var)) return false;
+      dynamic_match(var,
+      [&](TypeVariable *var) {
+        add_object(_M_context, "TypeVariable", var);
+      },
+      [&](TypeSynonymVariable *var) {
+        add_object(_M_context, "TypeSynonymVariable", var);
+      },
+      [&](DatatypeVariable *var) {
+        add_object(_M_context, "DatatypeVariable", var);
+      },
+      [&](BuiltinTypeVariable *var) {
+        add_object(_M_context, "BuiltinTypeVariable", var);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_type_fun(TypeFunction *fun)
+    {
+      if(!visit(_M_context, fun)) return false;
+      dynamic_match(fun,
+      [&](TypeFunction *fun) {
+        add_object(_M_context, "TypeFunction", fun);
+      },
+      [&](TypeSynonymFunction *fun) {
+        add_object(_M_context, "TypeSynonymFunction", fun);
+        add_named_nodes(_M_context, "TypeParameter", fun->inst_type_params());
+        add_named_nodes(_M_context, "TypeArgument", fun->args());
+      },
+      [&](DatatypeFunction *fun) {
+        add_object(_M_context, "DatatypeFunction", fun);
+        add_named_nodes(_M_context, "TypeParameter", fun->inst_type_params());
+        add_named_nodes(_M_context, "TypeArgument", fun->args());
+      },
+      [&](BuiltinTypeFunction *fun) {
+        add_object(_M_context, "BuiltinTypeFunction", fun);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_type_fun_inst(TypeFunctionInstance *inst)
+    {
+      if(!visit(_M_context, inst)) return false;
+      dynamic_match(inst,
+      [&](TypeFunctionInstance *inst) {
+        add_node(_M_context, "TypeFunctionInstance", inst);
+      },
+      [&](TypeSynonymFunctionInstance *inst) {
+        add_node(_M_context, "TypeSynonymFunctionInstance", inst);
+        add_node_list(_M_context, inst->args());
+      },
+      [&](DatatypeFunctionInstance *inst) {
+        add_node(_M_context, "DatatypeFunctionInstance", inst);
+        add_node_list(_M_context, inst->args());
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_datatype(Datatype *datatype)
+    {
+      dynamic_match(datatype,
+      [&](Datatype *datatype) {
+        add_object(_M_context, "Datatype", datatype);
+      },
+      [&](NonUniqueDatatype *datatype) {
+        add_object(_M_context, "NonUniqueDatatype", datatype);
+        _M_context.report.add("constructor lists", 1, sizeof(datatype->constrs()) + list_bytes(datatype->constrs()));
+      },
+      [&](UniqueDatatype *datatype) {
+        add_object(_M_context, "UniqueDatatype", datatype);
+        _M_context.report.add("constructor lists", 1, sizeof(datatype->constrs()) + list_bytes(datatype->constrs()));
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_constr(Constructor *constr)
+    {
+      if(!visit(_M_context, constr)) return false;
+      dynamic_match(constr,
+      [&](Constructor *constr) {
+        add_node(_M_context, "Constructor", constr);
+      },
+      [&](VariableConstructor *constr) {
+        add_node(_M_context, "VariableConstructor", constr);
+      },
+      [&](UnnamedFieldConstructor *constr) {
+        add_node(_M_context, "UnnamedFieldConstructor", constr);
+        add_named_nodes(_M_context, "Annotation", constr->annotations());
+        add_node_list(_M_context, constr->field_types());
+      },
+      [&](NamedFieldConstructor *constr) {
+        add_node(_M_context, "NamedFieldConstructor", constr);
+        add_named_nodes(_M_context, "Annotation", constr->annotations());
+        add_node_list(_M_context, constr->field_types());
+        _M_context.report.add("field index tables", 1, hash_table_bytes(constr->field_indices()));
+      });
+      add_string(_M_context, constr->ident());
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_type_named_field_pair(TypeNamedFieldPair *pair)
+    {
+      add_node(_M_context, "TypeNamedFieldPair", pair);
+      add_string(_M_context, pair->ident());
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_arg(Argument *arg)
+    {
+      add_node(_M_context, "Argument", arg);
+      add_string(_M_context, arg->ident());
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_type_expr(TypeExpression *expr)
+    {
+      dynamic_match(expr,
+      [&](TypeExpression *expr) {
+        add_node(_M_context, "TypeExpression", expr);
+      },
+      [&](With *with) {
+        add_node(_M_context, "With", with);
+      },
+      [&](TypeVariableExpression *type_var_expr) {
+        add_node(_M_context, "TypeVariableExpression", type_var_expr);
+        add_ident(_M_context, type_var_expr->ident());
+      },
+      [&](TypeParameterExpression *type_param_expr) {
+        add_node(_M_context, "TypeParameterExpression", type_param_expr);
+        add_string(_M_context, type_param_expr->ident());
+      },
+      [&](NonUniqueTupleType *tuple_type) {
+        add_node(_M_context, "NonUniqueTupleType", tuple_type);
+        add_node_list(_M_context, tuple_type->field_types());
+      },
+      [&](UniqueTupleType *tuple_type) {
+        add_node(_M_context, "UniqueTupleType", tuple_type);
+        add_node_list(_M_context, tuple_type->field_types());
+      },
+      [&](NonUniqueFunctionType *fun_type) {
+        add_node(_M_context, "NonUniqueFunctionType", fun_type);
+        add_node_list(_M_context, fun_type->arg_types());
+      },
+      [&](UniqueFunctionType *fun_type) {
+        add_node(_M_context, "UniqueFunctionType", fun_type);
+        add_node_list(_M_context, fun_type->arg_types());
+      },
+      [&](TypeApplication *type_app) {
+        add_node(_M_context, "TypeApplication", type_app);
+        add_ident(_M_context, type_app->fun_ident());
+        add_node_list(_M_context, type_app->args());
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_expr(Expression *expr)
+    {
+      dynamic_match(expr,
+      [&](Expression *expr) {
+        add_node(_M_context, "Expression", expr);
+      },
+      [&](DeferredExpression *deferred_expr) {
+        add_node(_M_context, "DeferredExpression", deferred_expr);
+      },
+      [&](Literal *literal) {
+        add_node(_M_context, "Literal", literal);
+      },
+      [&](List *list) {
+        add_node(_M_context, "List", list);
+        add_node_list(_M_context, list->elems());
+      },
+      [&](NonUniqueArray *array) {
+        add_node(_M_context, "NonUniqueArray", array);
+        add_node_list(_M_context, array->elems());
+      },
+      [&](UniqueArray *array) {
+        add_node(_M_context, "UniqueArray", array);
+        add_node_list(_M_context, array->elems());
+      },
+      [&](NonUniqueTuple *tuple) {
+        add_node(_M_context, "NonUniqueTuple", tuple);
+        add_node_list(_M_context, tuple->fields());
+      },
+      [&](UniqueTuple *tuple) {
+        add_node(_M_context, "UniqueTuple", tuple);
+        add_node_list(_M_context, tuple->fields());
+      },
+      [&](VariableExpression *var_expr) {
+        add_node(_M_context, "VariableExpression", var_expr);
+        add_ident(_M_context, var_expr->ident());
+      },
+      [&](NamedFieldConstructorApplication *app) {
+        add_node(_M_context, "NamedFieldConstructorApplication", app);
+        add_ident(_M_context, app->constr_ident());
+        add_node_list(_M_context, app->fields());
+      },
+      [&](NonUniqueApplication *app) {
+        add_node(_M_context, "NonUniqueApplication", app);
+        add_node_list(_M_context, app->args());
+      },
+      [&](UniqueApplication *app) {
+        add_node(_M_context, "UniqueApplication", app);
+        add_node_list(_M_context, app->args());
+      },
+      [&](BuiltinApplication *app) {
+        add_node(_M_context, "BuiltinApplication", app);
+        add_node_list(_M_context, app->args());
+      },
+      [&](Field *field) {
+        add_node(_M_context, "Field", field);
+      },
+      [&](UniqueField *field) {
+        add_node(_M_context, "UniqueField", field);
+      },
+      [&](SetUniqueField *set_field) {
+        add_node(_M_context, "SetUniqueField", set_field);
+      },
+      [&](NamedField *field) {
+        add_node(_M_context, "NamedField", field);
+        add_string(_M_context, field->ident());
+      },
+      [&](UniqueNamedField *field) {
+        add_node(_M_context, "UniqueNamedField", field);
+        add_string(_M_context, field->ident());
+      },
+      [&](SetUniqueNamedField *set_field) {
+        add_node(_M_context, "SetUniqueNamedField", set_field);
+        add_string(_M_context, set_field->ident());
+      },
+      [&](TypedExpression *typed_expr) {
+        add_node(_M_context, "TypedExpression", typed_expr);
+      },
+      [&](Let *let) {
+        add_node(_M_context, "Let", let);
+        add_node_list(_M_context, let->binds());
+      },
+      [&](Match *match) {
+        add_node(_M_context, "Match", match);
+        add_node_list(_M_context, match->cases());
+      },
+      [&](Throw *throv) {
+        add_node(_M_context, "Throw", throv);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_expr_named_field_pair(ExpressionNamedFieldPair *pair)
+    {
+      add_node(_M_context, "ExpressionNamedFieldPair", pair);
+      add_string(_M_context, pair->ident());
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_binding(Binding *bind)
+    {
+      dynamic_match(bind,
+      [&](Binding *bind) {
+        add_object(_M_context, "Binding", bind);
+      },
+      [&](VariableBinding *bind) {
+        add_node(_M_context, "VariableBinding", bind);
+        add_string(_M_context, bind->ident());
+      },
+      [&](TupleBinding *bind) {
+        add_object(_M_context, "TupleBinding", bind);
+        add_node_list(_M_context, bind->vars());
+        for(auto &var : bind->vars()) {
+          if(var.get() != nullptr) {
+            add_node(_M_context, "TupleBindingVariable", var.get());
+            add_string(_M_context, var->ident());
+          }
+        }
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_case(Case *caze)
+    {
+      add_object(_M_context, "Case", caze);
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_pattern(Pattern *pattern)
+    {
+      dynamic_match(pattern,
+      [&](Pattern *pattern) {
+        add_node(_M_context, "Pattern", pattern);
+      },
+      [&](VariableConstructorPattern *pattern) {
+        add_node(_M_context, "VariableConstructorPattern", pattern);
+        add_ident(_M_context, pattern->constr_ident());
+      },
+      [&](UnnamedFieldConstructorPattern *pattern) {
+        add_node(_M_context, "UnnamedFieldConstructorPattern", pattern);
+        add_ident(_M_context, pattern->constr_ident());
+        add_node_list(_M_context, pattern->field_patterns());
+      },
+      [&](NamedFieldConstructorPattern *pattern) {
+        add_node(_M_context, "NamedFieldConstructorPattern", pattern);
+        add_ident(_M_context, pattern->constr_ident());
+        add_node_list(_M_context, pattern->field_patterns());
+      },
+      [&](ListPattern *pattern) {
+        add_node(_M_context, "ListPattern", pattern);
+        add_node_list(_M_context, pattern->elem_patterns());
+      },
+      [&](NonUniqueArrayPattern *pattern) {
+        add_node(_M_context, "NonUniqueArrayPattern", pattern);
+        add_node_list(_M_context, pattern->elem_patterns());
+      },
+      [&](UniqueArrayPattern *pattern) {
+        add_node(_M_context, "UniqueArrayPattern", pattern);
+        add_node_list(_M_context, pattern->elem_patterns());
+      },
+      [&](NonUniqueTuplePattern *pattern) {
+        add_node(_M_context, "NonUniqueTuplePattern", pattern);
+        add_node_list(_M_context, pattern->field_patterns());
+      },
+      [&](UniqueTuplePattern *pattern) {
+        add_node(_M_context, "UniqueTuplePattern", pattern);
+        add_node_list(_M_context, pattern->field_patterns());
+      },
+      [&](LiteralPattern *pattern) {
+        add_node(_M_context, "LiteralPattern", pattern);
+      },
+      [&](VariablePattern *pattern) {
+        add_node(_M_context, "VariablePattern", pattern);
+        add_string(_M_context, pattern->ident());
+      },
+      [&](AsPattern *pattern) {
+        add_node(_M_context, "AsPattern", pattern);
+        add_string(_M_context, pattern->ident());
+      },
+      [&](WildcardPattern *pattern) {
+        add_node(_M_context, "WildcardPattern", pattern);
+      },
+      [&](TypedPattern *pattern) {
+        add_node(_M_context, "TypedPattern", pattern);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_pattern_named_field_pair(PatternNamedFieldPair *pair)
+    {
+      add_node(_M_context, "PatternNamedFieldPair", pair);
+      add_string(_M_context, pair->ident());
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_literal_value(LiteralValue *value)
+    {
+      dynamic_match(value,
+      [&](LiteralValue *value) {
+        add_object(_M_context, "LiteralValue", value);
+      },
+      [&](CharValue *value) {
+        add_object(_M_context, "CharValue", value);
+      },
+      [&](WideCharValue *value) {
+        add_object(_M_context, "WideCharValue", value);
+      },
+      [&](IntValue *value) {
+        add_object(_M_context, "IntValue", value);
+      },
+      [&](FloatValue *value) {
+        add_object(_M_context, "FloatValue", value);
+      },
+      [&](StringValue *value) {
+        add_object(_M_context, "StringValue", value);
+        add_string(_M_context, value->string());
+      },
+      [&](WideStringValue *value) {
+        add_object(_M_context, "WideStringValue", value);
+        add_wstring(_M_context, value->string());
+      },
+      [&](NonUniqueLambdaValue *value) {
+        add_object(_M_context, "NonUniqueLambdaValue", value);
+        add_node_list(_M_context, value->args());
+      },
+      [&](UniqueLambdaValue *value) {
+        add_object(_M_context, "UniqueLambdaValue", value);
+        add_node_list(_M_context, value->args());
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_value(Value *value)
+    {
+      dynamic_match(value,
+      [&](Value *value) {
+        add_node(_M_context, "Value", value);
+      },
+      [&](VariableLiteralValue *value) {
+        add_node(_M_context, "VariableLiteralValue", value);
+      },
+      [&](ListValue *value) {
+        add_node(_M_context, "ListValue", value);
+        add_node_list(_M_context, value->elems());
+      },
+      [&](ArrayValue *value) {
+        add_node(_M_context, "ArrayValue", value);
+        add_node_list(_M_context, value->elems());
+      },
+      [&](PackedListValue *value) {
+        add_node(_M_context, "PackedListValue", value);
+        add_packed_elems(_M_context, value->elems());
+      },
+      [&](PackedArrayValue *value) {
+        add_node(_M_context, "PackedArrayValue", value);
+        add_packed_elems(_M_context, value->elems());
+      },
+      [&](TupleValue *value) {
+        add_node(_M_context, "TupleValue", value);
+        add_node_list(_M_context, value->fields());
+      },
+      [&](VariableConstructorValue *value) {
+        add_node(_M_context, "VariableConstructorValue", value);
+        add_ident(_M_context, value->constr_ident());
+      },
+      [&](UnnamedFieldConstructorValue *value) {
+        add_node(_M_context, "UnnamedFieldConstructorValue", value);
+        add_ident(_M_context, value->constr_ident());
+        add_node_list(_M_context, value->fields());
+      },
+      [&](NamedFieldConstructorValue *value) {
+        add_node(_M_context, "NamedFieldConstructorValue", value);
+        add_ident(_M_context, value->constr_ident());
+        add_node_list(_M_context, value->fields());
+      },
+      [&](TypedValue *typed_value) {
+        add_node(_M_context, "TypedValue", typed_value);
+      });
+      return true;
+    }
+
+    bool MemoryReporterVisitor::enter_value_named_field_pair(ValueNamedFieldPair *pair)
+    {
+      add_node(_M_context, "ValueNamedFieldPair", pair);
+      add_string(_M_context, pair->ident());
+      return true;
+    }
+
+    //
+    // A MemoryReporter class.
+    //
+
+    MemoryReporter::~MemoryReporter() {}
+
+    bool MemoryReporter::report_memory(const Tree &tree, MemoryReport &report)
+    {
+      report.clear();
+      MemoryReporterContext context(report);
+      MemoryReporterVisitor visitor(context);
+      priv::NodeWalker walker(visitor);
+      report.add("Tree", 1, sizeof(Tree) + list_bytes(tree.defs()));
+      // Objects are reported from definitions at first. Information tables
+      // add objects that don't have definitions, for example builtin types.
+      for(auto &defs : tree.defs()) {
+        add_node_list(context, *defs);
+        walker.walk_defs(*defs);
+      }
+      report_infos(context, walker, tree);
+      report_ident_table(context, *(tree.ident_table()));
+      return true;
+    }
+  }
+}
@@ -0,0 +1,514 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <iterator>
+#include <lesfl/frontend.hpp>
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    //
+    // Static inline functions and static functions.
+    //
+
+    namespace
+    {
+      struct TarjanFrame
+      {
+        KeyIdentifier key_ident;
+        vector<KeyIdentifier> dep_key_idents;
+        size_t dep_index;
+
+        TarjanFrame(KeyIdentifier key_ident, const vector<KeyIdentifier> &dep_key_idents) :
+          key_ident(key_ident), dep_key_idents(dep_key_idents), dep_index(0) {}
+      };
+
+      struct TarjanContext
+      {
+        const unordered_map<KeyIdentifier, unordered_set<KeyIdentifier>> &deps;
+        unordered_map<KeyIdentifier, size_t> indices;
+        unordered_map<KeyIdentifier, size_t> low_links;
+        unordered_set<KeyIdentifier> on_stack_key_idents;
+        vector<KeyIdentifier> stack;
+        vector<TarjanFrame> frames;
+        vector<vector<KeyIdentifier>> &comps;
+
+        TarjanContext(const unordered_map<KeyIdentifier, unordered_set<KeyIdentifier>> &deps, vector<vector<KeyIdentifier>> &comps) :
+          deps(deps), comps(comps) {}
+      };
+
+      struct ModuleGraphBuilderContext
+      {
+        Tree &tree;
+        ModuleGraph &graph;
+        unordered_set<KeyIdentifier> module_key_idents;
+        AbsoluteIdentifier current_module_ident;
+        vector<AbsoluteIdentifier> saved_module_idents;
+        list<vector<AbsoluteIdentifier>> imported_module_ident_stack;
+        AbsoluteIdentifier predef_module_ident;
+        bool has_predef_module;
+        list<Error> &errors;
+        bool is_success;
+
+        ModuleGraphBuilderContext(Tree &tree, ModuleGraph &graph, list<Error> &errors) :
+          tree(tree), graph(graph), predef_module_ident("predef"), has_predef_module(false), errors(errors), is_success(true) {}
+      };
+
+      // The module graph builder walks a parsed tree, so module identifiers
+      // of imports and references are resolved by the builder in the same
+      // order as by the resolver.
+      class ModuleGraphBuilderVisitor : public priv::NodeVisitor
+      {
+        ModuleGraphBuilderContext &_M_context;
+      public:
+        ModuleGraphBuilderVisitor(ModuleGraphBuilderContext &context) : _M_context(context) {}
+
+        bool enter_def(Definition *def);
+
+        void leave_def(Definition *def);
+
+        bool enter_var(Variable *var);
+
+        bool enter_fun(Function *fun);
+
+        bool enter_type_expr(TypeExpression *expr);
+
+        bool enter_expr(Expression *expr);
+
+        bool enter_pattern(Pattern *pattern);
+
+        bool enter_literal_value(LiteralValue *value);
+
+        bool enter_value(Value *value);
+      private:
+        void add_ref_dep(const Identifier *ident);
+
+        void parse_body(Bodied *bodied);
+      };
+    }
+
+    static inline bool key_ident_less(KeyIdentifier key_ident1, KeyIdentifier key_ident2)
+    { return key_ident1.key() < key_ident2.key(); }
+
+    static vector<KeyIdentifier> sorted_key_idents(const unordered_set<KeyIdentifier> &key_idents)
+    {
+      vector<KeyIdentifier> sorted(key_idents.begin(), key_idents.end());
+      sort(sorted.begin(), sorted.end(), key_ident_less);
+      return sorted;
+    }
+
+    static void push_tarjan_frame(TarjanContext &context, KeyIdentifier key_ident)
+    {
+      size_t index = context.indices.size();
+      context.indices.insert(make_pair(key_ident, index));
+      context.low_links.insert(make_pair(key_ident, index));
+      context.stack.push_back(key_ident);
+      context.on_stack_key_idents.insert(key_ident);
+      auto deps_iter = context.deps.find(key_ident);
+      if(deps_iter != context.deps.end())
+        context.frames.push_back(TarjanFrame(key_ident, sorted_key_idents(deps_iter->second)));
+      else
+        context.frames.push_back(TarjanFrame(key_ident, vector<KeyIdentifier>()));
+    }
+
+    // The components are found by an explicit frame stack, so a length of an
+    // import chain isn't limited by a depth of a call stack.
+    static void strong_connect(TarjanContext &context, KeyIdentifier root_key_ident)
+    {
+      push_tarjan_frame(context, root_key_ident);
+      while(!context.frames.empty()) {
+        TarjanFrame &frame = context.frames.back();
+        if(frame.dep_index < frame.dep_key_idents.size()) {
+          KeyIdentifier key_ident = frame.key_ident;
+          KeyIdentifier dep_key_ident = frame.dep_key_idents[frame.dep_index];
+          frame.dep_index++;
+          auto index_iter = context.indices.find(dep_key_ident);
+          if(index_iter == context.indices.end()) {
+            push_tarjan_frame(context, dep_key_ident);
+          } else if(context.on_stack_key_idents.find(dep_key_ident) != context.on_stack_key_idents.end()) {
+            context.low_links[key_ident] = min(context.low_links[key_ident], index_iter->second);
+          }
+          continue;
+        }
+        KeyIdentifier key_ident = frame.key_ident;
+        context.frames.pop_back();
+        size_t low_link = context.low_links[key_ident];
+        if(low_link == context.indices[key_ident]) {
+          vector<KeyIdentifier> comp;
+          KeyIdentifier tmp_key_ident;
+          do {
+            tmp_key_ident = context.stack.back();
+            context.stack.pop_back();
+            context.on_stack_key_idents.erase(tmp_key_ident);
+            comp.push_back(tmp_key_ident);
+          } while(tmp_key_ident != key_ident);
+          sort(comp.begin(), comp.end(), key_ident_less);
+          context.comps.push_back(comp);
+        }
+        if(!context.frames.empty()) {
+          KeyIdentifier parent_key_ident = context.frames.back().key_ident;
+          context.low_links[parent_key_ident] = min(context.low_links[parent_key_ident], low_link);
+        }
+      }
+    }
+
+    static bool has_self_dep(const unordered_map<KeyIdentifier, unordered_set<KeyIdentifier>> &deps, KeyIdentifier key_ident)
+    {
+      auto iter = deps.find(key_ident);
+      return iter != deps.end() && iter->second.find(key_ident) != iter->second.end();
+    }
+
+    static bool add_module(ModuleGraphBuilderContext &context, const AbsoluteIdentifier &abs_ident, KeyIdentifier &key_ident, const Position &pos)
+    {
+      unique_ptr<AbsoluteIdentifier> tmp_abs_ident(new AbsoluteIdentifier(abs_ident.idents()));
+      bool is_added_abs_ident;
+      if(!context.tree.ident_table()->add_ident_or_get_key_ident(tmp_abs_ident.get(), key_ident, is_added_abs_ident)) {
+        context.errors.push_back(Error(pos, "internal error: can't add identifier to identifier table or get key identifier from identifier table"));
+        return false;
+      }
+      if(is_added_abs_ident) tmp_abs_ident.release();
+      context.module_key_idents.insert(key_ident);
+      context.graph.add_module(key_ident);
+      return true;
+    }
+
+    static bool get_module_abs_ident(ModuleGraphBuilderContext &context, const Identifier &ident, AbsoluteIdentifier &abs_ident, const Position &pos)
+    {
+      return dynamic_match(&ident,
+      [&](const Identifier *ident) -> bool {
+        context.errors.push_back(Error(pos, "internal error: unknown identifier class"));
+        return false;
+      },
+      [&](const AbsoluteIdentifier *ident) -> bool {
+        abs_ident = AbsoluteIdentifier(ident->idents());
+        return true;
+      },
+      [&](const RelativeIdentifier *ident) -> bool {
+        abs_ident = AbsoluteIdentifier(context.current_module_ident, *ident);
+        return true;
+      });
+    }
+
+    static bool add_modules(ModuleGraphBuilderContext &context, const NodeList<Definition> &defs)
+    {
+      bool is_success = true;
+      for(auto &def : defs) {
+        ModuleDefinition *module_def = dynamic_cast<ModuleDefinition *>(def.get());
+        if(module_def == nullptr) continue;
+        AbsoluteIdentifier module_abs_ident;
+        if(!get_module_abs_ident(context, *(module_def->ident()), module_abs_ident, module_def->pos())) {
+          is_success = false;
+          continue;
+        }
+        // Like the resolver, the builder adds the enclosing modules of a
+        // module that is defined by a qualified identifier.
+        AbsoluteIdentifier tmp_abs_ident;
+        KeyIdentifier key_ident;
+        bool tmp_is_success = true;
+        for(auto &ident : module_abs_ident.idents()) {
+          tmp_abs_ident.idents().push_back(ident);
+          tmp_is_success &= add_module(context, tmp_abs_ident, key_ident, module_def->pos());
+        }
+        if(!tmp_is_success) {
+          is_success = false;
+          continue;
+        }
+        AbsoluteIdentifier saved_module_ident = context.current_module_ident;
+        context.current_module_ident = module_abs_ident;
+        is_success &= add_modules(context, module_def->defs());
+        context.current_module_ident = saved_module_ident;
+      }
+      return is_success;
+    }
+
+    static bool find_module(ModuleGraphBuilderContext &context, AbsoluteIdentifier &abs_ident)
+    {
+      return abs_ident.set_key_ident(*(context.tree.ident_table())) &&
+        context.module_key_idents.find(abs_ident.key_ident()) != context.module_key_idents.end();
+    }
+
+    static bool find_module(ModuleGraphBuilderContext &context, const Identifier &ident, AbsoluteIdentifier &abs_ident)
+    {
+      return dynamic_match(&ident,
+      [](const Identifier *ident) -> bool {
+        return false;
+      },
+      [&](const AbsoluteIdentifier *ident) -> bool {
+        abs_ident = AbsoluteIdentifier(ident->idents());
+        return find_module(context, abs_ident);
+      },
+      [&](const RelativeIdentifier *ident) -> bool {
+        abs_ident = AbsoluteIdentifier(context.current_module_ident, *ident);
+        if(find_module(context, abs_ident)) return true;
+        auto iter = context.imported_module_ident_stack.rbegin();
+        for(; iter != context.imported_module_ident_stack.rend(); iter++) {
+          auto iter2 = iter->rbegin();
+          for(; iter2 != iter->rend(); iter2++) {
+            abs_ident = AbsoluteIdentifier(*iter2, *ident);
+            if(find_module(context, abs_ident)) return true;
+          }
+        }
+        if(!context.has_predef_module) return false;
+        abs_ident = AbsoluteIdentifier(context.predef_module_ident, *ident);
+        return find_module(context, abs_ident);
+      });
+    }
+
+    //
+    // A ModuleGraphBuilderVisitor class.
+    //
+
+    bool ModuleGraphBuilderVisitor::enter_def(Definition *def)
+    {
+      return dynamic_match(def,
+      [](Definition *def) -> bool {
+        return true;
+      },
+      [&](Import *import) -> bool {
+        AbsoluteIdentifier abs_ident;
+        if(!find_module(_M_context, *(import->module_ident()), abs_ident)) {
+          _M_context.errors.push_back(Error(import->pos(), "module " + import->module_ident()->to_string() + " is undefined"));
+          _M_context.is_success = false;
+          return false;
+        }
+        // A module that imports itself is kept as a cycle.
+        _M_context.graph.add_dep(_M_context.current_module_ident.key_ident(), abs_ident.key_ident());
+        _M_context.imported_module_ident_stack.back().push_back(abs_ident);
+        return false;
+      },
+      [&](ModuleDefinition *module_def) -> bool {
+        AbsoluteIdentifier module_abs_ident;
+        if(!get_module_abs_ident(_M_context, *(module_def->ident()), module_abs_ident, module_def->pos()) ||
+          !module_abs_ident.set_key_ident(*(_M_context.tree.ident_table()))) {
+          _M_context.is_success = false;
+          return false;
+        }
+        for(auto &imported_module_idents : _M_context.imported_module_ident_stack) {
+          for(auto &imported_module_ident : imported_module_idents)
+            _M_context.graph.add_dep(module_abs_ident.key_ident(), imported_module_ident.key_ident());
+        }
+        _M_context.saved_module_idents.push_back(_M_context.current_module_ident);
+        _M_context.current_module_ident = module_abs_ident;
+        _M_context.imported_module_ident_stack.push_back(vector<AbsoluteIdentifier>());
+        return true;
+      });
+    }
+
+    void ModuleGraphBuilderVisitor::leave_def(Definition *def)
+    {
+      if(dynamic_cast<ModuleDefinition *>(def) == nullptr) return;
+      _M_context.imported_module_ident_stack.pop_back();
+      _M_context.current_module_ident = _M_context.saved_module_idents.back();
+      _M_context.saved_module_idents.pop_back();
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_var(Variable *var)
+    {
+      AliasVariable *alias_var = dynamic_cast<AliasVariable *>(var);
+      if(alias_var != nullptr) add_ref_dep(alias_var->ident());
+      return true;
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_fun(Function *fun)
+    {
+      Bodied *bodied = dynamic_cast<Bodied *>(fun);
+      if(bodied != nullptr) parse_body(bodied);
+      return true;
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_type_expr(TypeExpression *expr)
+    {
+      dynamic_match(expr,
+      [](TypeExpression *expr) {},
+      [&](TypeVariableExpression *var_expr) {
+        add_ref_dep(var_expr->ident());
+      },
+      [&](TypeApplication *app) {
+        add_ref_dep(app->fun_ident());
+      });
+      return true;
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_expr(Expression *expr)
+    {
+      dynamic_match(expr,
+      [](Expression *expr) {},
+      [&](VariableExpression *var_expr) {
+        add_ref_dep(var_expr->ident());
+      },
+      [&](NamedFieldConstructorApplication *app) {
+        add_ref_dep(app->constr_ident());
+      });
+      return true;
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_pattern(Pattern *pattern)
+    {
+      ConstructorPattern *constr_pattern = dynamic_cast<ConstructorPattern *>(pattern);
+      if(constr_pattern != nullptr) add_ref_dep(constr_pattern->constr_ident());
+      return true;
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_literal_value(LiteralValue *value)
+    {
+      Bodied *bodied = dynamic_cast<Bodied *>(value);
+      if(bodied != nullptr) parse_body(bodied);
+      return true;
+    }
+
+    bool ModuleGraphBuilderVisitor::enter_value(Value *value)
+    {
+      ConstructorValue *constr_value = dynamic_cast<ConstructorValue *>(value);
+      if(constr_value != nullptr) add_ref_dep(constr_value->constr_ident());
+      return true;
+    }
+
+    void ModuleGraphBuilderVisitor::add_ref_dep(const Identifier *ident)
+    {
+      // Only an absolute identifier or a qualified identifier refers to a
+      // definition by a module identifier. Other references are resolved
+      // in the current module or in the imported modules.
+      unique_ptr<Identifier> module_ident;
+      dynamic_match(ident,
+      [](const Identifier *ident) {},
+      [&](const AbsoluteIdentifier *ident) {
+        unique_ptr<AbsoluteIdentifier> tmp_module_ident(new AbsoluteIdentifier());
+        if(ident->get_module_ident(*tmp_module_ident)) module_ident = move(tmp_module_ident);
+      },
+      [&](const RelativeIdentifier *ident) {
+        if(ident->idents().size() < 2) return;
+        list<string> idents(ident->idents().begin(), prev(ident->idents().end()));
+        module_ident = unique_ptr<Identifier>(new RelativeIdentifier(idents));
+      });
+      if(module_ident.get() == nullptr) return;
+      AbsoluteIdentifier abs_ident;
+      if(!find_module(_M_context, *module_ident, abs_ident)) return;
+      KeyIdentifier key_ident = _M_context.current_module_ident.key_ident();
+      if(abs_ident.key_ident() != key_ident) _M_context.graph.add_dep(key_ident, abs_ident.key_ident());
+    }
+
+    void ModuleGraphBuilderVisitor::parse_body(Bodied *bodied)
+    {
+      list<Error> tmp_errors;
+      if(!bodied->parse_body(tmp_errors)) {
+        for(auto &error : tmp_errors) _M_context.errors.push_back(error);
+        _M_context.is_success = false;
+      }
+    }
+
+    //
+    // A ModuleGraph class.
+    //
+
+    ModuleGraph::~ModuleGraph() {}
+
+    bool ModuleGraph::add_dep(KeyIdentifier key_ident, KeyIdentifier dep_key_ident)
+    {
+      add_module(dep_key_ident);
+      return _M_deps[key_ident].insert(dep_key_ident).second;
+    }
+
+    void ModuleGraph::components(vector<vector<KeyIdentifier>> &comps) const
+    {
+      comps.clear();
+      TarjanContext context(_M_deps, comps);
+      vector<KeyIdentifier> key_idents;
+      for(auto &tmp_pair : _M_deps) key_idents.push_back(tmp_pair.first);
+      sort(key_idents.begin(), key_idents.end(), key_ident_less);
+      for(auto key_ident : key_idents) {
+        if(context.indices.find(key_ident) == context.indices.end())
+          strong_connect(context, key_ident);
+      }
+    }
+
+    void ModuleGraph::cycles(vector<vector<KeyIdentifier>> &cycles) const
+    {
+      vector<vector<KeyIdentifier>> comps;
+      components(comps);
+      cycles.clear();
+      for(auto &comp : comps) {
+        if(comp.size() > 1 || has_self_dep(_M_deps, comp[0])) cycles.push_back(comp);
+      }
+    }
+
+    bool ModuleGraph::has_cycles() const
+    {
+      vector<vector<KeyIdentifier>> cycles;
+      this->cycles(cycles);
+      return !cycles.empty();
+    }
+
+    void ModuleGraph::schedule(vector<ModuleComponent> &comps) const
+    {
+      vector<vector<KeyIdentifier>> tmp_comps;
+      components(tmp_comps);
+      unordered_map<KeyIdentifier, size_t> comp_indices;
+      for(size_t i = 0; i < tmp_comps.size(); i++) {
+        for(auto key_ident : tmp_comps[i]) comp_indices.insert(make_pair(key_ident, i));
+      }
+      comps.clear();
+      for(size_t i = 0; i < tmp_comps.size(); i++) {
+        vector<size_t> dep_indices;
+        size_t level = 0;
+        for(auto key_ident : tmp_comps[i]) {
+          for(auto dep_key_ident : _M_deps.find(key_ident)->second) {
+            size_t dep_index = comp_indices[dep_key_ident];
+            if(dep_index != i) dep_indices.push_back(dep_index);
+          }
+        }
+        sort(dep_indices.begin(), dep_indices.end());
+        dep_indices.erase(unique(dep_indices.begin(), dep_indices.end()), dep_indices.end());
+        for(auto dep_index : dep_indices) level = max(level, comps[dep_index].level() + 1);
+        bool is_cycle = (tmp_comps[i].size() > 1 || has_self_dep(_M_deps, tmp_comps[i][0]));
+        comps.push_back(ModuleComponent(tmp_comps[i], dep_indices, level, is_cycle));
+      }
+    }
+
+    //
+    // A ModuleGraphBuilder class.
+    //
+
+    ModuleGraphBuilder::~ModuleGraphBuilder() {}
+
+    bool ModuleGraphBuilder::build_module_graph(Tree &tree, ModuleGraph &graph, list<Error> &errors)
+    {
+      graph.clear();
+      ModuleGraphBuilderContext context(tree, graph, errors);
+      for(auto module_key_ident : tree.module_key_idents()) {
+        context.module_key_idents.insert(module_key_ident);
+        graph.add_module(module_key_ident);
+      }
+      KeyIdentifier root_key_ident;
+      if(!add_module(context, AbsoluteIdentifier(), root_key_ident, Position(Source(), 0, 0))) return false;
+      for(auto &defs : tree.defs()) context.is_success &= add_modules(context, *defs);
+      context.has_predef_module = find_module(context, context.predef_module_ident);
+      ModuleGraphBuilderVisitor visitor(context);
+      priv::NodeWalker walker(visitor);
+      for(auto &defs : tree.defs()) {
+        context.current_module_ident = AbsoluteIdentifier();
+        context.current_module_ident.set_key_ident(root_key_ident);
+        context.imported_module_ident_stack.clear();
+        context.imported_module_ident_stack.push_back(vector<AbsoluteIdentifier>());
+        walker.walk_defs(*defs);
+      }
+      if(context.has_predef_module) {
+        for(auto module_key_ident : context.module_key_idents) {
+          if(module_key_ident != context.predef_module_ident.key_ident())
+            graph.add_dep(module_key_ident, context.predef_module_ident.key_ident());
+        }
+      }
+      return context.is_success;
+    }
+  }
+}
@@ -0,0 +1,550 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    //
+    // Static inline functions and static functions.
+    //
+
+    template<typename _T, size_t _N>
+    static inline void add_nodes(vector<priv::NodeWalkerTask> &children, const NodeList<_T, _N> &nodes)
+    { for(auto &node : nodes) children.push_back(priv::NodeWalkerTask(node.get())); }
+
+    template<typename _T>
+    static inline void add_opt_node(vector<priv::NodeWalkerTask> &children, _T *node)
+    { if(node != nullptr) children.push_back(priv::NodeWalkerTask(node)); }
+
+    static void add_def_children(vector<priv::NodeWalkerTask> &children, Definition *def)
+    {
+      dynamic_match(def,
+      [&](Definition *def) {},
+      [&](ModuleDefinition *module_def) {
+        add_nodes(children, module_def->defs());
+      },
+      [&](VariableDefinition *var_def) {
+        children.push_back(priv::NodeWalkerTask(static_cast<Variable *>(var_def->var().get())));
+      },
+      [&](VariableInstanceDefinition *var_inst_def) {
+        children.push_back(priv::NodeWalkerTask(static_cast<Instance *>(var_inst_def->var_inst().get())));
+      },
+      [&](FunctionDefinition *fun_def) {
+        children.push_back(priv::NodeWalkerTask(static_cast<Function *>(fun_def->fun().get())));
+      },
+      [&](FunctionInstanceDefinition *fun_inst_def) {
+        children.push_back(priv::NodeWalkerTask(static_cast<Instance *>(fun_inst_def->fun_inst().get())));
+      },
+      [&](TypeVariableDefinition *type_var_def) {
+        children.push_back(priv::NodeWalkerTask(static_cast<TypeVariable *>(type_var_def->var().get())));
+      },
+      [&](TypeFunctionDefinition *type_fun_def) {
+        children.push_back(priv::NodeWalkerTask(static_cast<TypeFunction *>(type_fun_def->fun().get())));
+      },
+      [&](TypeFunctionInstanceDefinition *type_fun_inst_def) {
+        children.push_back(priv::NodeWalkerTask(type_fun_inst_def->fun_inst().get()));
+      });
+    }
+
+    static void add_var_children(vector<priv::NodeWalkerTask> &children, Variable *var)
+    {
+      dynamic_match(var,
+      [&](Variable *var) {},
+      [&](UserDefinedVariable *var) {
+        add_opt_node(children, var->type_expr());
+        add_opt_node(children, var->value());
+      },
+      [&](ExternalVariable *var) {
+        add_opt_node(children, var->type_expr());
+      },
+      [&](AliasVariable *var) {
+        add_opt_node(children, var->type_expr());
+      },
+      [&](FunctionVariable *var) {
+        children.push_back(priv::NodeWalkerTask(var->fun().get()));
+      },
+      [&](ConstructorVariable *var) {
+        children.push_back(priv::NodeWalkerTask(var->constr().get()));
+      });
+    }
+
+    static void add_fun_children(vector<priv::NodeWalkerTask> &children, Function *fun)
+    {
+      dynamic_match(fun,
+      [&](Function *fun) {},
+      [&](UserDefinedFunction *fun) {
+        add_nodes(children, fun->args());
+        add_opt_node(children, fun->result_type_expr());
+        add_opt_node(children, fun->body());
+      },
+      [&](ExternalFunction *fun) {
+        add_nodes(children, fun->args());
+        add_opt_node(children, fun->result_type_expr());
+      },
+      [&](NativeFunction *fun) {
+        add_nodes(children, fun->args());
+        add_opt_node(children, fun->result_type_expr());
+      });
+    }
+
+    static void add_inst_children(vector<priv::NodeWalkerTask> &children, Instance *inst)
+    {
+      dynamic_match(inst,
+      [&](Instance *inst) {},
+      [&](VariableInstance *inst) {
+        children.push_back(priv::NodeWalkerTask(static_cast<Variable *>(inst->var().get())));
+      },
+      [&](FunctionInstance *inst) {
+        children.push_back(priv::NodeWalkerTask(static_cast<Function *>(inst->fun().get())));
+      });
+    }
+
+    static void add_type_var_children(vector<priv::NodeWalkerTask> &children, TypeVariable *var)
+    {
+      dynamic_match(var,
+      [&](TypeVariable *var) {},
+      [&](TypeSynonymVariable *var) {
+        children.push_back(priv::NodeWalkerTask(var->expr()));
+      },
+      [&](DatatypeVariable *var) {
+        children.push_back(priv::NodeWalkerTask(var->datatype()));
+      });
+    }
+
+    static void add_type_fun_children(vector<priv::NodeWalkerTask> &children, TypeFunction *fun)
+    {
+      dynamic_match(fun,
+      [&](TypeFunction *fun) {},
+      [&](TypeSynonymFunction *fun) {
+        add_opt_node(children, fun->body());
+      },
+      [&](DatatypeFunction *fun) {
+        children.push_back(priv::NodeWalkerTask(fun->datatype()));
+      });
+    }
+
+    static void add_type_fun_inst_children(vector<priv::NodeWalkerTask> &children, TypeFunctionInstance *inst)
+    {
+      dynamic_match(inst,
+      [&](TypeFunctionInstance *inst) {},
+      [&](TypeSynonymFunctionInstance *inst) {
+        add_nodes(children, inst->args());
+        children.push_back(priv::NodeWalkerTask(inst->body()));
+      },
+      [&](DatatypeFunctionInstance *inst) {
+        add_nodes(children, inst->args());
+        children.push_back(priv::NodeWalkerTask(inst->datatype()));
+      });
+    }
+
+    static void add_datatype_children(vector<priv::NodeWalkerTask> &children, Datatype *datatype)
+    {
+      dynamic_match(datatype,
+      [&](Datatype *datatype) {},
+      [&](NonUniqueDatatype *datatype) {
+        for(auto &constr : datatype->constrs()) children.push_back(priv::NodeWalkerTask(constr.get()));
+      },
+      [&](UniqueDatatype *datatype) {
+        for(auto &constr : datatype->constrs()) children.push_back(priv::NodeWalkerTask(static_cast<Constructor *>(constr.get())));
+      });
+    }
+
+    static void add_constr_children(vector<priv::NodeWalkerTask> &children, Constructor *constr)
+    {
+      dynamic_match(constr,
+      [&](Constructor *constr) {},
+      [&](UnnamedFieldConstructor *constr) {
+        add_nodes(children, constr->field_types());
+      },
+      [&](NamedFieldConstructor *constr) {
+        add_nodes(children, constr->field_types());
+      });
+    }
+
+    static void add_type_expr_children(vector<priv::NodeWalkerTask> &children, TypeExpression *expr)
+    {
+      dynamic_match(expr,
+      [&](TypeExpression *expr) {},
+      [&](With *with) {
+        children.push_back(priv::NodeWalkerTask(with->type1()));
+        children.push_back(priv::NodeWalkerTask(with->type2()));
+      },
+      [&](TupleType *tuple_type) {
+        add_nodes(children, tuple_type->field_types());
+      },
+      [&](FunctionType *fun_type) {
+        add_nodes(children, fun_type->arg_types());
+        children.push_back(priv::NodeWalkerTask(fun_type->result_type()));
+      },
+      [&](TypeApplication *type_app) {
+        add_nodes(children, type_app->args());
+      });
+    }
+
+    static void add_literal_value_children(vector<priv::NodeWalkerTask> &children, LiteralValue *value)
+    {
+      dynamic_match(value,
+      [&](LiteralValue *value) {},
+      [&](LambdaValue *value) {
+        add_nodes(children, value->args());
+        add_opt_node(children, value->result_type_expr());
+        add_opt_node(children, value->body());
+      });
+    }
+
+    static void add_expr_children(vector<priv::NodeWalkerTask> &children, Expression *expr)
+    {
+      dynamic_match(expr,
+      [&](Expression *expr) {},
+      [&](Literal *literal) {
+        children.push_back(priv::NodeWalkerTask(literal->literal_value()));
+      },
+      [&](Collection *collection) {
+        add_nodes(children, collection->elems());
+      },
+      [&](Tuple *tuple) {
+        add_nodes(children, tuple->fields());
+      },
+      [&](NamedFieldConstructorApplication *app) {
+        add_nodes(children, app->fields());
+      },
+      [&](Application *app) {
+        children.push_back(priv::NodeWalkerTask(app->fun()));
+        add_nodes(children, app->args());
+      },
+      [&](BuiltinApplication *app) {
+        add_nodes(children, app->args());
+      },
+      [&](SetUniqueField *set_field) {
+        children.push_back(priv::NodeWalkerTask(set_field->expr()));
+        children.push_back(priv::NodeWalkerTask(set_field->value_expr()));
+      },
+      [&](FieldOperator *field) {
+        children.push_back(priv::NodeWalkerTask(field->expr()));
+      },
+      [&](SetUniqueNamedField *set_field) {
+        children.push_back(priv::NodeWalkerTask(set_field->expr()));
+        children.push_back(priv::NodeWalkerTask(set_field->value_expr()));
+      },
+      [&](NamedFieldOperator *field) {
+        children.push_back(priv::NodeWalkerTask(field->expr()));
+      },
+      [&](TypedExpression *typed_expr) {
+        children.push_back(priv::NodeWalkerTask(typed_expr->expr()));
+        children.push_back(priv::NodeWalkerTask(typed_expr->type_expr()));
+      },
+      [&](Let *let) {
+        add_nodes(children, let->binds());
+        children.push_back(priv::NodeWalkerTask(let->expr()));
+      },
+      [&](Match *match) {
+        children.push_back(priv::NodeWalkerTask(match->expr()));
+        add_nodes(children, match->cases());
+      },
+      [&](Throw *throv) {
+        children.push_back(priv::NodeWalkerTask(throv->expr()));
+      });
+    }
+
+    static void add_binding_children(vector<priv::NodeWalkerTask> &children, Binding *bind)
+    {
+      dynamic_match(bind,
+      [&](Binding *bind) {},
+      [&](VariableBinding *bind) {
+        children.push_back(priv::NodeWalkerTask(bind->expr()));
+      },
+      [&](TupleBinding *bind) {
+        children.push_back(priv::NodeWalkerTask(bind->expr()));
+      });
+    }
+
+    static void add_pattern_children(vector<priv::NodeWalkerTask> &children, Pattern *pattern)
+    {
+      dynamic_match(pattern,
+      [&](Pattern *pattern) {},
+      [&](UnnamedFieldConstructorPattern *pattern) {
+        add_nodes(children, pattern->field_patterns());
+      },
+      [&](NamedFieldConstructorPattern *pattern) {
+        add_nodes(children, pattern->field_patterns());
+      },
+      [&](CollectionPattern *pattern) {
+        add_nodes(children, pattern->elem_patterns());
+      },
+      [&](TuplePattern *pattern) {
+        add_nodes(children, pattern->field_patterns());
+      },
+      [&](LiteralPattern *pattern) {
+        children.push_back(priv::NodeWalkerTask(pattern->literal_value()));
+      },
+      [&](AsPattern *pattern) {
+        children.push_back(priv::NodeWalkerTask(pattern->pattern()));
+      },
+      [&](TypedPattern *pattern) {
+        children.push_back(priv::NodeWalkerTask(pattern->pattern()));
+        children.push_back(priv::NodeWalkerTask(pattern->type_expr()));
+      });
+    }
+
+    static void add_value_children(vector<priv::NodeWalkerTask> &children, Value *value)
+    {
+      dynamic_match(value,
+      [&](Value *value) {},
+      [&](VariableLiteralValue *value) {
+        children.push_back(priv::NodeWalkerTask(value->literal_value()));
+      },
+      [&](CollectionValue *value) {
+        add_nodes(children, value->elems());
+      },
+      [&](TupleValue *value) {
+        add_nodes(children, value->fields());
+      },
+      [&](UnnamedFieldConstructorValue *value) {
+        add_nodes(children, value->fields());
+      },
+      [&](NamedFieldConstructorValue *value) {
+        add_nodes(children, value->fields());
+      },
+      [&](TypedValue *typed_value) {
+        children.push_back(priv::NodeWalkerTask(typed_value->value()));
+        children.push_back(priv::NodeWalkerTask(typed_value->type_expr()));
+      });
+    }
+
+    namespace priv
+    {
+      //
+      // A NodeVisitor class.
+      //
+
+      NodeVisitor::~NodeVisitor() {}
+
+      //
+      // A NodeWalker class.
+      //
+
+      void NodeWalker::walk_defs(const NodeList<Definition> &defs)
+      { for(auto &def : defs) walk(def.get()); }
+
+      void NodeWalker::walk_task(const NodeWalkerTask &task)
+      {
+        // A visitor can walk other nodes in an enter method, so the walk ends
+        // at the bottom of the stack for this call.
+        size_t bottom = _M_tasks.size();
+        _M_tasks.push_back(task);
+        while(_M_tasks.size() > bottom) {
+          NodeWalkerTask tmp_task = _M_tasks.back();
+          _M_tasks.pop_back();
+          if(tmp_task.is_leaving) {
+            leave(tmp_task);
+          } else if(enter(tmp_task)) {
+            tmp_task.is_leaving = true;
+            _M_tasks.push_back(tmp_task);
+            _M_children.clear();
+            add_children(tmp_task);
+            _M_tasks.insert(_M_tasks.end(), _M_children.rbegin(), _M_children.rend());
+          }
+        }
+      }
+
+      bool NodeWalker::enter(const NodeWalkerTask &task)
+      {
+        switch(task.kind) {
+          case NodeWalkerTaskKind::DEF:
+            return _M_visitor.enter_def(task.def);
+          case NodeWalkerTaskKind::VAR:
+            return _M_visitor.enter_var(task.var);
+          case NodeWalkerTaskKind::FUN:
+            return _M_visitor.enter_fun(task.fun);
+          case NodeWalkerTaskKind::INST:
+            return _M_visitor.enter_inst(task.inst);
+          case NodeWalkerTaskKind::TYPE_VAR:
+            return _M_visitor.enter_type_var(task.type_var);
+          case NodeWalkerTaskKind::TYPE_FUN:
+            return _M_visitor.enter_type_fun(task.type_fun);
+          case NodeWalkerTaskKind::TYPE_FUN_INST:
+            return _M_visitor.enter_type_fun_inst(task.type_fun_inst);
+          case NodeWalkerTaskKind::DATATYPE:
+            return _M_visitor.enter_datatype(task.datatype);
+          case NodeWalkerTaskKind::CONSTR:
+            return _M_visitor.enter_constr(task.constr);
+          case NodeWalkerTaskKind::TYPE_NAMED_FIELD_PAIR:
+            return _M_visitor.enter_type_named_field_pair(task.type_named_field_pair);
+          case NodeWalkerTaskKind::ARG:
+            return _M_visitor.enter_arg(task.arg);
+          case NodeWalkerTaskKind::TYPE_EXPR:
+            return _M_visitor.enter_type_expr(task.type_expr);
+          case NodeWalkerTaskKind::EXPR:
+            return _M_visitor.enter_expr(task.expr);
+          case NodeWalkerTaskKind::EXPR_NAMED_FIELD_PAIR:
+            return _M_visitor.enter_expr_named_field_pair(task.expr_named_field_pair);
+          case NodeWalkerTaskKind::BINDING:
+            return _M_visitor.enter_binding(task.bind);
+          case NodeWalkerTaskKind::CASE:
+            return _M_visitor.enter_case(task.caze);
+          case NodeWalkerTaskKind::PATTERN:
+            return _M_visitor.enter_pattern(task.pattern);
+          case NodeWalkerTaskKind::PATTERN_NAMED_FIELD_PAIR:
+            return _M_visitor.enter_pattern_named_field_pair(task.pattern_named_field_pair);
+          case NodeWalkerTaskKind::LITERAL_VALUE:
+            return _M_visitor.enter_literal_value(task.literal_value);
+          case NodeWalkerTaskKind::VALUE:
+            return _M_visitor.enter_value(task.value);
+          case NodeWalkerTaskKind::VALUE_NAMED_FIELD_PAIR:
+            return _M_visitor.enter_value_named_field_pair(task.value_named_field_pair);
+        }
+        return false;
+      }
+
+      void NodeWalker::leave(const NodeWalkerTask &task)
+      {
+        switch(task.kind) {
+          case NodeWalkerTaskKind::DEF:
+            _M_visitor.leave_def(task.def);
+            break;
+          case NodeWalkerTaskKind::VAR:
+            _M_visitor.leave_var(task.var);
+            break;
+          case NodeWalkerTaskKind::FUN:
+            _M_visitor.leave_fun(task.fun);
+            break;
+          case NodeWalkerTaskKind::INST:
+            _M_visitor.leave_inst(task.inst);
+            break;
+          case NodeWalkerTaskKind::TYPE_VAR:
+            _M_visitor.leave_type_var(task.type_var);
+            break;
+          case NodeWalkerTaskKind::TYPE_FUN:
+            _M_visitor.leave_type_fun(task.type_fun);
+            break;
+          case NodeWalkerTaskKind::TYPE_FUN_INST:
+            _M_visitor.leave_type_fun_inst(task.type_fun_inst);
+            break;
+          case NodeWalkerTaskKind::DATATYPE:
+            _M_visitor.leave_datatype(task.datatype);
+            break;
+          case NodeWalkerTaskKind::CONSTR:
+            _M_visitor.leave_constr(task.constr);
+            break;
+          case NodeWalkerTaskKind::TYPE_NAMED_FIELD_PAIR:
+            _M_visitor.leave_type_named_field_pair(task.type_named_field_pair);
+            break;
+          case NodeWalkerTaskKind::ARG:
+            _M_visitor.leave_arg(task.arg);
+            break;
+          case NodeWalkerTaskKind::TYPE_EXPR:
+            _M_visitor.leave_type_expr(task.type_expr);
+            break;
+          case NodeWalkerTaskKind::EXPR:
+            _M_visitor.leave_expr(task.expr);
+            break;
+          case NodeWalkerTaskKind::EXPR_NAMED_FIELD_PAIR:
+            _M_visitor.leave_expr_named_field_pair(task.expr_named_field_pair);
+            break;
+          case NodeWalkerTaskKind::BINDING:
+            _M_visitor.leave_binding(task.bind);
+            break;
+          case NodeWalkerTaskKind::CASE:
+            _M_visitor.leave_case(task.caze);
+            break;
+          case NodeWalkerTaskKind::PATTERN:
+            _M_visitor.leave_pattern(task.pattern);
+            break;
+          case NodeWalkerTaskKind::PATTERN_NAMED_FIELD_PAIR:
+            _M_visitor.leave_pattern_named_field_pair(task.pattern_named_field_pair);
+            break;
+          case NodeWalkerTaskKind::LITERAL_VALUE:
+            _M_visitor.leave_literal_value(task.literal_value);
+            break;
+          case NodeWalkerTaskKind::VALUE:
+            _M_visitor.leave_value(task.value);
+            break;
+          case NodeWalkerTaskKind::VALUE_NAMED_FIELD_PAIR:
+            _M_visitor.leave_value_named_field_pair(task.value_named_field_pair);
+            break;
+        }
+      }
+
+      void NodeWalker::add_children(const NodeWalkerTask &task)
+      {
+        switch(task.kind) {
+          case NodeWalkerTaskKind::DEF:
+            add_def_children(_M_children, task.def);
+            break;
+          case NodeWalkerTaskKind::VAR:
+            add_var_children(_M_children, task.var);
+            break;
+          case NodeWalkerTaskKind::FUN:
+            add_fun_children(_M_children, task.fun);
+            break;
+          case NodeWalkerTaskKind::INST:
+            add_inst_children(_M_children, task.inst);
+            break;
+          case NodeWalkerTaskKind::TYPE_VAR:
+            add_type_var_children(_M_children, task.type_var);
+            break;
+          case NodeWalkerTaskKind::TYPE_FUN:
+            add_type_fun_children(_M_children, task.type_fun);
+            break;
+          case NodeWalkerTaskKind::TYPE_FUN_INST:
+            add_type_fun_inst_children(_M_children, task.type_fun_inst);
+            break;
+          case NodeWalkerTaskKind::DATATYPE:
+            add_datatype_children(_M_children, task.datatype);
+            break;
+          case NodeWalkerTaskKind::CONSTR:
+            add_constr_children(_M_children, task.constr);
+            break;
+          case NodeWalkerTaskKind::TYPE_NAMED_FIELD_PAIR:
+            _M_children.push_back(NodeWalkerTask(task.type_named_field_pair->type_expr()));
+            break;
+          case NodeWalkerTaskKind::ARG:
+            add_opt_node(_M_children, task.arg->type_expr());
+            break;
+          case NodeWalkerTaskKind::TYPE_EXPR:
+            add_type_expr_children(_M_children, task.type_expr);
+            break;
+          case NodeWalkerTaskKind::EXPR:
+            add_expr_children(_M_children, task.expr);
+            break;
+          case NodeWalkerTaskKind::EXPR_NAMED_FIELD_PAIR:
+            _M_children.push_back(NodeWalkerTask(task.expr_named_field_pair->expr()));
+            break;
+          case NodeWalkerTaskKind::BINDING:
+            add_binding_children(_M_children, task.bind);
+            break;
+          case NodeWalkerTaskKind::CASE:
+            _M_children.push_back(NodeWalkerTask(task.caze->pattern()));
+            _M_children.push_back(NodeWalkerTask(task.caze->expr()));
+            break;
+          case NodeWalkerTaskKind::PATTERN:
+            add_pattern_children(_M_children, task.pattern);
+            break;
+          case NodeWalkerTaskKind::PATTERN_NAMED_FIELD_PAIR:
+            _M_children.push_back(NodeWalkerTask(task.pattern_named_field_pair->pattern()));
+            break;
+          case NodeWalkerTaskKind::LITERAL_VALUE:
+            add_literal_value_children(_M_children, task.literal_value);
+            break;
+          case NodeWalkerTaskKind::VALUE:
+            add_value_children(_M_children, task.value);
+            break;
+          case NodeWalkerTaskKind::VALUE_NAMED_FIELD_PAIR:
+            _M_children.push_back(NodeWalkerTask(task.value_named_field_pair->value()));
+            break;
+        }
+      }
+    }
+  }
+}
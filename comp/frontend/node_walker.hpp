@@ -0,0 +1,256 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_NODE_WALKER_HPP
+#define _FRONTEND_NODE_WALKER_HPP
+
+#include <vector>
+#include <lesfl/frontend/tree.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // An enter method returns false if the children of the node and the
+      // leave method of the node are skipped. A visitor can walk selected
+      // children of such node in the enter method by the same walker.
+      class NodeVisitor
+      {
+      protected:
+        NodeVisitor() {}
+      public:
+        virtual ~NodeVisitor();
+
+        virtual bool enter_def(Definition *def) { return true; }
+
+        virtual void leave_def(Definition *def) {}
+
+        virtual bool enter_var(Variable *var) { return true; }
+
+        virtual void leave_var(Variable *var) {}
+
+        virtual bool enter_fun(Function *fun) { return true; }
+
+        virtual void leave_fun(Function *fun) {}
+
+        virtual bool enter_inst(Instance *inst) { return true; }
+
+        virtual void leave_inst(Instance *inst) {}
+
+        virtual bool enter_type_var(TypeVariable *var) { return true; }
+
+        virtual void leave_type_var(TypeVariable *var) {}
+
+        virtual bool enter_type_fun(TypeFunction *fun) { return true; }
+
+        virtual void leave_type_fun(TypeFunction *fun) {}
+
+        virtual bool enter_type_fun_inst(TypeFunctionInstance *inst) { return true; }
+
+        virtual void leave_type_fun_inst(TypeFunctionInstance *inst) {}
+
+        virtual bool enter_datatype(Datatype *datatype) { return true; }
+
+        virtual void leave_datatype(Datatype *datatype) {}
+
+        virtual bool enter_constr(Constructor *constr) { return true; }
+
+        virtual void leave_constr(Constructor *constr) {}
+
+        virtual bool enter_type_named_field_pair(TypeNamedFieldPair *pair) { return true; }
+
+        virtual void leave_type_named_field_pair(TypeNamedFieldPair *pair) {}
+
+        virtual bool enter_arg(Argument *arg) { return true; }
+
+        virtual void leave_arg(Argument *arg) {}
+
+        virtual bool enter_type_expr(TypeExpression *expr) { return true; }
+
+        virtual void leave_type_expr(TypeExpression *expr) {}
+
+        virtual bool enter_expr(Expression *expr) { return true; }
+
+        virtual void leave_expr(Expression *expr) {}
+
+        virtual bool enter_expr_named_field_pair(ExpressionNamedFieldPair *pair) { return true; }
+
+        virtual void leave_expr_named_field_pair(ExpressionNamedFieldPair *pair) {}
+
+        virtual bool enter_binding(Binding *bind) { return true; }
+
+        virtual void leave_binding(Binding *bind) {}
+
+        virtual bool enter_case(Case *caze) { return true; }
+
+        virtual void leave_case(Case *caze) {}
+
+        virtual bool enter_pattern(Pattern *pattern) { return true; }
+
+        virtual void leave_pattern(Pattern *pattern) {}
+
+        virtual bool enter_pattern_named_field_pair(PatternNamedFieldPair *pair) { return true; }
+
+        virtual void leave_pattern_named_field_pair(PatternNamedFieldPair *pair) {}
+
+        virtual bool enter_literal_value(LiteralValue *value) { return true; }
+
+        virtual void leave_literal_value(LiteralValue *value) {}
+
+        virtual bool enter_value(Value *value) { return true; }
+
+        virtual void leave_value(Value *value) {}
+
+        virtual bool enter_value_named_field_pair(ValueNamedFieldPair *pair) { return true; }
+
+        virtual void leave_value_named_field_pair(ValueNamedFieldPair *pair) {}
+      };
+
+      enum class NodeWalkerTaskKind
+      {
+        DEF,
+        VAR,
+        FUN,
+        INST,
+        TYPE_VAR,
+        TYPE_FUN,
+        TYPE_FUN_INST,
+        DATATYPE,
+        CONSTR,
+        TYPE_NAMED_FIELD_PAIR,
+        ARG,
+        TYPE_EXPR,
+        EXPR,
+        EXPR_NAMED_FIELD_PAIR,
+        BINDING,
+        CASE,
+        PATTERN,
+        PATTERN_NAMED_FIELD_PAIR,
+        LITERAL_VALUE,
+        VALUE,
+        VALUE_NAMED_FIELD_PAIR
+      };
+
+      struct NodeWalkerTask
+      {
+        NodeWalkerTaskKind kind;
+        bool is_leaving;
+        union
+        {
+          Definition *def;
+          Variable *var;
+          Function *fun;
+          Instance *inst;
+          TypeVariable *type_var;
+          TypeFunction *type_fun;
+          TypeFunctionInstance *type_fun_inst;
+          Datatype *datatype;
+          Constructor *constr;
+          TypeNamedFieldPair *type_named_field_pair;
+          Argument *arg;
+          TypeExpression *type_expr;
+          Expression *expr;
+          ExpressionNamedFieldPair *expr_named_field_pair;
+          Binding *bind;
+          Case *caze;
+          Pattern *pattern;
+          PatternNamedFieldPair *pattern_named_field_pair;
+          LiteralValue *literal_value;
+          Value *value;
+          ValueNamedFieldPair *value_named_field_pair;
+        };
+
+        NodeWalkerTask(Definition *def) : kind(NodeWalkerTaskKind::DEF), is_leaving(false), def(def) {}
+
+        NodeWalkerTask(Variable *var) : kind(NodeWalkerTaskKind::VAR), is_leaving(false), var(var) {}
+
+        NodeWalkerTask(Function *fun) : kind(NodeWalkerTaskKind::FUN), is_leaving(false), fun(fun) {}
+
+        NodeWalkerTask(Instance *inst) : kind(NodeWalkerTaskKind::INST), is_leaving(false), inst(inst) {}
+
+        NodeWalkerTask(TypeVariable *var) : kind(NodeWalkerTaskKind::TYPE_VAR), is_leaving(false), type_var(var) {}
+
+        NodeWalkerTask(TypeFunction *fun) : kind(NodeWalkerTaskKind::TYPE_FUN), is_leaving(false), type_fun(fun) {}
+
+        NodeWalkerTask(TypeFunctionInstance *inst) :
+          kind(NodeWalkerTaskKind::TYPE_FUN_INST), is_leaving(false), type_fun_inst(inst) {}
+
+        NodeWalkerTask(Datatype *datatype) : kind(NodeWalkerTaskKind::DATATYPE), is_leaving(false), datatype(datatype) {}
+
+        NodeWalkerTask(Constructor *constr) : kind(NodeWalkerTaskKind::CONSTR), is_leaving(false), constr(constr) {}
+
+        NodeWalkerTask(TypeNamedFieldPair *pair) :
+          kind(NodeWalkerTaskKind::TYPE_NAMED_FIELD_PAIR), is_leaving(false), type_named_field_pair(pair) {}
+
+        NodeWalkerTask(Argument *arg) : kind(NodeWalkerTaskKind::ARG), is_leaving(false), arg(arg) {}
+
+        NodeWalkerTask(TypeExpression *expr) : kind(NodeWalkerTaskKind::TYPE_EXPR), is_leaving(false), type_expr(expr) {}
+
+        NodeWalkerTask(Expression *expr) : kind(NodeWalkerTaskKind::EXPR), is_leaving(false), expr(expr) {}
+
+        NodeWalkerTask(ExpressionNamedFieldPair *pair) :
+          kind(NodeWalkerTaskKind::EXPR_NAMED_FIELD_PAIR), is_leaving(false), expr_named_field_pair(pair) {}
+
+        NodeWalkerTask(Binding *bind) : kind(NodeWalkerTaskKind::BINDING), is_leaving(false), bind(bind) {}
+
+        NodeWalkerTask(Case *caze) : kind(NodeWalkerTaskKind::CASE), is_leaving(false), caze(caze) {}
+
+        NodeWalkerTask(Pattern *pattern) : kind(NodeWalkerTaskKind::PATTERN), is_leaving(false), pattern(pattern) {}
+
+        NodeWalkerTask(PatternNamedFieldPair *pair) :
+          kind(NodeWalkerTaskKind::PATTERN_NAMED_FIELD_PAIR), is_leaving(false), pattern_named_field_pair(pair) {}
+
+        NodeWalkerTask(LiteralValue *value) :
+          kind(NodeWalkerTaskKind::LITERAL_VALUE), is_leaving(false), literal_value(value) {}
+
+        NodeWalkerTask(Value *value) : kind(NodeWalkerTaskKind::VALUE), is_leaving(false), value(value) {}
+
+        NodeWalkerTask(ValueNamedFieldPair *pair) :
+          kind(NodeWalkerTaskKind::VALUE_NAMED_FIELD_PAIR), is_leaving(false), value_named_field_pair(pair) {}
+      };
+
+      // A NodeWalker object walks nodes in the preorder for the enter methods
+      // and in the postorder for the leave methods by an explicit task stack,
+      // so a depth of a tree isn't limited by a depth of a call stack. The
+      // children are walked in the order of the fields of the node. A walker
+      // doesn't parse deferred bodies, so a deferred body is walked as a
+      // DeferredExpression object.
+      class NodeWalker
+      {
+        NodeVisitor &_M_visitor;
+        std::vector<NodeWalkerTask> _M_tasks;
+        std::vector<NodeWalkerTask> _M_children;
+      public:
+        NodeWalker(NodeVisitor &visitor) : _M_visitor(visitor) {}
+
+        NodeWalker(const NodeWalker &) = delete;
+
+        NodeWalker &operator=(const NodeWalker &) = delete;
+
+        void walk_defs(const NodeList<Definition> &defs);
+
+        template<typename _T>
+        void walk(_T *node) { walk_task(NodeWalkerTask(node)); }
+
+        template<typename _T>
+        void walk_opt(_T *node) { if(node != nullptr) walk(node); }
+      private:
+        void walk_task(const NodeWalkerTask &task);
+
+        bool enter(const NodeWalkerTask &task);
+
+        void leave(const NodeWalkerTask &task);
+
+        void add_children(const NodeWalkerTask &task);
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,146 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <lesfl/frontend/parse_profile.hpp>
+#include "frontend/parse_profiler.hpp"
+#include "frontend/bison_parser.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // Static inline functions and static functions.
+
+      static inline bool has_prefix(const char *str, const char *prefix)
+      { return strncmp(str, prefix, strlen(prefix)) == 0; }
+
+      // The rule and the line are read from a formatted message rather than
+      // from the arguments, so other messages of Bison are only skipped.
+      static bool parse_rule_and_line(const char *msg, int &rule, int &line)
+      {
+        const char *str = strstr(msg, " by rule ");
+        return str != nullptr && sscanf(str, " by rule %d (line %d)", &rule, &line) == 2;
+      }
+
+      //
+      // A ParseProfiler class.
+      //
+
+      thread_local ParseProfiler *ParseProfiler::_S_current = nullptr;
+
+      ParseProfiler::ParseProfiler(SourceParseProfile &profile) :
+        _M_profile(profile), _M_stack_count(1), _M_saved_profiler(_S_current)
+      { _S_current = this; }
+
+      ParseProfiler::~ParseProfiler() { _S_current = _M_saved_profiler; }
+
+      void ParseProfiler::trace(const char *msg)
+      {
+        if(has_prefix(msg, "Splitting off stack ")) {
+          _M_profile.increase_stack_split_count();
+          _M_stack_count++;
+          _M_profile.update_max_stack_count(_M_stack_count);
+        } else if(has_prefix(msg, "Stack ") && strstr(msg, " dies.") != nullptr) {
+          _M_profile.increase_discarded_parse_count();
+          if(_M_stack_count > 1) _M_stack_count--;
+        } else if(has_prefix(msg, "Merging stack ")) {
+          _M_profile.increase_stack_merge_count();
+          if(_M_stack_count > 1) _M_stack_count--;
+        } else if(has_prefix(msg, "Reduced stack ") && strstr(msg, "action deferred") != nullptr) {
+          int rule, line;
+          _M_profile.increase_deferred_action_count();
+          if(parse_rule_and_line(msg, rule, line))
+            _M_profile.rule_profile(rule, line).increase_deferred_action_count();
+        } else if(has_prefix(msg, "Parse on stack ") && strstr(msg, " rejected by rule ") != nullptr) {
+          int rule, line;
+          _M_profile.increase_discarded_parse_count();
+          if(parse_rule_and_line(msg, rule, line))
+            _M_profile.rule_profile(rule, line).increase_rejected_parse_count();
+        } else if(has_prefix(msg, "Returning to deterministic operation.")) {
+          _M_stack_count = 1;
+        }
+      }
+
+      int trace_parser(FILE *file, const char *format, ...)
+      {
+        ParseProfiler *profiler = ParseProfiler::current();
+        if(profiler != nullptr) {
+          char msg[256];
+          va_list ap;
+          va_start(ap, format);
+          vsnprintf(msg, sizeof(msg), format, ap);
+          va_end(ap);
+          profiler->trace(msg);
+        }
+        return 0;
+      }
+    }
+
+    //
+    // A ParseProfile class.
+    //
+
+    bool ParseProfile::is_available()
+    {
+#if YYDEBUG
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    void ParseProfile::write_report(ostream &os) const
+    {
+      size_t split_count = 0, deferred_action_count = 0, discarded_parse_count = 0;
+      map<int, GrammarRuleProfile> rule_profiles;
+      if(!is_available()) {
+        os << "parse profile: unavailable\n";
+        return;
+      }
+      os << "parse profile:\n";
+      for(auto &source_profile : _M_source_profiles) {
+        os << "  " << source_profile.file_name() << ":";
+        os << " splits=" << source_profile.stack_split_count();
+        os << " max_stacks=" << source_profile.max_stack_count();
+        os << " merges=" << source_profile.stack_merge_count();
+        os << " deferred_actions=" << source_profile.deferred_action_count();
+        os << " discarded_parses=" << source_profile.discarded_parse_count() << "\n";
+        split_count += source_profile.stack_split_count();
+        deferred_action_count += source_profile.deferred_action_count();
+        discarded_parse_count += source_profile.discarded_parse_count();
+        for(auto &pair : source_profile.rule_profiles()) {
+          auto &rule_profile = rule_profiles.insert(make_pair(pair.first, GrammarRuleProfile(pair.second.rule(), pair.second.line()))).first->second;
+          rule_profile.add_counts(pair.second);
+        }
+      }
+      os << "total: splits=" << split_count;
+      os << " deferred_actions=" << deferred_action_count;
+      os << " discarded_parses=" << discarded_parse_count << "\n";
+      if(!rule_profiles.empty()) {
+        vector<const GrammarRuleProfile *> sorted_rule_profiles;
+        for(auto &pair : rule_profiles) sorted_rule_profiles.push_back(&(pair.second));
+        stable_sort(sorted_rule_profiles.begin(), sorted_rule_profiles.end(), [](const GrammarRuleProfile *profile1, const GrammarRuleProfile *profile2) {
+          return profile1->deferred_action_count() + profile1->rejected_parse_count() > profile2->deferred_action_count() + profile2->rejected_parse_count();
+        });
+        os << "ambiguous rules:\n";
+        for(auto rule_profile : sorted_rule_profiles) {
+          os << "  rule " << rule_profile->rule() << " (line " << rule_profile->line() << "):";
+          os << " deferred_actions=" << rule_profile->deferred_action_count();
+          os << " rejected_parses=" << rule_profile->rejected_parse_count() << "\n";
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,43 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_PARSE_PROFILER_HPP
+#define _FRONTEND_PARSE_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <lesfl/frontend/parse_profile.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      class ParseProfiler
+      {
+        static thread_local ParseProfiler *_S_current;
+
+        SourceParseProfile &_M_profile;
+        std::size_t _M_stack_count;
+        ParseProfiler *_M_saved_profiler;
+      public:
+        ParseProfiler(SourceParseProfile &profile);
+
+        ~ParseProfiler();
+
+        static ParseProfiler *current() { return _S_current; }
+
+        void trace(const char *msg);
+      };
+
+      int trace_parser(std::FILE *file, const char *format, ...);
+    }
+  }
+}
+
+#endif
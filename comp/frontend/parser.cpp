@@ -7,8 +7,11 @@
  ****************************************************************************/
 #include <lesfl/comp.hpp>
 #include <lesfl/frontend.hpp>
+#include "frontend/deferred_body.hpp"
 #include "frontend/driver.hpp"
 #include "frontend/lexer.hpp"
+#include "frontend/parse_profiler.hpp"
+#include "frontend/stats_collector.hpp"
 #include "frontend/bison_parser.hpp"
 
 using namespace std;
@@ -18,17 +21,119 @@ namespace lesfl
 {
   namespace frontend
   {
+    namespace priv
+    {
+      //
+      // A DeferredTokens class.
+      //
+
+      DeferredTokens::~DeferredTokens()
+      {
+        for(auto &token : _M_tokens) delete_value(token);
+      }
+
+      void DeferredTokens::delete_value(DeferredToken &token)
+      {
+        switch(token.token) {
+          case BisonParser::token::STRING:
+          case BisonParser::token::CONSTR_IDENT:
+          case BisonParser::token::VAR_IDENT:
+            if(token.value.string != nullptr) delete token.value.string;
+            break;
+          case BisonParser::token::WSTRING:
+            if(token.value.wstring != nullptr) delete token.value.wstring;
+            break;
+          case BisonParser::token::DEFERRED_BODY:
+            if(token.value.deferred_tokens != nullptr) delete token.value.deferred_tokens;
+            break;
+        }
+      }
+
+      void DeferredTokens::release_value(DeferredToken &token)
+      {
+        switch(token.token) {
+          case BisonParser::token::STRING:
+          case BisonParser::token::CONSTR_IDENT:
+          case BisonParser::token::VAR_IDENT:
+            token.value.string = nullptr;
+            break;
+          case BisonParser::token::WSTRING:
+            token.value.wstring = nullptr;
+            break;
+        }
+      }
+
+      //
+      // A TokenDeferredBody class.
+      //
+
+      TokenDeferredBody::~TokenDeferredBody() {}
+
+      Expression *TokenDeferredBody::parse(list<Error> &errors)
+      {
+        if(!_M_is_parsed) {
+          _M_is_parsed = true;
+          Driver driver(_M_source, _M_errors);
+          Lexer lexer(_M_tokens.get());
+          ostream null_os(nullptr);
+          BisonParser parser(driver, lexer);
+#if YYDEBUG
+          parser.set_debug_stream(null_os);
+#endif
+          bool is_success;
+          try {
+            is_success = (parser.parse() == 0);
+          } catch(BisonParser::syntax_error &e) {
+            driver.add_error(Error(Position(driver.source(), e.location.begin.line, e.location.begin.column), e.what()));
+            is_success = false;
+          }
+          _M_tokens.reset();
+          _M_is_success = is_success;
+          errors.insert(errors.end(), _M_errors.begin(), _M_errors.end());
+          return is_success ? driver.release_expr() : nullptr;
+        } else {
+          if(_M_is_success)
+            errors.push_back(Error(_M_pos, "internal error: deferred body is already parsed"));
+          else
+            errors.insert(errors.end(), _M_errors.begin(), _M_errors.end());
+          return nullptr;
+        }
+      }
+    }
+
+    //
+    // A Parser class.
+    //
+
     Parser::~Parser() {}
 
-    bool Parser::parse(const vector<Source> &sources, Tree &tree, list<Error> &errors)
+    bool Parser::parse(const vector<Source> &sources, Tree &tree, list<Error> &errors, const FrontendOptions &options)
+    { return parse_sources(sources, &tree, nullptr, errors, options); }
+
+    bool Parser::parse_defs(const vector<Source> &sources, const function<void (unique_ptr<Definition>)> &fun, list<Error> &errors, const FrontendOptions &options)
+    { return parse_sources(sources, nullptr, fun, errors, options); }
+
+    bool Parser::parse_sources(const vector<Source> &sources, Tree *tree, const function<void (unique_ptr<Definition>)> &def_fun, list<Error> &errors, const FrontendOptions &options)
     {
       bool is_success = true;
+      unique_ptr<StatsCollector> collector;
+      if(options.stats != nullptr) collector = unique_ptr<StatsCollector>(new StatsCollector(*(options.stats)));
       for(auto &source : sources) {
+        PhaseTimer timer(options.stats, options.stats != nullptr ? "parse " + source.file_name() : string());
         SourceStream ss = source.open();
         if(ss.istream().good()) {
-          Driver driver(source, tree, errors);
-          Lexer lexer(&(ss.istream()));
+          Driver driver = (tree != nullptr ? Driver(source, *tree, errors) : Driver(source, def_fun, errors));
+          Lexer lexer(&(ss.istream()), _M_is_deferred_parsing);
+          ostream null_os(nullptr);
           BisonParser parser(driver, lexer);
+          unique_ptr<ParseProfiler> profiler;
+#if YYDEBUG
+          parser.set_debug_stream(null_os);
+          if(options.profile != nullptr)
+            profiler = unique_ptr<ParseProfiler>(new ParseProfiler(options.profile->add_source_profile(source.file_name())));
+#else
+          if(options.profile != nullptr) options.profile->add_source_profile(source.file_name());
+#endif
           try {
             is_success &= (parser.parse() == 0);
           } catch(BisonParser::syntax_error &e) {
@@ -0,0 +1,180 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <lesfl/frontend.hpp>
+#include "frontend/node_walker.hpp"
+#include "util.hpp"
+
+using namespace std;
+using namespace lesfl::util;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace
+    {
+      class PositionIndexVisitor : public priv::NodeVisitor
+      {
+        PositionIndex &_M_index;
+      public:
+        PositionIndexVisitor(PositionIndex &index) : _M_index(index) {}
+
+        bool enter_def(Definition *def);
+
+        bool enter_type_expr(TypeExpression *expr);
+
+        bool enter_expr(Expression *expr);
+
+        bool enter_pattern(Pattern *pattern);
+
+        bool enter_value(Value *value);
+      };
+    }
+
+    //
+    // Static inline functions and static functions.
+    //
+
+    template<typename _T>
+    static inline void add_entry(PositionIndex &index, PositionIndexNodeKind kind, _T *node, const Identifier *ident = nullptr, const Indexable *local_var = nullptr)
+    { index.add_entry(node->pos().source().file_name(), PositionIndexEntry(kind, node, ident, local_var)); }
+
+    static inline const Indexable *local_var_from_ident(const Identifier *ident)
+    {
+      if(ident->has_key_ident()) return nullptr;
+      return dynamic_cast<const RelativeIdentifier *>(ident);
+    }
+
+    static inline bool is_before(size_t line1, size_t column1, size_t line2, size_t column2)
+    { return line1 < line2 || (line1 == line2 && column1 < column2); }
+
+    //
+    // A PositionIndexVisitor class.
+    //
+
+    bool PositionIndexVisitor::enter_def(Definition *def)
+    {
+      dynamic_match(def,
+      [&](Definition *def) {
+        add_entry(_M_index, PositionIndexNodeKind::DEF, def);
+      },
+      [&](Import *import) {
+        add_entry(_M_index, PositionIndexNodeKind::DEF, import, import->module_ident());
+      },
+      [&](ModuleDefinition *module_def) {
+        add_entry(_M_index, PositionIndexNodeKind::DEF, module_def, module_def->ident());
+      });
+      return true;
+    }
+
+    bool PositionIndexVisitor::enter_type_expr(TypeExpression *expr)
+    {
+      dynamic_match(expr,
+      [&](TypeExpression *expr) {
+        add_entry(_M_index, PositionIndexNodeKind::TYPE_EXPR, expr);
+      },
+      [&](TypeVariableExpression *type_var_expr) {
+        add_entry(_M_index, PositionIndexNodeKind::TYPE_EXPR, type_var_expr, type_var_expr->ident());
+      },
+      [&](TypeApplication *type_app) {
+        add_entry(_M_index, PositionIndexNodeKind::TYPE_EXPR, type_app, type_app->fun_ident());
+      });
+      return true;
+    }
+
+    bool PositionIndexVisitor::enter_expr(Expression *expr)
+    {
+      dynamic_match(expr,
+      [&](Expression *expr) {
+        add_entry(_M_index, PositionIndexNodeKind::EXPR, expr);
+      },
+      [&](VariableExpression *var_expr) {
+        add_entry(_M_index, PositionIndexNodeKind::EXPR, var_expr, var_expr->ident(), local_var_from_ident(var_expr->ident()));
+      },
+      [&](NamedFieldConstructorApplication *app) {
+        add_entry(_M_index, PositionIndexNodeKind::EXPR, app, app->constr_ident());
+      });
+      return true;
+    }
+
+    bool PositionIndexVisitor::enter_pattern(Pattern *pattern)
+    {
+      dynamic_match(pattern,
+      [&](Pattern *pattern) {
+        add_entry(_M_index, PositionIndexNodeKind::PATTERN, pattern);
+      },
+      [&](ConstructorPattern *pattern) {
+        add_entry(_M_index, PositionIndexNodeKind::PATTERN, pattern, pattern->constr_ident());
+      },
+      [&](VariablePattern *pattern) {
+        add_entry(_M_index, PositionIndexNodeKind::PATTERN, pattern, nullptr, pattern);
+      },
+      [&](AsPattern *pattern) {
+        add_entry(_M_index, PositionIndexNodeKind::PATTERN, pattern, nullptr, pattern);
+      });
+      return true;
+    }
+
+    bool PositionIndexVisitor::enter_value(Value *value)
+    {
+      dynamic_match(value,
+      [&](Value *value) {
+        add_entry(_M_index, PositionIndexNodeKind::VALUE, value);
+      },
+      [&](ConstructorValue *value) {
+        add_entry(_M_index, PositionIndexNodeKind::VALUE, value, value->constr_ident());
+      });
+      return true;
+    }
+
+    //
+    // A PositionIndex class.
+    //
+
+    const PositionIndexEntry *PositionIndex::find(const string &file_name, size_t line, size_t column) const
+    {
+      auto iter = _M_entries.find(file_name);
+      if(iter == _M_entries.end()) return nullptr;
+      const vector<PositionIndexEntry> &entries = iter->second;
+      // The last entry that doesn't begin after the location is the innermost
+      // node because a parent precedes its children for the same location.
+      auto entry_iter = upper_bound(entries.begin(), entries.end(), make_pair(line, column), [](const pair<size_t, size_t> &location, const PositionIndexEntry &entry) {
+        return is_before(location.first, location.second, entry.line(), entry.column());
+      });
+      if(entry_iter == entries.begin()) return nullptr;
+      entry_iter--;
+      return &(*entry_iter);
+    }
+
+    void PositionIndex::sort_entries()
+    {
+      for(auto &tmp_pair : _M_entries) {
+        stable_sort(tmp_pair.second.begin(), tmp_pair.second.end(), [](const PositionIndexEntry &entry1, const PositionIndexEntry &entry2) {
+          return is_before(entry1.line(), entry1.column(), entry2.line(), entry2.column());
+        });
+      }
+    }
+
+    //
+    // A PositionIndexBuilder class.
+    //
+
+    PositionIndexBuilder::~PositionIndexBuilder() {}
+
+    bool PositionIndexBuilder::build_position_index(const Tree &tree, PositionIndex &index)
+    {
+      index.clear();
+      PositionIndexVisitor visitor(index);
+      priv::NodeWalker walker(visitor);
+      for(auto &defs : tree.defs()) walker.walk_defs(*defs);
+      index.sort_entries();
+      return true;
+    }
+  }
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <lesfl/frontend/ref_index.hpp>
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    //
+    // A ReferenceIndex class.
+    //
+
+    void ReferenceIndex::add_refs(const vector<pair<KeyIdentifier, Reference>> &refs)
+    {
+      unordered_map<KeyIdentifier, size_t> ref_counts;
+      for(auto &pair : refs) ref_counts[pair.first]++;
+      for(auto &pair : ref_counts) {
+        vector<Reference> &key_ident_refs = _M_refs[pair.first];
+        key_ident_refs.reserve(key_ident_refs.size() + pair.second);
+      }
+      for(auto &pair : refs) _M_refs[pair.first].push_back(pair.second);
+    }
+  }
+}
@@ -9,6 +9,7 @@
 #include <iterator>
 #include <set>
 #include <lesfl/frontend.hpp>
+#include "frontend/stats_collector.hpp"
 #include "util.hpp"
 
 using namespace std;
@@ -32,6 +33,50 @@ namespace lesfl
         LocalVariablePair() : ref_count(0) {}
       };
 
+      enum class ResolverTaskKind
+      {
+        EXPR,
+        PATTERN,
+        VALUE,
+        TYPE_EXPR,
+        PUSH_LOCAL_VAR_VECTOR,
+        PUSH_ARG,
+        CLEAR_TOP_LOCAL_VAR_IDENTS,
+        POP_LOCAL_VARS,
+        POP_CLOSURE_LIMIT,
+        LAMBDA_BODY
+      };
+
+      struct ResolverTask
+      {
+        ResolverTaskKind kind;
+        union
+        {
+          Expression *expr;
+          Pattern *pattern;
+          Value *value;
+          TypeExpression *type_expr;
+          Argument *arg;
+          LambdaValue *lambda_value;
+        };
+        bool can_add_type_params;
+
+        ResolverTask(ResolverTaskKind kind) : kind(kind), expr(nullptr), can_add_type_params(false) {}
+
+        ResolverTask(Expression *expr) : kind(ResolverTaskKind::EXPR), expr(expr), can_add_type_params(false) {}
+
+        ResolverTask(Pattern *pattern) : kind(ResolverTaskKind::PATTERN), pattern(pattern), can_add_type_params(false) {}
+
+        ResolverTask(Value *value) : kind(ResolverTaskKind::VALUE), value(value), can_add_type_params(false) {}
+
+        ResolverTask(TypeExpression *type_expr, bool can_add_type_params) :
+          kind(ResolverTaskKind::TYPE_EXPR), type_expr(type_expr), can_add_type_params(can_add_type_params) {}
+
+        ResolverTask(Argument *arg) : kind(ResolverTaskKind::PUSH_ARG), arg(arg), can_add_type_params(false) {}
+
+        ResolverTask(LambdaValue *lambda_value) : kind(ResolverTaskKind::LAMBDA_BODY), lambda_value(lambda_value), can_add_type_params(false) {}
+      };
+
       struct ResolverContext
       {
         Tree &tree;
@@ -46,9 +91,16 @@ namespace lesfl
         unordered_map<string, size_t> type_param_indices;
         size_t type_param_count;
         bool template_flag;
-
-        ResolverContext(Tree &tree) :
-          tree(tree), predef_module_ident("predef"), local_var_count(0), type_param_count(0) {}
+        vector<ResolverTask> tasks;
+        Trace *trace;
+        bool can_add_refs;
+        const Definition *current_def;
+        KeyIdentifier current_def_key_ident;
+        bool has_current_def_key_ident;
+        vector<pair<KeyIdentifier, Reference>> refs;
+
+        ResolverContext(Tree &tree, Trace *trace = nullptr, bool can_add_refs = false) :
+          tree(tree), predef_module_ident("predef"), local_var_count(0), type_param_count(0), trace(trace), can_add_refs(can_add_refs), current_def(nullptr), has_current_def_key_ident(false) {}
       };
     }
 
@@ -121,7 +173,7 @@ namespace lesfl
         return false;
     }
 
-    static bool check_and_clear_local_var_ident_stack(ResolverContext &context, const Position &pos, list<Error> &errors)
+    static bool check_and_clear_local_var_ident_stack(ResolverContext &context, const Position &pos, DiagnosticList &errors)
     {
       bool is_success = true;
       if(!context.local_var_ident_stack.empty()) {
@@ -144,7 +196,7 @@ namespace lesfl
         return false;
     }
     
-    static bool check_and_clear_closure_limit_stack(ResolverContext &context, const Position &pos, list<Error> &errors)
+    static bool check_and_clear_closure_limit_stack(ResolverContext &context, const Position &pos, DiagnosticList &errors)
     {
       bool is_success = true;
       if(!context.closure_limit_stack.empty()) {
@@ -177,7 +229,7 @@ namespace lesfl
       context.type_param_count = 0;
     }
 
-    static bool check_and_clear_type_param_indices(ResolverContext &context, const Position &pos, list<Error> &errors)
+    static bool check_and_clear_type_param_indices(ResolverContext &context, const Position &pos, DiagnosticList &errors)
     {
       bool is_success = true;
       if(!context.type_param_indices.empty()) {
@@ -193,7 +245,16 @@ namespace lesfl
       return is_success;
     }
 
-    static bool add_ident_or_get_key_ident(ResolverContext &context, AbsoluteIdentifier *ident, KeyIdentifier &key_ident, bool &is_added, const Position &pos, list<Error> &errors)
+    template<typename _T>
+    static bool parse_body(_T *node, DiagnosticList &errors)
+    {
+      list<Error> tmp_errors;
+      bool is_success = node->parse_body(tmp_errors);
+      for(auto &error : tmp_errors) errors.push_back(error);
+      return is_success;
+    }
+
+    static bool add_ident_or_get_key_ident(ResolverContext &context, AbsoluteIdentifier *ident, KeyIdentifier &key_ident, bool &is_added, const Position &pos, DiagnosticList &errors)
     {
       if(!context.tree.ident_table()->add_ident_or_get_key_ident(ident, key_ident, is_added)) {
         errors.push_back(Error(pos, "internal error: can't add identifier to identifier table or get key identifier from identifier table"));
@@ -202,7 +263,7 @@ namespace lesfl
       return true;
     }
 
-    static bool get_module_abs_ident(ResolverContext &context, const Identifier &ident, AbsoluteIdentifier &abs_ident, const Position &pos, list<Error> &errors)
+    static bool get_module_abs_ident(ResolverContext &context, const Identifier &ident, AbsoluteIdentifier &abs_ident, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(&ident,
       [&pos, &errors](const Identifier *ident) -> bool {
@@ -219,7 +280,7 @@ namespace lesfl
       });
     }
 
-    static bool add_root_module(ResolverContext &context, list<Error> &errors)
+    static bool add_root_module(ResolverContext &context, DiagnosticList &errors)
     {
       unique_ptr<AbsoluteIdentifier> abs_ident(new AbsoluteIdentifier());
       bool is_added_abs_ident;
@@ -230,7 +291,7 @@ namespace lesfl
       return true;
     }
 
-    static bool add_constr(ResolverContext &context, const shared_ptr<Constructor> &constr, AccessModifier access_modifier, bool has_datatype_fun, KeyIdentifier *datatype_key_ident, DatatypeFunctionInstance *datatype_fun_inst, list<Error> &errors, const string *datatype_ident = nullptr)
+    static bool add_constr(ResolverContext &context, const shared_ptr<Constructor> &constr, AccessModifier access_modifier, bool has_datatype_fun, KeyIdentifier *datatype_key_ident, DatatypeFunctionInstance *datatype_fun_inst, DiagnosticList &errors, const string *datatype_ident = nullptr)
     {
       unique_ptr<AbsoluteIdentifier> abs_ident(new AbsoluteIdentifier(context.current_module_ident, constr->ident()));
       bool is_added_abs_ident;
@@ -243,14 +304,14 @@ namespace lesfl
       constr->set_datatype_fun_inst(datatype_fun_inst);
       shared_ptr<Variable> constr_var(new DefinedConstructorVariable(constr));
       if(!context.tree.add_var(key_ident, access_modifier, constr_var, constr->access_modifier(), datatype_ident)) {
-        errors.push_back(Error(constr->pos(), "variable " + abs_ident->to_string() + " is already defined"));
+        errors.add(Diagnostic(DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED, constr->pos(), key_ident));
         is_success = false;
       }
       context.tree.uncompiled_var_key_idents().push_back(key_ident);
       return is_success;
     }
 
-    static bool add_constrs_from_datatype(ResolverContext &context, Datatype *datatype, AccessModifier access_modifier, bool has_datatype_fun, KeyIdentifier *datatype_key_ident, DatatypeFunctionInstance *datatype_fun_inst, const Position &pos, list<Error> &errors, const string *datatype_ident = nullptr)
+    static bool add_constrs_from_datatype(ResolverContext &context, Datatype *datatype, AccessModifier access_modifier, bool has_datatype_fun, KeyIdentifier *datatype_key_ident, DatatypeFunctionInstance *datatype_fun_inst, const Position &pos, DiagnosticList &errors, const string *datatype_ident = nullptr)
     {
       return dynamic_match(datatype,
       [&pos, &errors](Datatype *datatype) -> bool {
@@ -273,7 +334,7 @@ namespace lesfl
       });
     }
 
-    static bool add_constrs_from_type_var(ResolverContext &context, const shared_ptr<DefinableTypeVariable> &var, AccessModifier access_modifier, KeyIdentifier datatype_key_ident, const Position &pos, list<Error> &errors)
+    static bool add_constrs_from_type_var(ResolverContext &context, const shared_ptr<DefinableTypeVariable> &var, AccessModifier access_modifier, KeyIdentifier datatype_key_ident, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(var.get(),
       [&pos, &errors](TypeVariable *var) -> bool {
@@ -291,7 +352,7 @@ namespace lesfl
       });
     }
 
-    static bool add_constrs_from_type_fun(ResolverContext &context, const shared_ptr<DefinableTypeFunction> &fun, AccessModifier access_modifier, KeyIdentifier datatype_key_ident, const Position &pos, list<Error> &errors)
+    static bool add_constrs_from_type_fun(ResolverContext &context, const shared_ptr<DefinableTypeFunction> &fun, AccessModifier access_modifier, KeyIdentifier datatype_key_ident, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(fun.get(),
       [&pos, &errors](TypeFunction *fun) -> bool {
@@ -309,7 +370,7 @@ namespace lesfl
       });
     }
 
-    static bool add_constrs_from_type_fun_inst(ResolverContext &context, const shared_ptr<TypeFunctionInstance> &inst, const string *datatype_ident, const Position &pos, list<Error> &errors)
+    static bool add_constrs_from_type_fun_inst(ResolverContext &context, const shared_ptr<TypeFunctionInstance> &inst, const string *datatype_ident, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(inst.get(),
       [&pos, &errors](TypeFunctionInstance *fun) -> bool {
@@ -327,10 +388,11 @@ namespace lesfl
       });
     }
 
-    static bool add_defs(ResolverContext &context, const list<unique_ptr<Definition>> &defs, list<Error> &errors)
+    static bool add_defs(ResolverContext &context, const NodeList<Definition> &defs, DiagnosticList &errors)
     {
       bool is_success = true;
       for(auto &def : defs) {
+        if(errors.must_stop()) break;
         is_success &= dynamic_match(def.get(), 
         [&errors](Definition *def) -> bool {
           errors.push_back(Error(def->pos(), "interal error: unknown definition class"));
@@ -362,6 +424,7 @@ namespace lesfl
             }
           }
           module_def->ident()->set_key_ident(key_ident);
+          priv::TraceSpan span(context.trace, "add module", context.trace != nullptr ? abs_ident->to_string() : string());
           AbsoluteIdentifier saved_current_module = context.current_module_ident;
           context.current_module_ident = *abs_ident;
           bool tmp_is_success = add_defs(context, module_def->defs(), errors);
@@ -376,7 +439,7 @@ namespace lesfl
           if(is_added_abs_ident) abs_ident.release();
           bool tmp_is_success = true;
           if(!context.tree.add_var(key_ident, var_def->access_modifier(), var_def->var())) {
-            errors.push_back(Error(var_def->pos(), "variable " + abs_ident->to_string() + " is already defined"));
+            errors.add(Diagnostic(DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED, var_def->pos(), key_ident));
             tmp_is_success = false;
           }
           context.tree.uncompiled_var_key_idents().push_back(key_ident);
@@ -394,7 +457,7 @@ namespace lesfl
           bool tmp_is_success = true;
           shared_ptr<Variable> fun_var(new FunctionVariable(fun_def->fun()));
           if(!context.tree.add_var(key_ident, fun_def->access_modifier(), fun_var)) {
-            errors.push_back(Error(fun_def->pos(), "variable " + abs_ident->to_string() + " is already defined"));
+            errors.add(Diagnostic(DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED, fun_def->pos(), key_ident));
             tmp_is_success = false;
           }
           context.tree.uncompiled_var_key_idents().push_back(key_ident);
@@ -411,7 +474,7 @@ namespace lesfl
           if(is_added_abs_ident) abs_ident.release();
           bool tmp_is_success = true;
           if(!context.tree.add_type_var(key_ident, type_var_def->access_modifier(), type_var_def->var())) {
-            errors.push_back(Error(type_var_def->pos(), "type " + abs_ident->to_string() + " is already defined"));
+            errors.add(Diagnostic(DiagnosticCode::TYPE_IS_ALREADY_DEFINED, type_var_def->pos(), key_ident));
             tmp_is_success = false;
           }
           context.template_flag = false;
@@ -428,7 +491,7 @@ namespace lesfl
           if(is_added_abs_ident) abs_ident.release();
           bool tmp_is_success = true;
           if(!context.tree.add_type_fun(key_ident, type_fun_def->access_modifier(), type_fun_def->fun())) {
-            errors.push_back(Error(def->pos(), "type template " + abs_ident->to_string() + " is already defined"));
+            errors.add(Diagnostic(DiagnosticCode::TYPE_TEMPLATE_IS_ALREADY_DEFINED, def->pos(), key_ident));
             tmp_is_success = false;
           }
           context.template_flag = true;
@@ -444,39 +507,79 @@ namespace lesfl
       return is_success;
     }
 
-    static bool get_non_alias_var(ResolverContext &context, const Identifier &ident, shared_ptr<Variable> &var, const Position &pos, list<Error> &errors)
+    static void resolve_alias_target(ResolverContext &context, KeyIdentifier key_ident)
     {
-      unordered_set<KeyIdentifier> marked_key_idents;
-      KeyIdentifier key_ident = ident.key_ident();
-      var = context.tree.var(ident);
-      marked_key_idents.insert(key_ident);
+      vector<VariableInfo *> path_var_infos;
+      AliasTargetState state = AliasTargetState::RESOLVED;
+      shared_ptr<Variable> non_alias_var;
       while(true) {
-        if(var.get() == nullptr) {
-          errors.push_back(Error(pos, "internal error: variable isn't found"));
-          return false;
+        VariableInfo *var_info = context.tree.var_info(key_ident);
+        if(var_info == nullptr || var_info->var().get() == nullptr) break;
+        if(var_info->alias_target_state() == AliasTargetState::RESOLVING) {
+          state = AliasTargetState::CYCLE;
+          break;
         }
-        AliasVariable *alias_var = dynamic_cast<AliasVariable *>(var.get());
-        if(alias_var == nullptr) break;
-        if(alias_var->is_template() && !alias_var->inst_type_params().empty()) break;
-        if(alias_var->ident()->has_key_ident()) {
-          key_ident = alias_var->ident()->key_ident();
-          if(marked_key_idents.find(key_ident) != marked_key_idents.end()) {
-            errors.push_back(Error(pos, "alias variable " + ident.to_abs_ident_string(*(context.tree.ident_table())) + " refers to alias cycle"));
-            var.reset();
-            return false;
-          }
-          var = context.tree.var(*(alias_var->ident()));
-          marked_key_idents.insert(key_ident);
-        } else {
-          errors.push_back(Error(pos, "alias variable " + ident.to_abs_ident_string(*(context.tree.ident_table())) + " refers to undefined variable"));
+        if(var_info->alias_target_state() != AliasTargetState::UNRESOLVED) {
+          state = var_info->alias_target_state();
+          non_alias_var = var_info->non_alias_var();
+          break;
+        }
+        AliasVariable *alias_var = dynamic_cast<AliasVariable *>(var_info->var().get());
+        if(alias_var == nullptr || (alias_var->is_template() && !alias_var->inst_type_params().empty())) {
+          non_alias_var = var_info->var();
+          var_info->set_non_alias_var(non_alias_var);
+          break;
+        }
+        var_info->set_alias_target_state(AliasTargetState::RESOLVING);
+        path_var_infos.push_back(var_info);
+        if(!alias_var->ident()->has_key_ident()) {
+          state = AliasTargetState::UNDEFINED;
+          break;
+        }
+        key_ident = alias_var->ident()->key_ident();
+      }
+      for(auto var_info : path_var_infos) {
+        if(state == AliasTargetState::RESOLVED)
+          var_info->set_non_alias_var(non_alias_var);
+        else
+          var_info->set_alias_target_state(state);
+      }
+    }
+
+    static void resolve_alias_targets(ResolverContext &context)
+    {
+      for(auto &pair : context.tree.var_infos()) {
+        if(pair.second.alias_target_state() == AliasTargetState::UNRESOLVED)
+          resolve_alias_target(context, pair.first);
+      }
+    }
+
+    static bool get_non_alias_var(ResolverContext &context, const Identifier &ident, shared_ptr<Variable> &var, const Position &pos, DiagnosticList &errors)
+    {
+      VariableInfo *var_info = context.tree.var_info(ident);
+      if(var_info != nullptr && var_info->alias_target_state() == AliasTargetState::UNRESOLVED)
+        resolve_alias_target(context, ident.key_ident());
+      AliasTargetState state = (var_info != nullptr ? var_info->alias_target_state() : AliasTargetState::RESOLVED);
+      switch(state) {
+        case AliasTargetState::UNDEFINED:
+          errors.add(Diagnostic(DiagnosticCode::ALIAS_REFERS_TO_UNDEFINED_VARIABLE, pos, ident.key_ident()));
           var.reset();
           return false;
-        }
+        case AliasTargetState::CYCLE:
+          errors.add(Diagnostic(DiagnosticCode::ALIAS_REFERS_TO_ALIAS_CYCLE, pos, ident.key_ident()));
+          var.reset();
+          return false;
+        default:
+          var = (var_info != nullptr ? var_info->non_alias_var() : shared_ptr<Variable>());
+          if(var.get() == nullptr) {
+            errors.push_back(Error(pos, "internal error: variable isn't found"));
+            return false;
+          }
+          return true;
       }
-      return true;
     }
 
-    static bool set_key_ident(ResolverContext &context, AbsoluteIdentifier &ident, function<bool (const AbsoluteIdentifier &, AccessModifier &, bool &)> get_access_modifier_fun, function<void (const AbsoluteIdentifier &)> *add_private_error_fun = nullptr, function<void ()> *add_undefined_error_fun = nullptr)
+    static bool set_key_ident(ResolverContext &context, AbsoluteIdentifier &ident, function<bool (const AbsoluteIdentifier &, AccessModifier &, bool &)> get_access_modifier_fun, function<void (KeyIdentifier)> *add_private_error_fun = nullptr, function<void ()> *add_undefined_error_fun = nullptr)
     {
       if(!ident.set_key_ident(*(context.tree.ident_table()))) {
         if(add_undefined_error_fun != nullptr) (*add_undefined_error_fun)();
@@ -495,7 +598,7 @@ namespace lesfl
         if(!has_tmp_module_ident || tmp_module_ident != context.current_module_ident) {
           if(access_modifier == AccessModifier::PRIVATE) {
             ident.unset_key_ident();
-            if(add_private_error_fun != nullptr) (*add_private_error_fun)(ident);
+            if(add_private_error_fun != nullptr) (*add_private_error_fun)(ident.key_ident());
             return false;
           }
         }
@@ -503,7 +606,7 @@ namespace lesfl
       return true;
     }
 
-    static bool set_key_ident(ResolverContext &context, RelativeIdentifier &ident, const AbsoluteIdentifier &module_ident, function<bool (const AbsoluteIdentifier &, AccessModifier &, bool &)> get_access_modifier_fun, bool *is_private = nullptr, function<void (const AbsoluteIdentifier &)> *add_private_error_fun = nullptr)
+    static bool set_key_ident(ResolverContext &context, RelativeIdentifier &ident, const AbsoluteIdentifier &module_ident, function<bool (const AbsoluteIdentifier &, AccessModifier &, bool &)> get_access_modifier_fun, bool *is_private = nullptr, function<void (KeyIdentifier)> *add_private_error_fun = nullptr)
     {
       AbsoluteIdentifier abs_ident(module_ident.idents(), ident);
       if(!abs_ident.set_key_ident(*(context.tree.ident_table()))) {
@@ -523,7 +626,7 @@ namespace lesfl
         if(!has_tmp_module_ident || tmp_module_ident != context.current_module_ident) {
           if(access_modifier == AccessModifier::PRIVATE) {
             abs_ident.unset_key_ident();
-            if(add_private_error_fun != nullptr) (*add_private_error_fun)(abs_ident);
+            if(add_private_error_fun != nullptr) (*add_private_error_fun)(abs_ident.key_ident());
             if(is_private != nullptr) *is_private = true;
             return false;
           }
@@ -533,7 +636,7 @@ namespace lesfl
       return true;
     }
 
-    static bool resolve_ident(ResolverContext &context, Identifier *ident, const Position &pos, list<Error> &errors, function<bool (const AbsoluteIdentifier &, AccessModifier &, bool &)> get_access_modifier_fun, function<void (const AbsoluteIdentifier &)> add_private_error_fun, function<void ()> add_undefined_error_fun, bool are_local_vars = true)
+    static bool resolve_ident(ResolverContext &context, Identifier *ident, const Position &pos, DiagnosticList &errors, function<bool (const AbsoluteIdentifier &, AccessModifier &, bool &)> get_access_modifier_fun, function<void (KeyIdentifier)> add_private_error_fun, function<void ()> add_undefined_error_fun, bool are_local_vars = true)
     {
       return dynamic_match(ident,
       [&](Identifier *ident) -> bool {
@@ -568,24 +671,43 @@ namespace lesfl
       });
     }
 
-    static bool resolve_module_ident(ResolverContext &context, Identifier *ident, const Position &pos, list<Error> &errors, bool can_add_error = true)
+    static inline void add_ref(ResolverContext &context, const Identifier *ident, const Position &pos)
     {
-      return resolve_ident(context, ident, pos, errors,
+      if(context.current_def == nullptr || !ident->has_key_ident()) return;
+      if(context.has_current_def_key_ident)
+        context.refs.push_back(make_pair(ident->key_ident(), Reference(context.current_def, context.current_def_key_ident, pos)));
+      else
+        context.refs.push_back(make_pair(ident->key_ident(), Reference(context.current_def, pos)));
+    }
+
+    static void add_undefined_error(ResolverContext &context, DiagnosticCode code, const Identifier *ident, const Position &pos, DiagnosticList &errors, bool is_tree_ident)
+    {
+      if(is_tree_ident)
+        errors.add(Diagnostic(code, pos, ident));
+      else
+        errors.push_back(Diagnostic(code, pos, ident).to_error(*(context.tree.ident_table())));
+    }
+
+    static bool resolve_module_ident(ResolverContext &context, Identifier *ident, const Position &pos, DiagnosticList &errors, bool can_add_error = true)
+    {
+      bool is_success = resolve_ident(context, ident, pos, errors,
       [&context](const AbsoluteIdentifier &abs_ident, AccessModifier &access_modifier, bool &is_added_module) {
         is_added_module = context.tree.has_module_key_ident(abs_ident);
         return false;
       },
-      [&pos, &errors, &can_add_error](const AbsoluteIdentifier &abs_ident) {
-        if(can_add_error) errors.push_back(Error(pos, "module " + abs_ident.to_string() + " is private"));
+      [&pos, &errors, &can_add_error](KeyIdentifier key_ident) {
+        if(can_add_error) errors.add(Diagnostic(DiagnosticCode::MODULE_IS_PRIVATE, pos, key_ident));
       },
-      [&ident, &pos, &errors, &can_add_error]() {
-        if(can_add_error) errors.push_back(Error(pos, "module " + ident->to_string() + " is undefined"));
+      [&context, &ident, &pos, &errors, &can_add_error]() {
+        if(can_add_error) add_undefined_error(context, DiagnosticCode::MODULE_IS_UNDEFINED, ident, pos, errors, true);
       }, false);
+      if(is_success) add_ref(context, ident, pos);
+      return is_success;
     }
 
-    static bool resolve_var_ident(ResolverContext &context, Identifier *ident, const Position &pos, list<Error> &errors)
+    static bool resolve_var_ident(ResolverContext &context, Identifier *ident, const Position &pos, DiagnosticList &errors, bool is_tree_ident = true)
     {
-      return resolve_ident(context, ident, pos, errors,
+      bool is_success = resolve_ident(context, ident, pos, errors,
       [&context](const AbsoluteIdentifier &abs_ident, AccessModifier &access_modifier, bool &is_added_var) {
         VariableInfo *info = context.tree.var_info(abs_ident);
         is_added_var = (info != nullptr);
@@ -610,59 +732,83 @@ namespace lesfl
         if(is_added_var) access_modifier = info->access_modifier();
         return is_added_var;
       },
-      [&pos, &errors](const AbsoluteIdentifier &abs_ident) {
-        errors.push_back(Error(pos, "variable " + abs_ident.to_string() + " is private"));
+      [&pos, &errors](KeyIdentifier key_ident) {
+        errors.add(Diagnostic(DiagnosticCode::VARIABLE_IS_PRIVATE, pos, key_ident));
       },
-      [&ident, &pos, &errors]() {
-        errors.push_back(Error(pos, "variable " + ident->to_string() + " is undefined"));
+      [&context, &ident, &pos, &errors, is_tree_ident]() {
+        add_undefined_error(context, DiagnosticCode::VARIABLE_IS_UNDEFINED, ident, pos, errors, is_tree_ident);
       });
+      if(is_success && is_tree_ident) add_ref(context, ident, pos);
+      return is_success;
     }
 
-    static bool resolve_type_var_ident(ResolverContext &context, Identifier *ident, const Position &pos, list<Error> &errors)
+    static bool resolve_type_var_ident(ResolverContext &context, Identifier *ident, const Position &pos, DiagnosticList &errors)
     {
-      return resolve_ident(context, ident, pos, errors,
+      bool is_success = resolve_ident(context, ident, pos, errors,
       [&context](const AbsoluteIdentifier &abs_ident, AccessModifier &access_modifier, bool &is_added_type_var) {
         TypeVariableInfo *info = context.tree.type_var_info(abs_ident);
         is_added_type_var = (info != nullptr);
         if(is_added_type_var) access_modifier = info->access_modifier();
         return is_added_type_var;
       },
-      [&pos, &errors](const AbsoluteIdentifier &abs_ident) {
-        errors.push_back(Error(pos, "type " + abs_ident.to_string() + " is private"));
+      [&pos, &errors](KeyIdentifier key_ident) {
+        errors.add(Diagnostic(DiagnosticCode::TYPE_IS_PRIVATE, pos, key_ident));
       },
-      [&ident, &pos, &errors]() {
-        errors.push_back(Error(pos, "type " + ident->to_string() +" is undefined"));
+      [&context, &ident, &pos, &errors]() {
+        add_undefined_error(context, DiagnosticCode::TYPE_IS_UNDEFINED, ident, pos, errors, true);
       }, false);
+      if(is_success) add_ref(context, ident, pos);
+      return is_success;
     }
 
-    static bool resolve_type_fun_ident(ResolverContext &context, Identifier *ident, const Position &pos, list<Error> &errors)
+    static bool resolve_type_fun_ident(ResolverContext &context, Identifier *ident, const Position &pos, DiagnosticList &errors, bool is_tree_ident = true)
     {
-      return resolve_ident(context, ident, pos, errors,
+      bool is_success = resolve_ident(context, ident, pos, errors,
       [&context](const AbsoluteIdentifier &abs_ident, AccessModifier &access_modifier, bool &is_added_type_fun) {
         TypeFunctionInfo *info = context.tree.type_fun_info(abs_ident);
         is_added_type_fun = (info != nullptr);
         if(is_added_type_fun) access_modifier = info->access_modifier();
         return is_added_type_fun;
       },
-      [&pos, &errors](const AbsoluteIdentifier &abs_ident) {
-        errors.push_back(Error(pos, "type template " + abs_ident.to_string() + " is private"));
+      [&pos, &errors](KeyIdentifier key_ident) {
+        errors.add(Diagnostic(DiagnosticCode::TYPE_TEMPLATE_IS_PRIVATE, pos, key_ident));
       },
-      [&ident, &pos, &errors]() {
-        errors.push_back(Error(pos, "type template " + ident->to_string() + " is undefined"));
+      [&context, &ident, &pos, &errors, is_tree_ident]() {
+        add_undefined_error(context, DiagnosticCode::TYPE_TEMPLATE_IS_UNDEFINED, ident, pos, errors, is_tree_ident);
       }, false);
+      if(is_success && is_tree_ident) add_ref(context, ident, pos);
+      return is_success;
     }
 
-    static bool resolve_idents_from_expr(ResolverContext &context, Expression *expr, list<Error> &errors);
+    static bool resolve_idents_from_args(ResolverContext &context, const NodeList<Argument> &args, DiagnosticList &errors, bool can_add_param_types = false);
 
-    static bool resolve_idents_from_pattern(ResolverContext &context, Pattern *pattern, list<Error> &errors);
+    // The functions which resolve identifiers from nodes don't recurse. They
+    // push tasks for children onto the task stack in reverse order so that
+    // children are resolved in order of the children. Very deep expressions
+    // such as long chains of binary operators therefore don't overflow the
+    // call stack.
 
-    static bool resolve_idents_from_value(ResolverContext &context, Value *value, list<Error> &errors);
+    static inline void push_task(ResolverContext &context, const ResolverTask &task)
+    { context.tasks.push_back(task); }
 
-    static bool resolve_idents_from_type_expr(ResolverContext &context, TypeExpression *expr, list<Error> &errors, bool can_add_param_types = false);
+    template<typename _T>
+    static inline void push_tasks(ResolverContext &context, const NodeList<_T> &nodes)
+    {
+      for(auto iter = nodes.end(); iter != nodes.begin();) {
+        --iter;
+        context.tasks.push_back(ResolverTask(iter->get()));
+      }
+    }
 
-    static bool resolve_idents_from_args(ResolverContext &context, const list<unique_ptr<Argument>> &args, list<Error> &errors, bool can_add_param_types = false);
+    static inline void push_type_expr_tasks(ResolverContext &context, const NodeList<TypeExpression> &exprs, bool can_add_type_params)
+    {
+      for(auto iter = exprs.end(); iter != exprs.begin();) {
+        --iter;
+        context.tasks.push_back(ResolverTask(iter->get(), can_add_type_params));
+      }
+    }
 
-    static bool resolve_idents_from_literal_value(ResolverContext &context, LiteralValue *value, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_literal_value(ResolverContext &context, LiteralValue *value, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(value,
       [&pos, &errors](LiteralValue *value) -> bool {
@@ -674,20 +820,26 @@ namespace lesfl
       },
       [&](LambdaValue *value) -> bool {
         NonUniqueLambdaValue *non_unique_lambda_value = dynamic_cast<NonUniqueLambdaValue *>(value);
-        if(non_unique_lambda_value != nullptr && non_unique_lambda_value->fun_modifier() == FunctionModifier::PRIMITIVE)
-          push_closure_limit(context, context.local_var_count);
-        bool is_success = resolve_idents_from_args(context, value->args(), errors);
+        bool is_primitive = (non_unique_lambda_value != nullptr && non_unique_lambda_value->fun_modifier() == FunctionModifier::PRIMITIVE);
+        if(is_primitive) push_closure_limit(context, context.local_var_count);
+        push_local_var_vector(context);
+        push_task(context, ResolverTask(ResolverTaskKind::POP_LOCAL_VARS));
+        if(is_primitive) push_task(context, ResolverTask(ResolverTaskKind::POP_CLOSURE_LIMIT));
+        push_task(context, ResolverTask(value));
         if(value->result_type_expr() != nullptr)
-          is_success &= resolve_idents_from_type_expr(context, value->result_type_expr(), errors);
-        is_success &= resolve_idents_from_expr(context, value->body(), errors);
-        if(non_unique_lambda_value != nullptr && non_unique_lambda_value->fun_modifier() == FunctionModifier::PRIMITIVE)
-          pop_closure_limit(context);
-        pop_local_vars(context);
-        return is_success;
+          push_task(context, ResolverTask(value->result_type_expr(), false));
+        push_task(context, ResolverTask(ResolverTaskKind::CLEAR_TOP_LOCAL_VAR_IDENTS));
+        for(auto iter = value->args().end(); iter != value->args().begin();) {
+          --iter;
+          if((*iter)->type_expr() != nullptr)
+            push_task(context, ResolverTask((*iter)->type_expr(), false));
+          push_task(context, ResolverTask(iter->get()));
+        }
+        return true;
       });
     }
 
-    static bool resolve_idents_from_expr_named_field_pairs(ResolverContext &context, const list<unique_ptr<ExpressionNamedFieldPair>> &pairs, const unordered_map<string, size_t> &indices, function<string ()> *constr_abs_ident_string_fun, list<Error> &errors)
+    static bool resolve_idents_from_expr_named_field_pairs(ResolverContext &context, const NodeList<ExpressionNamedFieldPair> &pairs, const unordered_map<string, size_t> &indices, function<string ()> *constr_abs_ident_string_fun, DiagnosticList &errors)
     {
       bool is_success = true;
       set<size_t> used_indices;
@@ -707,12 +859,15 @@ namespace lesfl
             errors.push_back(Error(pair->pos(), "field " + pair->to_ident_string() + " is undefined at constructor " + (*constr_abs_ident_string_fun)()));
           is_success = false;
         }
-        is_success &= resolve_idents_from_expr(context, pair->expr(), errors);
+      }
+      for(auto iter = pairs.end(); iter != pairs.begin();) {
+        --iter;
+        push_task(context, ResolverTask((*iter)->expr()));
       }
       return is_success;
     }
 
-    static bool resolve_idents_from_binds(ResolverContext &context, const list<unique_ptr<Binding>> &binds, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_binds(ResolverContext &context, const NodeList<Binding> &binds, const Position &pos, DiagnosticList &errors)
     {
       bool is_success = true;
       unordered_set<KeyIdentifier> used_key_idents;
@@ -745,23 +900,21 @@ namespace lesfl
         });
       }
       clear_top_local_var_idents(context);
-      for(auto &bind : binds) {
-        is_success &= dynamic_match(bind.get(),
-        [&](Binding *bind) -> bool {
-          errors.push_back(Error(pos, "internal error: unknown binding class"));
-          return false;
-        },
-        [&](VariableBinding *bind) -> bool {
-          return resolve_idents_from_expr(context, bind->expr(), errors);
+      for(auto iter = binds.end(); iter != binds.begin();) {
+        --iter;
+        dynamic_match(iter->get(),
+        [&](Binding *bind) {},
+        [&](VariableBinding *bind) {
+          push_task(context, ResolverTask(bind->expr()));
         },
-        [&](TupleBinding *bind) -> bool {
-          return resolve_idents_from_expr(context, bind->expr(), errors);
+        [&](TupleBinding *bind) {
+          push_task(context, ResolverTask(bind->expr()));
         });
       }
       return is_success;
     }
 
-    static bool resolve_idents_from_expr(ResolverContext &context, Expression *expr, list<Error> &errors)
+    static bool resolve_idents_from_expr_node(ResolverContext &context, Expression *expr, DiagnosticList &errors)
     {
       return dynamic_match(expr,
       [&errors](Expression *expr) -> bool {
@@ -772,18 +925,12 @@ namespace lesfl
         return resolve_idents_from_literal_value(context, literal->literal_value(), literal->pos(), errors);
       },
       [&](Collection *collection) -> bool {
-        bool is_success = true;
-        for(auto &elem : collection->elems()) {
-          is_success &= resolve_idents_from_expr(context, elem.get(), errors);
-        }
-        return is_success;
+        push_tasks(context, collection->elems());
+        return true;
       },
       [&](Tuple *tuple) -> bool {
-        bool is_success = true;
-        for(auto &field : tuple->fields()) {
-          is_success &= resolve_idents_from_expr(context, field.get(), errors);
-        }
-        return is_success;
+        push_tasks(context, tuple->fields());
+        return true;
       },
       [&](VariableExpression *var_expr) -> bool {
         return resolve_var_ident(context, var_expr->ident(), var_expr->pos(), errors);
@@ -833,69 +980,55 @@ namespace lesfl
         return is_success;
       },
       [&](Application *app) -> bool {
-        bool is_success = resolve_idents_from_expr(context, app->fun(), errors);
-        for(auto &arg : app->args()) {
-          is_success &= resolve_idents_from_expr(context, arg.get(), errors);
-        }
-        return is_success;
+        push_tasks(context, app->args());
+        push_task(context, ResolverTask(app->fun()));
+        return true;
       },
       [&](BuiltinApplication *app) -> bool {
-        bool is_success = true;
-        for(auto &arg : app->args()) {
-          is_success &= resolve_idents_from_expr(context, arg.get(), errors);
-        }
-        return is_success;
-      },
-      [&](Field *field) -> bool {
-        return resolve_idents_from_expr(context, field->expr(), errors);
-      },
-      [&](UniqueField *field) -> bool {
-        return resolve_idents_from_expr(context, field->expr(), errors);
-      },
-      [&](SetUniqueField *set_field) -> bool {
-        bool is_success = resolve_idents_from_expr(context, set_field->expr(), errors);
-        is_success &= resolve_idents_from_expr(context, set_field->value_expr(), errors);
-        return is_success;
-      },
-      [&](NamedField *field) -> bool {
-        return resolve_idents_from_expr(context, field->expr(), errors);
+        push_tasks(context, app->args());
+        return true;
       },
-      [&](UniqueNamedField *field) -> bool {
-        return resolve_idents_from_expr(context, field->expr(), errors);
+      [&](FieldOperator *field) -> bool {
+        SetUniqueField *set_field = dynamic_cast<SetUniqueField *>(field);
+        if(set_field != nullptr) push_task(context, ResolverTask(set_field->value_expr()));
+        push_task(context, ResolverTask(field->expr()));
+        return true;
       },
-      [&](SetUniqueNamedField *set_field) -> bool {
-        bool is_success = resolve_idents_from_expr(context, set_field->expr(), errors);
-        is_success &= resolve_idents_from_expr(context, set_field->value_expr(), errors);
-        return is_success;
+      [&](NamedFieldOperator *field) -> bool {
+        SetUniqueNamedField *set_field = dynamic_cast<SetUniqueNamedField *>(field);
+        if(set_field != nullptr) push_task(context, ResolverTask(set_field->value_expr()));
+        push_task(context, ResolverTask(field->expr()));
+        return true;
       },
       [&](TypedExpression *typed_expr) -> bool {
-        bool is_success = resolve_idents_from_expr(context, typed_expr->expr(), errors);
-        is_success &= resolve_idents_from_type_expr(context, typed_expr->type_expr(), errors);
-        return is_success;
+        push_task(context, ResolverTask(typed_expr->type_expr(), false));
+        push_task(context, ResolverTask(typed_expr->expr()));
+        return true;
       },
       [&](Let *let) -> bool {
-        bool is_success = resolve_idents_from_binds(context, let->binds(), let->pos(), errors);
-        is_success &= resolve_idents_from_expr(context, let->expr(), errors);
-        pop_local_vars(context);
-        return is_success;
+        push_task(context, ResolverTask(ResolverTaskKind::POP_LOCAL_VARS));
+        push_task(context, ResolverTask(let->expr()));
+        return resolve_idents_from_binds(context, let->binds(), let->pos(), errors);
       },
       [&](Match *match) -> bool {
-        bool is_success = resolve_idents_from_expr(context, match->expr(), errors);
-        for(auto &caze : match->cases()) {
-          push_local_var_vector(context);
-          is_success &= resolve_idents_from_pattern(context, caze->pattern(), errors);
-          clear_top_local_var_idents(context);
-          is_success &= resolve_idents_from_expr(context, caze->expr(), errors);
-          pop_local_vars(context);
+        for(auto iter = match->cases().end(); iter != match->cases().begin();) {
+          --iter;
+          push_task(context, ResolverTask(ResolverTaskKind::POP_LOCAL_VARS));
+          push_task(context, ResolverTask((*iter)->expr()));
+          push_task(context, ResolverTask(ResolverTaskKind::CLEAR_TOP_LOCAL_VAR_IDENTS));
+          push_task(context, ResolverTask((*iter)->pattern()));
+          push_task(context, ResolverTask(ResolverTaskKind::PUSH_LOCAL_VAR_VECTOR));
         }
-        return is_success;
+        push_task(context, ResolverTask(match->expr()));
+        return true;
       },
       [&](Throw *throv) {
-        return resolve_idents_from_expr(context, throv->expr(), errors);
+        push_task(context, ResolverTask(throv->expr()));
+        return true;
       });
     }
 
-    static bool resolve_idents_from_pattern_named_field_pairs(ResolverContext &context, const list<unique_ptr<PatternNamedFieldPair>> &pairs, const unordered_map<string, size_t> &indices, function<string ()> *constr_abs_ident_string_fun, list<Error> &errors)
+    static bool resolve_idents_from_pattern_named_field_pairs(ResolverContext &context, const NodeList<PatternNamedFieldPair> &pairs, const unordered_map<string, size_t> &indices, function<string ()> *constr_abs_ident_string_fun, DiagnosticList &errors)
     {
       bool is_success = true;
       set<size_t> used_indices;
@@ -915,12 +1048,15 @@ namespace lesfl
             errors.push_back(Error(pair->pos(), "field " + pair->to_ident_string() + " is undefined at constructor " + (*constr_abs_ident_string_fun)()));
           is_success = false;
         }
-        is_success &= resolve_idents_from_pattern(context, pair->pattern(), errors);
+      }
+      for(auto iter = pairs.end(); iter != pairs.begin();) {
+        --iter;
+        push_task(context, ResolverTask((*iter)->pattern()));
       }
       return is_success;
     }
 
-    static bool resolve_idents_from_pattern(ResolverContext &context, Pattern *pattern, list<Error> &errors)
+    static bool resolve_idents_from_pattern_node(ResolverContext &context, Pattern *pattern, DiagnosticList &errors)
     {
       return dynamic_match(pattern,
       [&errors](Pattern *pattern) -> bool {
@@ -988,9 +1124,7 @@ namespace lesfl
           });
         } else 
           is_success = false;
-        for(auto &field_pattern : pattern->field_patterns()) {
-          is_success &= resolve_idents_from_pattern(context, field_pattern.get(), errors);
-        }
+        push_tasks(context, pattern->field_patterns());
         return is_success;
       },
       [&](NamedFieldConstructorPattern *pattern) -> bool {
@@ -1038,18 +1172,12 @@ namespace lesfl
         return is_success;
       },
       [&](CollectionPattern *pattern) -> bool {
-        bool is_success = true;
-        for(auto &elem_pattern : pattern->elem_patterns()) {
-          is_success &= resolve_idents_from_pattern(context, elem_pattern.get(), errors);
-        }
-        return is_success;
+        push_tasks(context, pattern->elem_patterns());
+        return true;
       },
       [&](TuplePattern *pattern) -> bool {
-        bool is_success = true;
-        for(auto &field_pattern : pattern->field_patterns()) {
-          is_success &= resolve_idents_from_pattern(context, field_pattern.get(), errors);
-        }
-        return is_success;
+        push_tasks(context, pattern->field_patterns());
+        return true;
       },
       [](LiteralPattern *pattern) -> bool {
         return true;
@@ -1068,20 +1196,20 @@ namespace lesfl
           errors.push_back(Error(pattern->pos(), "variable " + pattern->to_ident_string() + " is already defined"));
           is_success = false;
         }
-        is_success &= resolve_idents_from_pattern(context, pattern->pattern(), errors);
+        push_task(context, ResolverTask(pattern->pattern()));
         return is_success;
       },
       [](WildcardPattern *pattern) -> bool {
         return true;
       },
       [&](TypedPattern *pattern) -> bool {
-        bool is_success = resolve_idents_from_pattern(context, pattern->pattern(), errors);
-        is_success &= resolve_idents_from_type_expr(context, pattern->type_expr(), errors);
-        return is_success;
+        push_task(context, ResolverTask(pattern->type_expr(), false));
+        push_task(context, ResolverTask(pattern->pattern()));
+        return true;
       });
     }
 
-    static bool resolve_idents_from_value_named_field_pairs(ResolverContext &context, const list<unique_ptr<ValueNamedFieldPair>> &pairs, const unordered_map<string, size_t> &indices, function<string ()> *constr_abs_ident_string_fun, list<Error> &errors)
+    static bool resolve_idents_from_value_named_field_pairs(ResolverContext &context, const NodeList<ValueNamedFieldPair> &pairs, const unordered_map<string, size_t> &indices, function<string ()> *constr_abs_ident_string_fun, DiagnosticList &errors)
     {
       bool is_success = true;
       set<size_t> used_indices;
@@ -1101,12 +1229,15 @@ namespace lesfl
             errors.push_back(Error(pair->pos(), "field " + pair->to_ident_string() + " is undefined at constructor " + (*constr_abs_ident_string_fun)()));
           is_success = false;
         }
-        is_success &= resolve_idents_from_value(context, pair->value(), errors);
+      }
+      for(auto iter = pairs.end(); iter != pairs.begin();) {
+        --iter;
+        push_task(context, ResolverTask((*iter)->value()));
       }
       return is_success;
     }
 
-    static bool resolve_idents_from_value(ResolverContext &context, Value *value, list<Error> &errors)
+    static bool resolve_idents_from_value_node(ResolverContext &context, Value *value, DiagnosticList &errors)
     {
       return dynamic_match(value,
       [&errors](Value *value) -> bool {
@@ -1120,18 +1251,17 @@ namespace lesfl
         return is_success;
       },
       [&](CollectionValue *value) -> bool {
-        bool is_success = true;
-        for(auto &elem : value->elems()) {
-          is_success &= resolve_idents_from_value(context, elem.get(), errors);
-        }
+        push_tasks(context, value->elems());
+        return true;
+      },
+      [&](PackedCollectionValue *value) -> bool {
+        bool is_success = check_and_clear_local_var_ident_stack(context, value->pos(), errors);
+        is_success &= check_and_clear_closure_limit_stack(context, value->pos(), errors);
         return is_success;
       },
       [&](TupleValue *value) -> bool {
-        bool is_success = true;
-        for(auto &field : value->fields()) {
-          is_success &= resolve_idents_from_value(context, field.get(), errors);
-        }
-        return is_success;
+        push_tasks(context, value->fields());
+        return true;
       },
       [&](VariableConstructorValue *value) -> bool {
         bool is_success = resolve_var_ident(context, value->constr_ident(), value->pos(), errors);
@@ -1193,9 +1323,7 @@ namespace lesfl
           });
         } else
           is_success = false;
-        for(auto &field_value : value->fields()) {
-          is_success &= resolve_idents_from_value(context, field_value.get(), errors);
-        }
+        push_tasks(context, value->fields());
         return is_success;
       },
       [&](NamedFieldConstructorValue *value) -> bool {
@@ -1243,13 +1371,13 @@ namespace lesfl
         return is_success;
       },
       [&](TypedValue *typed_value) -> bool {
-        bool is_success = resolve_idents_from_value(context, typed_value->value(), errors);
-        is_success &= resolve_idents_from_type_expr(context, typed_value->type_expr(), errors);
-        return is_success;
+        push_task(context, ResolverTask(typed_value->type_expr(), false));
+        push_task(context, ResolverTask(typed_value->value()));
+        return true;
       });
     }
 
-    static bool resolve_idents_from_type_expr(ResolverContext &context, TypeExpression *expr, list<Error> &errors, bool can_add_type_params)
+    static bool resolve_idents_from_type_expr_node(ResolverContext &context, TypeExpression *expr, DiagnosticList &errors, bool can_add_type_params)
     {
       return dynamic_match(expr,
       [&errors](TypeExpression *expr) -> bool {
@@ -1257,10 +1385,9 @@ namespace lesfl
         return false;
       },
       [&](With *with) -> bool {
-        bool is_success = true;
-        is_success &= resolve_idents_from_type_expr(context, with->type1(), errors, can_add_type_params);
-        is_success &= resolve_idents_from_type_expr(context, with->type2(), errors, can_add_type_params);
-        return is_success;
+        push_task(context, ResolverTask(with->type2(), can_add_type_params));
+        push_task(context, ResolverTask(with->type1(), can_add_type_params));
+        return true;
       },
       [&](TypeVariableExpression *type_var_expr) -> bool {
         return resolve_type_var_ident(context, type_var_expr->ident(), type_var_expr->pos(), errors);
@@ -1285,30 +1412,91 @@ namespace lesfl
         }
       },
       [&](TupleType *tuple_type) -> bool {
-        bool is_success = true;
-        for(auto &field_type : tuple_type->field_types()) {
-          is_success &=  resolve_idents_from_type_expr(context, field_type.get(), errors, can_add_type_params);
-        }
-        return is_success;
+        push_type_expr_tasks(context, tuple_type->field_types(), can_add_type_params);
+        return true;
       },
       [&](FunctionType *fun_type) -> bool {
-        bool is_success = true;
-        for(auto &arg_type : fun_type->arg_types()) {
-          is_success &=  resolve_idents_from_type_expr(context, arg_type.get(), errors, can_add_type_params);
-        }
-        is_success &= resolve_idents_from_type_expr(context, fun_type->result_type(), errors, can_add_type_params);
-        return is_success;
+        push_task(context, ResolverTask(fun_type->result_type(), can_add_type_params));
+        push_type_expr_tasks(context, fun_type->arg_types(), can_add_type_params);
+        return true;
       },
       [&](TypeApplication *type_app) -> bool {
         bool is_success = resolve_type_fun_ident(context, type_app->fun_ident(), type_app->pos(), errors);
-        for(auto &arg : type_app->args()) {
-          is_success &=  resolve_idents_from_type_expr(context, arg.get(), errors, can_add_type_params);
-        }
+        push_type_expr_tasks(context, type_app->args(), can_add_type_params);
         return is_success;
       });
     }
 
-    static bool resolve_idents_from_args(ResolverContext &context, const list<unique_ptr<Argument>> &args, list<Error> &errors, bool can_add_type_params)
+    static bool resolve_idents_from_tasks(ResolverContext &context, size_t task_count, DiagnosticList &errors)
+    {
+      bool is_success = true;
+      while(context.tasks.size() > task_count) {
+        ResolverTask task = context.tasks.back();
+        context.tasks.pop_back();
+        switch(task.kind) {
+          case ResolverTaskKind::EXPR:
+            is_success &= resolve_idents_from_expr_node(context, task.expr, errors);
+            break;
+          case ResolverTaskKind::PATTERN:
+            is_success &= resolve_idents_from_pattern_node(context, task.pattern, errors);
+            break;
+          case ResolverTaskKind::VALUE:
+            is_success &= resolve_idents_from_value_node(context, task.value, errors);
+            break;
+          case ResolverTaskKind::TYPE_EXPR:
+            is_success &= resolve_idents_from_type_expr_node(context, task.type_expr, errors, task.can_add_type_params);
+            break;
+          case ResolverTaskKind::PUSH_LOCAL_VAR_VECTOR:
+            push_local_var_vector(context);
+            break;
+          case ResolverTaskKind::PUSH_ARG:
+            if(!push_local_var(context, *(task.arg))) {
+              errors.push_back(Error(task.arg->pos(), "argument " + task.arg->to_ident_string() + " is already defined"));
+              is_success = false;
+            }
+            break;
+          case ResolverTaskKind::CLEAR_TOP_LOCAL_VAR_IDENTS:
+            clear_top_local_var_idents(context);
+            break;
+          case ResolverTaskKind::POP_LOCAL_VARS:
+            pop_local_vars(context);
+            break;
+          case ResolverTaskKind::POP_CLOSURE_LIMIT:
+            pop_closure_limit(context);
+            break;
+          case ResolverTaskKind::LAMBDA_BODY:
+            if(parse_body(task.lambda_value, errors))
+              push_task(context, ResolverTask(task.lambda_value->body()));
+            else
+              is_success = false;
+            break;
+        }
+      }
+      return is_success;
+    }
+
+    static bool resolve_idents_from_expr(ResolverContext &context, Expression *expr, DiagnosticList &errors)
+    {
+      size_t task_count = context.tasks.size();
+      push_task(context, ResolverTask(expr));
+      return resolve_idents_from_tasks(context, task_count, errors);
+    }
+
+    static bool resolve_idents_from_value(ResolverContext &context, Value *value, DiagnosticList &errors)
+    {
+      size_t task_count = context.tasks.size();
+      push_task(context, ResolverTask(value));
+      return resolve_idents_from_tasks(context, task_count, errors);
+    }
+
+    static bool resolve_idents_from_type_expr(ResolverContext &context, TypeExpression *expr, DiagnosticList &errors, bool can_add_type_params = false)
+    {
+      size_t task_count = context.tasks.size();
+      push_task(context, ResolverTask(expr, can_add_type_params));
+      return resolve_idents_from_tasks(context, task_count, errors);
+    }
+
+    static bool resolve_idents_from_args(ResolverContext &context, const NodeList<Argument> &args, DiagnosticList &errors, bool can_add_type_params)
     {
       bool is_success = true;
       push_local_var_vector(context);
@@ -1324,7 +1512,7 @@ namespace lesfl
       return is_success;
     }
 
-    static bool check_annotations(const list<unique_ptr<Annotation>> &annotations, list<Error> &errors)
+    static bool check_annotations(const NodeList<Annotation> &annotations, DiagnosticList &errors)
     {
       bool is_success = true;
       bool is_eager = false;
@@ -1370,7 +1558,7 @@ namespace lesfl
       return is_success;
     }
 
-    static bool resolve_idents_from_type_params(ResolverContext &context, const list<unique_ptr<TypeParameter>> &params, list<Error> &errors, bool can_add_type_params = false)
+    static bool resolve_idents_from_type_params(ResolverContext &context, const NodeList<TypeParameter> &params, DiagnosticList &errors, bool can_add_type_params = false)
     {
       bool is_success = true;
       for(auto &param : params) {
@@ -1389,7 +1577,7 @@ namespace lesfl
       return is_success;
     }
 
-    static bool resolve_idents_from_type_args(ResolverContext &context, const list<unique_ptr<TypeArgument>> &args, list<Error> &errors)
+    static bool resolve_idents_from_type_args(ResolverContext &context, const NodeList<TypeArgument> &args, DiagnosticList &errors)
     {
       bool is_success = true;
       for(auto &arg : args) {
@@ -1401,7 +1589,7 @@ namespace lesfl
       return is_success;
     }
 
-    static bool resolve_idents_from_type_named_field_pairs(ResolverContext &context, const list<unique_ptr<TypeNamedFieldPair>> &pairs, unordered_map<string, size_t> &indices, list<Error> &errors, function<string ()> constr_abs_ident_string_fun)
+    static bool resolve_idents_from_type_named_field_pairs(ResolverContext &context, const NodeList<TypeNamedFieldPair> &pairs, unordered_map<string, size_t> &indices, DiagnosticList &errors, function<string ()> constr_abs_ident_string_fun)
     {
       bool is_success = true;
       indices.clear();
@@ -1417,7 +1605,7 @@ namespace lesfl
       return is_success;
     }
 
-    static bool resolve_idents_from_constr(ResolverContext &context, const shared_ptr<Constructor> &constr, KeyIdentifier *datatype_key_ident, list<Error> &errors)
+    static bool resolve_idents_from_constr(ResolverContext &context, const shared_ptr<Constructor> &constr, KeyIdentifier *datatype_key_ident, DiagnosticList &errors)
     {
       if(datatype_key_ident != nullptr) constr->set_datatype_key_ident(*datatype_key_ident);
       return dynamic_match(constr.get(),
@@ -1448,7 +1636,7 @@ namespace lesfl
       });
     }
 
-    static bool resolve_idents_from_datatype(ResolverContext &context, Datatype *datatype, const Position &pos, list<Error> &errors, KeyIdentifier *datatype_key_ident = nullptr)
+    static bool resolve_idents_from_datatype(ResolverContext &context, Datatype *datatype, const Position &pos, DiagnosticList &errors, KeyIdentifier *datatype_key_ident = nullptr)
     {
       return dynamic_match(datatype,
       [&pos, &errors](Datatype *datatype) -> bool {
@@ -1471,7 +1659,7 @@ namespace lesfl
       });
     }
     
-    static bool resolve_idents_from_var(ResolverContext &context, const shared_ptr<OriginalVariable> &var, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_var(ResolverContext &context, const shared_ptr<OriginalVariable> &var, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(var.get(),
       [&pos, &errors](Variable *var) -> bool {
@@ -1506,10 +1694,10 @@ namespace lesfl
       });
     }
 
-    static bool resolve_idents_from_var_inst(ResolverContext &context, const shared_ptr<VariableInstance> &inst, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_var_inst(ResolverContext &context, const shared_ptr<VariableInstance> &inst, const Position &pos, DiagnosticList &errors)
     { return resolve_idents_from_var(context, inst->var(), pos, errors); }
 
-    static bool resolve_idents_from_fun(ResolverContext &context, const shared_ptr<OriginalFunction> &fun, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_fun(ResolverContext &context, const shared_ptr<OriginalFunction> &fun, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(fun.get(),
       [&pos, &errors](Function *fun) -> bool {
@@ -1527,7 +1715,9 @@ namespace lesfl
         is_success &= resolve_idents_from_args(context, fun->args(), errors, true);
         if(fun->result_type_expr() != nullptr)
           is_success &= resolve_idents_from_type_expr(context, fun->result_type_expr(), errors, true);
-        if(fun->body() != nullptr)
+        if(!parse_body(fun, errors))
+          is_success = false;
+        else if(fun->body() != nullptr)
           is_success &= resolve_idents_from_expr(context, fun->body(), errors);
         pop_local_vars(context);
         context.template_flag = false;
@@ -1559,10 +1749,10 @@ namespace lesfl
       });
     }
 
-    static bool resolve_idents_from_fun_inst(ResolverContext &context, const shared_ptr<FunctionInstance> &inst, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_fun_inst(ResolverContext &context, const shared_ptr<FunctionInstance> &inst, const Position &pos, DiagnosticList &errors)
     { return resolve_idents_from_fun(context, inst->fun(), pos, errors); }
 
-    static bool resolve_idents_from_type_var(ResolverContext &context, const shared_ptr<DefinableTypeVariable> &var, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_type_var(ResolverContext &context, const shared_ptr<DefinableTypeVariable> &var, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(var.get(),
       [&pos, &errors](TypeVariable *var) -> bool {
@@ -1583,7 +1773,7 @@ namespace lesfl
       });
     }
 
-    static bool resolve_idents_from_type_fun(ResolverContext &context, const shared_ptr<DefinableTypeFunction> &fun, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_type_fun(ResolverContext &context, const shared_ptr<DefinableTypeFunction> &fun, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(fun.get(),
       [&pos, &errors](TypeFunction *fun) -> bool {
@@ -1613,7 +1803,7 @@ namespace lesfl
       });
     }
 
-    static bool resolve_idents_from_type_fun_inst(ResolverContext &context, const shared_ptr<TypeFunctionInstance> &inst, KeyIdentifier datatype_key_ident, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_type_fun_inst(ResolverContext &context, const shared_ptr<TypeFunctionInstance> &inst, KeyIdentifier datatype_key_ident, const Position &pos, DiagnosticList &errors)
     { 
       return dynamic_match(inst.get(),
        [&pos, &errors](TypeFunctionInstance *inst) -> bool {
@@ -1644,7 +1834,7 @@ namespace lesfl
       });
     }
     
-    static bool resolve_idents_from_alias_var(ResolverContext &context, const shared_ptr<DefinableVariable> &var, const Position &pos, list<Error> &errors)
+    static bool resolve_idents_from_alias_var(ResolverContext &context, const shared_ptr<DefinableVariable> &var, const Position &pos, DiagnosticList &errors)
     {
       return dynamic_match(var.get(),
       [&pos, &errors](DefinableVariable *var) -> bool {
@@ -1671,10 +1861,39 @@ namespace lesfl
       });
     }
 
-    static bool resolve_idents_from_alias_defs(ResolverContext &context, const list<unique_ptr<Definition>> &defs, list<Error> &errors)
+    static const string *def_ident(Definition *def)
+    {
+      return dynamic_match(def,
+      [](Definition *def) -> const string * { return nullptr; },
+      [](VariableDefinition *def) { return &(def->ident()); },
+      [](VariableInstanceDefinition *def) { return &(def->ident()); },
+      [](FunctionDefinition *def) { return &(def->ident()); },
+      [](FunctionInstanceDefinition *def) { return &(def->ident()); },
+      [](TypeVariableDefinition *def) { return &(def->ident()); },
+      [](TypeFunctionDefinition *def) { return &(def->ident()); },
+      [](TypeFunctionInstanceDefinition *def) { return &(def->ident()); });
+    }
+
+    static void set_current_def(ResolverContext &context, Definition *def)
+    {
+      if(!context.can_add_refs) return;
+      context.current_def = def;
+      context.has_current_def_key_ident = false;
+      const string *ident = def_ident(def);
+      if(ident != nullptr) {
+        AbsoluteIdentifier abs_ident(context.current_module_ident, *ident);
+        if(abs_ident.set_key_ident(*(context.tree.ident_table()))) {
+          context.current_def_key_ident = abs_ident.key_ident();
+          context.has_current_def_key_ident = true;
+        }
+      }
+    }
+
+    static bool resolve_idents_from_alias_defs(ResolverContext &context, const NodeList<Definition> &defs, DiagnosticList &errors)
     {
       bool is_success = true;
       for(auto &def : defs) {
+        if(errors.must_stop()) break;
         is_success &= dynamic_match(def.get(), 
         [](const Definition *def) -> bool {
           return true;
@@ -1694,16 +1913,31 @@ namespace lesfl
           return tmp_is_success;
         },
         [&](VariableDefinition *var_def) -> bool {
-          return resolve_idents_from_alias_var(context, var_def->var(), var_def->pos(), errors);
+          set_current_def(context, var_def);
+          bool tmp_is_success = resolve_idents_from_alias_var(context, var_def->var(), var_def->pos(), errors);
+          context.current_def = nullptr;
+          return tmp_is_success;
         });
       }
       return is_success;
     }
 
-    static bool resolve_idents_from_defs(ResolverContext &context, const list<unique_ptr<Definition>> &defs, list<Error> &errors)
+    static void add_def_trace_event(ResolverContext &context, Definition *def, uint64_t start_nanoseconds)
+    {
+      uint64_t nanoseconds = context.trace->nanoseconds_since_start() - start_nanoseconds;
+      if(nanoseconds < context.trace->def_threshold_nanoseconds()) return;
+      const string *ident = def_ident(def);
+      if(ident != nullptr)
+        context.trace->add_event(AbsoluteIdentifier(context.current_module_ident, *ident).to_string(), "resolve definition", start_nanoseconds, nanoseconds);
+    }
+
+    static bool resolve_idents_from_defs(ResolverContext &context, const NodeList<Definition> &defs, DiagnosticList &errors)
     {
       bool is_success = true;
       for(auto &def : defs) {
+        if(errors.must_stop()) break;
+        uint64_t def_start_nanoseconds = (context.trace != nullptr ? context.trace->nanoseconds_since_start() : 0);
+        set_current_def(context, def.get());
         is_success &= dynamic_match(def.get(), 
         [](const Definition *def) -> bool {
           return true;
@@ -1716,6 +1950,7 @@ namespace lesfl
         [&](ModuleDefinition *module_def) -> bool {
           AbsoluteIdentifier saved_current_module = context.current_module_ident;
           context.current_module_ident = *(module_def->ident()->abs_ident(*(context.tree.ident_table())));
+          priv::TraceSpan span(context.trace, "resolve module", context.trace != nullptr ? context.current_module_ident.to_string() : string());
           push_imported_module_vector(context);
           bool tmp_is_success = resolve_idents_from_defs(context, module_def->defs(), errors);
           pop_imported_modules(context);
@@ -1727,7 +1962,7 @@ namespace lesfl
         },
         [&](VariableInstanceDefinition *var_inst_def) -> bool {
           AbsoluteIdentifier abs_ident(context.current_module_ident, var_inst_def->ident());
-          bool tmp_is_success = resolve_var_ident(context, &abs_ident, var_inst_def->pos(), errors);
+          bool tmp_is_success = resolve_var_ident(context, &abs_ident, var_inst_def->pos(), errors, false);
           if(tmp_is_success) {
             VariableInfo *var_info = context.tree.var_info(abs_ident);
             if(var_info != nullptr) {
@@ -1743,7 +1978,7 @@ namespace lesfl
         },
         [&](FunctionInstanceDefinition *fun_inst_def) -> bool {
           AbsoluteIdentifier abs_ident(context.current_module_ident, fun_inst_def->ident());
-          bool tmp_is_success = resolve_var_ident(context, &abs_ident, fun_inst_def->pos(), errors);
+          bool tmp_is_success = resolve_var_ident(context, &abs_ident, fun_inst_def->pos(), errors, false);
           if(tmp_is_success) {
             VariableInfo *var_info = context.tree.var_info(abs_ident);
             if(var_info != nullptr) {
@@ -1762,7 +1997,7 @@ namespace lesfl
         },
         [&](TypeFunctionInstanceDefinition *type_fun_inst_def) -> bool {
           AbsoluteIdentifier abs_ident(context.current_module_ident, type_fun_inst_def->ident());
-          bool tmp_is_success = resolve_type_fun_ident(context, &abs_ident, type_fun_inst_def->pos(), errors);
+          bool tmp_is_success = resolve_type_fun_ident(context, &abs_ident, type_fun_inst_def->pos(), errors, false);
           if(tmp_is_success) {
             TypeFunctionInfo *type_fun_info = context.tree.type_fun_info(abs_ident);
             if(type_fun_info != nullptr) {
@@ -1773,6 +2008,7 @@ namespace lesfl
           tmp_is_success &= resolve_idents_from_type_fun_inst(context, type_fun_inst_def->fun_inst(), abs_ident.key_ident(), type_fun_inst_def->pos(), errors);
           return tmp_is_success;
         });
+        if(context.trace != nullptr) add_def_trace_event(context, def.get(), def_start_nanoseconds);
       }
       return is_success;
     }
@@ -1783,23 +2019,53 @@ namespace lesfl
 
     Resolver::~Resolver() {}
 
-    bool Resolver::resolve(Tree &tree, list<Error> &errors)
+    bool Resolver::resolve(Tree &tree, list<Error> &errors, const FrontendOptions &options)
     {
-      ResolverContext context(tree);
+      DiagnosticList diags;
+      bool is_success = resolve_tree(tree, diags, options);
+      diags.append_errors(errors, *(tree.ident_table()));
+      return is_success;
+    }
+
+    bool Resolver::resolve(Tree &tree, DiagnosticList &diags, const FrontendOptions &options)
+    { return resolve_tree(tree, diags, options); }
+
+    bool Resolver::resolve_tree(Tree &tree, DiagnosticList &errors, const FrontendOptions &options)
+    {
+      ResolverContext context(tree, options.stats != nullptr ? options.stats->trace() : nullptr, options.ref_index != nullptr);
       bool is_success = true;
-      is_success &= add_root_module(context, errors);
-      for(auto &defs : tree.defs()) {
-        is_success &= add_defs(context, *defs, errors);
+      unique_ptr<priv::StatsCollector> collector;
+      if(options.stats != nullptr) collector = unique_ptr<priv::StatsCollector>(new priv::StatsCollector(*(options.stats)));
+      {
+        priv::PhaseTimer timer(options.stats, "add definitions");
+        is_success &= add_root_module(context, errors);
+        for(auto &defs : tree.defs()) {
+          if(errors.must_stop()) break;
+          is_success &= add_defs(context, *defs, errors);
+        }
       }
-      for(auto &defs : tree.defs()) {
-        clear_imported_module_ident_stack(context);
-        push_imported_module_vector(context);
-        is_success &= resolve_idents_from_alias_defs(context, *defs, errors);
+      {
+        priv::PhaseTimer timer(options.stats, "resolve aliases");
+        for(auto &defs : tree.defs()) {
+          if(errors.must_stop()) break;
+          clear_imported_module_ident_stack(context);
+          push_imported_module_vector(context);
+          is_success &= resolve_idents_from_alias_defs(context, *defs, errors);
+        }
+        resolve_alias_targets(context);
+      }
+      {
+        priv::PhaseTimer timer(options.stats, "resolve definitions");
+        for(auto &defs : tree.defs()) {
+          if(errors.must_stop()) break;
+          clear_imported_module_ident_stack(context);
+          push_imported_module_vector(context);
+          is_success &= resolve_idents_from_defs(context, *defs, errors);
+        }
       }
-      for(auto &defs : tree.defs()) {
-        clear_imported_module_ident_stack(context);
-        push_imported_module_vector(context);
-        is_success &= resolve_idents_from_defs(context, *defs, errors);
+      if(options.ref_index != nullptr) {
+        options.ref_index->clear();
+        options.ref_index->add_refs(context.refs);
       }
       return is_success;
     }
@@ -0,0 +1,234 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <lesfl/frontend/stats.hpp>
+#include "frontend/stats_collector.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      //
+      // A StatsCollector class.
+      //
+
+      thread_local StatsCollector *StatsCollector::_S_current = nullptr;
+
+      StatsCollector::StatsCollector(FrontendStats &stats) :
+        _M_stats(stats), _M_saved_collector(_S_current)
+      { _S_current = this; }
+
+      StatsCollector::~StatsCollector() { _S_current = _M_saved_collector; }
+
+      //
+      // A PhaseTimer class.
+      //
+
+      PhaseTimer::PhaseTimer(FrontendStats *stats, const string &name) :
+        _M_stats(stats)
+      {
+        if(_M_stats != nullptr) {
+          _M_name = name;
+          _M_start_allocation_count = FrontendStats::allocation_count();
+          _M_trace_start_nanoseconds = (_M_stats->trace() != nullptr ? _M_stats->trace()->nanoseconds_since_start() : 0);
+          _M_start = chrono::steady_clock::now();
+        }
+      }
+
+      PhaseTimer::~PhaseTimer()
+      {
+        if(_M_stats != nullptr) {
+          auto end = chrono::steady_clock::now();
+          uint64_t nanoseconds = chrono::duration_cast<chrono::nanoseconds>(end - _M_start).count();
+          _M_stats->add_phase_stats(PhaseStats(_M_name, nanoseconds, FrontendStats::allocation_count() - _M_start_allocation_count));
+          if(_M_stats->trace() != nullptr)
+            _M_stats->trace()->add_event(_M_name, "phase", _M_trace_start_nanoseconds, _M_stats->trace()->nanoseconds_since_start() - _M_trace_start_nanoseconds);
+        }
+      }
+    }
+
+    // Static inline functions and static functions.
+
+    static void write_json_string(ostream &os, const string &str)
+    {
+      os << '"';
+      for(char c : str) {
+        switch(c) {
+          case '"':
+            os << "\\\"";
+            break;
+          case '\\':
+            os << "\\\\";
+            break;
+          case '\n':
+            os << "\\n";
+            break;
+          case '\t':
+            os << "\\t";
+            break;
+          default:
+            if(static_cast<unsigned char>(c) < 0x20) {
+              char buf[7];
+              snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+              os << buf;
+            } else
+              os << c;
+            break;
+        }
+      }
+      os << '"';
+    }
+
+    static void write_json_microseconds(ostream &os, uint64_t nanoseconds)
+    { os << (nanoseconds / 1000) << '.' << setw(3) << setfill('0') << (nanoseconds % 1000) << setfill(' '); }
+
+    //
+    // A Trace class.
+    //
+
+    void Trace::add_event(const string &name, const string &category, uint64_t start_nanoseconds, uint64_t nanoseconds)
+    {
+      lock_guard<mutex> guard(_M_mutex);
+      thread::id thread_id = this_thread::get_id();
+      size_t thread_index = find(_M_thread_ids.begin(), _M_thread_ids.end(), thread_id) - _M_thread_ids.begin();
+      if(thread_index >= _M_thread_ids.size()) _M_thread_ids.push_back(thread_id);
+      _M_events.push_back(TraceEvent(name, category, start_nanoseconds, nanoseconds, thread_index));
+    }
+
+    void Trace::clear()
+    {
+      lock_guard<mutex> guard(_M_mutex);
+      _M_events.clear();
+      _M_thread_ids.clear();
+    }
+
+    void Trace::write_json(ostream &os) const
+    {
+      lock_guard<mutex> guard(_M_mutex);
+      os << "{\"traceEvents\": [";
+      bool is_first = true;
+      for(size_t i = 0; i < _M_thread_ids.size(); i++) {
+        os << (is_first ? "\n" : ",\n");
+        os << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << i;
+        os << ", \"args\": {\"name\": \"thread " << i << "\"}}";
+        is_first = false;
+      }
+      for(auto &event : _M_events) {
+        os << (is_first ? "\n" : ",\n");
+        os << "  {\"name\": ";
+        write_json_string(os, event.name());
+        os << ", \"cat\": ";
+        write_json_string(os, event.category());
+        os << ", \"ph\": \"X\", \"ts\": ";
+        write_json_microseconds(os, event.start_nanoseconds());
+        os << ", \"dur\": ";
+        write_json_microseconds(os, event.nanoseconds());
+        os << ", \"pid\": 1, \"tid\": " << event.thread_index() << "}";
+        is_first = false;
+      }
+      os << (is_first ? "]}\n" : "\n]}\n");
+    }
+
+    //
+    // A FrontendStats class.
+    //
+
+    thread_local size_t FrontendStats::_S_allocation_count = 0;
+
+    void FrontendStats::clear()
+    {
+      _M_phase_stats.clear();
+      _M_interned_ident_count = 0;
+      _M_ident_table_probe_count = 0;
+      _M_ident_lookup_miss_count = 0;
+    }
+
+    void FrontendStats::write_json(ostream &os) const
+    {
+      os << "{\n";
+      os << "  \"phases\": [";
+      bool is_first = true;
+      for(auto &phase_stats : _M_phase_stats) {
+        os << (is_first ? "\n" : ",\n");
+        os << "    {\"name\": ";
+        write_json_string(os, phase_stats.name());
+        os << ", \"nanoseconds\": " << phase_stats.nanoseconds();
+        os << ", \"allocations\": " << phase_stats.allocation_count() << "}";
+        is_first = false;
+      }
+      os << (is_first ? "],\n" : "\n  ],\n");
+      os << "  \"interned_idents\": " << _M_interned_ident_count << ",\n";
+      os << "  \"ident_table_probes\": " << _M_ident_table_probe_count << ",\n";
+      os << "  \"ident_lookup_misses\": " << _M_ident_lookup_miss_count << "\n";
+      os << "}\n";
+    }
+
+    //
+    // A MemoryReport class.
+    //
+
+    const MemoryUsage *MemoryReport::usage(const string &name) const
+    {
+      auto iter = _M_usage_indices.find(name);
+      return iter != _M_usage_indices.end() ? &(_M_usages[iter->second]) : nullptr;
+    }
+
+    void MemoryReport::add(const string &name, size_t count, size_t bytes)
+    {
+      auto iter = _M_usage_indices.find(name);
+      if(iter != _M_usage_indices.end()) {
+        _M_usages[iter->second].add(count, bytes);
+      } else {
+        _M_usage_indices.insert(make_pair(name, _M_usages.size()));
+        _M_usages.push_back(MemoryUsage(name, count, bytes));
+      }
+    }
+
+    size_t MemoryReport::total_bytes() const
+    {
+      size_t bytes = 0;
+      for(auto &usage : _M_usages) bytes += usage.bytes();
+      return bytes;
+    }
+
+    void MemoryReport::clear()
+    {
+      _M_usages.clear();
+      _M_usage_indices.clear();
+    }
+
+    void MemoryReport::write_json(ostream &os) const
+    {
+      vector<const MemoryUsage *> usages;
+      for(auto &usage : _M_usages) usages.push_back(&usage);
+      stable_sort(usages.begin(), usages.end(), [](const MemoryUsage *usage1, const MemoryUsage *usage2) {
+        return usage1->bytes() > usage2->bytes();
+      });
+      os << "{\n";
+      os << "  \"usages\": [";
+      bool is_first = true;
+      for(auto usage : usages) {
+        os << (is_first ? "\n" : ",\n");
+        os << "    {\"name\": ";
+        write_json_string(os, usage->name());
+        os << ", \"count\": " << usage->count();
+        os << ", \"bytes\": " << usage->bytes() << "}";
+        is_first = false;
+      }
+      os << (is_first ? "],\n" : "\n  ],\n");
+      os << "  \"total_bytes\": " << total_bytes() << "\n";
+      os << "}\n";
+    }
+  }
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_STATS_COLLECTOR_HPP
+#define _FRONTEND_STATS_COLLECTOR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <lesfl/frontend/stats.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      class StatsCollector
+      {
+        static thread_local StatsCollector *_S_current;
+
+        FrontendStats &_M_stats;
+        StatsCollector *_M_saved_collector;
+      public:
+        StatsCollector(FrontendStats &stats);
+
+        StatsCollector(const StatsCollector &) = delete;
+
+        ~StatsCollector();
+
+        StatsCollector &operator=(const StatsCollector &) = delete;
+
+        static StatsCollector *current() { return _S_current; }
+
+        FrontendStats &stats() { return _M_stats; }
+      };
+
+      class PhaseTimer
+      {
+        FrontendStats *_M_stats;
+        std::string _M_name;
+        std::chrono::steady_clock::time_point _M_start;
+        std::size_t _M_start_allocation_count;
+        std::uint64_t _M_trace_start_nanoseconds;
+      public:
+        PhaseTimer(FrontendStats *stats, const std::string &name);
+
+        PhaseTimer(const PhaseTimer &) = delete;
+
+        ~PhaseTimer();
+
+        PhaseTimer &operator=(const PhaseTimer &) = delete;
+      };
+
+      class TraceSpan
+      {
+        Trace *_M_trace;
+        const char *_M_category;
+        std::string _M_name;
+        std::uint64_t _M_start_nanoseconds;
+      public:
+        TraceSpan(Trace *trace, const char *category, const std::string &name) :
+          _M_trace(trace), _M_category(category), _M_name(name), _M_start_nanoseconds(trace != nullptr ? trace->nanoseconds_since_start() : 0) {}
+
+        TraceSpan(const TraceSpan &) = delete;
+
+        ~TraceSpan()
+        { if(_M_trace != nullptr) _M_trace->add_event(_M_name, _M_category, _M_start_nanoseconds, _M_trace->nanoseconds_since_start() - _M_start_nanoseconds); }
+
+        TraceSpan &operator=(const TraceSpan &) = delete;
+      };
+
+      inline Trace *current_trace()
+      {
+        StatsCollector *collector = StatsCollector::current();
+        return collector != nullptr ? collector->stats().trace() : nullptr;
+      }
+
+      inline void count_interned_ident()
+      {
+        StatsCollector *collector = StatsCollector::current();
+        if(collector != nullptr) collector->stats().increase_interned_ident_count();
+      }
+
+      inline void count_ident_table_probe()
+      {
+        StatsCollector *collector = StatsCollector::current();
+        if(collector != nullptr) collector->stats().increase_ident_table_probe_count();
+      }
+
+      inline void count_ident_lookup_miss()
+      {
+        StatsCollector *collector = StatsCollector::current();
+        if(collector != nullptr) collector->stats().increase_ident_lookup_miss_count();
+      }
+    }
+  }
+}
+
+#endif
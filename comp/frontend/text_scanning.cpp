@@ -0,0 +1,157 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#if defined(__GNUC__) && defined(__AVX2__)
+#include <immintrin.h>
+#define LESFL_AVX2_TEXT_SCANNING
+#elif defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#define LESFL_SSE2_TEXT_SCANNING
+#endif
+#include <cstdint>
+#include <cstring>
+#include "frontend/text_scanning.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      // Static inline functions and static functions.
+
+      static inline bool is_utf8_continuation(unsigned char c)
+      { return (c & 0xc0) == 0x80; }
+
+      static inline wchar_t *put_code_point(wchar_t *dst, uint32_t code_point)
+      {
+#if defined(__SIZEOF_WCHAR_T__) && __SIZEOF_WCHAR_T__ == 2
+        if(code_point >= 0x10000) {
+          code_point -= 0x10000;
+          *dst++ = static_cast<wchar_t>(0xd800 + (code_point >> 10));
+          *dst++ = static_cast<wchar_t>(0xdc00 + (code_point & 0x3ff));
+          return dst;
+        }
+#endif
+        *dst++ = static_cast<wchar_t>(code_point);
+        return dst;
+      }
+
+      static size_t decode_utf8(const unsigned char *src, size_t length, uint32_t &code_point)
+      {
+        unsigned char c = src[0];
+        if(c < 0x80) {
+          code_point = c;
+          return 1;
+        } else if(c >= 0xc2 && c <= 0xdf) {
+          if(length < 2 || !is_utf8_continuation(src[1])) return 0;
+          code_point = ((c & 0x1fU) << 6) | (src[1] & 0x3fU);
+          return 2;
+        } else if(c >= 0xe0 && c <= 0xef) {
+          if(length < 3 || !is_utf8_continuation(src[1]) || !is_utf8_continuation(src[2])) return 0;
+          if(c == 0xe0 && src[1] < 0xa0) return 0;
+          if(c == 0xed && src[1] >= 0xa0) return 0;
+          code_point = ((c & 0x0fU) << 12) | ((src[1] & 0x3fU) << 6) | (src[2] & 0x3fU);
+          return 3;
+        } else if(c >= 0xf0 && c <= 0xf4) {
+          if(length < 4 || !is_utf8_continuation(src[1]) || !is_utf8_continuation(src[2]) || !is_utf8_continuation(src[3])) return 0;
+          if(c == 0xf0 && src[1] < 0x90) return 0;
+          if(c == 0xf4 && src[1] >= 0x90) return 0;
+          code_point = ((c & 0x07U) << 18) | ((src[1] & 0x3fU) << 12) | ((src[2] & 0x3fU) << 6) | (src[3] & 0x3fU);
+          return 4;
+        } else
+          return 0;
+      }
+
+      size_t count_newlines(const char *str, size_t length, const char *&line_start)
+      {
+        size_t count = 0;
+        size_t i = 0;
+        const char *end = str + length;
+        line_start = str;
+#if defined(LESFL_AVX2_TEXT_SCANNING)
+        const __m256i newlines = _mm256_set1_epi8('\n');
+        for(; i + 32 <= length; i += 32) {
+          __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+          unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newlines)));
+          if(mask != 0) {
+            count += __builtin_popcount(mask);
+            line_start = str + i + (32 - __builtin_clz(mask));
+          }
+        }
+#elif defined(LESFL_SSE2_TEXT_SCANNING)
+        const __m128i newlines = _mm_set1_epi8('\n');
+        for(; i + 16 <= length; i += 16) {
+          __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + i));
+          unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newlines)));
+          if(mask != 0) {
+            count += __builtin_popcount(mask);
+            line_start = str + i + (32 - __builtin_clz(mask));
+          }
+        }
+#endif
+        // The rest of the text, or the whole text without the SIMD
+        // instructions, is scanned by memchr.
+        const char *rest = str + i;
+        while(true) {
+          const char *newline = static_cast<const char *>(memchr(rest, '\n', end - rest));
+          if(newline == nullptr) break;
+          count++;
+          line_start = rest = newline + 1;
+        }
+        return count;
+      }
+
+      bool append_utf8_to_wstring(const char *str, size_t length, wstring &wstr)
+      {
+        size_t old_length = wstr.length();
+        wstr.resize(old_length + length);
+        const unsigned char *src = reinterpret_cast<const unsigned char *>(str);
+        wchar_t *dst = &(wstr[0]) + old_length;
+        size_t i = 0;
+        while(i < length) {
+#if defined(__SIZEOF_WCHAR_T__) && __SIZEOF_WCHAR_T__ == 4
+#if defined(LESFL_AVX2_TEXT_SCANNING)
+          for(; i + 16 <= length; i += 16, dst += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            if(_mm_movemask_epi8(chunk) != 0) break;
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_cvtepu8_epi32(chunk));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(chunk, 8)));
+          }
+#elif defined(LESFL_SSE2_TEXT_SCANNING)
+          const __m128i zero = _mm_setzero_si128();
+          for(; i + 16 <= length; i += 16, dst += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            if(_mm_movemask_epi8(chunk) != 0) break;
+            __m128i low = _mm_unpacklo_epi8(chunk, zero);
+            __m128i high = _mm_unpackhi_epi8(chunk, zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4), _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8), _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), _mm_unpackhi_epi16(high, zero));
+          }
+#endif
+#endif
+          for(; i < length && src[i] < 0x80; i++) *dst++ = static_cast<wchar_t>(src[i]);
+          if(i >= length) break;
+          uint32_t code_point;
+          size_t sequence_length = decode_utf8(src + i, length - i, code_point);
+          if(sequence_length == 0) {
+            wstr.resize(old_length);
+            return false;
+          }
+          dst = put_code_point(dst, code_point);
+          i += sequence_length;
+        }
+        wstr.resize(dst - &(wstr[0]));
+        return true;
+      }
+    }
+  }
+}
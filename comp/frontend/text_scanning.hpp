@@ -0,0 +1,27 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_TEXT_SCANNING_HPP
+#define _FRONTEND_TEXT_SCANNING_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace priv
+    {
+      std::size_t count_newlines(const char *str, std::size_t length, const char *&line_start);
+
+      bool append_utf8_to_wstring(const char *str, std::size_t length, std::wstring &wstr);
+    }
+  }
+}
+
+#endif
@@ -5,8 +5,12 @@
  *   License v3 or later. See the LICENSE file and the GPL file for         *
  *   the full licensing terms.                                              *
  ****************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <tuple>
 #include <lesfl/frontend/tree.hpp>
 #include "frontend/ident.hpp"
+#include "frontend/key_ident_remapper.hpp"
 
 using namespace std;
 
@@ -14,6 +18,137 @@ namespace lesfl
 {
   namespace frontend
   {
+    // Static inline functions and static functions.
+
+    template<typename _T>
+    static inline _T get_packed_elem(const vector<char> &data, size_t i)
+    {
+      _T x;
+      memcpy(&x, data.data() + i * sizeof(_T), sizeof(_T));
+      return x;
+    }
+
+    template<typename _T>
+    static inline void add_packed_elem(vector<char> &data, _T x)
+    {
+      size_t offset = data.size();
+      data.resize(offset + sizeof(_T));
+      memcpy(data.data() + offset, &x, sizeof(_T));
+    }
+
+    template<typename _T>
+    static void renumber_key_idents_in_map(unordered_map<KeyIdentifier, _T> &map, const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      vector<pair<KeyIdentifier, _T>> pairs;
+      pairs.reserve(map.size());
+      for(auto &tmp_pair : map) pairs.push_back(make_pair(key_ident_map.at(tmp_pair.first), move(tmp_pair.second)));
+      sort(pairs.begin(), pairs.end(), [](const pair<KeyIdentifier, _T> &pair1, const pair<KeyIdentifier, _T> &pair2) {
+        return pair1.first.key() < pair2.first.key();
+      });
+      // Elements are inserted in the order of keys so that iteration order
+      // doesn't depend on the old key identifiers.
+      map.clear();
+      for(auto &tmp_pair : pairs) map.insert(move(tmp_pair));
+    }
+
+    static void renumber_key_idents_in_vector(vector<KeyIdentifier> &key_idents, const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      for(auto &key_ident : key_idents) key_ident = key_ident_map.at(key_ident);
+      sort(key_idents.begin(), key_idents.end(), [](KeyIdentifier key_ident1, KeyIdentifier key_ident2) {
+        return key_ident1.key() < key_ident2.key();
+      });
+    }
+
+    template<typename _Pair>
+    static void renumber_key_idents_in_pairs(vector<_Pair> &pairs, const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      for(auto &pair : pairs) pair.key_ident = key_ident_map.at(pair.key_ident);
+      stable_sort(pairs.begin(), pairs.end(), [](const _Pair &pair1, const _Pair &pair2) {
+        return pair1.key_ident.key() < pair2.key_ident.key();
+      });
+    }
+
+    template<typename _T>
+    static vector<pair<KeyIdentifier, _T *>> sorted_info_pairs(unordered_map<KeyIdentifier, _T> &map, const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      vector<pair<KeyIdentifier, _T *>> pairs;
+      pairs.reserve(map.size());
+      for(auto &tmp_pair : map) pairs.push_back(make_pair(key_ident_map.at(tmp_pair.first), &(tmp_pair.second)));
+      sort(pairs.begin(), pairs.end(), [](const pair<KeyIdentifier, _T *> &pair1, const pair<KeyIdentifier, _T *> &pair2) {
+        return pair1.first.key() < pair2.first.key();
+      });
+      return pairs;
+    }
+
+    template<typename _T>
+    static vector<tuple<const AbsoluteIdentifier *, _T *, _T *>> duplicate_info_tuples(unordered_map<KeyIdentifier, _T> &infos, const AbsoluteIdentifierTable &table, unordered_map<KeyIdentifier, _T> &other_infos, const AbsoluteIdentifierTable &other_table)
+    {
+      vector<tuple<const AbsoluteIdentifier *, _T *, _T *>> tuples;
+      for(auto &tmp_pair : other_infos) {
+        const AbsoluteIdentifier *other_abs_ident = other_table.ident(tmp_pair.first);
+        if(other_abs_ident == nullptr) continue;
+        // An identifier without a key identifier is looked up by its names.
+        AbsoluteIdentifier tmp_abs_ident(other_abs_ident->idents());
+        const AbsoluteIdentifier *abs_ident = table.ident(&tmp_abs_ident);
+        if(abs_ident == nullptr) continue;
+        auto iter = infos.find(abs_ident->key_ident());
+        if(iter != infos.end()) tuples.push_back(make_tuple(abs_ident, &(iter->second), &(tmp_pair.second)));
+      }
+      sort(tuples.begin(), tuples.end(), [](const tuple<const AbsoluteIdentifier *, _T *, _T *> &tuple1, const tuple<const AbsoluteIdentifier *, _T *, _T *> &tuple2) {
+        return get<0>(tuple1)->key_ident().key() < get<0>(tuple2)->key_ident().key();
+      });
+      return tuples;
+    }
+
+    static void add_def_positions(const NodeList<Definition> &defs, unordered_map<const void *, const Position *> &positions)
+    {
+      for(auto &def : defs) {
+        ModuleDefinition *module_def = dynamic_cast<ModuleDefinition *>(def.get());
+        if(module_def != nullptr) {
+          add_def_positions(module_def->defs(), positions);
+          continue;
+        }
+        VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def.get());
+        if(var_def != nullptr) positions.insert(make_pair(dynamic_cast<const void *>(var_def->var().get()), &(def->pos())));
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def.get());
+        if(fun_def != nullptr) positions.insert(make_pair(dynamic_cast<const void *>(fun_def->fun().get()), &(def->pos())));
+        TypeVariableDefinition *type_var_def = dynamic_cast<TypeVariableDefinition *>(def.get());
+        if(type_var_def != nullptr) positions.insert(make_pair(dynamic_cast<const void *>(type_var_def->var().get()), &(def->pos())));
+        TypeFunctionDefinition *type_fun_def = dynamic_cast<TypeFunctionDefinition *>(def.get());
+        if(type_fun_def != nullptr) positions.insert(make_pair(dynamic_cast<const void *>(type_fun_def->fun().get()), &(def->pos())));
+      }
+    }
+
+    template<typename _T>
+    static const Position &def_position(const _T *object, const unordered_map<const void *, const Position *> &positions, const Position &default_pos)
+    {
+      auto iter = positions.find(dynamic_cast<const void *>(object));
+      return iter != positions.end() ? *(iter->second) : default_pos;
+    }
+
+    static const Position &var_def_position(const Variable *var, const unordered_map<const void *, const Position *> &positions, const Position &default_pos)
+    {
+      const FunctionVariable *fun_var = dynamic_cast<const FunctionVariable *>(var);
+      if(fun_var != nullptr) return def_position(fun_var->fun().get(), positions, default_pos);
+      const ConstructorVariable *constr_var = dynamic_cast<const ConstructorVariable *>(var);
+      if(constr_var != nullptr) return constr_var->constr()->pos();
+      return def_position(var, positions, default_pos);
+    }
+
+    static bool are_same_builtin_types(const TypeVariable *var1, const TypeVariable *var2)
+    {
+      const BuiltinTypeVariable *builtin_var1 = dynamic_cast<const BuiltinTypeVariable *>(var1);
+      const BuiltinTypeVariable *builtin_var2 = dynamic_cast<const BuiltinTypeVariable *>(var2);
+      return builtin_var1 != nullptr && builtin_var2 != nullptr && builtin_var1->builtin_type() == builtin_var2->builtin_type();
+    }
+
+    static bool are_same_builtin_types(const TypeFunction *fun1, const TypeFunction *fun2)
+    {
+      const BuiltinTypeFunction *builtin_fun1 = dynamic_cast<const BuiltinTypeFunction *>(fun1);
+      const BuiltinTypeFunction *builtin_fun2 = dynamic_cast<const BuiltinTypeFunction *>(fun2);
+      return builtin_fun1 != nullptr && builtin_fun2 != nullptr && builtin_fun1->builtin_type_template() == builtin_fun2->builtin_type_template();
+    }
+
     //
     // A Positional class.
     //
@@ -26,6 +161,26 @@ namespace lesfl
 
     Inlinable::~Inlinable() {}
 
+    //
+    // A Bodied class.
+    //
+
+    Bodied::Bodied(Expression *body) :
+      _M_body(body), _M_has_deferred_body(dynamic_cast<DeferredExpression *>(body) != nullptr) {}
+
+    Bodied::~Bodied() { NodeListTeardown::defer(_M_body); }
+
+    bool Bodied::parse_body(list<Error> &errors)
+    {
+      if(!_M_has_deferred_body) return true;
+      DeferredExpression *deferred_expr = static_cast<DeferredExpression *>(_M_body.get());
+      Expression *expr = deferred_expr->deferred_body()->parse(errors);
+      if(expr == nullptr) return false;
+      _M_body.reset(expr);
+      _M_has_deferred_body = false;
+      return true;
+    }
+
     //
     // An Accessible class.
     //
@@ -71,11 +226,140 @@ namespace lesfl
 
     TypeFunctionInfo::~TypeFunctionInfo() {}
 
+    //
+    // A NodeListTeardown class.
+    //
+
+    thread_local NodeListTeardown *NodeListTeardown::_S_current = nullptr;
+
     //
     // A Tree class.
     //
 
-    Tree::~Tree() {}
+    Tree::~Tree()
+    {
+      NodeListTeardown teardown;
+      _M_defs.clear();
+      _M_var_infos.clear();
+      _M_type_var_infos.clear();
+      _M_type_fun_infos.clear();
+      _M_uncompiled_inst_pairs.clear();
+      _M_uncompiled_type_fun_inst_pairs.clear();
+    }
+
+    void Tree::renumber_key_idents(const unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map)
+    {
+      vector<KeyIdentifier> module_key_idents(_M_module_key_idents.begin(), _M_module_key_idents.end());
+      renumber_key_idents_in_vector(module_key_idents, key_ident_map);
+      _M_module_key_idents.clear();
+      _M_module_key_idents.insert(module_key_idents.begin(), module_key_idents.end());
+      renumber_key_idents_in_map(_M_var_infos, key_ident_map);
+      renumber_key_idents_in_map(_M_type_var_infos, key_ident_map);
+      renumber_key_idents_in_map(_M_type_fun_infos, key_ident_map);
+      renumber_key_idents_in_vector(_M_uncompiled_var_key_idents, key_ident_map);
+      renumber_key_idents_in_vector(_M_uncompiled_type_var_key_idents, key_ident_map);
+      renumber_key_idents_in_vector(_M_uncompiled_type_fun_key_idents, key_ident_map);
+      renumber_key_idents_in_pairs(_M_uncompiled_inst_pairs, key_ident_map);
+      renumber_key_idents_in_pairs(_M_uncompiled_type_fun_inst_pairs, key_ident_map);
+    }
+
+    bool Tree::merge(Tree &&tree, list<Error> &errors)
+    {
+      if(&tree == this) return true;
+      Position default_pos(Source(), 0, 0);
+      // Both trees are left unchanged if a variable, a type or a type template
+      // is defined in both trees.
+      unordered_map<const void *, const Position *> positions;
+      for(auto &defs : tree._M_defs) add_def_positions(*defs, positions);
+      bool is_success = true;
+      for(auto &tmp_tuple : duplicate_info_tuples(_M_var_infos, *_M_ident_table, tree._M_var_infos, *(tree._M_ident_table))) {
+        const Position &pos = var_def_position(get<2>(tmp_tuple)->var().get(), positions, default_pos);
+        errors.push_back(Error(pos, "variable " + get<0>(tmp_tuple)->to_string() + " is already defined"));
+        is_success = false;
+      }
+      for(auto &tmp_tuple : duplicate_info_tuples(_M_type_var_infos, *_M_ident_table, tree._M_type_var_infos, *(tree._M_ident_table))) {
+        if(are_same_builtin_types(get<1>(tmp_tuple)->var().get(), get<2>(tmp_tuple)->var().get())) continue;
+        const Position &pos = def_position(get<2>(tmp_tuple)->var().get(), positions, default_pos);
+        errors.push_back(Error(pos, "type " + get<0>(tmp_tuple)->to_string() + " is already defined"));
+        is_success = false;
+      }
+      for(auto &tmp_tuple : duplicate_info_tuples(_M_type_fun_infos, *_M_ident_table, tree._M_type_fun_infos, *(tree._M_ident_table))) {
+        if(are_same_builtin_types(get<1>(tmp_tuple)->fun().get(), get<2>(tmp_tuple)->fun().get())) continue;
+        const Position &pos = def_position(get<2>(tmp_tuple)->fun().get(), positions, default_pos);
+        errors.push_back(Error(pos, "type template " + get<0>(tmp_tuple)->to_string() + " is already defined"));
+        is_success = false;
+      }
+      if(!is_success) return false;
+      unordered_map<KeyIdentifier, KeyIdentifier> key_ident_map;
+      // Identifiers are added in the order of the old key identifiers, so the
+      // new key identifiers don't depend on the iteration order of the table.
+      vector<pair<KeyIdentifier, const AbsoluteIdentifier *>> ident_pairs;
+      for(auto &tmp_pair : tree._M_ident_table->ident_map())
+        ident_pairs.push_back(make_pair(tmp_pair.first, tmp_pair.second.get()));
+      sort(ident_pairs.begin(), ident_pairs.end(), [](const pair<KeyIdentifier, const AbsoluteIdentifier *> &pair1, const pair<KeyIdentifier, const AbsoluteIdentifier *> &pair2) {
+        return pair1.first.key() < pair2.first.key();
+      });
+      for(auto &tmp_pair : ident_pairs) {
+        if(tree._M_ident_table != _M_ident_table) {
+          unique_ptr<AbsoluteIdentifier> abs_ident(new AbsoluteIdentifier(tmp_pair.second->idents()));
+          KeyIdentifier key_ident;
+          bool is_added_abs_ident;
+          if(!_M_ident_table->add_ident_or_get_key_ident(abs_ident.get(), key_ident, is_added_abs_ident)) {
+            errors.push_back(Error(default_pos, "internal error: can't add identifier to identifier table or get key identifier from identifier table"));
+            return false;
+          }
+          if(is_added_abs_ident) abs_ident.release();
+          key_ident_map.insert(make_pair(tmp_pair.first, key_ident));
+        } else
+          key_ident_map.insert(make_pair(tmp_pair.first, tmp_pair.first));
+      }
+      if(tree._M_ident_table != _M_ident_table) priv::remap_key_idents(tree, key_ident_map);
+      // Builtin types of the other tree are skipped and their instances are
+      // added to the builtin types of this tree.
+      unordered_set<KeyIdentifier> skipped_key_idents;
+      for(auto key_ident : tree._M_module_key_idents)
+        _M_module_key_idents.insert(key_ident_map.at(key_ident));
+      for(auto &tmp_pair : sorted_info_pairs(tree._M_var_infos, key_ident_map))
+        _M_var_infos.insert(make_pair(tmp_pair.first, *(tmp_pair.second)));
+      for(auto &tmp_pair : sorted_info_pairs(tree._M_type_var_infos, key_ident_map)) {
+        if(!_M_type_var_infos.insert(make_pair(tmp_pair.first, *(tmp_pair.second))).second)
+          skipped_key_idents.insert(tmp_pair.first);
+      }
+      for(auto &tmp_pair : sorted_info_pairs(tree._M_type_fun_infos, key_ident_map)) {
+        auto result = _M_type_fun_infos.insert(make_pair(tmp_pair.first, *(tmp_pair.second)));
+        if(!result.second) {
+          for(auto &inst : *(tmp_pair.second->insts())) result.first->second.add_inst(inst);
+          skipped_key_idents.insert(tmp_pair.first);
+        }
+      }
+      for(auto key_ident : tree._M_uncompiled_var_key_idents)
+        _M_uncompiled_var_key_idents.push_back(key_ident_map.at(key_ident));
+      for(auto key_ident : tree._M_uncompiled_type_var_key_idents) {
+        KeyIdentifier new_key_ident = key_ident_map.at(key_ident);
+        if(skipped_key_idents.find(new_key_ident) == skipped_key_idents.end())
+          _M_uncompiled_type_var_key_idents.push_back(new_key_ident);
+      }
+      for(auto key_ident : tree._M_uncompiled_type_fun_key_idents) {
+        KeyIdentifier new_key_ident = key_ident_map.at(key_ident);
+        if(skipped_key_idents.find(new_key_ident) == skipped_key_idents.end())
+          _M_uncompiled_type_fun_key_idents.push_back(new_key_ident);
+      }
+      for(auto &pair : tree._M_uncompiled_inst_pairs)
+        _M_uncompiled_inst_pairs.push_back(InstancePair(key_ident_map.at(pair.key_ident), pair.inst));
+      for(auto &pair : tree._M_uncompiled_type_fun_inst_pairs)
+        _M_uncompiled_type_fun_inst_pairs.push_back(TypeFunctionInstancePair(key_ident_map.at(pair.key_ident), pair.inst));
+      _M_defs.splice(_M_defs.end(), tree._M_defs);
+      tree._M_module_key_idents.clear();
+      tree._M_var_infos.clear();
+      tree._M_type_var_infos.clear();
+      tree._M_type_fun_infos.clear();
+      tree._M_uncompiled_var_key_idents.clear();
+      tree._M_uncompiled_type_var_key_idents.clear();
+      tree._M_uncompiled_type_fun_key_idents.clear();
+      tree._M_uncompiled_inst_pairs.clear();
+      tree._M_uncompiled_type_fun_inst_pairs.clear();
+      return true;
+    }
 
     //
     // A Definition class.
@@ -159,13 +443,13 @@ namespace lesfl
     // A DefinableVariable class.
     //
 
-    DefinableVariable::~DefinableVariable() {}
+    DefinableVariable::~DefinableVariable() { NodeListTeardown::defer(_M_type_expr); }
 
     //
     // An UserDefinedVariable class.
     //
 
-    UserDefinedVariable::~UserDefinedVariable() {}
+    UserDefinedVariable::~UserDefinedVariable() { NodeListTeardown::defer(_M_value); }
 
     //
     // An ExternalVariable class.
@@ -237,7 +521,7 @@ namespace lesfl
     // A DefinableFunction class.
     //
 
-    DefinableFunction::~DefinableFunction() {}
+    DefinableFunction::~DefinableFunction() { NodeListTeardown::defer(_M_result_type_expr); }
 
     //
     // An UserDefinedFunction class.
@@ -267,7 +551,7 @@ namespace lesfl
     // An Argument class.
     //
 
-    Argument::~Argument() {}
+    Argument::~Argument() { NodeListTeardown::defer(_M_type_expr); }
 
     //
     // An Annotation class.
@@ -284,11 +568,23 @@ namespace lesfl
 
     Expression::~Expression() {}
 
+    //
+    // A DeferredBody class.
+    //
+
+    DeferredBody::~DeferredBody() {}
+
+    //
+    // A DeferredExpression class.
+    //
+
+    DeferredExpression::~DeferredExpression() {}
+
     //
     // A Literal class.
     //
 
-    Literal::~Literal() {}
+    Literal::~Literal() { NodeListTeardown::defer(_M_literal_value); }
 
     //
     // A Collection class.
@@ -354,7 +650,7 @@ namespace lesfl
     // An Application class.
     //
 
-    Application::~Application() {}
+    Application::~Application() { NodeListTeardown::defer(_M_fun); }
 
     //
     // A NonUniqueApplication class.
@@ -378,7 +674,7 @@ namespace lesfl
     // A FieldOperator class.
     //
 
-    FieldOperator::~FieldOperator() {}
+    FieldOperator::~FieldOperator() { NodeListTeardown::defer(_M_expr); }
 
     //
     // A Field class.
@@ -396,13 +692,13 @@ namespace lesfl
     // A SetUniqueField class.
     //
 
-    SetUniqueField::~SetUniqueField() {}
+    SetUniqueField::~SetUniqueField() { NodeListTeardown::defer(_M_value_expr); }
 
     //
     // A NamedFieldOperator class.
     //
 
-    NamedFieldOperator::~NamedFieldOperator() {}
+    NamedFieldOperator::~NamedFieldOperator() { NodeListTeardown::defer(_M_expr); }
 
     //
     // A NamedField class.
@@ -420,37 +716,41 @@ namespace lesfl
     // A SetUniqueField class.
     //
 
-    SetUniqueNamedField::~SetUniqueNamedField() {}
+    SetUniqueNamedField::~SetUniqueNamedField() { NodeListTeardown::defer(_M_value_expr); }
 
     //
     // A TypedExpression class.
     //
 
-    TypedExpression::~TypedExpression() {}
+    TypedExpression::~TypedExpression()
+    {
+      NodeListTeardown::defer(_M_expr);
+      NodeListTeardown::defer(_M_type_expr);
+    }
 
     //
     // A Let class.
     //
 
-    Let::~Let() {}
+    Let::~Let() { NodeListTeardown::defer(_M_expr); }
 
     //
     // A Match class.
     //
 
-    Match::~Match() {}
+    Match::~Match() { NodeListTeardown::defer(_M_expr); }
 
     //
     // A Throw class.
     //
 
-    Throw::~Throw() {}
+    Throw::~Throw() { NodeListTeardown::defer(_M_expr); }
 
     //
     // An ExpressionNamedFieldPair class.
     //
 
-    ExpressionNamedFieldPair::~ExpressionNamedFieldPair() {}
+    ExpressionNamedFieldPair::~ExpressionNamedFieldPair() { NodeListTeardown::defer(_M_expr); }
 
     //
     // A Binding class.
@@ -480,7 +780,11 @@ namespace lesfl
     // A Case class.
     //
 
-    Case::~Case() {}
+    Case::~Case()
+    {
+      NodeListTeardown::defer(_M_pattern);
+      NodeListTeardown::defer(_M_expr);
+    }
 
     //
     // A Pattern class.
@@ -570,7 +874,7 @@ namespace lesfl
     // A LiteralPattern class.
     //
 
-    LiteralPattern::~LiteralPattern() {}
+    LiteralPattern::~LiteralPattern() { NodeListTeardown::defer(_M_literal_value); }
 
     //
     // A VariablePattern class.
@@ -582,7 +886,7 @@ namespace lesfl
     // An AsPattern class.
     //
 
-    AsPattern::~AsPattern() {}
+    AsPattern::~AsPattern() { NodeListTeardown::defer(_M_pattern); }
 
     //
     // A WildcardPattern class.
@@ -594,13 +898,17 @@ namespace lesfl
     // A TypedPattern class.
     //
 
-    TypedPattern::~TypedPattern() {}
+    TypedPattern::~TypedPattern()
+    {
+      NodeListTeardown::defer(_M_pattern);
+      NodeListTeardown::defer(_M_type_expr);
+    }
 
     //
     // A PatternNamedFieldPair class.
     //
 
-    PatternNamedFieldPair::~PatternNamedFieldPair() {}
+    PatternNamedFieldPair::~PatternNamedFieldPair() { NodeListTeardown::defer(_M_pattern); }
 
     //
     // A LiteralValue class.
@@ -660,7 +968,7 @@ namespace lesfl
     // A LambdaValue class.
     //
 
-    LambdaValue::~LambdaValue() {}
+    LambdaValue::~LambdaValue() { NodeListTeardown::defer(_M_result_type_expr); }
 
     //
     // A NonUniqueLambdaValue class.
@@ -684,7 +992,7 @@ namespace lesfl
     // A VariableLiteralValue class.
     //
 
-    VariableLiteralValue::~VariableLiteralValue() {}
+    VariableLiteralValue::~VariableLiteralValue() { NodeListTeardown::defer(_M_literal_value); }
 
     //
     // A CollectionValue class.
@@ -704,6 +1012,127 @@ namespace lesfl
 
     ArrayValue::~ArrayValue() {}
 
+    //
+    // A PackedElements class.
+    //
+
+    size_t PackedElements::elem_size(PackedElementType elem_type)
+    {
+      switch(elem_type) {
+        case PackedElementType::CHAR:
+          return sizeof(char);
+        case PackedElementType::INT8:
+          return sizeof(int8_t);
+        case PackedElementType::INT16:
+          return sizeof(int16_t);
+        case PackedElementType::INT32:
+          return sizeof(int32_t);
+        case PackedElementType::INT64:
+          return sizeof(int64_t);
+        case PackedElementType::SINGLE_FLOAT:
+          return sizeof(float);
+        default:
+          return sizeof(double);
+      }
+    }
+
+    char PackedElements::char_elem(size_t i) const
+    { return get_packed_elem<char>(_M_data, i); }
+
+    int64_t PackedElements::int_elem(size_t i) const
+    {
+      switch(_M_elem_type) {
+        case PackedElementType::INT8:
+          return get_packed_elem<int8_t>(_M_data, i);
+        case PackedElementType::INT16:
+          return get_packed_elem<int16_t>(_M_data, i);
+        case PackedElementType::INT32:
+          return get_packed_elem<int32_t>(_M_data, i);
+        default:
+          return get_packed_elem<int64_t>(_M_data, i);
+      }
+    }
+
+    double PackedElements::float_elem(size_t i) const
+    {
+      if(_M_elem_type == PackedElementType::SINGLE_FLOAT)
+        return get_packed_elem<float>(_M_data, i);
+      else
+        return get_packed_elem<double>(_M_data, i);
+    }
+
+    void PackedElements::add_char_elem(char c)
+    {
+      add_packed_elem(_M_data, c);
+      _M_elem_count++;
+    }
+
+    void PackedElements::add_int_elem(int64_t i)
+    {
+      switch(_M_elem_type) {
+        case PackedElementType::INT8:
+          add_packed_elem(_M_data, static_cast<int8_t>(i));
+          break;
+        case PackedElementType::INT16:
+          add_packed_elem(_M_data, static_cast<int16_t>(i));
+          break;
+        case PackedElementType::INT32:
+          add_packed_elem(_M_data, static_cast<int32_t>(i));
+          break;
+        default:
+          add_packed_elem(_M_data, i);
+          break;
+      }
+      _M_elem_count++;
+    }
+
+    void PackedElements::add_float_elem(double f)
+    {
+      if(_M_elem_type == PackedElementType::SINGLE_FLOAT)
+        add_packed_elem(_M_data, static_cast<float>(f));
+      else
+        add_packed_elem(_M_data, f);
+      _M_elem_count++;
+    }
+
+    SimpleLiteralValue *PackedElements::make_literal_value(size_t i) const
+    {
+      switch(_M_elem_type) {
+        case PackedElementType::CHAR:
+          return new CharValue(char_elem(i));
+        case PackedElementType::INT8:
+          return new IntValue(IntType::INT8, int_elem(i));
+        case PackedElementType::INT16:
+          return new IntValue(IntType::INT16, int_elem(i));
+        case PackedElementType::INT32:
+          return new IntValue(IntType::INT32, int_elem(i));
+        case PackedElementType::INT64:
+          return new IntValue(IntType::INT64, int_elem(i));
+        case PackedElementType::SINGLE_FLOAT:
+          return new FloatValue(FloatType::SINGLE, float_elem(i));
+        default:
+          return new FloatValue(FloatType::DOUBLE, float_elem(i));
+      }
+    }
+
+    //
+    // A PackedCollectionValue class.
+    //
+
+    PackedCollectionValue::~PackedCollectionValue() {}
+
+    //
+    // A PackedListValue class.
+    //
+
+    PackedListValue::~PackedListValue() {}
+
+    //
+    // A PackedArrayValue class.
+    //
+
+    PackedArrayValue::~PackedArrayValue() {}
+
     //
     // A TupleValue class.
     //
@@ -744,13 +1173,17 @@ namespace lesfl
     // A TypedValue class.
     //
 
-    TypedValue::~TypedValue() {}
+    TypedValue::~TypedValue()
+    {
+      NodeListTeardown::defer(_M_value);
+      NodeListTeardown::defer(_M_type_expr);
+    }
 
     //
     // A ValueNamedFieldPair class.
     //
 
-    ValueNamedFieldPair::~ValueNamedFieldPair() {}
+    ValueNamedFieldPair::~ValueNamedFieldPair() { NodeListTeardown::defer(_M_value); }
 
     //
     // A TypeVariable class.
@@ -768,7 +1201,7 @@ namespace lesfl
     // A TypeSynonymVariable class.
     //
 
-    TypeSynonymVariable::~TypeSynonymVariable() {}
+    TypeSynonymVariable::~TypeSynonymVariable() { NodeListTeardown::defer(_M_expr); }
 
     //
     // A DatatypeVariable class.
@@ -798,7 +1231,7 @@ namespace lesfl
     // A TypeSynonymFunction class.
     //
 
-    TypeSynonymFunction::~TypeSynonymFunction() {}
+    TypeSynonymFunction::~TypeSynonymFunction() { NodeListTeardown::defer(_M_body); }
 
     //
     // A DatatypeFunction class.
@@ -822,7 +1255,7 @@ namespace lesfl
     // A TypeSynonymFunctionInstance class.
     //
 
-    TypeSynonymFunctionInstance::~TypeSynonymFunctionInstance() {}
+    TypeSynonymFunctionInstance::~TypeSynonymFunctionInstance() { NodeListTeardown::defer(_M_body); }
 
     //
     // A DatatypeFunctionInstance class.
@@ -898,7 +1331,7 @@ namespace lesfl
     // A TypeNamedFieldPair class.
     //
 
-    TypeNamedFieldPair::~TypeNamedFieldPair() {}
+    TypeNamedFieldPair::~TypeNamedFieldPair() { NodeListTeardown::defer(_M_type_expr); }
 
     //
     // A TypeExpression class.
@@ -910,7 +1343,11 @@ namespace lesfl
     // A TypeExpression class.
     //
 
-    With::~With() {}
+    With::~With()
+    {
+      NodeListTeardown::defer(_M_type1);
+      NodeListTeardown::defer(_M_type2);
+    }
 
     //
     // A TypeVariableExpression class.
@@ -946,7 +1383,7 @@ namespace lesfl
     // A FunctionType class.
     //
 
-    FunctionType::~FunctionType() {}
+    FunctionType::~FunctionType() { NodeListTeardown::defer(_M_result_type); }
 
     //
     // A NonUniqueFunctionType class.
@@ -8,7 +8,11 @@
 #ifndef _LESFL_COMP_HPP
 #define _LESFL_COMP_HPP
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <letin/comp.hpp>
 
 namespace lesfl
@@ -22,11 +26,36 @@ namespace lesfl
 
   class Interface
   {
-    int _M_x;
+    std::unordered_map<std::string, std::uint64_t> _M_module_fingerprints;
   public:
     Interface() {}
 
     virtual ~Interface();
+
+    const std::unordered_map<std::string, std::uint64_t> &module_fingerprints() const
+    { return _M_module_fingerprints; }
+
+    bool module_fingerprint(const std::string &module_ident, std::uint64_t &fingerprint) const
+    {
+      auto iter = _M_module_fingerprints.find(module_ident);
+      if(iter == _M_module_fingerprints.end()) return false;
+      fingerprint = iter->second;
+      return true;
+    }
+
+    void set_module_fingerprint(const std::string &module_ident, std::uint64_t fingerprint)
+    { _M_module_fingerprints[module_ident] = fingerprint; }
+
+    bool has_same_module_fingerprints(const Interface &iface, const std::vector<std::string> &module_idents) const
+    {
+      for(auto &module_ident : module_idents) {
+        std::uint64_t fingerprint1, fingerprint2;
+        if(!module_fingerprint(module_ident, fingerprint1)) return false;
+        if(!iface.module_fingerprint(module_ident, fingerprint2)) return false;
+        if(fingerprint1 != fingerprint2) return false;
+      }
+      return true;
+    }
   };
 
   class Program
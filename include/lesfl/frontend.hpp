@@ -8,6 +8,17 @@
 #ifndef _LESFL_FRONTEND_HPP
 #define _LESFL_FRONTEND_HPP
 
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <lesfl/frontend/diagnostic.hpp>
+#include <lesfl/frontend/frozen_tree.hpp>
+#include <lesfl/frontend/module_graph.hpp>
+#include <lesfl/frontend/parse_profile.hpp>
+#include <lesfl/frontend/position_index.hpp>
+#include <lesfl/frontend/ref_index.hpp>
+#include <lesfl/frontend/scanned_source.hpp>
+#include <lesfl/frontend/stats.hpp>
 #include <lesfl/frontend/tree.hpp>
 #include <lesfl/comp.hpp>
 
@@ -15,37 +26,147 @@ namespace lesfl
 {
   namespace frontend
   {
+    // A FrontendOptions object points to objects that are filled out by the
+    // parser, the builtin type adder, and the resolver. A null pointer turns
+    // off the corresponding object, and each entry point ignores the objects
+    // that it doesn't fill out.
+    struct FrontendOptions
+    {
+      FrontendStats *stats;
+      ParseProfile *profile;
+      ReferenceIndex *ref_index;
+
+      FrontendOptions() : stats(nullptr), profile(nullptr), ref_index(nullptr) {}
+    };
+
     class Parser
     {
+      bool _M_is_deferred_parsing;
+
+      bool parse_sources(const std::vector<Source> &sources, Tree *tree, const std::function<void (std::unique_ptr<Definition>)> &def_fun, std::list<Error> &errors, const FrontendOptions &options);
     public:
-      Parser() {}
+      Parser(bool is_deferred_parsing = false) : _M_is_deferred_parsing(is_deferred_parsing) {}
 
       virtual ~Parser();
 
-      bool parse(const std::vector<Source> &sources, Tree &tree, std::list<Error> &errors);
+      bool is_deferred_parsing() const { return _M_is_deferred_parsing; }
+
+      bool parse(const std::vector<Source> &sources, Tree &tree, std::list<Error> &errors, const FrontendOptions &options = FrontendOptions());
+
+      bool parse(const Source &source, Tree &tree, std::list<Error> &errors, const FrontendOptions &options = FrontendOptions())
+      { return parse(std::vector<Source> { source }, tree, errors, options); }
 
-      bool parse(const Source &source, Tree &tree, std::list<Error> &errors)
-      { return parse(std::vector<Source> { source }, tree, errors); }
+      bool parse_defs(const std::vector<Source> &sources, const std::function<void (std::unique_ptr<Definition>)> &fun, std::list<Error> &errors, const FrontendOptions &options = FrontendOptions());
+
+      bool parse_defs(const Source &source, const std::function<void (std::unique_ptr<Definition>)> &fun, std::list<Error> &errors, const FrontendOptions &options = FrontendOptions())
+      { return parse_defs(std::vector<Source> { source }, fun, errors, options); }
     };
 
     class BuiltinTypeAdder
     {
+      bool add_types(Tree &tree);
     public:
       BuiltinTypeAdder() {}
 
       virtual ~BuiltinTypeAdder();
       
-      bool add_builtin_types(Tree &tree);
+      bool add_builtin_types(Tree &tree, const FrontendOptions &options = FrontendOptions());
     };
     
     class Resolver
     {
+      bool resolve_tree(Tree &tree, DiagnosticList &diags, const FrontendOptions &options);
     public:
       Resolver() {}
 
       virtual ~Resolver();
 
-      bool resolve(Tree &tree, std::list<Error> &errors);
+      bool resolve(Tree &tree, std::list<Error> &errors, const FrontendOptions &options = FrontendOptions());
+
+      bool resolve(Tree &tree, DiagnosticList &diags, const FrontendOptions &options = FrontendOptions());
+    };
+
+    class KeyIdentifierRenumberer
+    {
+    public:
+      KeyIdentifierRenumberer() {}
+
+      virtual ~KeyIdentifierRenumberer();
+
+      bool renumber(Tree &tree)
+      {
+        std::unordered_map<KeyIdentifier, KeyIdentifier> key_ident_map;
+        return renumber(tree, key_ident_map);
+      }
+
+      bool renumber(Tree &tree, std::unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map);
+    };
+
+    class Fingerprinter
+    {
+    public:
+      Fingerprinter() {}
+
+      virtual ~Fingerprinter();
+
+      bool fingerprint_modules(const Tree &tree, std::unordered_map<KeyIdentifier, std::uint64_t> &fingerprints);
+
+      bool fingerprint_modules(const Tree &tree, Interface &iface);
+    };
+
+    class Freezer
+    {
+    public:
+      Freezer() {}
+
+      virtual ~Freezer();
+
+      bool freeze(const Tree &tree, FrozenTree &frozen_tree, std::list<Error> &errors);
+    };
+
+    class MemoryReporter
+    {
+    public:
+      MemoryReporter() {}
+
+      virtual ~MemoryReporter();
+
+      bool report_memory(const Tree &tree, MemoryReport &report);
+    };
+
+    class ModuleGraphBuilder
+    {
+    public:
+      ModuleGraphBuilder() {}
+
+      virtual ~ModuleGraphBuilder();
+
+      bool build_module_graph(Tree &tree, ModuleGraph &graph, std::list<Error> &errors);
+    };
+
+    class PositionIndexBuilder
+    {
+    public:
+      PositionIndexBuilder() {}
+
+      virtual ~PositionIndexBuilder();
+
+      bool build_position_index(const Tree &tree, PositionIndex &index);
+    };
+
+    class ImportScanner
+    {
+    public:
+      ImportScanner() {}
+
+      virtual ~ImportScanner();
+
+      bool scan(const Source &source, ScannedSource &scanned_source, std::list<Error> &errors);
+
+      bool write_depfile(std::ostream &os, const std::string &target, const std::vector<Source> &sources, const std::vector<Source> &search_sources, std::list<Error> &errors);
+
+      bool write_depfile(std::ostream &os, const std::string &target, const std::vector<Source> &sources, std::list<Error> &errors)
+      { return write_depfile(os, target, sources, sources, errors); }
     };
   }
 }
@@ -0,0 +1,128 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_DIAGNOSTIC_HPP
+#define _LESFL_FRONTEND_DIAGNOSTIC_HPP
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <lesfl/frontend/ident.hpp>
+#include <lesfl/comp.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    enum class DiagnosticCode
+    {
+      MESSAGE,                          // formatted message
+      VARIABLE_IS_ALREADY_DEFINED,      // key identifier
+      TYPE_IS_ALREADY_DEFINED,          // key identifier
+      TYPE_TEMPLATE_IS_ALREADY_DEFINED, // key identifier
+      MODULE_IS_PRIVATE,                // key identifier
+      MODULE_IS_UNDEFINED,              // identifier
+      VARIABLE_IS_PRIVATE,              // key identifier
+      VARIABLE_IS_UNDEFINED,            // identifier
+      TYPE_IS_PRIVATE,                  // key identifier
+      TYPE_IS_UNDEFINED,                // identifier
+      TYPE_TEMPLATE_IS_PRIVATE,         // key identifier
+      TYPE_TEMPLATE_IS_UNDEFINED,       // identifier
+      ALIAS_REFERS_TO_UNDEFINED_VARIABLE, // key identifier
+      ALIAS_REFERS_TO_ALIAS_CYCLE       // key identifier
+    };
+
+    // A Diagnostic object has copies of a position and an identifier, so it
+    // can outlive the tree. A message of a diagnostic with a key identifier
+    // is formatted from the identifier table of the tree. A diagnostic with
+    // the MESSAGE code owns its error.
+    class Diagnostic
+    {
+      DiagnosticCode _M_code;
+      Position _M_pos;
+      KeyIdentifier _M_key_ident;
+      std::shared_ptr<const Identifier> _M_ident;
+      std::shared_ptr<const Error> _M_error;
+    public:
+      Diagnostic(DiagnosticCode code, const Position &pos, KeyIdentifier key_ident) :
+        _M_code(code), _M_pos(pos), _M_key_ident(key_ident) {}
+
+      Diagnostic(DiagnosticCode code, const Position &pos, const Identifier *ident);
+
+      Diagnostic(const Error &error) :
+        _M_code(DiagnosticCode::MESSAGE), _M_pos(error.pos()), _M_error(new Error(error)) {}
+
+      DiagnosticCode code() const { return _M_code; }
+
+      const Position &pos() const { return _M_pos; }
+
+      KeyIdentifier key_ident() const { return _M_key_ident; }
+
+      const Identifier *ident() const { return _M_ident.get(); }
+
+      std::string msg(const AbsoluteIdentifierTable &table) const;
+
+      Error to_error(const AbsoluteIdentifierTable &table) const
+      { return Error(_M_pos, msg(table)); }
+    };
+
+    // A DiagnosticList object keeps at most the maximal number of
+    // diagnostics; further diagnostics are only counted. In the first-N mode,
+    // the resolver stops after the maximal number of diagnostics.
+    class DiagnosticList
+    {
+    public:
+      static const std::size_t unlimited = static_cast<std::size_t>(-1);
+    private:
+      std::vector<Diagnostic> _M_diags;
+      std::size_t _M_max_count;
+      bool _M_is_first_n_mode;
+      std::size_t _M_omitted_count;
+    public:
+      DiagnosticList(std::size_t max_count = unlimited, bool is_first_n_mode = false) :
+        _M_max_count(max_count), _M_is_first_n_mode(is_first_n_mode), _M_omitted_count(0) {}
+
+      const std::vector<Diagnostic> &diags() const { return _M_diags; }
+
+      bool empty() const { return _M_diags.empty(); }
+
+      std::size_t size() const { return _M_diags.size(); }
+
+      std::size_t max_count() const { return _M_max_count; }
+
+      bool is_first_n_mode() const { return _M_is_first_n_mode; }
+
+      std::size_t omitted_count() const { return _M_omitted_count; }
+
+      bool is_full() const { return _M_diags.size() >= _M_max_count; }
+
+      bool must_stop() const { return _M_is_first_n_mode && is_full(); }
+
+      void add(const Diagnostic &diag)
+      {
+        if(!is_full())
+          _M_diags.push_back(diag);
+        else
+          _M_omitted_count++;
+      }
+
+      void push_back(const Error &error) { add(Diagnostic(error)); }
+
+      void clear()
+      {
+        _M_diags.clear();
+        _M_omitted_count = 0;
+      }
+
+      void append_errors(std::list<Error> &errors, const AbsoluteIdentifierTable &table) const;
+    };
+  }
+}
+
+#endif
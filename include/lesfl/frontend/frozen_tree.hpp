@@ -0,0 +1,253 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_FROZEN_TREE_HPP
+#define _LESFL_FRONTEND_FROZEN_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <lesfl/frontend/ident.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    // Children are listed in brackets. A child can be FrozenTree::null_node
+    // for an absent optional node. Flags and data are zero if they aren't
+    // listed.
+    enum class FrozenNodeKind : std::uint8_t
+    {
+      // Definitions: data = 1 + number of instance type parameters for a
+      // template, otherwise 0.
+      VARIABLE,                         // [type_expr, value]
+      VARIABLE_INSTANCE,                // [type_expr, value]
+      FUNCTION,                         // [args..., result_type_expr, body]; flags = inline modifier | function modifier << 4
+      FUNCTION_INSTANCE,                // [args..., result_type_expr, body]; flags = inline modifier | function modifier << 4
+      ARGUMENT,                         // [type_expr]; data = local variable index
+      // Type definitions: data = number of type arguments | number of instance
+      // type parameters << 32 for a type function.
+      TYPE_SYNONYM_VARIABLE,            // [expr]
+      DATATYPE_VARIABLE,                // [datatype]
+      TYPE_SYNONYM_FUNCTION,            // [body]
+      DATATYPE_FUNCTION,                // [datatype]
+      TYPE_SYNONYM_FUNCTION_INSTANCE,   // [args..., body]; flags = 1 for a template
+      DATATYPE_FUNCTION_INSTANCE,       // [args..., datatype]; flags = 1 for a template
+      NON_UNIQUE_DATATYPE,              // [constrs...]
+      UNIQUE_DATATYPE,                  // [constrs...]
+      VARIABLE_CONSTRUCTOR,             // data = key identifier
+      UNNAMED_FIELD_CONSTRUCTOR,        // [field_types...]; flags = inline modifier, data = key identifier
+      NAMED_FIELD_CONSTRUCTOR,          // [TYPE_NAMED_FIELD...]; flags = inline modifier, data = key identifier
+      TYPE_NAMED_FIELD,                 // [type_expr]; data = string index
+      // Expressions.
+      LIST,                             // [elems...]
+      NON_UNIQUE_ARRAY,                 // [elems...]
+      UNIQUE_ARRAY,                     // [elems...]
+      NON_UNIQUE_TUPLE,                 // [fields...]
+      UNIQUE_TUPLE,                     // [fields...]
+      GLOBAL_VARIABLE,                  // data = key identifier
+      LOCAL_VARIABLE,                   // data = local variable index
+      NAMED_FIELD_CONSTRUCTOR_APPLICATION, // [EXPRESSION_NAMED_FIELD...]; data = key identifier
+      EXPRESSION_NAMED_FIELD,           // [expr]; data = field index
+      NON_UNIQUE_APPLICATION,           // [fun, args...]; flags = function modifier
+      UNIQUE_APPLICATION,               // [fun, args...]
+      BUILTIN_APPLICATION,              // [args...]; data = builtin function
+      FIELD,                            // [expr]; data = field index
+      UNIQUE_FIELD,                     // [expr]; data = field index
+      SET_UNIQUE_FIELD,                 // [expr, value_expr]; data = field index
+      NAMED_FIELD,                      // [expr]; data = string index
+      UNIQUE_NAMED_FIELD,               // [expr]; data = string index
+      SET_UNIQUE_NAMED_FIELD,           // [expr, value_expr]; data = string index
+      TYPED_EXPRESSION,                 // [expr, type_expr]
+      LET,                              // [binds..., expr]
+      VARIABLE_BINDING,                 // [expr]; data = local variable index
+      TUPLE_BINDING,                    // [TUPLE_BINDING_VARIABLE..., expr]
+      TUPLE_BINDING_VARIABLE,           // data = local variable index
+      MATCH,                            // [expr, CASE...]
+      CASE,                             // [pattern, expr]
+      THROW,                            // [expr]
+      // Literals of expressions, patterns and values.
+      CHAR,                             // data = character
+      WIDE_CHAR,                        // data = character
+      INT,                              // flags = integer type, data = integer
+      FLOAT,                            // flags = floating-point type, data = bits of double
+      STRING,                           // data = string index
+      WIDE_STRING,                      // data = wide string index
+      NON_UNIQUE_LAMBDA,                // [args..., result_type_expr, body]; flags = inline modifier | function modifier << 4
+      UNIQUE_LAMBDA,                    // [args..., result_type_expr, body]; flags = inline modifier
+      // Patterns.
+      VARIABLE_CONSTRUCTOR_PATTERN,     // data = key identifier
+      UNNAMED_FIELD_CONSTRUCTOR_PATTERN, // [field_patterns...]; data = key identifier
+      NAMED_FIELD_CONSTRUCTOR_PATTERN,  // [PATTERN_NAMED_FIELD...]; data = key identifier
+      PATTERN_NAMED_FIELD,              // [pattern]; data = field index
+      LIST_PATTERN,                     // [elem_patterns...]
+      NON_UNIQUE_ARRAY_PATTERN,         // [elem_patterns...]
+      UNIQUE_ARRAY_PATTERN,             // [elem_patterns...]
+      NON_UNIQUE_TUPLE_PATTERN,         // [field_patterns...]
+      UNIQUE_TUPLE_PATTERN,             // [field_patterns...]
+      VARIABLE_PATTERN,                 // data = local variable index
+      AS_PATTERN,                       // [pattern]; data = local variable index
+      WILDCARD_PATTERN,
+      TYPED_PATTERN,                    // [pattern, type_expr]
+      // Values.
+      LIST_VALUE,                       // [elems...]
+      ARRAY_VALUE,                      // [elems...]
+      PACKED_LIST_VALUE,                // flags = packed element type, data = packed elements index
+      PACKED_ARRAY_VALUE,               // flags = packed element type, data = packed elements index
+      TUPLE_VALUE,                      // [fields...]
+      VARIABLE_CONSTRUCTOR_VALUE,       // data = key identifier
+      UNNAMED_FIELD_CONSTRUCTOR_VALUE,  // [fields...]; data = key identifier
+      NAMED_FIELD_CONSTRUCTOR_VALUE,    // [VALUE_NAMED_FIELD...]; data = key identifier
+      VALUE_NAMED_FIELD,                // [value]; data = field index
+      TYPED_VALUE,                      // [value, type_expr]
+      // Type expressions.
+      WITH,                             // [type_expr1, type_expr2]
+      TYPE_VARIABLE,                    // data = key identifier
+      TYPE_PARAMETER,                   // data = type parameter index
+      NON_UNIQUE_TUPLE_TYPE,            // [field_types...]
+      UNIQUE_TUPLE_TYPE,                // [field_types...]
+      NON_UNIQUE_FUNCTION_TYPE,         // [arg_types..., result_type]; flags = function modifier
+      UNIQUE_FUNCTION_TYPE,             // [arg_types..., result_type]
+      TYPE_APPLICATION                  // [args...]; data = key identifier
+    };
+
+    // A FrozenTree object stores all nodes in one table of columns, and the
+    // kind column tags each node. The table isn't split per kind, because a
+    // child of most nodes can have any kind of its category. A child of split
+    // tables would be a pair of a kind and an index instead of one 32-bit
+    // node number. One node numbering also gives one array of children and
+    // one table of positions, and a reader visits nodes in the order in which
+    // the freezer has added them. The flags and data columns have unused
+    // entries for the kinds without flags and data.
+    class FrozenTree
+    {
+    public:
+      static const std::uint32_t null_node = 0xffffffff;
+    private:
+      std::vector<FrozenNodeKind> _M_kinds;
+      std::vector<std::uint8_t> _M_flags;
+      std::vector<std::uint64_t> _M_data;
+      std::vector<std::uint32_t> _M_first_child_indices;
+      std::vector<std::uint32_t> _M_child_counts;
+      std::vector<std::uint32_t> _M_source_string_indices;
+      std::vector<std::uint32_t> _M_lines;
+      std::vector<std::uint32_t> _M_columns;
+      std::vector<std::uint32_t> _M_children;
+      std::vector<std::uint64_t> _M_def_key_idents;
+      std::vector<std::uint32_t> _M_def_nodes;
+      std::vector<std::uint64_t> _M_type_def_key_idents;
+      std::vector<std::uint32_t> _M_type_def_nodes;
+      std::vector<std::uint64_t> _M_ident_key_idents;
+      std::vector<std::uint32_t> _M_ident_offsets;
+      std::vector<std::uint32_t> _M_ident_string_indices;
+      std::vector<std::uint32_t> _M_string_offsets;
+      std::vector<char> _M_string_chars;
+      std::vector<std::uint32_t> _M_wstring_offsets;
+      std::vector<std::uint32_t> _M_wstring_chars;
+      std::vector<std::uint32_t> _M_packed_elem_offsets;
+      std::vector<std::uint32_t> _M_packed_elem_counts;
+      std::vector<char> _M_packed_elem_data;
+    public:
+      FrozenTree() { clear(); }
+
+      virtual ~FrozenTree();
+
+      std::size_t node_count() const { return _M_kinds.size(); }
+
+      FrozenNodeKind kind(std::uint32_t node) const { return _M_kinds[node]; }
+
+      std::uint8_t flags(std::uint32_t node) const { return _M_flags[node]; }
+
+      std::uint64_t data(std::uint32_t node) const { return _M_data[node]; }
+
+      std::uint32_t child_count(std::uint32_t node) const { return _M_child_counts[node]; }
+
+      std::uint32_t child(std::uint32_t node, std::uint32_t i) const
+      { return _M_children[_M_first_child_indices[node] + i]; }
+
+      const std::uint32_t *children(std::uint32_t node) const
+      { return _M_children.data() + _M_first_child_indices[node]; }
+
+      std::string source_file_name(std::uint32_t node) const
+      { return string(_M_source_string_indices[node]); }
+
+      std::uint32_t line(std::uint32_t node) const { return _M_lines[node]; }
+
+      std::uint32_t column(std::uint32_t node) const { return _M_columns[node]; }
+
+      std::size_t def_count() const { return _M_def_nodes.size(); }
+
+      KeyIdentifier def_key_ident(std::size_t i) const { return KeyIdentifier(_M_def_key_idents[i]); }
+
+      std::uint32_t def_node(std::size_t i) const { return _M_def_nodes[i]; }
+
+      std::size_t type_def_count() const { return _M_type_def_nodes.size(); }
+
+      KeyIdentifier type_def_key_ident(std::size_t i) const { return KeyIdentifier(_M_type_def_key_idents[i]); }
+
+      std::uint32_t type_def_node(std::size_t i) const { return _M_type_def_nodes[i]; }
+
+      // Absolute identifiers are sorted by key identifiers.
+      std::size_t ident_count() const { return _M_ident_key_idents.size(); }
+
+      KeyIdentifier ident_key_ident(std::size_t i) const { return KeyIdentifier(_M_ident_key_idents[i]); }
+
+      AbsoluteIdentifier ident(std::size_t i) const;
+
+      bool find_ident(KeyIdentifier key_ident, AbsoluteIdentifier &ident) const;
+
+      std::size_t string_count() const { return _M_string_offsets.size() - 1; }
+
+      std::string string(std::uint32_t i) const
+      { return std::string(_M_string_chars.data() + _M_string_offsets[i], _M_string_offsets[i + 1] - _M_string_offsets[i]); }
+
+      std::size_t wstring_count() const { return _M_wstring_offsets.size() - 1; }
+
+      std::wstring wstring(std::uint32_t i) const;
+
+      std::size_t packed_elems_count() const { return _M_packed_elem_offsets.size(); }
+
+      std::uint32_t packed_elem_count(std::uint32_t i) const { return _M_packed_elem_counts[i]; }
+
+      const char *packed_elem_data(std::uint32_t i) const
+      { return _M_packed_elem_data.data() + _M_packed_elem_offsets[i]; }
+
+      std::uint32_t add_node(FrozenNodeKind kind, std::uint8_t flags, std::uint64_t data, const std::uint32_t *children, std::uint32_t child_count, std::uint32_t source_string_index, std::uint32_t line, std::uint32_t column);
+
+      void add_def(KeyIdentifier key_ident, std::uint32_t node)
+      {
+        _M_def_key_idents.push_back(key_ident.key());
+        _M_def_nodes.push_back(node);
+      }
+
+      void add_type_def(KeyIdentifier key_ident, std::uint32_t node)
+      {
+        _M_type_def_key_idents.push_back(key_ident.key());
+        _M_type_def_nodes.push_back(node);
+      }
+
+      void add_ident(KeyIdentifier key_ident, const std::uint32_t *string_indices, std::uint32_t string_index_count);
+
+      std::uint32_t add_string(const std::string &str);
+
+      std::uint32_t add_wstring(const std::wstring &str);
+
+      std::uint32_t add_packed_elems(const char *data, std::size_t size, std::uint32_t elem_count);
+
+      void clear();
+
+      void write(std::ostream &os) const;
+
+      bool read(std::istream &is);
+    };
+  }
+}
+
+#endif
@@ -217,9 +217,19 @@ namespace lesfl
 
       const AbsoluteIdentifier *ident(const AbsoluteIdentifier *orig_ident) const; 
 
+      const std::unordered_map<KeyIdentifier, std::unique_ptr<const AbsoluteIdentifier>> &ident_map() const
+      { return _M_ident_map; }
+
+      std::size_t ident_set_bucket_count() const { return _M_ident_set.bucket_count(); }
+
       bool add_ident(AbsoluteIdentifier *ident, KeyIdentifier &key_ident);
 
       bool add_ident_or_get_key_ident(AbsoluteIdentifier *ident, KeyIdentifier &key_ident, bool &is_added);
+
+      // Renumbers the key identifiers in the lexicographic order of the
+      // absolute identifiers and returns a map from the old key identifiers
+      // to the new key identifiers.
+      void renumber_idents(std::unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map);
     };
 
     inline const AbsoluteIdentifier *Identifier::abs_ident(const AbsoluteIdentifierTable &table) const
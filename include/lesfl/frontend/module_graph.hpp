@@ -0,0 +1,79 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_MODULE_GRAPH_HPP
+#define _LESFL_FRONTEND_MODULE_GRAPH_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <lesfl/frontend/ident.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    class ModuleComponent
+    {
+      std::vector<KeyIdentifier> _M_module_key_idents;
+      std::vector<std::size_t> _M_dep_indices;
+      std::size_t _M_level;
+      bool _M_is_cycle;
+    public:
+      ModuleComponent(const std::vector<KeyIdentifier> &module_key_idents, const std::vector<std::size_t> &dep_indices, std::size_t level, bool is_cycle) :
+        _M_module_key_idents(module_key_idents), _M_dep_indices(dep_indices), _M_level(level), _M_is_cycle(is_cycle) {}
+
+      const std::vector<KeyIdentifier> &module_key_idents() const { return _M_module_key_idents; }
+
+      const std::vector<std::size_t> &dep_indices() const { return _M_dep_indices; }
+
+      std::size_t level() const { return _M_level; }
+
+      bool is_cycle() const { return _M_is_cycle; }
+    };
+
+    class ModuleGraph
+    {
+      std::unordered_map<KeyIdentifier, std::unordered_set<KeyIdentifier>> _M_deps;
+    public:
+      ModuleGraph() {}
+
+      virtual ~ModuleGraph();
+
+      const std::unordered_map<KeyIdentifier, std::unordered_set<KeyIdentifier>> &deps() const
+      { return _M_deps; }
+
+      const std::unordered_set<KeyIdentifier> *module_deps(KeyIdentifier key_ident) const
+      {
+        auto iter = _M_deps.find(key_ident);
+        return iter != _M_deps.end() ? &(iter->second) : nullptr;
+      }
+
+      bool has_module(KeyIdentifier key_ident) const
+      { return _M_deps.find(key_ident) != _M_deps.end(); }
+
+      bool add_module(KeyIdentifier key_ident)
+      { return _M_deps.insert(std::make_pair(key_ident, std::unordered_set<KeyIdentifier>())).second; }
+
+      bool add_dep(KeyIdentifier key_ident, KeyIdentifier dep_key_ident);
+
+      void clear() { _M_deps.clear(); }
+
+      void components(std::vector<std::vector<KeyIdentifier>> &comps) const;
+
+      void cycles(std::vector<std::vector<KeyIdentifier>> &cycles) const;
+
+      bool has_cycles() const;
+
+      void schedule(std::vector<ModuleComponent> &comps) const;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,214 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_NODE_LIST_HPP
+#define _LESFL_FRONTEND_NODE_LIST_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    // A NodeListTeardown object defers destruction of nodes from node lists
+    // and of single child nodes while it is alive. Deferred nodes are
+    // destroyed by the destructor of the first NodeListTeardown object in a
+    // loop instead of recursion, so destruction of very deep trees doesn't
+    // overflow the call stack.
+    class NodeListTeardown
+    {
+      static thread_local NodeListTeardown *_S_current;
+      std::vector<std::pair<void *, void (*)(void *)>> _M_nodes;
+      bool _M_is_active;
+
+      template<typename _T>
+      static void delete_node(void *node)
+      { delete static_cast<_T *>(node); }
+    public:
+      NodeListTeardown() : _M_is_active(_S_current == nullptr)
+      { if(_M_is_active) _S_current = this; }
+
+      NodeListTeardown(const NodeListTeardown &) = delete;
+
+      ~NodeListTeardown()
+      {
+        if(_M_is_active) {
+          while(!_M_nodes.empty()) {
+            std::pair<void *, void (*)(void *)> node = _M_nodes.back();
+            _M_nodes.pop_back();
+            node.second(node.first);
+          }
+          _S_current = nullptr;
+        }
+      }
+
+      NodeListTeardown &operator=(const NodeListTeardown &) = delete;
+
+      template<typename _T>
+      static bool defer(std::unique_ptr<_T> &node)
+      {
+        if(_S_current == nullptr) return false;
+        if(node.get() != nullptr) {
+          _S_current->_M_nodes.push_back(std::make_pair(static_cast<void *>(node.get()), &delete_node<_T>));
+          node.release();
+        }
+        return true;
+      }
+    };
+
+    // A NodeList object stores first elements in inline slots. The inline
+    // slots have a pointer to heap elements after growth. Elements in the
+    // heap can have free slots at the front, so the push_front method is
+    // amortized constant like the push_back method.
+    template<typename _T, std::size_t _N = 4>
+    class NodeList
+    {
+      static_assert(_N > 0, "number of inline elements is zero");
+    public:
+      typedef std::unique_ptr<_T> value_type;
+      typedef std::unique_ptr<_T> &reference;
+      typedef const std::unique_ptr<_T> &const_reference;
+      typedef std::unique_ptr<_T> *iterator;
+      typedef const std::unique_ptr<_T> *const_iterator;
+      typedef std::size_t size_type;
+    private:
+      union Storage
+      {
+        std::unique_ptr<_T> inline_elems[_N];
+        std::unique_ptr<_T> *heap_elems;
+
+        Storage() : inline_elems() {}
+
+        ~Storage() {}
+      };
+
+      Storage _M_storage;
+      std::unique_ptr<_T> *_M_elems;
+      std::size_t _M_size;
+      std::size_t _M_capacity;
+
+      bool is_inline() const { return _M_capacity == _N; }
+
+      std::unique_ptr<_T> *storage_elems()
+      { return is_inline() ? _M_storage.inline_elems : _M_storage.heap_elems; }
+
+      void grow(std::size_t front_slot_count)
+      {
+        std::size_t new_capacity = _M_capacity * 2;
+        std::unique_ptr<_T> *new_elems = new std::unique_ptr<_T>[new_capacity];
+        for(std::size_t i = 0; i < _M_size; i++) new_elems[front_slot_count + i] = std::move(_M_elems[i]);
+        if(is_inline()) {
+          for(std::size_t i = 0; i < _N; i++) _M_storage.inline_elems[i].~value_type();
+        } else
+          delete [] _M_storage.heap_elems;
+        _M_storage.heap_elems = new_elems;
+        _M_elems = new_elems + front_slot_count;
+        _M_capacity = new_capacity;
+      }
+
+      void move_elems(std::size_t front_slot_count)
+      {
+        std::unique_ptr<_T> *new_elems = storage_elems() + front_slot_count;
+        if(new_elems < _M_elems) {
+          for(std::size_t i = 0; i < _M_size; i++) new_elems[i] = std::move(_M_elems[i]);
+        } else {
+          for(std::size_t i = _M_size; i > 0; i--) new_elems[i - 1] = std::move(_M_elems[i - 1]);
+        }
+        _M_elems = new_elems;
+      }
+
+      // The elements are moved instead of growth if more than half of slots
+      // are free, so each move is paid by the following pushes.
+      bool has_many_free_slots() const
+      { return _M_capacity - _M_size > _M_size; }
+    public:
+      NodeList() : _M_elems(_M_storage.inline_elems), _M_size(0), _M_capacity(_N) {}
+
+      NodeList(const NodeList &) = delete;
+
+      ~NodeList()
+      {
+        for(std::size_t i = 0; i < _M_size; i++) NodeListTeardown::defer(_M_elems[i]);
+        if(is_inline()) {
+          for(std::size_t i = 0; i < _N; i++) _M_storage.inline_elems[i].~value_type();
+        } else
+          delete [] _M_storage.heap_elems;
+      }
+
+      NodeList &operator=(const NodeList &) = delete;
+
+      bool empty() const { return _M_size == 0; }
+
+      std::size_t size() const { return _M_size; }
+
+      std::size_t capacity() const { return _M_capacity; }
+
+      iterator begin() { return _M_elems; }
+
+      const_iterator begin() const { return _M_elems; }
+
+      iterator end() { return _M_elems + _M_size; }
+
+      const_iterator end() const { return _M_elems + _M_size; }
+
+      reference front() { return _M_elems[0]; }
+
+      const_reference front() const { return _M_elems[0]; }
+
+      reference back() { return _M_elems[_M_size - 1]; }
+
+      const_reference back() const { return _M_elems[_M_size - 1]; }
+
+      reference operator[](std::size_t i) { return _M_elems[i]; }
+
+      const_reference operator[](std::size_t i) const { return _M_elems[i]; }
+
+      void push_back(std::unique_ptr<_T> &&elem)
+      {
+        if(static_cast<std::size_t>(_M_elems - storage_elems()) + _M_size >= _M_capacity) {
+          if(has_many_free_slots())
+            move_elems(0);
+          else
+            grow(0);
+        }
+        _M_elems[_M_size] = std::move(elem);
+        _M_size++;
+      }
+
+      void push_front(std::unique_ptr<_T> &&elem)
+      {
+        if(_M_elems == storage_elems()) {
+          if(is_inline() && _M_size < _N)
+            // The inline elements are moved to the end of the inline slots.
+            move_elems(_N - _M_size);
+          else if(has_many_free_slots())
+            move_elems((_M_capacity - _M_size) / 2);
+          else
+            // The heap elements after growth have as many free slots at the
+            // front as the old capacity.
+            grow(_M_capacity);
+        }
+        _M_elems--;
+        _M_elems[0] = std::move(elem);
+        _M_size++;
+      }
+
+      void clear()
+      {
+        NodeListTeardown teardown;
+        for(std::size_t i = 0; i < _M_size; i++) NodeListTeardown::defer(_M_elems[i]);
+        _M_elems = storage_elems();
+        _M_size = 0;
+      }
+    };
+  }
+}
+
+#endif
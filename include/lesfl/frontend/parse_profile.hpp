@@ -0,0 +1,119 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_PARSE_PROFILE_HPP
+#define _LESFL_FRONTEND_PARSE_PROFILE_HPP
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    class GrammarRuleProfile
+    {
+      int _M_rule;
+      int _M_line;
+      std::size_t _M_deferred_action_count;
+      std::size_t _M_rejected_parse_count;
+    public:
+      GrammarRuleProfile(int rule, int line) :
+        _M_rule(rule), _M_line(line), _M_deferred_action_count(0), _M_rejected_parse_count(0) {}
+
+      int rule() const { return _M_rule; }
+
+      int line() const { return _M_line; }
+
+      std::size_t deferred_action_count() const { return _M_deferred_action_count; }
+
+      void increase_deferred_action_count() { _M_deferred_action_count++; }
+
+      std::size_t rejected_parse_count() const { return _M_rejected_parse_count; }
+
+      void increase_rejected_parse_count() { _M_rejected_parse_count++; }
+
+      void add_counts(const GrammarRuleProfile &profile)
+      {
+        _M_deferred_action_count += profile._M_deferred_action_count;
+        _M_rejected_parse_count += profile._M_rejected_parse_count;
+      }
+    };
+
+    class SourceParseProfile
+    {
+      std::string _M_file_name;
+      std::size_t _M_stack_split_count;
+      std::size_t _M_max_stack_count;
+      std::size_t _M_deferred_action_count;
+      std::size_t _M_discarded_parse_count;
+      std::size_t _M_stack_merge_count;
+      std::map<int, GrammarRuleProfile> _M_rule_profiles;
+    public:
+      SourceParseProfile(const std::string &file_name) :
+        _M_file_name(file_name), _M_stack_split_count(0), _M_max_stack_count(1),
+        _M_deferred_action_count(0), _M_discarded_parse_count(0), _M_stack_merge_count(0) {}
+
+      const std::string &file_name() const { return _M_file_name; }
+
+      std::size_t stack_split_count() const { return _M_stack_split_count; }
+
+      void increase_stack_split_count() { _M_stack_split_count++; }
+
+      std::size_t max_stack_count() const { return _M_max_stack_count; }
+
+      void update_max_stack_count(std::size_t stack_count)
+      { if(stack_count > _M_max_stack_count) _M_max_stack_count = stack_count; }
+
+      std::size_t deferred_action_count() const { return _M_deferred_action_count; }
+
+      void increase_deferred_action_count() { _M_deferred_action_count++; }
+
+      std::size_t discarded_parse_count() const { return _M_discarded_parse_count; }
+
+      void increase_discarded_parse_count() { _M_discarded_parse_count++; }
+
+      std::size_t stack_merge_count() const { return _M_stack_merge_count; }
+
+      void increase_stack_merge_count() { _M_stack_merge_count++; }
+
+      const std::map<int, GrammarRuleProfile> &rule_profiles() const { return _M_rule_profiles; }
+
+      GrammarRuleProfile &rule_profile(int rule, int line)
+      { return _M_rule_profiles.insert(std::make_pair(rule, GrammarRuleProfile(rule, line))).first->second; }
+    };
+
+    // The counts of a parse profile are only collected if the library is
+    // built with the PARSE_PROFILING variable, otherwise they are zeros and
+    // the is_available method returns false.
+    class ParseProfile
+    {
+      std::vector<SourceParseProfile> _M_source_profiles;
+    public:
+      ParseProfile() {}
+
+      static bool is_available();
+
+      const std::vector<SourceParseProfile> &source_profiles() const { return _M_source_profiles; }
+
+      SourceParseProfile &add_source_profile(const std::string &file_name)
+      {
+        _M_source_profiles.push_back(SourceParseProfile(file_name));
+        return _M_source_profiles.back();
+      }
+
+      void clear() { _M_source_profiles.clear(); }
+
+      void write_report(std::ostream &os) const;
+    };
+  }
+}
+
+#endif
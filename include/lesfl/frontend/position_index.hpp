@@ -0,0 +1,110 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_POSITION_INDEX_HPP
+#define _LESFL_FRONTEND_POSITION_INDEX_HPP
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <lesfl/frontend/ident.hpp>
+#include <lesfl/frontend/tree.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    enum class PositionIndexNodeKind
+    {
+      DEF,
+      EXPR,
+      PATTERN,
+      TYPE_EXPR,
+      VALUE
+    };
+
+    class PositionIndexEntry
+    {
+      std::size_t _M_line;
+      std::size_t _M_column;
+      PositionIndexNodeKind _M_kind;
+      Positional *_M_node;
+      const Identifier *_M_ident;
+      const Indexable *_M_local_var;
+    public:
+      PositionIndexEntry(PositionIndexNodeKind kind, Positional *node, const Identifier *ident = nullptr, const Indexable *local_var = nullptr) :
+        _M_line(node->pos().line()), _M_column(node->pos().column()), _M_kind(kind), _M_node(node), _M_ident(ident), _M_local_var(local_var) {}
+
+      std::size_t line() const { return _M_line; }
+
+      std::size_t column() const { return _M_column; }
+
+      PositionIndexNodeKind kind() const { return _M_kind; }
+
+      Positional *node() const { return _M_node; }
+
+      Definition *def() const
+      { return _M_kind == PositionIndexNodeKind::DEF ? static_cast<Definition *>(_M_node) : nullptr; }
+
+      Expression *expr() const
+      { return _M_kind == PositionIndexNodeKind::EXPR ? static_cast<Expression *>(_M_node) : nullptr; }
+
+      Pattern *pattern() const
+      { return _M_kind == PositionIndexNodeKind::PATTERN ? static_cast<Pattern *>(_M_node) : nullptr; }
+
+      TypeExpression *type_expr() const
+      { return _M_kind == PositionIndexNodeKind::TYPE_EXPR ? static_cast<TypeExpression *>(_M_node) : nullptr; }
+
+      Value *value() const
+      { return _M_kind == PositionIndexNodeKind::VALUE ? static_cast<Value *>(_M_node) : nullptr; }
+
+      const Identifier *ident() const { return _M_ident; }
+
+      bool has_key_ident() const { return _M_ident != nullptr && _M_ident->has_key_ident(); }
+
+      KeyIdentifier key_ident() const { return _M_ident->key_ident(); }
+
+      bool has_local_var_index() const { return _M_local_var != nullptr; }
+
+      std::size_t local_var_index() const { return _M_local_var->index(); }
+    };
+
+    // A PositionIndex object finds the innermost node at a location of a
+    // source. Nodes only have their beginnings, so a node is found for all
+    // locations from its beginning to the beginning of the next node. Key
+    // identifiers and local variable indices are valid for a resolved tree.
+    class PositionIndex
+    {
+      std::unordered_map<std::string, std::vector<PositionIndexEntry>> _M_entries;
+    public:
+      PositionIndex() {}
+
+      const std::unordered_map<std::string, std::vector<PositionIndexEntry>> &entries() const
+      { return _M_entries; }
+
+      const std::vector<PositionIndexEntry> *entries(const std::string &file_name) const
+      {
+        auto iter = _M_entries.find(file_name);
+        return iter != _M_entries.end() ? &(iter->second) : nullptr;
+      }
+
+      const PositionIndexEntry *find(const std::string &file_name, std::size_t line, std::size_t column) const;
+
+      // Entries of each source must be added in the preorder of the nodes and
+      // be sorted after adding.
+      void add_entry(const std::string &file_name, const PositionIndexEntry &entry)
+      { _M_entries[file_name].push_back(entry); }
+
+      void sort_entries();
+
+      void clear() { _M_entries.clear(); }
+    };
+  }
+}
+
+#endif
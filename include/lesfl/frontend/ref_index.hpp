@@ -0,0 +1,75 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_REF_INDEX_HPP
+#define _LESFL_FRONTEND_REF_INDEX_HPP
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <lesfl/frontend/ident.hpp>
+#include <lesfl/frontend/tree.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    // A Reference object refers to a definition and a position of a tree
+    // node, so the tree must be alive while the reference is used. The
+    // definition hasn't a key identifier if it is an import or a module
+    // definition.
+    class Reference
+    {
+      const Definition *_M_def;
+      KeyIdentifier _M_def_key_ident;
+      bool _M_has_def_key_ident;
+      const Position *_M_pos;
+    public:
+      Reference(const Definition *def, const Position &pos) :
+        _M_def(def), _M_has_def_key_ident(false), _M_pos(&pos) {}
+
+      Reference(const Definition *def, KeyIdentifier def_key_ident, const Position &pos) :
+        _M_def(def), _M_def_key_ident(def_key_ident), _M_has_def_key_ident(true), _M_pos(&pos) {}
+
+      const Definition *def() const { return _M_def; }
+
+      bool has_def_key_ident() const { return _M_has_def_key_ident; }
+
+      KeyIdentifier def_key_ident() const { return _M_def_key_ident; }
+
+      const Position &pos() const { return *_M_pos; }
+    };
+
+    class ReferenceIndex
+    {
+      std::unordered_map<KeyIdentifier, std::vector<Reference>> _M_refs;
+    public:
+      ReferenceIndex() {}
+
+      const std::unordered_map<KeyIdentifier, std::vector<Reference>> &refs() const
+      { return _M_refs; }
+
+      const std::vector<Reference> *refs(KeyIdentifier key_ident) const
+      {
+        auto iter = _M_refs.find(key_ident);
+        return iter != _M_refs.end() ? &(iter->second) : nullptr;
+      }
+
+      bool has_refs(KeyIdentifier key_ident) const
+      { return _M_refs.find(key_ident) != _M_refs.end(); }
+
+      void add_ref(KeyIdentifier key_ident, const Reference &ref)
+      { _M_refs[key_ident].push_back(ref); }
+
+      void add_refs(const std::vector<std::pair<KeyIdentifier, Reference>> &refs);
+
+      void clear() { _M_refs.clear(); }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_SCANNED_SOURCE_HPP
+#define _LESFL_FRONTEND_SCANNED_SOURCE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <lesfl/comp.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    // A scanned import holds the module identifier as it is written. A
+    // relative module identifier is expanded at lookup in the current module
+    // and in the previous imports in the same order as by the resolver.
+    class ScannedImport
+    {
+      std::string _M_module_ident;
+      std::string _M_current_module_ident;
+      bool _M_has_prev_import;
+      std::size_t _M_prev_import_index;
+      Position _M_pos;
+    public:
+      ScannedImport(const std::string &module_ident, const std::string &current_module_ident, const Position &pos) :
+        _M_module_ident(module_ident), _M_current_module_ident(current_module_ident), _M_has_prev_import(false), _M_prev_import_index(0), _M_pos(pos) {}
+
+      ScannedImport(const std::string &module_ident, const std::string &current_module_ident, std::size_t prev_import_index, const Position &pos) :
+        _M_module_ident(module_ident), _M_current_module_ident(current_module_ident), _M_has_prev_import(true), _M_prev_import_index(prev_import_index), _M_pos(pos) {}
+
+      const std::string &module_ident() const { return _M_module_ident; }
+
+      bool is_abs_module_ident() const
+      { return !_M_module_ident.empty() && _M_module_ident[0] == '.'; }
+
+      const std::string &current_module_ident() const { return _M_current_module_ident; }
+
+      // The previous import is the last import that is visible from this
+      // import, so the visible imports are a chain from the last import.
+      bool has_prev_import() const { return _M_has_prev_import; }
+
+      std::size_t prev_import_index() const { return _M_prev_import_index; }
+
+      const Position &pos() const { return _M_pos; }
+    };
+
+    class ScannedSource
+    {
+      std::vector<std::string> _M_module_idents;
+      std::vector<ScannedImport> _M_imports;
+    public:
+      ScannedSource() {}
+
+      const std::vector<std::string> &module_idents() const { return _M_module_idents; }
+
+      void add_module_ident(const std::string &module_ident) { _M_module_idents.push_back(module_ident); }
+
+      const std::vector<ScannedImport> &imports() const { return _M_imports; }
+
+      void add_import(const ScannedImport &import) { _M_imports.push_back(import); }
+
+      void clear()
+      {
+        _M_module_idents.clear();
+        _M_imports.clear();
+      }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,194 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _LESFL_FRONTEND_STATS_HPP
+#define _LESFL_FRONTEND_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    class PhaseStats
+    {
+      std::string _M_name;
+      std::uint64_t _M_nanoseconds;
+      std::size_t _M_allocation_count;
+    public:
+      PhaseStats(const std::string &name, std::uint64_t nanoseconds, std::size_t allocation_count) :
+        _M_name(name), _M_nanoseconds(nanoseconds), _M_allocation_count(allocation_count) {}
+
+      const std::string &name() const { return _M_name; }
+
+      std::uint64_t nanoseconds() const { return _M_nanoseconds; }
+
+      std::size_t allocation_count() const { return _M_allocation_count; }
+    };
+
+    class TraceEvent
+    {
+      std::string _M_name;
+      std::string _M_category;
+      std::uint64_t _M_start_nanoseconds;
+      std::uint64_t _M_nanoseconds;
+      std::size_t _M_thread_index;
+    public:
+      TraceEvent(const std::string &name, const std::string &category, std::uint64_t start_nanoseconds, std::uint64_t nanoseconds, std::size_t thread_index) :
+        _M_name(name), _M_category(category), _M_start_nanoseconds(start_nanoseconds), _M_nanoseconds(nanoseconds), _M_thread_index(thread_index) {}
+
+      const std::string &name() const { return _M_name; }
+
+      const std::string &category() const { return _M_category; }
+
+      std::uint64_t start_nanoseconds() const { return _M_start_nanoseconds; }
+
+      std::uint64_t nanoseconds() const { return _M_nanoseconds; }
+
+      std::size_t thread_index() const { return _M_thread_index; }
+    };
+
+    // A Trace object records spans of phases, modules and top-level
+    // definitions that take at least the definition threshold. It can be
+    // written in the trace event format of Chrome. Events can be added from
+    // many threads; each thread has own track.
+    class Trace
+    {
+      std::chrono::steady_clock::time_point _M_start_time;
+      std::uint64_t _M_def_threshold_nanoseconds;
+      mutable std::mutex _M_mutex;
+      std::vector<TraceEvent> _M_events;
+      std::vector<std::thread::id> _M_thread_ids;
+    public:
+      Trace(std::uint64_t def_threshold_nanoseconds = 1000000) :
+        _M_start_time(std::chrono::steady_clock::now()), _M_def_threshold_nanoseconds(def_threshold_nanoseconds) {}
+
+      Trace(const Trace &) = delete;
+
+      Trace &operator=(const Trace &) = delete;
+
+      std::uint64_t def_threshold_nanoseconds() const { return _M_def_threshold_nanoseconds; }
+
+      void set_def_threshold_nanoseconds(std::uint64_t nanoseconds) { _M_def_threshold_nanoseconds = nanoseconds; }
+
+      std::uint64_t nanoseconds_since_start() const
+      { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _M_start_time).count(); }
+
+      const std::vector<TraceEvent> &events() const { return _M_events; }
+
+      std::size_t thread_count() const { return _M_thread_ids.size(); }
+
+      void add_event(const std::string &name, const std::string &category, std::uint64_t start_nanoseconds, std::uint64_t nanoseconds);
+
+      void clear();
+
+      void write_json(std::ostream &os) const;
+    };
+
+    // Allocations are counted only if a program calls
+    // FrontendStats::count_allocation from its replacement of the global
+    // operator new. Otherwise, allocation counts of phases are zero.
+    class FrontendStats
+    {
+      static thread_local std::size_t _S_allocation_count;
+
+      std::vector<PhaseStats> _M_phase_stats;
+      std::size_t _M_interned_ident_count;
+      std::size_t _M_ident_table_probe_count;
+      std::size_t _M_ident_lookup_miss_count;
+      Trace *_M_trace;
+    public:
+      FrontendStats() :
+        _M_interned_ident_count(0), _M_ident_table_probe_count(0), _M_ident_lookup_miss_count(0), _M_trace(nullptr) {}
+
+      static std::size_t allocation_count() { return _S_allocation_count; }
+
+      static void count_allocation() { _S_allocation_count++; }
+
+      const std::vector<PhaseStats> &phase_stats() const { return _M_phase_stats; }
+
+      void add_phase_stats(const PhaseStats &stats) { _M_phase_stats.push_back(stats); }
+
+      std::size_t interned_ident_count() const { return _M_interned_ident_count; }
+
+      void increase_interned_ident_count() { _M_interned_ident_count++; }
+
+      std::size_t ident_table_probe_count() const { return _M_ident_table_probe_count; }
+
+      void increase_ident_table_probe_count() { _M_ident_table_probe_count++; }
+
+      std::size_t ident_lookup_miss_count() const { return _M_ident_lookup_miss_count; }
+
+      void increase_ident_lookup_miss_count() { _M_ident_lookup_miss_count++; }
+
+      Trace *trace() const { return _M_trace; }
+
+      void set_trace(Trace *trace) { _M_trace = trace; }
+
+      void clear();
+
+      void write_json(std::ostream &os) const;
+    };
+
+    class MemoryUsage
+    {
+      std::string _M_name;
+      std::size_t _M_count;
+      std::size_t _M_bytes;
+    public:
+      MemoryUsage(const std::string &name, std::size_t count, std::size_t bytes) :
+        _M_name(name), _M_count(count), _M_bytes(bytes) {}
+
+      const std::string &name() const { return _M_name; }
+
+      std::size_t count() const { return _M_count; }
+
+      std::size_t bytes() const { return _M_bytes; }
+
+      void add(std::size_t count, std::size_t bytes)
+      {
+        _M_count += count;
+        _M_bytes += bytes;
+      }
+    };
+
+    // A MemoryReport object contains approximate memory usage of a tree. Node
+    // classes are reported by sizes of their objects. Heap memory of strings,
+    // identifiers, node lists, file names of positions, the identifier table
+    // and the information tables is reported under separate names, so bytes of
+    // all usages can be summed.
+    class MemoryReport
+    {
+      std::vector<MemoryUsage> _M_usages;
+      std::unordered_map<std::string, std::size_t> _M_usage_indices;
+    public:
+      MemoryReport() {}
+
+      const std::vector<MemoryUsage> &usages() const { return _M_usages; }
+
+      const MemoryUsage *usage(const std::string &name) const;
+
+      void add(const std::string &name, std::size_t count, std::size_t bytes);
+
+      std::size_t total_bytes() const;
+
+      void clear();
+
+      void write_json(std::ostream &os) const;
+    };
+  }
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include <utility>
 #include <lesfl/frontend/builtin.hpp>
 #include <lesfl/frontend/ident.hpp>
+#include <lesfl/frontend/node_list.hpp>
 #include <lesfl/comp.hpp>
 
 namespace lesfl
@@ -31,6 +32,7 @@ namespace lesfl
     class Argument;
     class Annotation;
     class Expression;
+    class DeferredBody;
     class ExpressionNamedFieldPair;
     class Binding;
     class TupleBindingVariable;
@@ -68,6 +70,17 @@ namespace lesfl
       DOUBLE
     };
 
+    enum class PackedElementType
+    {
+      CHAR,
+      INT8,
+      INT16,
+      INT32,
+      INT64,
+      SINGLE_FLOAT,
+      DOUBLE_FLOAT
+    };
+
     enum class AccessModifier
     {
       NONE,
@@ -86,6 +99,15 @@ namespace lesfl
       PRIMITIVE
     };
 
+    enum class AliasTargetState
+    {
+      UNRESOLVED,
+      RESOLVING,
+      RESOLVED,
+      UNDEFINED,
+      CYCLE
+    };
+
     struct InstancePair
     {
       KeyIdentifier key_ident;
@@ -144,6 +166,25 @@ namespace lesfl
       InlineModifier inline_modifier() const { return _M_inline_modifier; }
     };
 
+    class Bodied
+    {
+    protected:
+      std::unique_ptr<Expression> _M_body;
+      bool _M_has_deferred_body;
+
+      Bodied(Expression *body);
+    public:
+      virtual ~Bodied();
+
+      // A deferred body is a DeferredExpression object until it is parsed by
+      // the parse_body method.
+      Expression *body() const { return _M_body.get(); }
+
+      bool has_deferred_body() const { return _M_has_deferred_body; }
+
+      bool parse_body(std::list<Error> &errors);
+    };
+
     class Identifiable
     {
     protected:
@@ -186,9 +227,11 @@ namespace lesfl
       std::shared_ptr<std::list<std::shared_ptr<Instance>>> _M_insts;
       AccessModifier _M_constr_access_modifier;
       const std::string *_M_datatype_ident;
+      AliasTargetState _M_alias_target_state;
+      std::shared_ptr<Variable> _M_non_alias_var;
     public:
       VariableInfo(AccessModifier access_modifier, const std::shared_ptr<Variable> &var, AccessModifier constr_access_modifier = AccessModifier::NONE, const std::string *datatype_ident = nullptr) :
-        Accessible(constr_access_modifier == AccessModifier::PRIVATE ? constr_access_modifier : access_modifier), _M_var(var), _M_insts(std::shared_ptr<std::list<std::shared_ptr<Instance>>>(new std::list<std::shared_ptr<Instance>>())), _M_constr_access_modifier(constr_access_modifier), _M_datatype_ident(datatype_ident) {}
+        Accessible(constr_access_modifier == AccessModifier::PRIVATE ? constr_access_modifier : access_modifier), _M_var(var), _M_insts(std::shared_ptr<std::list<std::shared_ptr<Instance>>>(new std::list<std::shared_ptr<Instance>>())), _M_constr_access_modifier(constr_access_modifier), _M_datatype_ident(datatype_ident), _M_alias_target_state(AliasTargetState::UNRESOLVED) {}
 
       ~VariableInfo();
 
@@ -210,6 +253,18 @@ namespace lesfl
         _M_access_modifier = (_M_constr_access_modifier == AccessModifier::PRIVATE ? _M_constr_access_modifier : access_modifier);
         _M_datatype_ident = nullptr;
       }
+
+      AliasTargetState alias_target_state() const { return _M_alias_target_state; }
+
+      void set_alias_target_state(AliasTargetState state) { _M_alias_target_state = state; }
+
+      const std::shared_ptr<Variable> &non_alias_var() const { return _M_non_alias_var; }
+
+      void set_non_alias_var(const std::shared_ptr<Variable> &var)
+      {
+        _M_alias_target_state = AliasTargetState::RESOLVED;
+        _M_non_alias_var = var;
+      }
     };
 
     class TypeVariableInfo : public Accessible
@@ -244,7 +299,7 @@ namespace lesfl
 
     class Tree
     {
-      std::list<std::unique_ptr<const std::list<std::unique_ptr<Definition>>>> _M_defs;
+      std::list<std::unique_ptr<const NodeList<Definition>>> _M_defs;
       std::shared_ptr<AbsoluteIdentifierTable> _M_ident_table;
       std::unordered_set<KeyIdentifier> _M_module_key_idents;
       std::unordered_map<KeyIdentifier, VariableInfo> _M_var_infos;
@@ -262,11 +317,11 @@ namespace lesfl
 
       virtual ~Tree();
 
-      const std::list<std::unique_ptr<const std::list<std::unique_ptr<Definition>>>> &defs() const
+      const std::list<std::unique_ptr<const NodeList<Definition>>> &defs() const
       { return _M_defs; }
 
-      void add_defs(const std::list<std::unique_ptr<Definition>> *defs)
-      { _M_defs.push_back(std::unique_ptr<const std::list<std::unique_ptr<Definition>>>(defs)); }
+      void add_defs(const NodeList<Definition> *defs)
+      { _M_defs.push_back(std::unique_ptr<const NodeList<Definition>>(defs)); }
 
       const std::shared_ptr<AbsoluteIdentifierTable> &ident_table() const
       { return _M_ident_table; }
@@ -401,6 +456,18 @@ namespace lesfl
       const std::vector<TypeFunctionInstancePair> &uncompiled_type_fun_inst_pairs() const { return _M_uncompiled_type_fun_inst_pairs; }
 
       std::vector<TypeFunctionInstancePair> &uncompiled_type_fun_inst_pairs() { return _M_uncompiled_type_fun_inst_pairs; }
+
+      // Replaces the key identifiers of the tables and the uncompiled
+      // definitions. The uncompiled definitions are sorted by the new key
+      // identifiers.
+      void renumber_key_idents(const std::unordered_map<KeyIdentifier, KeyIdentifier> &key_ident_map);
+
+      // Moves the definitions and the information of the other tree to this
+      // tree. The other tree can have another identifier table, so its key
+      // identifiers are replaced by the key identifiers of this tree.
+      // Definitions that are defined in both trees are reported as errors,
+      // except builtin types, and then both trees are left unchanged.
+      bool merge(Tree &&tree, std::list<Error> &errors);
     };
 
     class Definition : public Positional
@@ -426,16 +493,16 @@ namespace lesfl
     class ModuleDefinition : public Definition
     {
       std::unique_ptr<Identifier> _M_ident;
-      std::unique_ptr<const std::list<std::unique_ptr<Definition>>> _M_defs;
+      std::unique_ptr<const NodeList<Definition>> _M_defs;
     public:
-      ModuleDefinition(Identifier *ident, const std::list<std::unique_ptr<Definition>> *defs, const Position &pos) :
+      ModuleDefinition(Identifier *ident, const NodeList<Definition> *defs, const Position &pos) :
         Definition(pos), _M_ident(ident), _M_defs(defs) {}
 
       ~ModuleDefinition();
 
       Identifier *ident() const { return _M_ident.get(); }
 
-      const std::list<std::unique_ptr<Definition>> &defs() const { return *_M_defs; }
+      const NodeList<Definition> &defs() const { return *_M_defs; }
     };
 
     class VariableDefinition : public Definition, public Accessible
@@ -570,7 +637,7 @@ namespace lesfl
     class DefinableVariable : public virtual OriginalVariable
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<TypeParameter>>> _M_inst_type_params;
+      std::unique_ptr<const NodeList<TypeParameter>> _M_inst_type_params;
       std::unique_ptr<TypeExpression> _M_type_expr;
 
       DefinableVariable() : _M_inst_type_params(nullptr), _M_type_expr(nullptr) {}
@@ -578,17 +645,17 @@ namespace lesfl
       DefinableVariable(TypeExpression *type_expr) :
         _M_inst_type_params(nullptr), _M_type_expr(type_expr) {}
 
-      DefinableVariable(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params) :
+      DefinableVariable(const NodeList<TypeParameter> *inst_type_params) :
         _M_inst_type_params(inst_type_params), _M_type_expr(nullptr) {}
 
-      DefinableVariable(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, TypeExpression *type_expr) :
+      DefinableVariable(const NodeList<TypeParameter> *inst_type_params, TypeExpression *type_expr) :
         _M_inst_type_params(inst_type_params), _M_type_expr(type_expr) {}
     public:
       ~DefinableVariable();
 
       bool is_template() const { return _M_inst_type_params.get() != nullptr; }
 
-      const std::list<std::unique_ptr<TypeParameter>> &inst_type_params() const { return *_M_inst_type_params; }
+      const NodeList<TypeParameter> &inst_type_params() const { return *_M_inst_type_params; }
 
       TypeExpression *type_expr() const { return _M_type_expr.get(); }
     };    
@@ -602,13 +669,13 @@ namespace lesfl
       UserDefinedVariable(TypeExpression *type_expr, Value *value) :
         DefinableVariable(type_expr), _M_value(value) {}
 
-      UserDefinedVariable(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, Value *value) :
+      UserDefinedVariable(const NodeList<TypeParameter> *inst_type_params, Value *value) :
         DefinableVariable(inst_type_params), _M_value(value) {}
 
-      UserDefinedVariable(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, TypeExpression *type_expr, Value *value) :
+      UserDefinedVariable(const NodeList<TypeParameter> *inst_type_params, TypeExpression *type_expr, Value *value) :
         DefinableVariable(inst_type_params, type_expr), _M_value(value) {}
 
-      UserDefinedVariable(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, TypeExpression *type_expr) :
+      UserDefinedVariable(const NodeList<TypeParameter> *inst_type_params, TypeExpression *type_expr) :
         DefinableVariable(inst_type_params, type_expr), _M_value(nullptr) {}
 
       ~UserDefinedVariable();
@@ -635,7 +702,7 @@ namespace lesfl
       AliasVariable(TypeExpression *type_expr, Identifier *ident, const Position &pos) :
         DefinableVariable(type_expr), Positional(pos), _M_ident(ident) {}
 
-      AliasVariable(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, TypeExpression *type_expr, Identifier *ident, const Position &pos) :
+      AliasVariable(const NodeList<TypeParameter> *inst_type_params, TypeExpression *type_expr, Identifier *ident, const Position &pos) :
         DefinableVariable(inst_type_params, type_expr), Positional(pos), _M_ident(ident) {}
 
       ~AliasVariable();
@@ -732,71 +799,68 @@ namespace lesfl
     class DefinableFunction : public virtual OriginalFunction
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<TypeParameter>>> _M_inst_type_params;
-      std::unique_ptr<const std::list<std::unique_ptr<Annotation>>> _M_annotations;
+      std::unique_ptr<const NodeList<TypeParameter>> _M_inst_type_params;
+      std::unique_ptr<const NodeList<Annotation>> _M_annotations;
       FunctionModifier _M_fun_modifier;
-      std::unique_ptr<const std::list<std::unique_ptr<Argument>>> _M_args;
+      std::unique_ptr<const NodeList<Argument>> _M_args;
       std::unique_ptr<TypeExpression> _M_result_type_expr;
 
-      DefinableFunction(const std::list<std::unique_ptr<Annotation>> *annotations, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args) :
+      DefinableFunction(const NodeList<Annotation> *annotations, FunctionModifier fun_modifier, const NodeList<Argument> *args) :
         OriginalFunction(args->size()), _M_inst_type_params(nullptr), _M_annotations(annotations), _M_fun_modifier(fun_modifier), _M_args(args), _M_result_type_expr(nullptr) {}
 
-      DefinableFunction(const std::list<std::unique_ptr<Annotation>> *annotations, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr) :
+      DefinableFunction(const NodeList<Annotation> *annotations, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr) :
         OriginalFunction(args->size()), _M_inst_type_params(nullptr), _M_annotations(annotations), _M_fun_modifier(fun_modifier), _M_args(args), _M_result_type_expr(result_type_expr) {}
 
-      DefinableFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<Annotation>> *annotations, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args) :
+      DefinableFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<Annotation> *annotations, FunctionModifier fun_modifier, const NodeList<Argument> *args) :
         OriginalFunction(args->size()), _M_inst_type_params(inst_type_params), _M_annotations(annotations), _M_fun_modifier(fun_modifier), _M_args(args), _M_result_type_expr(nullptr) {}
 
-      DefinableFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<Annotation>> *annotations, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr) :
+      DefinableFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<Annotation> *annotations, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr) :
         OriginalFunction(args->size()), _M_inst_type_params(inst_type_params), _M_annotations(annotations), _M_fun_modifier(fun_modifier), _M_args(args), _M_result_type_expr(result_type_expr) {}
     public:
       ~DefinableFunction();
 
       bool is_template() const { return _M_inst_type_params.get() != nullptr; }
 
-      const std::list<std::unique_ptr<TypeParameter>> &inst_type_params() const { return *_M_inst_type_params; }
+      const NodeList<TypeParameter> &inst_type_params() const { return *_M_inst_type_params; }
 
-      const std::list<std::unique_ptr<Annotation>> &annotations() const { return *_M_annotations; }
+      const NodeList<Annotation> &annotations() const { return *_M_annotations; }
 
       FunctionModifier fun_modifier() const { return _M_fun_modifier; }
 
-      const std::list<std::unique_ptr<Argument>> &args() const { return *_M_args; }
+      const NodeList<Argument> &args() const { return *_M_args; }
 
       std::size_t arg_count() const { return _M_arg_count; }
       
       TypeExpression *result_type_expr() const { return _M_result_type_expr.get(); }
     };
 
-    class UserDefinedFunction : public DefinableFunction, public InstanceFunction, public Inlinable
+    class UserDefinedFunction : public DefinableFunction, public InstanceFunction, public Inlinable, public Bodied
     {
-      std::unique_ptr<Expression> _M_body;
     public:
-      UserDefinedFunction(const std::list<std::unique_ptr<Annotation>> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, Expression *body) :
-        OriginalFunction(args->size()), DefinableFunction(annotations, fun_modifier, args), InstanceFunction(args->size()), Inlinable(inline_modifier), _M_body(body) {}
+      UserDefinedFunction(const NodeList<Annotation> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, Expression *body) :
+        OriginalFunction(args->size()), DefinableFunction(annotations, fun_modifier, args), InstanceFunction(args->size()), Inlinable(inline_modifier), Bodied(body) {}
 
-      UserDefinedFunction(const std::list<std::unique_ptr<Annotation>> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, Expression *body) :
-        OriginalFunction(args->size()), DefinableFunction(annotations, fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(inline_modifier), _M_body(body) {}
+      UserDefinedFunction(const NodeList<Annotation> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, Expression *body) :
+        OriginalFunction(args->size()), DefinableFunction(annotations, fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(inline_modifier), Bodied(body) {}
 
-      UserDefinedFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<Annotation>> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, Expression *body) :
-        OriginalFunction(args->size()), DefinableFunction(inst_type_params, annotations, fun_modifier, args), InstanceFunction(args->size()), Inlinable(inline_modifier), _M_body(body) {}
+      UserDefinedFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<Annotation> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, Expression *body) :
+        OriginalFunction(args->size()), DefinableFunction(inst_type_params, annotations, fun_modifier, args), InstanceFunction(args->size()), Inlinable(inline_modifier), Bodied(body) {}
 
-      UserDefinedFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<Annotation>> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, Expression *body) :
-        OriginalFunction(args->size()), DefinableFunction(inst_type_params, annotations, fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(inline_modifier), _M_body(body) {}
+      UserDefinedFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<Annotation> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, Expression *body) :
+        OriginalFunction(args->size()), DefinableFunction(inst_type_params, annotations, fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(inline_modifier), Bodied(body) {}
 
-      UserDefinedFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr) :
-        OriginalFunction(args->size()), DefinableFunction(inst_type_params, new std::list<std::unique_ptr<Annotation>>(), fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(InlineModifier::NONE), _M_body(nullptr) {}
+      UserDefinedFunction(const NodeList<TypeParameter> *inst_type_params, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr) :
+        OriginalFunction(args->size()), DefinableFunction(inst_type_params, new NodeList<Annotation>(), fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(InlineModifier::NONE), Bodied(nullptr) {}
 
       ~UserDefinedFunction();
-
-      Expression *body() const { return _M_body.get(); }
     };
 
     class ExternalFunction : public DefinableFunction, public InstanceFunction
     {
       std::string _M_external_fun_ident;
     public:
-      ExternalFunction(FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, const std::string &external_fun_ident) :
-        OriginalFunction(args->size()), DefinableFunction(new std::list<std::unique_ptr<Annotation>>(), fun_modifier, args, result_type_expr), InstanceFunction(args->size()), _M_external_fun_ident(external_fun_ident) {}
+      ExternalFunction(FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, const std::string &external_fun_ident) :
+        OriginalFunction(args->size()), DefinableFunction(new NodeList<Annotation>(), fun_modifier, args, result_type_expr), InstanceFunction(args->size()), _M_external_fun_ident(external_fun_ident) {}
 
       ~ExternalFunction();
 
@@ -807,7 +871,7 @@ namespace lesfl
     {
       std::string _M_native_fun_ident;
     public:
-      NativeFunction(const std::list<std::unique_ptr<Annotation>> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, const std::string &native_fun_ident) :
+      NativeFunction(const NodeList<Annotation> *annotations, InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, const std::string &native_fun_ident) :
         OriginalFunction(args->size()), DefinableFunction(annotations, fun_modifier, args, result_type_expr), InstanceFunction(args->size()), Inlinable(inline_modifier), _M_native_fun_ident(native_fun_ident) {}
 
       ~NativeFunction();
@@ -863,6 +927,28 @@ namespace lesfl
       ~Expression();
     };
 
+    class DeferredBody
+    {
+    protected:
+      DeferredBody() {}
+    public:
+      virtual ~DeferredBody();
+
+      virtual Expression *parse(std::list<Error> &errors) = 0;
+    };
+
+    class DeferredExpression : public Expression
+    {
+      std::unique_ptr<DeferredBody> _M_deferred_body;
+    public:
+      DeferredExpression(DeferredBody *deferred_body, const Position &pos) :
+        Expression(pos), _M_deferred_body(deferred_body) {}
+
+      ~DeferredExpression();
+
+      DeferredBody *deferred_body() const { return _M_deferred_body.get(); }
+    };
+
     class Literal : public Expression
     {
       std::unique_ptr<LiteralValue> _M_literal_value;
@@ -877,20 +963,20 @@ namespace lesfl
     class Collection : public Expression
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Expression>>> _M_elems;
+      std::unique_ptr<const NodeList<Expression>> _M_elems;
 
-      Collection(const std::list<std::unique_ptr<Expression>> *elems, const Position &pos) :
+      Collection(const NodeList<Expression> *elems, const Position &pos) :
         Expression(pos), _M_elems(elems) {}
     public:
       ~Collection();
 
-      const std::list<std::unique_ptr<Expression>> &elems() const { return *_M_elems; } 
+      const NodeList<Expression> &elems() const { return *_M_elems; } 
     };
 
     class List : public Collection
     {
     public:
-      List(const std::list<std::unique_ptr<Expression>> *elems, const Position &pos) : Collection(elems, pos) {}
+      List(const NodeList<Expression> *elems, const Position &pos) : Collection(elems, pos) {}
 
       ~List();
     };
@@ -898,7 +984,7 @@ namespace lesfl
     class Array : public Collection
     {
     protected:
-      Array(const std::list<std::unique_ptr<Expression>> *elems, const Position &pos) : Collection(elems, pos) {}
+      Array(const NodeList<Expression> *elems, const Position &pos) : Collection(elems, pos) {}
     public:
       ~Array();
     };
@@ -906,7 +992,7 @@ namespace lesfl
     class NonUniqueArray : public Array
     {
     public:
-      NonUniqueArray(const std::list<std::unique_ptr<Expression>> *elems, const Position &pos) : Array(elems, pos) {}
+      NonUniqueArray(const NodeList<Expression> *elems, const Position &pos) : Array(elems, pos) {}
 
       ~NonUniqueArray();
     };
@@ -914,7 +1000,7 @@ namespace lesfl
     class UniqueArray : public Array
     {
     public:
-      UniqueArray(const std::list<std::unique_ptr<Expression>> *elems, const Position &pos) : Array(elems, pos) {}
+      UniqueArray(const NodeList<Expression> *elems, const Position &pos) : Array(elems, pos) {}
 
       ~UniqueArray();
     };
@@ -922,20 +1008,20 @@ namespace lesfl
     class Tuple : public Expression
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Expression>>> _M_fields;
+      std::unique_ptr<const NodeList<Expression>> _M_fields;
 
-      Tuple(const std::list<std::unique_ptr<Expression>> *fields, const Position &pos) :
+      Tuple(const NodeList<Expression> *fields, const Position &pos) :
         Expression(pos), _M_fields(fields) {}
     public:
       ~Tuple();
 
-      const std::list<std::unique_ptr<Expression>> &fields() const { return *_M_fields; }
+      const NodeList<Expression> &fields() const { return *_M_fields; }
     };
 
     class NonUniqueTuple : public Tuple
     {
     public:
-      NonUniqueTuple(const std::list<std::unique_ptr<Expression>> *fields, const Position &pos) : Tuple(fields, pos) {}
+      NonUniqueTuple(const NodeList<Expression> *fields, const Position &pos) : Tuple(fields, pos) {}
 
       ~NonUniqueTuple();
     };
@@ -943,7 +1029,7 @@ namespace lesfl
     class UniqueTuple : public Tuple
     {
     public:
-      UniqueTuple(const std::list<std::unique_ptr<Expression>> *fields, const Position &pos) : Tuple(fields, pos) {}
+      UniqueTuple(const NodeList<Expression> *fields, const Position &pos) : Tuple(fields, pos) {}
 
       ~UniqueTuple();
     };
@@ -962,38 +1048,38 @@ namespace lesfl
     class NamedFieldConstructorApplication : public Expression
     {
       std::unique_ptr<Identifier> _M_constr_ident;
-      std::unique_ptr<const std::list<std::unique_ptr<ExpressionNamedFieldPair>>> _M_fields;
+      std::unique_ptr<const NodeList<ExpressionNamedFieldPair>> _M_fields;
     public:
-      NamedFieldConstructorApplication(Identifier *constr_ident, const std::list<std::unique_ptr<ExpressionNamedFieldPair>> *fields, const Position &pos) :
+      NamedFieldConstructorApplication(Identifier *constr_ident, const NodeList<ExpressionNamedFieldPair> *fields, const Position &pos) :
         Expression(pos), _M_constr_ident(constr_ident), _M_fields(fields) {}
 
       ~NamedFieldConstructorApplication();
 
       Identifier *constr_ident() const { return _M_constr_ident.get(); }
 
-      const std::list<std::unique_ptr<ExpressionNamedFieldPair>> &fields() const { return *_M_fields; }
+      const NodeList<ExpressionNamedFieldPair> &fields() const { return *_M_fields; }
     };
 
     class Application : public Expression
     {
       std::unique_ptr<Expression> _M_fun;
-      std::unique_ptr<const std::list<std::unique_ptr<Expression>>> _M_args;
+      std::unique_ptr<const NodeList<Expression>> _M_args;
     protected:
-      Application(Expression *fun, const std::list<std::unique_ptr<Expression>> *args, const Position &pos) :
+      Application(Expression *fun, const NodeList<Expression> *args, const Position &pos) :
         Expression(pos), _M_fun(fun), _M_args(args) {}
     public:
       ~Application();
 
       Expression *fun() const { return _M_fun.get(); }
 
-      const std::list<std::unique_ptr<Expression>> &args() const { return *_M_args; }
+      const NodeList<Expression> &args() const { return *_M_args; }
     };
 
     class NonUniqueApplication : public Application
     {
       FunctionModifier _M_fun_modifier;
     public:
-      NonUniqueApplication(Expression *fun, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Expression>> *args, const Position &pos) :
+      NonUniqueApplication(Expression *fun, FunctionModifier fun_modifier, const NodeList<Expression> *args, const Position &pos) :
         Application(fun, args, pos), _M_fun_modifier(fun_modifier) {}
 
       ~NonUniqueApplication();
@@ -1004,7 +1090,7 @@ namespace lesfl
     class UniqueApplication : public Application
     {
     public:
-      UniqueApplication(Expression *fun, const std::list<std::unique_ptr<Expression>> *args, const Position &pos) :
+      UniqueApplication(Expression *fun, const NodeList<Expression> *args, const Position &pos) :
         Application(fun, args, pos) {}
 
       ~UniqueApplication();
@@ -1013,16 +1099,16 @@ namespace lesfl
     class BuiltinApplication : public Expression
     {
       BuiltinFunction _M_fun;
-      std::unique_ptr<const std::list<std::unique_ptr<Expression>>> _M_args;
+      std::unique_ptr<const NodeList<Expression>> _M_args;
     public:
-      BuiltinApplication(BuiltinFunction fun, const std::list<std::unique_ptr<Expression>> *args, const Position &pos) :
+      BuiltinApplication(BuiltinFunction fun, const NodeList<Expression> *args, const Position &pos) :
         Expression(pos), _M_fun(fun), _M_args(args) {}
 
       ~BuiltinApplication();
 
       BuiltinFunction fun() const { return _M_fun; }
 
-      const std::list<std::unique_ptr<Expression>> &args() const { return *_M_args; }
+      const NodeList<Expression> &args() const { return *_M_args; }
     };
 
     class FieldOperator : public Expression
@@ -1131,15 +1217,15 @@ namespace lesfl
 
     class Let : public Expression
     {
-      std::unique_ptr<const std::list<std::unique_ptr<Binding>>> _M_binds;
+      std::unique_ptr<const NodeList<Binding>> _M_binds;
       std::unique_ptr<Expression> _M_expr;
     public:
-      Let(const std::list<std::unique_ptr<Binding>> *binds, Expression *expr, const Position &pos) :
+      Let(const NodeList<Binding> *binds, Expression *expr, const Position &pos) :
         Expression(pos), _M_binds(binds), _M_expr(expr) {}
 
       ~Let();
 
-      const std::list<std::unique_ptr<Binding>> &binds() const { return *_M_binds; }
+      const NodeList<Binding> &binds() const { return *_M_binds; }
 
       Expression *expr() const { return _M_expr.get(); }
     };
@@ -1147,16 +1233,16 @@ namespace lesfl
     class Match : public Expression
     {
       std::unique_ptr<Expression> _M_expr;
-      std::unique_ptr<const std::list<std::unique_ptr<Case>>> _M_cases;
+      std::unique_ptr<const NodeList<Case>> _M_cases;
     public:
-      Match(Expression *expr, const std::list<std::unique_ptr<Case>> *cases, const Position &pos) :
+      Match(Expression *expr, const NodeList<Case> *cases, const Position &pos) :
         Expression(pos), _M_expr(expr), _M_cases(cases) {}
 
       ~Match();
 
       Expression *expr() const { return _M_expr.get(); }
 
-      const std::list<std::unique_ptr<Case>> &cases() const { return *_M_cases; }      
+      const NodeList<Case> &cases() const { return *_M_cases; }      
     };
 
     class Throw : public Expression
@@ -1204,15 +1290,15 @@ namespace lesfl
 
     class TupleBinding : public Binding
     {
-      std::unique_ptr<const std::list<std::unique_ptr<TupleBindingVariable>>> _M_vars;
+      std::unique_ptr<const NodeList<TupleBindingVariable>> _M_vars;
       Expression *_M_expr;
     public:
-      TupleBinding(const std::list<std::unique_ptr<TupleBindingVariable>> *vars, Expression *expr) :
+      TupleBinding(const NodeList<TupleBindingVariable> *vars, Expression *expr) :
         _M_vars(vars), _M_expr(expr) {}
 
       ~TupleBinding();
 
-      const std::list<std::unique_ptr<TupleBindingVariable>> &vars() const { return *_M_vars; }
+      const NodeList<TupleBindingVariable> &vars() const { return *_M_vars; }
 
       Expression *expr() const { return _M_expr; }
     };
@@ -1281,45 +1367,45 @@ namespace lesfl
 
     class UnnamedFieldConstructorPattern : public FunctionConstructorPattern
     {
-      std::unique_ptr<const std::list<std::unique_ptr<Pattern>>> _M_field_patterns;
+      std::unique_ptr<const NodeList<Pattern>> _M_field_patterns;
     public:
-      UnnamedFieldConstructorPattern(Identifier *constr_ident, const std::list<std::unique_ptr<Pattern>> *field_patterns, const Position &pos) :
+      UnnamedFieldConstructorPattern(Identifier *constr_ident, const NodeList<Pattern> *field_patterns, const Position &pos) :
         FunctionConstructorPattern(constr_ident, pos), _M_field_patterns(field_patterns) {}
 
       ~UnnamedFieldConstructorPattern();
 
-      const std::list<std::unique_ptr<Pattern>> &field_patterns() const { return *_M_field_patterns; }
+      const NodeList<Pattern> &field_patterns() const { return *_M_field_patterns; }
     };
 
     class NamedFieldConstructorPattern : public FunctionConstructorPattern
     {
-      std::unique_ptr<const std::list<std::unique_ptr<PatternNamedFieldPair>>> _M_field_patterns;
+      std::unique_ptr<const NodeList<PatternNamedFieldPair>> _M_field_patterns;
     public:
-      NamedFieldConstructorPattern(Identifier *constr_ident, const std::list<std::unique_ptr<PatternNamedFieldPair>> *field_patterns, const Position &pos) :
+      NamedFieldConstructorPattern(Identifier *constr_ident, const NodeList<PatternNamedFieldPair> *field_patterns, const Position &pos) :
         FunctionConstructorPattern(constr_ident, pos), _M_field_patterns(field_patterns) {}
 
       ~NamedFieldConstructorPattern();
 
-      const std::list<std::unique_ptr<PatternNamedFieldPair>> &field_patterns() const { return *_M_field_patterns; }
+      const NodeList<PatternNamedFieldPair> &field_patterns() const { return *_M_field_patterns; }
     };
 
     class CollectionPattern : public Pattern
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Pattern>>> _M_elem_patterns;
+      std::unique_ptr<const NodeList<Pattern>> _M_elem_patterns;
 
-      CollectionPattern(const std::list<std::unique_ptr<Pattern>> *elem_patterns, const Position &pos) :
+      CollectionPattern(const NodeList<Pattern> *elem_patterns, const Position &pos) :
         Pattern(pos), _M_elem_patterns(elem_patterns) {}
     public:
       ~CollectionPattern();
 
-      const std::list<std::unique_ptr<Pattern>> &elem_patterns() const { return *_M_elem_patterns; }
+      const NodeList<Pattern> &elem_patterns() const { return *_M_elem_patterns; }
     };
 
     class ListPattern : public CollectionPattern
     {
     public:
-      ListPattern(const std::list<std::unique_ptr<Pattern>> *elem_patterns, const Position &pos) :
+      ListPattern(const NodeList<Pattern> *elem_patterns, const Position &pos) :
         CollectionPattern(elem_patterns, pos) {}
 
       ~ListPattern();
@@ -1328,7 +1414,7 @@ namespace lesfl
     class ArrayPattern : public CollectionPattern
     {
     protected:
-      ArrayPattern(const std::list<std::unique_ptr<Pattern>> *elem_patterns, const Position &pos) :
+      ArrayPattern(const NodeList<Pattern> *elem_patterns, const Position &pos) :
         CollectionPattern(elem_patterns, pos) {}
     public:
       ~ArrayPattern();
@@ -1337,7 +1423,7 @@ namespace lesfl
     class NonUniqueArrayPattern : public ArrayPattern
     {
     public:
-      NonUniqueArrayPattern(const std::list<std::unique_ptr<Pattern>> *elem_patterns, const Position &pos) :
+      NonUniqueArrayPattern(const NodeList<Pattern> *elem_patterns, const Position &pos) :
         ArrayPattern(elem_patterns, pos) {}
 
       ~NonUniqueArrayPattern();
@@ -1346,7 +1432,7 @@ namespace lesfl
     class UniqueArrayPattern : public ArrayPattern
     {
     public:
-      UniqueArrayPattern(const std::list<std::unique_ptr<Pattern>> *elem_patterns, const Position &pos) :
+      UniqueArrayPattern(const NodeList<Pattern> *elem_patterns, const Position &pos) :
         ArrayPattern(elem_patterns, pos) {}
 
       ~UniqueArrayPattern();
@@ -1355,20 +1441,20 @@ namespace lesfl
     class TuplePattern : public Pattern
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Pattern>>> _M_field_patterns;
+      std::unique_ptr<const NodeList<Pattern>> _M_field_patterns;
 
-      TuplePattern(const std::list<std::unique_ptr<Pattern>> *field_patterns, const Position &pos) :
+      TuplePattern(const NodeList<Pattern> *field_patterns, const Position &pos) :
         Pattern(pos), _M_field_patterns(field_patterns) {}
     public:
       ~TuplePattern();
 
-      const std::list<std::unique_ptr<Pattern>> &field_patterns() const { return *_M_field_patterns; }
+      const NodeList<Pattern> &field_patterns() const { return *_M_field_patterns; }
     };
 
     class NonUniqueTuplePattern : public TuplePattern
     {
     public:
-      NonUniqueTuplePattern(const std::list<std::unique_ptr<Pattern>> *field_patterns, const Position &pos) :
+      NonUniqueTuplePattern(const NodeList<Pattern> *field_patterns, const Position &pos) :
         TuplePattern(field_patterns, pos) {}
 
       ~NonUniqueTuplePattern();
@@ -1377,7 +1463,7 @@ namespace lesfl
     class UniqueTuplePattern : public TuplePattern
     {
     public:
-      UniqueTuplePattern(const std::list<std::unique_ptr<Pattern>> *field_patterns, const Position &pos) :
+      UniqueTuplePattern(const NodeList<Pattern> *field_patterns, const Position &pos) :
         TuplePattern(field_patterns, pos) {}
 
       ~UniqueTuplePattern();
@@ -1546,36 +1632,33 @@ namespace lesfl
       const std::wstring &string() const { return _M_string; }
     };
 
-    class LambdaValue : public virtual LiteralValue, public Inlinable
+    class LambdaValue : public virtual LiteralValue, public Inlinable, public Bodied
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Argument>>> _M_args;
+      std::unique_ptr<const NodeList<Argument>> _M_args;
       std::unique_ptr<TypeExpression> _M_result_type_expr;
-      std::unique_ptr<Expression> _M_body;
 
-      LambdaValue(InlineModifier inline_modifier, const std::list<std::unique_ptr<Argument>> *args, Expression *body) :
-        Inlinable(inline_modifier), _M_args(args), _M_result_type_expr(nullptr), _M_body(body) {}
+      LambdaValue(InlineModifier inline_modifier, const NodeList<Argument> *args, Expression *body) :
+        Inlinable(inline_modifier), Bodied(body), _M_args(args), _M_result_type_expr(nullptr) {}
 
-      LambdaValue(InlineModifier inline_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, Expression *body) :
-        Inlinable(inline_modifier), _M_args(args), _M_result_type_expr(result_type_expr), _M_body(body) {}
+      LambdaValue(InlineModifier inline_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, Expression *body) :
+        Inlinable(inline_modifier), Bodied(body), _M_args(args), _M_result_type_expr(result_type_expr) {}
     public:
       ~LambdaValue();
 
-      const std::list<std::unique_ptr<Argument>> &args() const { return *_M_args; }
+      const NodeList<Argument> &args() const { return *_M_args; }
 
       TypeExpression *result_type_expr() const { return _M_result_type_expr.get(); }
-
-      Expression *body() const { return _M_body.get(); }
     };
 
     class NonUniqueLambdaValue : public LambdaValue, public NonUniqueLiteralValue
     {
       FunctionModifier _M_fun_modifier;
     public:
-      NonUniqueLambdaValue(InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, Expression *body) :
+      NonUniqueLambdaValue(InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, Expression *body) :
         LambdaValue(inline_modifier, args, body), _M_fun_modifier(fun_modifier) {}
 
-      NonUniqueLambdaValue(InlineModifier inline_modifier, FunctionModifier fun_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, Expression *body) :
+      NonUniqueLambdaValue(InlineModifier inline_modifier, FunctionModifier fun_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, Expression *body) :
         LambdaValue(inline_modifier, args, result_type_expr, body), _M_fun_modifier(fun_modifier) {}
 
       ~NonUniqueLambdaValue();
@@ -1586,10 +1669,10 @@ namespace lesfl
     class UniqueLambdaValue : public LambdaValue
     {
     public:
-      UniqueLambdaValue(InlineModifier inline_modifier, const std::list<std::unique_ptr<Argument>> *args, Expression *body) :
+      UniqueLambdaValue(InlineModifier inline_modifier, const NodeList<Argument> *args, Expression *body) :
         LambdaValue(inline_modifier, args, body) {}
 
-      UniqueLambdaValue(InlineModifier inline_modifier, const std::list<std::unique_ptr<Argument>> *args, TypeExpression *result_type_expr, Expression *body) :
+      UniqueLambdaValue(InlineModifier inline_modifier, const NodeList<Argument> *args, TypeExpression *result_type_expr, Expression *body) :
         LambdaValue(inline_modifier, args, result_type_expr, body) {}
 
       ~UniqueLambdaValue();
@@ -1618,20 +1701,20 @@ namespace lesfl
     class CollectionValue : public Value
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Value>>> _M_elems;
+      std::unique_ptr<const NodeList<Value>> _M_elems;
 
-      CollectionValue(const std::list<std::unique_ptr<Value>> *elems, const Position &pos) :
+      CollectionValue(const NodeList<Value> *elems, const Position &pos) :
         Value(pos), _M_elems(elems) {} 
     public:
       ~CollectionValue();
 
-      const std::list<std::unique_ptr<Value>> &elems() const { return *_M_elems; }
+      const NodeList<Value> &elems() const { return *_M_elems; }
     };
 
     class ListValue : public CollectionValue
     {
     public:
-      ListValue(const std::list<std::unique_ptr<Value>> *elems, const Position &pos) :
+      ListValue(const NodeList<Value> *elems, const Position &pos) :
         CollectionValue(elems, pos) {}
 
       ~ListValue();
@@ -1640,22 +1723,87 @@ namespace lesfl
     class ArrayValue : public CollectionValue
     {
     public:
-      ArrayValue(const std::list<std::unique_ptr<Value>> *elems, const Position &pos) :
+      ArrayValue(const NodeList<Value> *elems, const Position &pos) :
         CollectionValue(elems, pos) {}
 
       ~ArrayValue();
     };
 
+    class PackedElements
+    {
+      PackedElementType _M_elem_type;
+      std::size_t _M_elem_count;
+      std::vector<char> _M_data;
+    public:
+      PackedElements(PackedElementType elem_type) :
+        _M_elem_type(elem_type), _M_elem_count(0) {}
+
+      static std::size_t elem_size(PackedElementType elem_type);
+
+      PackedElementType elem_type() const { return _M_elem_type; }
+
+      std::size_t size() const { return _M_elem_count; }
+
+      std::size_t data_size() const { return _M_data.size(); }
+
+      void reserve(std::size_t count) { _M_data.reserve(count * elem_size(_M_elem_type)); }
+
+      char char_elem(std::size_t i) const;
+
+      std::int64_t int_elem(std::size_t i) const;
+
+      double float_elem(std::size_t i) const;
+
+      void add_char_elem(char c);
+
+      void add_int_elem(std::int64_t i);
+
+      void add_float_elem(double f);
+
+      SimpleLiteralValue *make_literal_value(std::size_t i) const;
+    };
+
+    class PackedCollectionValue : public Value
+    {
+    protected:
+      std::unique_ptr<const PackedElements> _M_elems;
+
+      PackedCollectionValue(const PackedElements *elems, const Position &pos) :
+        Value(pos), _M_elems(elems) {}
+    public:
+      ~PackedCollectionValue();
+
+      const PackedElements &elems() const { return *_M_elems; }
+    };
+
+    class PackedListValue : public PackedCollectionValue
+    {
+    public:
+      PackedListValue(const PackedElements *elems, const Position &pos) :
+        PackedCollectionValue(elems, pos) {}
+
+      ~PackedListValue();
+    };
+
+    class PackedArrayValue : public PackedCollectionValue
+    {
+    public:
+      PackedArrayValue(const PackedElements *elems, const Position &pos) :
+        PackedCollectionValue(elems, pos) {}
+
+      ~PackedArrayValue();
+    };
+
     class TupleValue : public Value
     {
-      std::unique_ptr<const std::list<std::unique_ptr<Value>>> _M_fields;
+      std::unique_ptr<const NodeList<Value>> _M_fields;
     public:
-      TupleValue(const std::list<std::unique_ptr<Value>> *fields, const Position &pos) :
+      TupleValue(const NodeList<Value> *fields, const Position &pos) :
         Value(pos), _M_fields(fields) {}
 
       ~TupleValue();
 
-      const std::list<std::unique_ptr<Value>> &fields() const { return *_M_fields; }
+      const NodeList<Value> &fields() const { return *_M_fields; }
     };
 
     class ConstructorValue : public Value
@@ -1691,26 +1839,26 @@ namespace lesfl
 
     class UnnamedFieldConstructorValue : public FunctionConstructorValue
     {
-      std::unique_ptr<const std::list<std::unique_ptr<Value>>> _M_fields;
+      std::unique_ptr<const NodeList<Value>> _M_fields;
     public:
-      UnnamedFieldConstructorValue(Identifier *constr_ident, const std::list<std::unique_ptr<Value>> *fields, const Position &pos) :
+      UnnamedFieldConstructorValue(Identifier *constr_ident, const NodeList<Value> *fields, const Position &pos) :
         FunctionConstructorValue(constr_ident, pos), _M_fields(fields) {}
 
       ~UnnamedFieldConstructorValue();
 
-      const std::list<std::unique_ptr<Value>> &fields() const { return *_M_fields; }
+      const NodeList<Value> &fields() const { return *_M_fields; }
     };
 
     class NamedFieldConstructorValue : public FunctionConstructorValue
     {
-      std::unique_ptr<const std::list<std::unique_ptr<ValueNamedFieldPair>>> _M_fields;
+      std::unique_ptr<const NodeList<ValueNamedFieldPair>> _M_fields;
     public:
-      NamedFieldConstructorValue(Identifier *constr_ident, const std::list<std::unique_ptr<ValueNamedFieldPair>> *fields, const Position &pos) :
+      NamedFieldConstructorValue(Identifier *constr_ident, const NodeList<ValueNamedFieldPair> *fields, const Position &pos) :
         FunctionConstructorValue(constr_ident, pos), _M_fields(fields) {}
 
       ~NamedFieldConstructorValue();
 
-      const std::list<std::unique_ptr<ValueNamedFieldPair>> &fields() const { return *_M_fields; }
+      const NodeList<ValueNamedFieldPair> &fields() const { return *_M_fields; }
     };
 
     class TypedValue : public Value
@@ -1804,27 +1952,27 @@ namespace lesfl
     class DefinableTypeFunction : public TypeFunction
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<TypeParameter>>> _M_inst_type_params;
-      std::unique_ptr<const std::list<std::unique_ptr<TypeArgument>>> _M_args;
+      std::unique_ptr<const NodeList<TypeParameter>> _M_inst_type_params;
+      std::unique_ptr<const NodeList<TypeArgument>> _M_args;
     public:
-      DefinableTypeFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<TypeArgument>> *args) :
+      DefinableTypeFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<TypeArgument> *args) :
         TypeFunction(args->size()), _M_inst_type_params(inst_type_params), _M_args(args) {}
 
       ~DefinableTypeFunction();
 
-      const std::list<std::unique_ptr<TypeParameter>> &inst_type_params() const { return *_M_inst_type_params; }
+      const NodeList<TypeParameter> &inst_type_params() const { return *_M_inst_type_params; }
 
-      const std::list<std::unique_ptr<TypeArgument>> &args() const { return *_M_args; }
+      const NodeList<TypeArgument> &args() const { return *_M_args; }
     };
 
     class TypeSynonymFunction : public DefinableTypeFunction
     {
       std::unique_ptr<TypeExpression> _M_body;
     public:
-      TypeSynonymFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<TypeArgument>> *args, TypeExpression *body) :
+      TypeSynonymFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<TypeArgument> *args, TypeExpression *body) :
         DefinableTypeFunction(inst_type_params, args), _M_body(body) {}
 
-      TypeSynonymFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<TypeArgument>> *args) :
+      TypeSynonymFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<TypeArgument> *args) :
         DefinableTypeFunction(inst_type_params, args), _M_body(nullptr) {}
         
       ~TypeSynonymFunction();
@@ -1836,7 +1984,7 @@ namespace lesfl
     {
       std::unique_ptr<Datatype> _M_datatype;
     public:
-      DatatypeFunction(const std::list<std::unique_ptr<TypeParameter>> *inst_type_params, const std::list<std::unique_ptr<TypeArgument>> *args, Datatype *datatype) :
+      DatatypeFunction(const NodeList<TypeParameter> *inst_type_params, const NodeList<TypeArgument> *args, Datatype *datatype) :
         DefinableTypeFunction(inst_type_params, args), _M_datatype(datatype) {}
 
       ~DatatypeFunction();
@@ -1860,23 +2008,23 @@ namespace lesfl
     {
     protected:
       bool _M_is_template;
-      std::unique_ptr<const std::list<std::unique_ptr<TypeExpression>>> _M_args;
+      std::unique_ptr<const NodeList<TypeExpression>> _M_args;
 
-      TypeFunctionInstance(bool is_template, const std::list<std::unique_ptr<TypeExpression>> *args, const Position &pos) :
+      TypeFunctionInstance(bool is_template, const NodeList<TypeExpression> *args, const Position &pos) :
         Positional(pos), _M_is_template(is_template), _M_args(args) {}
     public:
       virtual ~TypeFunctionInstance();
       
       bool is_template() const { return _M_is_template; }
 
-      const std::list<std::unique_ptr<TypeExpression>> &args() const { return *_M_args; }
+      const NodeList<TypeExpression> &args() const { return *_M_args; }
     };
 
     class TypeSynonymFunctionInstance : public TypeFunctionInstance
     {
       std::unique_ptr<TypeExpression> _M_body;
     public:
-      TypeSynonymFunctionInstance(bool is_template, const std::list<std::unique_ptr<TypeExpression>> *args, TypeExpression *body, const Position &pos) :
+      TypeSynonymFunctionInstance(bool is_template, const NodeList<TypeExpression> *args, TypeExpression *body, const Position &pos) :
         TypeFunctionInstance(is_template, args, pos), _M_body(body) {}
 
       ~TypeSynonymFunctionInstance();
@@ -1888,7 +2036,7 @@ namespace lesfl
     {
       std::unique_ptr<Datatype> _M_datatype;
     public:
-      DatatypeFunctionInstance(bool is_template, const std::list<std::unique_ptr<TypeExpression>> *args, Datatype *datatype, const Position &pos) :
+      DatatypeFunctionInstance(bool is_template, const NodeList<TypeExpression> *args, Datatype *datatype, const Position &pos) :
         TypeFunctionInstance(is_template, args, pos), _M_datatype(datatype) {}
 
       ~DatatypeFunctionInstance();
@@ -1968,45 +2116,45 @@ namespace lesfl
     class FunctionConstructor : public Constructor, public Inlinable
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<Annotation>>> _M_annotations;
+      std::unique_ptr<const NodeList<Annotation>> _M_annotations;
 
-      FunctionConstructor(const std::list<std::unique_ptr<Annotation>> *annotations, AccessModifier access_modifier, InlineModifier inline_modifier, const std::string &ident, const Position &pos) :
+      FunctionConstructor(const NodeList<Annotation> *annotations, AccessModifier access_modifier, InlineModifier inline_modifier, const std::string &ident, const Position &pos) :
         Constructor(access_modifier, ident, pos), Inlinable(inline_modifier), _M_annotations(annotations) {}
     public:
       ~FunctionConstructor();
 
-      const std::list<std::unique_ptr<Annotation>> &annotations() const { return *_M_annotations; }
+      const NodeList<Annotation> &annotations() const { return *_M_annotations; }
 
       virtual std::size_t field_count() = 0;
     };
 
     class UnnamedFieldConstructor : public FunctionConstructor
     {
-      std::unique_ptr<const std::list<std::unique_ptr<TypeExpression>>> _M_field_types;
+      std::unique_ptr<const NodeList<TypeExpression>> _M_field_types;
     public:
-      UnnamedFieldConstructor(const std::list<std::unique_ptr<Annotation>> *annotations, AccessModifier access_modifier, InlineModifier inline_modifier, const std::string &ident, const std::list<std::unique_ptr<TypeExpression>> *field_types, const Position &pos) :
+      UnnamedFieldConstructor(const NodeList<Annotation> *annotations, AccessModifier access_modifier, InlineModifier inline_modifier, const std::string &ident, const NodeList<TypeExpression> *field_types, const Position &pos) :
         FunctionConstructor(annotations, access_modifier, inline_modifier, ident, pos), _M_field_types(field_types) {}
 
       ~UnnamedFieldConstructor();
 
       std::size_t field_count();
 
-      const std::list<std::unique_ptr<TypeExpression>> &field_types() const { return *_M_field_types; }
+      const NodeList<TypeExpression> &field_types() const { return *_M_field_types; }
     };
 
     class NamedFieldConstructor : public FunctionConstructor
     {
-      std::unique_ptr<const std::list<std::unique_ptr<TypeNamedFieldPair>>> _M_field_types;
+      std::unique_ptr<const NodeList<TypeNamedFieldPair>> _M_field_types;
       std::unordered_map<std::string, std::size_t> _M_field_indices;
     public:
-      NamedFieldConstructor(const std::list<std::unique_ptr<Annotation>> *annotations, AccessModifier access_modifier, InlineModifier inline_modifier, const std::string &ident, const std::list<std::unique_ptr<TypeNamedFieldPair>> *field_types, const Position &pos) :
+      NamedFieldConstructor(const NodeList<Annotation> *annotations, AccessModifier access_modifier, InlineModifier inline_modifier, const std::string &ident, const NodeList<TypeNamedFieldPair> *field_types, const Position &pos) :
         FunctionConstructor(annotations, access_modifier, inline_modifier, ident, pos), _M_field_types(field_types) {}
 
       ~NamedFieldConstructor();
 
       std::size_t field_count();
 
-      const std::list<std::unique_ptr<TypeNamedFieldPair>> &field_types() const { return *_M_field_types; }
+      const NodeList<TypeNamedFieldPair> &field_types() const { return *_M_field_types; }
 
       const std::unordered_map<std::string, std::size_t> &field_indices() const { return _M_field_indices; }
 
@@ -2090,20 +2238,20 @@ namespace lesfl
     class TupleType : public TypeExpression
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<TypeExpression>>> _M_field_types;
+      std::unique_ptr<const NodeList<TypeExpression>> _M_field_types;
 
-      TupleType(const std::list<std::unique_ptr<TypeExpression>> *field_types, const Position &pos) :
+      TupleType(const NodeList<TypeExpression> *field_types, const Position &pos) :
         TypeExpression(pos), _M_field_types(field_types) {}
     public:
       ~TupleType();
 
-      const std::list<std::unique_ptr<TypeExpression>> &field_types() const { return *_M_field_types; }
+      const NodeList<TypeExpression> &field_types() const { return *_M_field_types; }
     };
 
     class NonUniqueTupleType : public TupleType
     {
     public:
-      NonUniqueTupleType(const std::list<std::unique_ptr<TypeExpression>> *field_types, const Position &pos) :
+      NonUniqueTupleType(const NodeList<TypeExpression> *field_types, const Position &pos) :
         TupleType(field_types, pos) {}
 
       ~NonUniqueTupleType();
@@ -2112,7 +2260,7 @@ namespace lesfl
     class UniqueTupleType : public TupleType
     {
     public:
-      UniqueTupleType(const std::list<std::unique_ptr<TypeExpression>> *field_types, const Position &pos) :
+      UniqueTupleType(const NodeList<TypeExpression> *field_types, const Position &pos) :
         TupleType(field_types, pos) {}
 
       ~UniqueTupleType();
@@ -2121,15 +2269,15 @@ namespace lesfl
     class FunctionType : public TypeExpression
     {
     protected:
-      std::unique_ptr<const std::list<std::unique_ptr<TypeExpression>>> _M_arg_types;
+      std::unique_ptr<const NodeList<TypeExpression>> _M_arg_types;
       std::unique_ptr<TypeExpression> _M_result_type;
 
-      FunctionType(const std::list<std::unique_ptr<TypeExpression>> *arg_types, TypeExpression *result_type, const Position &pos) :
+      FunctionType(const NodeList<TypeExpression> *arg_types, TypeExpression *result_type, const Position &pos) :
         TypeExpression(pos), _M_arg_types(arg_types), _M_result_type(result_type) {}
     public:
       ~FunctionType();
 
-      const std::list<std::unique_ptr<TypeExpression>> &arg_types() const { return *_M_arg_types; }
+      const NodeList<TypeExpression> &arg_types() const { return *_M_arg_types; }
 
       TypeExpression *result_type() const { return _M_result_type.get(); }
     };
@@ -2138,7 +2286,7 @@ namespace lesfl
     {
       FunctionModifier _M_fun_modifier;
     public:
-      NonUniqueFunctionType(const std::list<std::unique_ptr<TypeExpression>> *arg_types, FunctionModifier fun_modifier, TypeExpression *result_type, const Position &pos) :
+      NonUniqueFunctionType(const NodeList<TypeExpression> *arg_types, FunctionModifier fun_modifier, TypeExpression *result_type, const Position &pos) :
         FunctionType(arg_types, result_type, pos), _M_fun_modifier(fun_modifier) {}
 
       ~NonUniqueFunctionType();
@@ -2149,7 +2297,7 @@ namespace lesfl
     class UniqueFunctionType : public FunctionType
     {
     public:
-      UniqueFunctionType(const std::list<std::unique_ptr<TypeExpression>> *arg_types, TypeExpression *result_type, const Position &pos) :
+      UniqueFunctionType(const NodeList<TypeExpression> *arg_types, TypeExpression *result_type, const Position &pos) :
         FunctionType(arg_types, result_type, pos) {}
 
       ~UniqueFunctionType();
@@ -2158,16 +2306,16 @@ namespace lesfl
     class TypeApplication : public TypeExpression
     {
       std::unique_ptr<Identifier> _M_fun_ident;
-      std::unique_ptr<const std::list<std::unique_ptr<TypeExpression>>> _M_args;
+      std::unique_ptr<const NodeList<TypeExpression>> _M_args;
     public:
-      TypeApplication(Identifier *fun_ident, const std::list<std::unique_ptr<TypeExpression>> *args, const Position &pos) :
+      TypeApplication(Identifier *fun_ident, const NodeList<TypeExpression> *args, const Position &pos) :
         TypeExpression(pos), _M_fun_ident(fun_ident), _M_args(args) {}
 
       ~TypeApplication();
 
       Identifier *fun_ident() const { return _M_fun_ident.get(); }
 
-      const std::list<std::unique_ptr<TypeExpression>> &args() const { return *_M_args; }
+      const NodeList<TypeExpression> &args() const { return *_M_args; }
     };
   }
 }
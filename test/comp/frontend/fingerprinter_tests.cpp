@@ -0,0 +1,283 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <sstream>
+#include "frontend/fingerprinter_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(FingerprinterTests);
+
+      void FingerprinterTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+        _M_fingerprinter = new Fingerprinter();
+      }
+
+      void FingerprinterTests::tearDown()
+      {
+        delete _M_fingerprinter;
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      bool FingerprinterTests::fingerprint_module(const char *str, const list<string> &module_idents, uint64_t &fingerprint)
+      { return fingerprint_module(*_M_parser, str, module_idents, fingerprint); }
+
+      bool FingerprinterTests::fingerprint_module(Parser &parser, const char *str, const list<string> &module_idents, uint64_t &fingerprint)
+      {
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        if(!_M_builtin_type_adder->add_builtin_types(tree)) return false;
+        if(!parser.parse(sources, tree, errors)) return false;
+        if(!_M_resolver->resolve(tree, errors)) return false;
+        unordered_map<KeyIdentifier, uint64_t> fingerprints;
+        if(!_M_fingerprinter->fingerprint_modules(tree, fingerprints)) return false;
+        AbsoluteIdentifier module_abs_ident(module_idents);
+        if(!module_abs_ident.set_key_ident(*(tree.ident_table()))) return false;
+        auto iter = fingerprints.find(module_abs_ident.key_ident());
+        if(iter == fingerprints.end()) return false;
+        fingerprint = iter->second;
+        return true;
+      }
+
+      void FingerprinterTests::test_fingerprinter_fingerprints_modules()
+      {
+        istringstream iss("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int64 = #iadd(x, 1)\n\
+}\n\
+\n\
+module otherlib {\n\
+  f(x: Int64): Int64 = #iadd(x, 1)\n\
+}\n\
+\n\
+g(x: Int64): Int64 = #isub(x, 1)\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        unordered_map<KeyIdentifier, uint64_t> fingerprints;
+        CPPUNIT_ASSERT_EQUAL(true, _M_fingerprinter->fingerprint_modules(tree, fingerprints));
+        CPPUNIT_ASSERT_EQUAL(tree.module_key_idents().size(), fingerprints.size());
+        AbsoluteIdentifier root_abs_ident;
+        CPPUNIT_ASSERT_EQUAL(true, root_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier somelib_abs_ident(list<string> { "somelib" });
+        CPPUNIT_ASSERT_EQUAL(true, somelib_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier otherlib_abs_ident(list<string> { "otherlib" });
+        CPPUNIT_ASSERT_EQUAL(true, otherlib_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT(fingerprints.end() != fingerprints.find(root_abs_ident.key_ident()));
+        CPPUNIT_ASSERT(fingerprints.end() != fingerprints.find(somelib_abs_ident.key_ident()));
+        CPPUNIT_ASSERT(fingerprints.end() != fingerprints.find(otherlib_abs_ident.key_ident()));
+        CPPUNIT_ASSERT(fingerprints[root_abs_ident.key_ident()] != fingerprints[somelib_abs_ident.key_ident()]);
+        CPPUNIT_ASSERT(fingerprints[somelib_abs_ident.key_ident()] != fingerprints[otherlib_abs_ident.key_ident()]);
+      }
+
+      void FingerprinterTests::test_fingerprinter_does_not_change_fingerprint_for_private_change()
+      {
+        uint64_t fingerprint1, fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int64 = g(x)\n\
+\n\
+  private g(x) = #iadd(x, 1)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint1));
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int64 = g(x)\n\
+\n\
+  private g(x) = #isub(x, 2)\n\
+\n\
+  private h(x) = x\n\
+}\n\
+", list<string> { "somelib" }, fingerprint2));
+        CPPUNIT_ASSERT_EQUAL(fingerprint1, fingerprint2);
+      }
+
+      void FingerprinterTests::test_fingerprinter_does_not_change_fingerprint_for_body_change_of_typed_function()
+      {
+        uint64_t fingerprint1, fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int64 = #iadd(x, 1)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint1));
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+\n\
+  f(x: Int64): Int64 =\n\
+    #isub(x, 1)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint2));
+        CPPUNIT_ASSERT_EQUAL(fingerprint1, fingerprint2);
+      }
+
+      void FingerprinterTests::test_fingerprinter_changes_fingerprint_for_public_type_change()
+      {
+        uint64_t fingerprint1, fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int64 = #iadd(x, 1)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint1));
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int32 = #itoi32(#iadd(x, 1))\n\
+}\n\
+", list<string> { "somelib" }, fingerprint2));
+        CPPUNIT_ASSERT(fingerprint1 != fingerprint2);
+      }
+
+      void FingerprinterTests::test_fingerprinter_changes_fingerprint_for_body_change_of_inline_function()
+      {
+        uint64_t fingerprint1, fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  inline f(x: Int64): Int64 = #iadd(x, 1)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint1));
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  inline f(x: Int64): Int64 = #isub(x, 1)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint2));
+        CPPUNIT_ASSERT(fingerprint1 != fingerprint2);
+      }
+
+      void FingerprinterTests::test_fingerprinter_changes_fingerprint_for_constructor_change()
+      {
+        uint64_t fingerprint1, fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  datatype T = C(Int8, Int64)\n\
+}\n\
+", list<string> { "somelib" }, fingerprint1));
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  datatype T = C(Int8, Int64) | D\n\
+}\n\
+", list<string> { "somelib" }, fingerprint2));
+        CPPUNIT_ASSERT(fingerprint1 != fingerprint2);
+      }
+
+      void FingerprinterTests::test_fingerprinter_adds_fingerprints_to_interface()
+      {
+        istringstream iss("\
+import stdlib\n\
+\n\
+module somelib {\n\
+  f(x: Int64): Int64 = #iadd(x, 1)\n\
+}\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        unordered_map<KeyIdentifier, uint64_t> fingerprints;
+        CPPUNIT_ASSERT_EQUAL(true, _M_fingerprinter->fingerprint_modules(tree, fingerprints));
+        Interface iface;
+        CPPUNIT_ASSERT_EQUAL(true, _M_fingerprinter->fingerprint_modules(tree, iface));
+        AbsoluteIdentifier somelib_abs_ident(list<string> { "somelib" });
+        CPPUNIT_ASSERT_EQUAL(true, somelib_abs_ident.set_key_ident(*(tree.ident_table())));
+        uint64_t fingerprint;
+        CPPUNIT_ASSERT_EQUAL(true, iface.module_fingerprint(".somelib", fingerprint));
+        CPPUNIT_ASSERT_EQUAL(fingerprints[somelib_abs_ident.key_ident()], fingerprint);
+        Interface iface2;
+        CPPUNIT_ASSERT_EQUAL(true, _M_fingerprinter->fingerprint_modules(tree, iface2));
+        CPPUNIT_ASSERT_EQUAL(true, iface.has_same_module_fingerprints(iface2, vector<string> { ".somelib" }));
+        CPPUNIT_ASSERT_EQUAL(false, iface.has_same_module_fingerprints(Interface(), vector<string> { ".somelib" }));
+      }
+
+      void FingerprinterTests::test_fingerprinter_fingerprints_very_deep_expression()
+      {
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        uint64_t fingerprint1;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module(str.c_str(), list<string> {}, fingerprint1));
+        uint64_t fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module(str.c_str(), list<string> {}, fingerprint2));
+        CPPUNIT_ASSERT_EQUAL(fingerprint1, fingerprint2);
+        str.insert(str.size() - 1, " + x");
+        uint64_t fingerprint3;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module(str.c_str(), list<string> {}, fingerprint3));
+        CPPUNIT_ASSERT(fingerprint1 != fingerprint3);
+      }
+
+      void FingerprinterTests::test_fingerprinter_fingerprints_modules_with_deferred_bodies()
+      {
+        const char *str = "\
+import stdlib\n\
+\n\
+module somelib {\n\
+  inline f(x: Int64): Int64 = #iadd(x, 1)\n\
+\n\
+  inline g(x: Int64): Int64 =\n\
+    let\n\
+      h = \\(y: Int64) -> #imul(y, 2)\n\
+    in\n\
+      h(x)\n\
+\n\
+  k = \\(x: Int64) -> #isub(x, 1)\n\
+}\n\
+";
+        Parser deferring_parser(true);
+        uint64_t fingerprint1;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module(str, list<string> { "somelib" }, fingerprint1));
+        uint64_t fingerprint2;
+        CPPUNIT_ASSERT_EQUAL(true, fingerprint_module(deferring_parser, str, list<string> { "somelib" }, fingerprint2));
+        CPPUNIT_ASSERT_EQUAL(fingerprint1, fingerprint2);
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_FINGERPRINTER_TESTS_HPP
+#define _FRONTEND_FINGERPRINTER_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class FingerprinterTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(FingerprinterTests);
+        CPPUNIT_TEST(test_fingerprinter_fingerprints_modules);
+        CPPUNIT_TEST(test_fingerprinter_does_not_change_fingerprint_for_private_change);
+        CPPUNIT_TEST(test_fingerprinter_does_not_change_fingerprint_for_body_change_of_typed_function);
+        CPPUNIT_TEST(test_fingerprinter_changes_fingerprint_for_public_type_change);
+        CPPUNIT_TEST(test_fingerprinter_changes_fingerprint_for_body_change_of_inline_function);
+        CPPUNIT_TEST(test_fingerprinter_changes_fingerprint_for_constructor_change);
+        CPPUNIT_TEST(test_fingerprinter_adds_fingerprints_to_interface);
+        CPPUNIT_TEST(test_fingerprinter_fingerprints_very_deep_expression);
+        CPPUNIT_TEST(test_fingerprinter_fingerprints_modules_with_deferred_bodies);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+        Fingerprinter *_M_fingerprinter;
+
+        bool fingerprint_module(const char *str, const std::list<std::string> &module_idents, std::uint64_t &fingerprint);
+
+        bool fingerprint_module(Parser &parser, const char *str, const std::list<std::string> &module_idents, std::uint64_t &fingerprint);
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_fingerprinter_fingerprints_modules();
+        void test_fingerprinter_does_not_change_fingerprint_for_private_change();
+        void test_fingerprinter_does_not_change_fingerprint_for_body_change_of_typed_function();
+        void test_fingerprinter_changes_fingerprint_for_public_type_change();
+        void test_fingerprinter_changes_fingerprint_for_body_change_of_inline_function();
+        void test_fingerprinter_changes_fingerprint_for_constructor_change();
+        void test_fingerprinter_adds_fingerprints_to_interface();
+        void test_fingerprinter_fingerprints_very_deep_expression();
+        void test_fingerprinter_fingerprints_modules_with_deferred_bodies();
+      };
+    }
+  }
+}
+
+#endif
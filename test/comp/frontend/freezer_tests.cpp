@@ -0,0 +1,402 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include "frontend/freezer_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(FreezerTests);
+
+      void FreezerTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+        _M_freezer = new Freezer();
+      }
+
+      void FreezerTests::tearDown()
+      {
+        delete _M_freezer;
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      bool FreezerTests::freeze(const char *str, Tree &tree, FrozenTree &frozen_tree)
+      {
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        if(!_M_builtin_type_adder->add_builtin_types(tree)) return false;
+        if(!_M_parser->parse(sources, tree, errors)) return false;
+        if(!_M_resolver->resolve(tree, errors)) return false;
+        if(!_M_freezer->freeze(tree, frozen_tree, errors)) return false;
+        return errors.empty();
+      }
+
+      bool FreezerTests::find_def_node(const Tree &tree, const FrozenTree &frozen_tree, const char *ident, uint32_t &node)
+      {
+        AbsoluteIdentifier abs_ident(ident);
+        if(!abs_ident.set_key_ident(*(tree.ident_table()))) return false;
+        for(size_t i = 0; i < frozen_tree.def_count(); i++) {
+          if(frozen_tree.def_key_ident(i) == abs_ident.key_ident()) {
+            node = frozen_tree.def_node(i);
+            return true;
+          }
+        }
+        return false;
+      }
+
+      bool FreezerTests::find_type_def_nodes(const Tree &tree, const FrozenTree &frozen_tree, const char *ident, vector<uint32_t> &nodes)
+      {
+        AbsoluteIdentifier abs_ident(ident);
+        if(!abs_ident.set_key_ident(*(tree.ident_table()))) return false;
+        nodes.clear();
+        for(size_t i = 0; i < frozen_tree.type_def_count(); i++) {
+          if(frozen_tree.type_def_key_ident(i) == abs_ident.key_ident())
+            nodes.push_back(frozen_tree.type_def_node(i));
+        }
+        return !nodes.empty();
+      }
+
+      void FreezerTests::test_freezer_freezes_function_and_variable()
+      {
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze("\
+import stdlib\n\
+\n\
+f(x: Int64): Int64 = #iadd(x, 1)\n\
+a = 2\n\
+", tree, frozen_tree));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), frozen_tree.def_count());
+        uint32_t fun_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree, "f", fun_node));
+        CPPUNIT_ASSERT(FrozenNodeKind::FUNCTION == frozen_tree.kind(fun_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), frozen_tree.data(fun_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(3), frozen_tree.child_count(fun_node));
+        uint32_t arg_node = frozen_tree.child(fun_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::ARGUMENT == frozen_tree.kind(arg_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), frozen_tree.data(arg_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(3), frozen_tree.line(arg_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(3), frozen_tree.column(arg_node));
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), frozen_tree.source_file_name(arg_node));
+        uint32_t result_type_node = frozen_tree.child(fun_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_VARIABLE == frozen_tree.kind(result_type_node));
+        AbsoluteIdentifier int64_abs_ident(list<string> { "stdlib", "Int64" });
+        CPPUNIT_ASSERT_EQUAL(true, int64_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(int64_abs_ident.key_ident().key()), frozen_tree.data(result_type_node));
+        uint32_t body_node = frozen_tree.child(fun_node, 2);
+        CPPUNIT_ASSERT(FrozenNodeKind::BUILTIN_APPLICATION == frozen_tree.kind(body_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(BuiltinFunction::IADD), frozen_tree.data(body_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(body_node));
+        uint32_t var_node = frozen_tree.child(body_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::LOCAL_VARIABLE == frozen_tree.kind(var_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), frozen_tree.data(var_node));
+        uint32_t int_node = frozen_tree.child(body_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::INT == frozen_tree.kind(int_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(IntType::INT64), frozen_tree.flags(int_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), frozen_tree.data(int_node));
+        uint32_t var_def_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree, "a", var_def_node));
+        CPPUNIT_ASSERT(FrozenNodeKind::VARIABLE == frozen_tree.kind(var_def_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(var_def_node));
+        CPPUNIT_ASSERT_EQUAL(FrozenTree::null_node, frozen_tree.child(var_def_node, 0));
+        uint32_t value_node = frozen_tree.child(var_def_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::INT == frozen_tree.kind(value_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), frozen_tree.data(value_node));
+      }
+
+      void FreezerTests::test_freezer_freezes_let_expression_and_global_variable()
+      {
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze("\
+import stdlib\n\
+\n\
+f(x: Int64): Int64 = x\n\
+g(x: Int64): Int64 =\n\
+  let y = f(x)\n\
+  in  y\n\
+", tree, frozen_tree));
+        uint32_t fun_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree, "g", fun_node));
+        uint32_t let_node = frozen_tree.child(fun_node, 2);
+        CPPUNIT_ASSERT(FrozenNodeKind::LET == frozen_tree.kind(let_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(let_node));
+        uint32_t bind_node = frozen_tree.child(let_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::VARIABLE_BINDING == frozen_tree.kind(bind_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), frozen_tree.data(bind_node));
+        uint32_t app_node = frozen_tree.child(bind_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::NON_UNIQUE_APPLICATION == frozen_tree.kind(app_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(app_node));
+        uint32_t global_var_node = frozen_tree.child(app_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::GLOBAL_VARIABLE == frozen_tree.kind(global_var_node));
+        AbsoluteIdentifier f_abs_ident("f");
+        CPPUNIT_ASSERT_EQUAL(true, f_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(f_abs_ident.key_ident().key()), frozen_tree.data(global_var_node));
+        uint32_t local_var_node = frozen_tree.child(app_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::LOCAL_VARIABLE == frozen_tree.kind(local_var_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), frozen_tree.data(local_var_node));
+        uint32_t expr_node = frozen_tree.child(let_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::LOCAL_VARIABLE == frozen_tree.kind(expr_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), frozen_tree.data(expr_node));
+      }
+
+      void FreezerTests::test_freezer_freezes_packed_list_value()
+      {
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze("\
+a = [1i8, 2i8, 3i8, 4i8, 5i8, 6i8, 7i8, 8i8, 9i8, 10i8, 11i8, 12i8, 13i8, 14i8, 15i8, 16i8, -1i8]\n\
+", tree, frozen_tree));
+        uint32_t var_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree, "a", var_node));
+        uint32_t value_node = frozen_tree.child(var_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::PACKED_LIST_VALUE == frozen_tree.kind(value_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(PackedElementType::INT8), frozen_tree.flags(value_node));
+        uint32_t i = frozen_tree.data(value_node);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(17), frozen_tree.packed_elem_count(i));
+        const char *data = frozen_tree.packed_elem_data(i);
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(1), static_cast<int>(data[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(16), static_cast<int>(data[15]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(-1), static_cast<int>(data[16]));
+      }
+
+      void FreezerTests::test_freezer_freezes_type_definitions()
+      {
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze("\
+import stdlib\n\
+\n\
+datatype T = C | D(Int64, T)\n\
+\n\
+unique datatype U = E {\n\
+    field1: Int64\n\
+  }\n\
+\n\
+type V = T\n\
+\n\
+template\n\
+type X(t) = Array(t)\n\
+\n\
+template(t)\n\
+datatype W(t)\n\
+\n\
+instance\n\
+datatype W(Int64) = F\n\
+", tree, frozen_tree));
+        AbsoluteIdentifier stdlib_int64_abs_ident(list<string> { "stdlib", "Int64" });
+        CPPUNIT_ASSERT_EQUAL(true, stdlib_int64_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier t_abs_ident("T");
+        CPPUNIT_ASSERT_EQUAL(true, t_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier c_abs_ident("C");
+        CPPUNIT_ASSERT_EQUAL(true, c_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier d_abs_ident("D");
+        CPPUNIT_ASSERT_EQUAL(true, d_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier e_abs_ident("E");
+        CPPUNIT_ASSERT_EQUAL(true, e_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier f_abs_ident("F");
+        CPPUNIT_ASSERT_EQUAL(true, f_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), frozen_tree.type_def_count());
+        vector<uint32_t> nodes;
+        CPPUNIT_ASSERT_EQUAL(true, find_type_def_nodes(tree, frozen_tree, "T", nodes));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), nodes.size());
+        CPPUNIT_ASSERT(FrozenNodeKind::DATATYPE_VARIABLE == frozen_tree.kind(nodes[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(nodes[0]));
+        uint32_t datatype_node = frozen_tree.child(nodes[0], 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::NON_UNIQUE_DATATYPE == frozen_tree.kind(datatype_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(datatype_node));
+        uint32_t constr_node1 = frozen_tree.child(datatype_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::VARIABLE_CONSTRUCTOR == frozen_tree.kind(constr_node1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(c_abs_ident.key_ident().key()), frozen_tree.data(constr_node1));
+        uint32_t constr_node2 = frozen_tree.child(datatype_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::UNNAMED_FIELD_CONSTRUCTOR == frozen_tree.kind(constr_node2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(d_abs_ident.key_ident().key()), frozen_tree.data(constr_node2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(constr_node2));
+        uint32_t field_type_node1 = frozen_tree.child(constr_node2, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_VARIABLE == frozen_tree.kind(field_type_node1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(stdlib_int64_abs_ident.key_ident().key()), frozen_tree.data(field_type_node1));
+        uint32_t field_type_node2 = frozen_tree.child(constr_node2, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_VARIABLE == frozen_tree.kind(field_type_node2));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(t_abs_ident.key_ident().key()), frozen_tree.data(field_type_node2));
+        CPPUNIT_ASSERT_EQUAL(true, find_type_def_nodes(tree, frozen_tree, "U", nodes));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), nodes.size());
+        CPPUNIT_ASSERT(FrozenNodeKind::DATATYPE_VARIABLE == frozen_tree.kind(nodes[0]));
+        datatype_node = frozen_tree.child(nodes[0], 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::UNIQUE_DATATYPE == frozen_tree.kind(datatype_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(datatype_node));
+        uint32_t constr_node3 = frozen_tree.child(datatype_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::NAMED_FIELD_CONSTRUCTOR == frozen_tree.kind(constr_node3));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(e_abs_ident.key_ident().key()), frozen_tree.data(constr_node3));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(constr_node3));
+        uint32_t named_field_node = frozen_tree.child(constr_node3, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_NAMED_FIELD == frozen_tree.kind(named_field_node));
+        CPPUNIT_ASSERT_EQUAL(string("field1"), frozen_tree.string(frozen_tree.data(named_field_node)));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(named_field_node));
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_VARIABLE == frozen_tree.kind(frozen_tree.child(named_field_node, 0)));
+        CPPUNIT_ASSERT_EQUAL(true, find_type_def_nodes(tree, frozen_tree, "V", nodes));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), nodes.size());
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_SYNONYM_VARIABLE == frozen_tree.kind(nodes[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(nodes[0]));
+        uint32_t type_var_node = frozen_tree.child(nodes[0], 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_VARIABLE == frozen_tree.kind(type_var_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(t_abs_ident.key_ident().key()), frozen_tree.data(type_var_node));
+        CPPUNIT_ASSERT_EQUAL(true, find_type_def_nodes(tree, frozen_tree, "X", nodes));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), nodes.size());
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_SYNONYM_FUNCTION == frozen_tree.kind(nodes[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1), frozen_tree.data(nodes[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(nodes[0]));
+        uint32_t type_app_node = frozen_tree.child(nodes[0], 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_APPLICATION == frozen_tree.kind(type_app_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(type_app_node));
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_PARAMETER == frozen_tree.kind(frozen_tree.child(type_app_node, 0)));
+        CPPUNIT_ASSERT_EQUAL(true, find_type_def_nodes(tree, frozen_tree, "W", nodes));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), nodes.size());
+        CPPUNIT_ASSERT(FrozenNodeKind::DATATYPE_FUNCTION == frozen_tree.kind(nodes[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(1) | (static_cast<uint64_t>(1) << 32), frozen_tree.data(nodes[0]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(nodes[0]));
+        datatype_node = frozen_tree.child(nodes[0], 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::NON_UNIQUE_DATATYPE == frozen_tree.kind(datatype_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(0), frozen_tree.child_count(datatype_node));
+        CPPUNIT_ASSERT(FrozenNodeKind::DATATYPE_FUNCTION_INSTANCE == frozen_tree.kind(nodes[1]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint8_t>(0), frozen_tree.flags(nodes[1]));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(2), frozen_tree.child_count(nodes[1]));
+        uint32_t arg_node = frozen_tree.child(nodes[1], 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::TYPE_VARIABLE == frozen_tree.kind(arg_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(stdlib_int64_abs_ident.key_ident().key()), frozen_tree.data(arg_node));
+        datatype_node = frozen_tree.child(nodes[1], 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::NON_UNIQUE_DATATYPE == frozen_tree.kind(datatype_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(1), frozen_tree.child_count(datatype_node));
+        uint32_t constr_node4 = frozen_tree.child(datatype_node, 0);
+        CPPUNIT_ASSERT(FrozenNodeKind::VARIABLE_CONSTRUCTOR == frozen_tree.kind(constr_node4));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(f_abs_ident.key_ident().key()), frozen_tree.data(constr_node4));
+      }
+
+      void FreezerTests::test_frozen_tree_writes_and_reads_tree()
+      {
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze("\
+import stdlib\n\
+\n\
+f(x: Int64): Int64 = #iadd(x, 1)\n\
+s = \"abc\"\n\
+ws = w\"def\"\n\
+\n\
+datatype T = C\n\
+", tree, frozen_tree));
+        ostringstream oss;
+        frozen_tree.write(oss);
+        istringstream iss(oss.str());
+        FrozenTree frozen_tree2;
+        CPPUNIT_ASSERT_EQUAL(true, frozen_tree2.read(iss));
+        CPPUNIT_ASSERT_EQUAL(frozen_tree.node_count(), frozen_tree2.node_count());
+        for(uint32_t node = 0; node < frozen_tree.node_count(); node++) {
+          CPPUNIT_ASSERT(frozen_tree.kind(node) == frozen_tree2.kind(node));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.flags(node), frozen_tree2.flags(node));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.data(node), frozen_tree2.data(node));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.child_count(node), frozen_tree2.child_count(node));
+          for(uint32_t i = 0; i < frozen_tree.child_count(node); i++)
+            CPPUNIT_ASSERT_EQUAL(frozen_tree.child(node, i), frozen_tree2.child(node, i));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.source_file_name(node), frozen_tree2.source_file_name(node));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.line(node), frozen_tree2.line(node));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.column(node), frozen_tree2.column(node));
+        }
+        CPPUNIT_ASSERT_EQUAL(frozen_tree.def_count(), frozen_tree2.def_count());
+        for(size_t i = 0; i < frozen_tree.def_count(); i++) {
+          CPPUNIT_ASSERT(frozen_tree.def_key_ident(i) == frozen_tree2.def_key_ident(i));
+          CPPUNIT_ASSERT_EQUAL(frozen_tree.def_node(i), frozen_tree2.def_node(i));
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), frozen_tree2.type_def_count());
+        CPPUNIT_ASSERT(frozen_tree.type_def_key_ident(0) == frozen_tree2.type_def_key_ident(0));
+        CPPUNIT_ASSERT_EQUAL(frozen_tree.type_def_node(0), frozen_tree2.type_def_node(0));
+        CPPUNIT_ASSERT_EQUAL(tree.ident_table()->ident_map().size(), frozen_tree2.ident_count());
+        for(size_t i = 0; i < frozen_tree2.ident_count(); i++) {
+          const AbsoluteIdentifier *abs_ident = tree.ident_table()->ident(frozen_tree2.ident_key_ident(i));
+          CPPUNIT_ASSERT(nullptr != abs_ident);
+          CPPUNIT_ASSERT(*abs_ident == frozen_tree2.ident(i));
+        }
+        AbsoluteIdentifier type_def_abs_ident;
+        CPPUNIT_ASSERT_EQUAL(true, frozen_tree2.find_ident(frozen_tree2.type_def_key_ident(0), type_def_abs_ident));
+        CPPUNIT_ASSERT(AbsoluteIdentifier("T") == type_def_abs_ident);
+        uint32_t string_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree2, "s", string_node));
+        uint32_t string_value_node = frozen_tree2.child(string_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::STRING == frozen_tree2.kind(string_value_node));
+        CPPUNIT_ASSERT_EQUAL(string("abc"), frozen_tree2.string(frozen_tree2.data(string_value_node)));
+        uint32_t wstring_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree2, "ws", wstring_node));
+        uint32_t wstring_value_node = frozen_tree2.child(wstring_node, 1);
+        CPPUNIT_ASSERT(FrozenNodeKind::WIDE_STRING == frozen_tree2.kind(wstring_value_node));
+        CPPUNIT_ASSERT(wstring(L"def") == frozen_tree2.wstring(frozen_tree2.data(wstring_value_node)));
+      }
+
+      void FreezerTests::test_freezer_freezes_very_deep_expression()
+      {
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze(str.c_str(), tree, frozen_tree));
+        uint32_t fun_node;
+        CPPUNIT_ASSERT_EQUAL(true, find_def_node(tree, frozen_tree, "f", fun_node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(3), frozen_tree.child_count(fun_node));
+        uint32_t node = frozen_tree.child(fun_node, 2);
+        size_t depth = 0;
+        while(frozen_tree.kind(node) == FrozenNodeKind::NON_UNIQUE_APPLICATION) {
+          CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(3), frozen_tree.child_count(node));
+          CPPUNIT_ASSERT(FrozenNodeKind::LOCAL_VARIABLE == frozen_tree.kind(frozen_tree.child(node, 2)));
+          node = frozen_tree.child(node, 1);
+          depth++;
+        }
+        CPPUNIT_ASSERT(FrozenNodeKind::LOCAL_VARIABLE == frozen_tree.kind(node));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100000), depth);
+      }
+
+      void FreezerTests::test_frozen_tree_does_not_read_invalid_tree()
+      {
+        Tree tree;
+        FrozenTree frozen_tree;
+        CPPUNIT_ASSERT_EQUAL(true, freeze("\
+import stdlib\n\
+\n\
+f(x: Int64): Int64 = #iadd(x, 1)\n\
+", tree, frozen_tree));
+        ostringstream oss;
+        frozen_tree.write(oss);
+        string str = oss.str();
+        istringstream iss1(str.substr(0, str.length() - 1));
+        FrozenTree frozen_tree2;
+        CPPUNIT_ASSERT_EQUAL(false, frozen_tree2.read(iss1));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), frozen_tree2.node_count());
+        string str2 = str;
+        str2[0] = 'X';
+        istringstream iss2(str2);
+        CPPUNIT_ASSERT_EQUAL(false, frozen_tree2.read(iss2));
+        string str3 = str;
+        // A byte order mark follows a magic.
+        reverse(str3.begin() + 8, str3.begin() + 12);
+        istringstream iss3(str3);
+        CPPUNIT_ASSERT_EQUAL(false, frozen_tree2.read(iss3));
+      }
+    }
+  }
+}
@@ -0,0 +1,61 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_FREEZER_TESTS_HPP
+#define _FRONTEND_FREEZER_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class FreezerTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(FreezerTests);
+        CPPUNIT_TEST(test_freezer_freezes_function_and_variable);
+        CPPUNIT_TEST(test_freezer_freezes_let_expression_and_global_variable);
+        CPPUNIT_TEST(test_freezer_freezes_packed_list_value);
+        CPPUNIT_TEST(test_freezer_freezes_type_definitions);
+        CPPUNIT_TEST(test_frozen_tree_writes_and_reads_tree);
+        CPPUNIT_TEST(test_freezer_freezes_very_deep_expression);
+        CPPUNIT_TEST(test_frozen_tree_does_not_read_invalid_tree);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+        Freezer *_M_freezer;
+
+        bool freeze(const char *str, Tree &tree, FrozenTree &frozen_tree);
+
+        bool find_def_node(const Tree &tree, const FrozenTree &frozen_tree, const char *ident, std::uint32_t &node);
+
+        bool find_type_def_nodes(const Tree &tree, const FrozenTree &frozen_tree, const char *ident, std::vector<std::uint32_t> &nodes);
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_freezer_freezes_function_and_variable();
+        void test_freezer_freezes_let_expression_and_global_variable();
+        void test_freezer_freezes_packed_list_value();
+        void test_freezer_freezes_type_definitions();
+        void test_frozen_tree_writes_and_reads_tree();
+        void test_freezer_freezes_very_deep_expression();
+        void test_frozen_tree_does_not_read_invalid_tree();
+      };
+    }
+  }
+}
+
+#endif
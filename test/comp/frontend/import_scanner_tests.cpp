@@ -0,0 +1,180 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <sstream>
+#include "frontend/import_scanner_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(ImportScannerTests);
+
+      void ImportScannerTests::setUp()
+      {
+        _M_import_scanner = new ImportScanner();
+      }
+
+      void ImportScannerTests::tearDown()
+      {
+        delete _M_import_scanner;
+      }
+
+      void ImportScannerTests::test_import_scanner_scans_modules_and_imports()
+      {
+        istringstream iss("\
+import stdlib\n\
+\n\
+module liba {\n\
+  import .libb\n\
+\n\
+  module module1.module2 {\n\
+    import libc\n\
+    f(x) = x\n\
+  }\n\
+}\n\
+\n\
+module .libd {\n\
+}\n\
+");
+        ScannedSource scanned_source;
+        list<Error> errors;
+        CPPUNIT_ASSERT_EQUAL(true, _M_import_scanner->scan(Source("test.lesfl", iss), scanned_source, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT((vector<string> { ".liba", ".liba.module1.module2", ".libd" } == scanned_source.module_idents()));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), scanned_source.imports().size());
+        const ScannedImport &import1 = scanned_source.imports()[0];
+        CPPUNIT_ASSERT_EQUAL(string("stdlib"), import1.module_ident());
+        CPPUNIT_ASSERT_EQUAL(string("."), import1.current_module_ident());
+        CPPUNIT_ASSERT_EQUAL(false, import1.has_prev_import());
+        CPPUNIT_ASSERT_EQUAL(1U, import1.pos().line());
+        CPPUNIT_ASSERT_EQUAL(8U, import1.pos().column());
+        const ScannedImport &import2 = scanned_source.imports()[1];
+        CPPUNIT_ASSERT_EQUAL(string(".libb"), import2.module_ident());
+        CPPUNIT_ASSERT_EQUAL(true, import2.is_abs_module_ident());
+        CPPUNIT_ASSERT_EQUAL(string(".liba"), import2.current_module_ident());
+        CPPUNIT_ASSERT_EQUAL(true, import2.has_prev_import());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), import2.prev_import_index());
+        CPPUNIT_ASSERT_EQUAL(4U, import2.pos().line());
+        CPPUNIT_ASSERT_EQUAL(10U, import2.pos().column());
+        const ScannedImport &import3 = scanned_source.imports()[2];
+        CPPUNIT_ASSERT_EQUAL(string("libc"), import3.module_ident());
+        CPPUNIT_ASSERT_EQUAL(false, import3.is_abs_module_ident());
+        CPPUNIT_ASSERT_EQUAL(string(".liba.module1.module2"), import3.current_module_ident());
+        CPPUNIT_ASSERT_EQUAL(true, import3.has_prev_import());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), import3.prev_import_index());
+        CPPUNIT_ASSERT_EQUAL(7U, import3.pos().line());
+        CPPUNIT_ASSERT_EQUAL(12U, import3.pos().column());
+      }
+
+      void ImportScannerTests::test_import_scanner_skips_comments_and_literals()
+      {
+        istringstream iss("\
+// import liba\n\
+/* import libb /* module libc { */ import libd */\n\
+s = \"import libe\"\n\
+ws = w\"import libf\"\n\
+c = 'x'\n\
+`import` = 1\n\
+import libg\n\
+");
+        ScannedSource scanned_source;
+        list<Error> errors;
+        CPPUNIT_ASSERT_EQUAL(true, _M_import_scanner->scan(Source("test.lesfl", iss), scanned_source, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, scanned_source.module_idents().empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), scanned_source.imports().size());
+        CPPUNIT_ASSERT_EQUAL(string("libg"), scanned_source.imports()[0].module_ident());
+        CPPUNIT_ASSERT_EQUAL(7U, scanned_source.imports()[0].pos().line());
+      }
+
+      void ImportScannerTests::test_import_scanner_writes_depfile()
+      {
+        istringstream iss1("\
+import .liba\n\
+f(x) = x\n\
+");
+        istringstream iss2("\
+module liba {\n\
+  import .libb\n\
+}\n\
+");
+        istringstream iss3("\
+module libb {\n\
+}\n\
+");
+        istringstream iss4("\
+module libc {\n\
+}\n\
+");
+        vector<Source> sources {
+          Source("test.lesfl", iss1),
+          Source("liba.lesfl", iss2),
+          Source("lib b.lesfl", iss3),
+          Source("libc.lesfl", iss4)
+        };
+        list<Error> errors;
+        ostringstream oss;
+        CPPUNIT_ASSERT_EQUAL(true, _M_import_scanner->write_depfile(oss, "test.o", vector<Source> { sources[0] }, sources, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(string("\
+test.o: \\\n\
+  lib\\ b.lesfl \\\n\
+  liba.lesfl \\\n\
+  test.lesfl\n\
+"), oss.str());
+      }
+
+      void ImportScannerTests::test_import_scanner_writes_depfile_for_last_matching_import()
+      {
+        istringstream iss1("\
+import .liba\n\
+import .libb\n\
+import libc\n\
+");
+        istringstream iss2("\
+module liba {\n\
+}\n\
+");
+        istringstream iss3("\
+module libb {\n\
+}\n\
+");
+        istringstream iss4("\
+module liba.libc {\n\
+}\n\
+");
+        istringstream iss5("\
+module libb.libc {\n\
+}\n\
+");
+        vector<Source> sources {
+          Source("test.lesfl", iss1),
+          Source("liba.lesfl", iss2),
+          Source("libb.lesfl", iss3),
+          Source("liba_libc.lesfl", iss4),
+          Source("libb_libc.lesfl", iss5)
+        };
+        list<Error> errors;
+        ostringstream oss;
+        CPPUNIT_ASSERT_EQUAL(true, _M_import_scanner->write_depfile(oss, "test.o", vector<Source> { sources[0] }, sources, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(string("\
+test.o: \\\n\
+  liba.lesfl \\\n\
+  libb.lesfl \\\n\
+  libb_libc.lesfl \\\n\
+  test.lesfl\n\
+"), oss.str());
+      }
+    }
+  }
+}
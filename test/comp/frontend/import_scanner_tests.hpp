@@ -0,0 +1,46 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_IMPORT_SCANNER_TESTS_HPP
+#define _FRONTEND_IMPORT_SCANNER_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class ImportScannerTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(ImportScannerTests);
+        CPPUNIT_TEST(test_import_scanner_scans_modules_and_imports);
+        CPPUNIT_TEST(test_import_scanner_skips_comments_and_literals);
+        CPPUNIT_TEST(test_import_scanner_writes_depfile);
+        CPPUNIT_TEST(test_import_scanner_writes_depfile_for_last_matching_import);
+        CPPUNIT_TEST_SUITE_END();
+
+        ImportScanner *_M_import_scanner;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_import_scanner_scans_modules_and_imports();
+        void test_import_scanner_skips_comments_and_literals();
+        void test_import_scanner_writes_depfile();
+        void test_import_scanner_writes_depfile_for_last_matching_import();
+      };
+    }
+  }
+}
+
+#endif
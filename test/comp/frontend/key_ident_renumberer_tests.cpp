@@ -0,0 +1,215 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <map>
+#include <sstream>
+#include "frontend/key_ident_renumberer_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(KeyIdentifierRenumbererTests);
+
+      static map<string, size_t> key_idents_from_ident_table(const AbsoluteIdentifierTable &table)
+      {
+        map<string, size_t> key_idents;
+        for(auto &pair : table.ident_map()) key_idents.insert(make_pair(pair.second->to_string(), pair.first.key()));
+        return key_idents;
+      }
+
+      void KeyIdentifierRenumbererTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+        _M_key_ident_renumberer = new KeyIdentifierRenumberer();
+      }
+
+      void KeyIdentifierRenumbererTests::tearDown()
+      {
+        delete _M_key_ident_renumberer;
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      void KeyIdentifierRenumbererTests::test_key_ident_renumberer_renumbers_key_identifiers_in_lexicographic_order()
+      {
+        istringstream iss("\
+g(x) = f(x)\n\
+\n\
+f(x: T) = x\n\
+\n\
+datatype T = C | B\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        unordered_map<KeyIdentifier, KeyIdentifier> key_ident_map;
+        CPPUNIT_ASSERT_EQUAL(true, _M_key_ident_renumberer->renumber(tree, key_ident_map));
+        CPPUNIT_ASSERT_EQUAL(tree.ident_table()->ident_map().size(), key_ident_map.size());
+        map<string, size_t> key_idents = key_idents_from_ident_table(*(tree.ident_table()));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), key_idents["."]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), key_idents[".B"]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), key_idents[".C"]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), key_idents[".T"]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), key_idents[".f"]);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), key_idents[".g"]);
+        for(auto &pair : tree.ident_table()->ident_map())
+          CPPUNIT_ASSERT(pair.first == pair.second->key_ident());
+        vector<KeyIdentifier> expected_key_idents {
+          KeyIdentifier(1),
+          KeyIdentifier(2),
+          KeyIdentifier(4),
+          KeyIdentifier(5)
+        };
+        CPPUNIT_ASSERT(expected_key_idents == tree.uncompiled_var_key_idents());
+        CPPUNIT_ASSERT(nullptr != tree.var_info(KeyIdentifier(4)));
+        CPPUNIT_ASSERT(nullptr != tree.type_var_info(KeyIdentifier(3)));
+        auto def_iter = tree.defs().front()->begin();
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        CPPUNIT_ASSERT_EQUAL(string("g"), fun_def->ident());
+        UserDefinedFunction *fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+        CPPUNIT_ASSERT(nullptr != fun);
+        NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(fun->body());
+        CPPUNIT_ASSERT(nullptr != app);
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(app->fun());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), var_expr->ident()->key_ident().key());
+        def_iter++;
+        fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        CPPUNIT_ASSERT_EQUAL(string("f"), fun_def->ident());
+        fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+        CPPUNIT_ASSERT(nullptr != fun);
+        TypeVariableExpression *type_var_expr = dynamic_cast<TypeVariableExpression *>(fun->args()[0]->type_expr());
+        CPPUNIT_ASSERT(nullptr != type_var_expr);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), type_var_expr->ident()->key_ident().key());
+      }
+
+      void KeyIdentifierRenumbererTests::test_key_ident_renumberer_gives_same_key_identifiers_for_different_definition_orders()
+      {
+        istringstream iss1("\
+datatype T = C(T, T) | E\n\
+\n\
+f(x: T) = g(x)\n\
+\n\
+g(x) = x\n\
+");
+        istringstream iss2("\
+g(x) = x\n\
+\n\
+f(x: T) = g(x)\n\
+\n\
+datatype T = C(T, T) | E\n\
+");
+        vector<Source> sources1;
+        sources1.push_back(Source("test1.lesfl", iss1));
+        vector<Source> sources2;
+        sources2.push_back(Source("test2.lesfl", iss2));
+        list<Error> errors;
+        Tree tree1;
+        Tree tree2;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree1));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources1, tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree2));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources2, tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT(key_idents_from_ident_table(*(tree1.ident_table())) != key_idents_from_ident_table(*(tree2.ident_table())));
+        CPPUNIT_ASSERT_EQUAL(true, _M_key_ident_renumberer->renumber(tree1));
+        CPPUNIT_ASSERT_EQUAL(true, _M_key_ident_renumberer->renumber(tree2));
+        CPPUNIT_ASSERT(key_idents_from_ident_table(*(tree1.ident_table())) == key_idents_from_ident_table(*(tree2.ident_table())));
+        CPPUNIT_ASSERT(tree1.uncompiled_var_key_idents() == tree2.uncompiled_var_key_idents());
+        CPPUNIT_ASSERT(tree1.uncompiled_type_var_key_idents() == tree2.uncompiled_type_var_key_idents());
+        auto var_info_iter1 = tree1.var_infos().begin();
+        auto var_info_iter2 = tree2.var_infos().begin();
+        for(; var_info_iter1 != tree1.var_infos().end(); var_info_iter1++, var_info_iter2++) {
+          CPPUNIT_ASSERT(var_info_iter2 != tree2.var_infos().end());
+          CPPUNIT_ASSERT(var_info_iter1->first == var_info_iter2->first);
+        }
+        CPPUNIT_ASSERT(var_info_iter2 == tree2.var_infos().end());
+      }
+
+      void KeyIdentifierRenumbererTests::test_key_ident_renumberer_complains_on_shared_identifier_table()
+      {
+        istringstream iss("\
+f(x) = x\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        shared_ptr<AbsoluteIdentifierTable> ident_table(new AbsoluteIdentifierTable());
+        Tree tree(ident_table);
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        map<string, size_t> key_idents = key_idents_from_ident_table(*ident_table);
+        CPPUNIT_ASSERT_EQUAL(false, _M_key_ident_renumberer->renumber(tree));
+        CPPUNIT_ASSERT(key_idents == key_idents_from_ident_table(*ident_table));
+      }
+
+      void KeyIdentifierRenumbererTests::test_key_ident_renumberer_renumbers_key_identifiers_for_very_deep_expression()
+      {
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        unordered_map<KeyIdentifier, KeyIdentifier> key_ident_map;
+        CPPUNIT_ASSERT_EQUAL(true, _M_key_ident_renumberer->renumber(tree, key_ident_map));
+        AbsoluteIdentifier f_abs_ident(list<string> { "f" });
+        CPPUNIT_ASSERT_EQUAL(true, f_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier plus_abs_ident(list<string> { "+" });
+        CPPUNIT_ASSERT_EQUAL(true, plus_abs_ident.set_key_ident(*(tree.ident_table())));
+        VariableInfo *var_info = tree.var_info(f_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != var_info);
+        FunctionVariable *fun_var = dynamic_cast<FunctionVariable *>(var_info->var().get());
+        CPPUNIT_ASSERT(nullptr != fun_var);
+        UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_var->fun().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_fun);
+        Expression *expr = user_defined_fun->body();
+        size_t depth = 0;
+        for(NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(expr); app != nullptr; app = dynamic_cast<NonUniqueApplication *>(expr)) {
+          VariableExpression *var_expr = dynamic_cast<VariableExpression *>(app->fun());
+          CPPUNIT_ASSERT(nullptr != var_expr);
+          CPPUNIT_ASSERT_EQUAL(true, var_expr->ident()->has_key_ident());
+          CPPUNIT_ASSERT(plus_abs_ident.key_ident() == var_expr->ident()->key_ident());
+          expr = app->args().front().get();
+          depth++;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100000), depth);
+      }
+    }
+  }
+}
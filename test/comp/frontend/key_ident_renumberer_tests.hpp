@@ -0,0 +1,49 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_KEY_IDENT_RENUMBERER_TESTS_HPP
+#define _FRONTEND_KEY_IDENT_RENUMBERER_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class KeyIdentifierRenumbererTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(KeyIdentifierRenumbererTests);
+        CPPUNIT_TEST(test_key_ident_renumberer_renumbers_key_identifiers_in_lexicographic_order);
+        CPPUNIT_TEST(test_key_ident_renumberer_gives_same_key_identifiers_for_different_definition_orders);
+        CPPUNIT_TEST(test_key_ident_renumberer_complains_on_shared_identifier_table);
+        CPPUNIT_TEST(test_key_ident_renumberer_renumbers_key_identifiers_for_very_deep_expression);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+        KeyIdentifierRenumberer *_M_key_ident_renumberer;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_key_ident_renumberer_renumbers_key_identifiers_in_lexicographic_order();
+        void test_key_ident_renumberer_gives_same_key_identifiers_for_different_definition_orders();
+        void test_key_ident_renumberer_complains_on_shared_identifier_table();
+        void test_key_ident_renumberer_renumbers_key_identifiers_for_very_deep_expression();
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,150 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <sstream>
+#include "frontend/memory_reporter_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(MemoryReporterTests);
+
+      void MemoryReporterTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+        _M_memory_reporter = new MemoryReporter();
+      }
+
+      void MemoryReporterTests::tearDown()
+      {
+        delete _M_memory_reporter;
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      void MemoryReporterTests::test_memory_reporter_reports_node_classes()
+      {
+        istringstream iss("\
+datatype T = C(T, T) | E\n\
+f(x) =\n\
+  x match {\n\
+    C(y, z) -> g(y, 1)\n\
+    _       -> 2\n\
+  }\n\
+g(x, y) = x\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        MemoryReport report;
+        CPPUNIT_ASSERT_EQUAL(true, _M_memory_reporter->report_memory(tree, report));
+        const MemoryUsage *usage = report.usage("Match");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), usage->count());
+        CPPUNIT_ASSERT_EQUAL(sizeof(Match), usage->bytes());
+        usage = report.usage("Case");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), usage->count());
+        usage = report.usage("NonUniqueApplication");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), usage->count());
+        usage = report.usage("VariableExpression");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), usage->count());
+        usage = report.usage("IntValue");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), usage->count());
+        usage = report.usage("UnnamedFieldConstructorPattern");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), usage->count());
+        usage = report.usage("TypeVariableExpression");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), usage->count());
+        usage = report.usage("Identifier");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), usage->count());
+        // Functions are reachable from definitions and variable informations,
+        // but they are reported once.
+        usage = report.usage("UserDefinedFunction");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), usage->count());
+        usage = report.usage("BuiltinTypeVariable");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT(usage->count() > 0);
+        usage = report.usage("VariableInfo");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(tree.var_infos().size(), usage->count());
+        usage = report.usage("AbsoluteIdentifierTable");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(tree.ident_table()->ident_map().size(), usage->count());
+        CPPUNIT_ASSERT(nullptr == report.usage("Throw"));
+        size_t total_bytes = 0;
+        for(auto &usage : report.usages()) total_bytes += usage.bytes();
+        CPPUNIT_ASSERT_EQUAL(total_bytes, report.total_bytes());
+      }
+
+      void MemoryReporterTests::test_memory_report_writes_json()
+      {
+        MemoryReport report;
+        report.add("Match", 1, 72);
+        report.add("Case", 2, 48);
+        report.add("Match", 1, 72);
+        ostringstream oss;
+        report.write_json(oss);
+        string expected_str("\
+{\n\
+  \"usages\": [\n\
+    {\"name\": \"Match\", \"count\": 2, \"bytes\": 144},\n\
+    {\"name\": \"Case\", \"count\": 2, \"bytes\": 48}\n\
+  ],\n\
+  \"total_bytes\": 192\n\
+}\n\
+");
+        CPPUNIT_ASSERT_EQUAL(expected_str, oss.str());
+      }
+
+      void MemoryReporterTests::test_memory_reporter_reports_very_deep_expression()
+      {
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        MemoryReport report;
+        CPPUNIT_ASSERT_EQUAL(true, _M_memory_reporter->report_memory(tree, report));
+        const MemoryUsage *usage = report.usage("NonUniqueApplication");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100000), usage->count());
+        usage = report.usage("VariableExpression");
+        CPPUNIT_ASSERT(nullptr != usage);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(200003), usage->count());
+      }
+    }
+  }
+}
@@ -0,0 +1,47 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_MEMORY_REPORTER_TESTS_HPP
+#define _FRONTEND_MEMORY_REPORTER_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class MemoryReporterTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(MemoryReporterTests);
+        CPPUNIT_TEST(test_memory_reporter_reports_node_classes);
+        CPPUNIT_TEST(test_memory_report_writes_json);
+        CPPUNIT_TEST(test_memory_reporter_reports_very_deep_expression);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+        MemoryReporter *_M_memory_reporter;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_memory_reporter_reports_node_classes();
+        void test_memory_report_writes_json();
+        void test_memory_reporter_reports_very_deep_expression();
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,301 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <sstream>
+#include "frontend/module_graph_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(ModuleGraphTests);
+
+      void ModuleGraphTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_module_graph_builder = new ModuleGraphBuilder();
+      }
+
+      void ModuleGraphTests::tearDown()
+      {
+        delete _M_module_graph_builder;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      void ModuleGraphTests::test_module_graph_computes_components()
+      {
+        ModuleGraph graph;
+        graph.add_dep(KeyIdentifier(1), KeyIdentifier(2));
+        graph.add_dep(KeyIdentifier(2), KeyIdentifier(3));
+        graph.add_dep(KeyIdentifier(3), KeyIdentifier(2));
+        graph.add_module(KeyIdentifier(4));
+        vector<vector<KeyIdentifier>> comps;
+        graph.components(comps);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), comps.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), comps[0].size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), comps[0][0].key());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), comps[0][1].key());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps[1].size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps[1][0].key());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps[2].size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), comps[2][0].key());
+      }
+
+      void ModuleGraphTests::test_module_graph_detects_cycles()
+      {
+        ModuleGraph graph;
+        graph.add_dep(KeyIdentifier(1), KeyIdentifier(2));
+        graph.add_dep(KeyIdentifier(2), KeyIdentifier(3));
+        CPPUNIT_ASSERT_EQUAL(false, graph.has_cycles());
+        graph.add_dep(KeyIdentifier(3), KeyIdentifier(1));
+        CPPUNIT_ASSERT_EQUAL(true, graph.has_cycles());
+        vector<vector<KeyIdentifier>> cycles;
+        graph.cycles(cycles);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), cycles.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), cycles[0].size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), cycles[0][0].key());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), cycles[0][1].key());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), cycles[0][2].key());
+      }
+
+      void ModuleGraphTests::test_module_graph_detects_self_dependency_as_cycle()
+      {
+        ModuleGraph graph;
+        graph.add_dep(KeyIdentifier(1), KeyIdentifier(2));
+        CPPUNIT_ASSERT_EQUAL(false, graph.has_cycles());
+        graph.add_dep(KeyIdentifier(2), KeyIdentifier(2));
+        CPPUNIT_ASSERT_EQUAL(true, graph.has_cycles());
+        vector<vector<KeyIdentifier>> cycles;
+        graph.cycles(cycles);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), cycles.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), cycles[0].size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), cycles[0][0].key());
+        vector<ModuleComponent> comps;
+        graph.schedule(comps);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), comps.size());
+        CPPUNIT_ASSERT_EQUAL(true, comps[0].is_cycle());
+        CPPUNIT_ASSERT_EQUAL(true, comps[0].dep_indices().empty());
+        CPPUNIT_ASSERT_EQUAL(false, comps[1].is_cycle());
+      }
+
+      void ModuleGraphTests::test_module_graph_computes_components_for_long_chain()
+      {
+        ModuleGraph graph;
+        for(size_t i = 1; i < 100000; i++) graph.add_dep(KeyIdentifier(i), KeyIdentifier(i + 1));
+        graph.add_dep(KeyIdentifier(100000), KeyIdentifier(1));
+        vector<vector<KeyIdentifier>> comps;
+        graph.components(comps);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100000), comps[0].size());
+      }
+
+      void ModuleGraphTests::test_module_graph_schedules_components()
+      {
+        ModuleGraph graph;
+        graph.add_dep(KeyIdentifier(1), KeyIdentifier(2));
+        graph.add_dep(KeyIdentifier(2), KeyIdentifier(3));
+        graph.add_dep(KeyIdentifier(3), KeyIdentifier(2));
+        graph.add_dep(KeyIdentifier(4), KeyIdentifier(1));
+        graph.add_dep(KeyIdentifier(5), KeyIdentifier(3));
+        vector<ModuleComponent> comps;
+        graph.schedule(comps);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), comps.size());
+        CPPUNIT_ASSERT_EQUAL(true, comps[0].is_cycle());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), comps[0].module_key_idents()[0].key());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), comps[0].module_key_idents()[1].key());
+        CPPUNIT_ASSERT_EQUAL(true, comps[0].dep_indices().empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), comps[0].level());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps[1].module_key_idents()[0].key());
+        CPPUNIT_ASSERT(vector<size_t> { 0 } == comps[1].dep_indices());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps[1].level());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), comps[2].module_key_idents()[0].key());
+        CPPUNIT_ASSERT(vector<size_t> { 1 } == comps[2].dep_indices());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), comps[2].level());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), comps[3].module_key_idents()[0].key());
+        CPPUNIT_ASSERT(vector<size_t> { 0 } == comps[3].dep_indices());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), comps[3].level());
+      }
+
+      void ModuleGraphTests::test_module_graph_builder_builds_module_graph()
+      {
+        istringstream iss("\
+module liba {\n\
+  import .libb\n\
+  f() = 1\n\
+}\n\
+\n\
+module libb {\n\
+  import .liba\n\
+  g() = 2\n\
+}\n\
+\n\
+module libc {\n\
+  import .libb\n\
+  h() = 3\n\
+}\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        ModuleGraph graph;
+        CPPUNIT_ASSERT_EQUAL(true, _M_module_graph_builder->build_module_graph(tree, graph, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier liba_abs_ident(list<string> { "liba" });
+        CPPUNIT_ASSERT_EQUAL(true, liba_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier libb_abs_ident(list<string> { "libb" });
+        CPPUNIT_ASSERT_EQUAL(true, libb_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier libc_abs_ident(list<string> { "libc" });
+        CPPUNIT_ASSERT_EQUAL(true, libc_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), graph.deps().size());
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { libb_abs_ident.key_ident() } == *(graph.module_deps(liba_abs_ident.key_ident())));
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { liba_abs_ident.key_ident() } == *(graph.module_deps(libb_abs_ident.key_ident())));
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { libb_abs_ident.key_ident() } == *(graph.module_deps(libc_abs_ident.key_ident())));
+        CPPUNIT_ASSERT_EQUAL(true, graph.has_cycles());
+        vector<ModuleComponent> comps;
+        graph.schedule(comps);
+        size_t libab_comp_index = comps.size(), libc_comp_index = comps.size();
+        for(size_t i = 0; i < comps.size(); i++) {
+          if(comps[i].is_cycle()) libab_comp_index = i;
+          if(comps[i].module_key_idents()[0] == libc_abs_ident.key_ident()) libc_comp_index = i;
+        }
+        CPPUNIT_ASSERT(libab_comp_index < libc_comp_index);
+        CPPUNIT_ASSERT(libc_comp_index < comps.size());
+        CPPUNIT_ASSERT(vector<size_t> { libab_comp_index } == comps[libc_comp_index].dep_indices());
+      }
+
+      void ModuleGraphTests::test_module_graph_builder_builds_module_graph_for_nested_modules()
+      {
+        istringstream iss("\
+import stdlib\n\
+\n\
+module liba {\n\
+  import .libb\n\
+\n\
+  module module1 {\n\
+    f() = 1\n\
+  }\n\
+}\n\
+\n\
+module libb {\n\
+  g() = 2\n\
+}\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        ModuleGraph graph;
+        CPPUNIT_ASSERT_EQUAL(true, _M_module_graph_builder->build_module_graph(tree, graph, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier root_abs_ident;
+        CPPUNIT_ASSERT_EQUAL(true, root_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier stdlib_abs_ident(list<string> { "stdlib" });
+        CPPUNIT_ASSERT_EQUAL(true, stdlib_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier liba_abs_ident(list<string> { "liba" });
+        CPPUNIT_ASSERT_EQUAL(true, liba_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier liba_module1_abs_ident(list<string> { "liba", "module1" });
+        CPPUNIT_ASSERT_EQUAL(true, liba_module1_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier libb_abs_ident(list<string> { "libb" });
+        CPPUNIT_ASSERT_EQUAL(true, libb_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { stdlib_abs_ident.key_ident() } == *(graph.module_deps(root_abs_ident.key_ident())));
+        CPPUNIT_ASSERT((unordered_set<KeyIdentifier> { stdlib_abs_ident.key_ident(), libb_abs_ident.key_ident() } == *(graph.module_deps(liba_abs_ident.key_ident()))));
+        CPPUNIT_ASSERT((unordered_set<KeyIdentifier> { stdlib_abs_ident.key_ident(), libb_abs_ident.key_ident() } == *(graph.module_deps(liba_module1_abs_ident.key_ident()))));
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { stdlib_abs_ident.key_ident() } == *(graph.module_deps(libb_abs_ident.key_ident())));
+        CPPUNIT_ASSERT_EQUAL(false, graph.has_cycles());
+      }
+
+      void ModuleGraphTests::test_module_graph_builder_builds_module_graph_for_self_import()
+      {
+        istringstream iss("\
+module liba {\n\
+  import .liba\n\
+  f() = 1\n\
+}\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        ModuleGraph graph;
+        CPPUNIT_ASSERT_EQUAL(true, _M_module_graph_builder->build_module_graph(tree, graph, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier liba_abs_ident(list<string> { "liba" });
+        CPPUNIT_ASSERT_EQUAL(true, liba_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { liba_abs_ident.key_ident() } == *(graph.module_deps(liba_abs_ident.key_ident())));
+        vector<vector<KeyIdentifier>> cycles;
+        graph.cycles(cycles);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), cycles.size());
+        CPPUNIT_ASSERT(vector<KeyIdentifier> { liba_abs_ident.key_ident() } == cycles[0]);
+      }
+
+      void ModuleGraphTests::test_module_graph_builder_builds_module_graph_for_references()
+      {
+        istringstream iss("\
+f() = .libb.g + libc.h\n\
+\n\
+module liba {\n\
+  module module1 {\n\
+    g() = 1\n\
+  }\n\
+\n\
+  h() = module1.g\n\
+}\n\
+\n\
+module libb {\n\
+  g() = 2\n\
+}\n\
+\n\
+module libc {\n\
+  type T = .libb.U\n\
+  h() = libc.h\n\
+}\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        ModuleGraph graph;
+        CPPUNIT_ASSERT_EQUAL(true, _M_module_graph_builder->build_module_graph(tree, graph, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier root_abs_ident;
+        CPPUNIT_ASSERT_EQUAL(true, root_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier liba_abs_ident(list<string> { "liba" });
+        CPPUNIT_ASSERT_EQUAL(true, liba_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier liba_module1_abs_ident(list<string> { "liba", "module1" });
+        CPPUNIT_ASSERT_EQUAL(true, liba_module1_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier libb_abs_ident(list<string> { "libb" });
+        CPPUNIT_ASSERT_EQUAL(true, libb_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier libc_abs_ident(list<string> { "libc" });
+        CPPUNIT_ASSERT_EQUAL(true, libc_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT((unordered_set<KeyIdentifier> { libb_abs_ident.key_ident(), libc_abs_ident.key_ident() } == *(graph.module_deps(root_abs_ident.key_ident()))));
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { liba_module1_abs_ident.key_ident() } == *(graph.module_deps(liba_abs_ident.key_ident())));
+        CPPUNIT_ASSERT_EQUAL(true, graph.module_deps(libb_abs_ident.key_ident())->empty());
+        CPPUNIT_ASSERT(unordered_set<KeyIdentifier> { libb_abs_ident.key_ident() } == *(graph.module_deps(libc_abs_ident.key_ident())));
+        CPPUNIT_ASSERT_EQUAL(false, graph.has_cycles());
+      }
+    }
+  }
+}
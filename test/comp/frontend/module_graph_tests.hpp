@@ -0,0 +1,58 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_MODULE_GRAPH_TESTS_HPP
+#define _FRONTEND_MODULE_GRAPH_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class ModuleGraphTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(ModuleGraphTests);
+        CPPUNIT_TEST(test_module_graph_computes_components);
+        CPPUNIT_TEST(test_module_graph_detects_cycles);
+        CPPUNIT_TEST(test_module_graph_detects_self_dependency_as_cycle);
+        CPPUNIT_TEST(test_module_graph_computes_components_for_long_chain);
+        CPPUNIT_TEST(test_module_graph_schedules_components);
+        CPPUNIT_TEST(test_module_graph_builder_builds_module_graph);
+        CPPUNIT_TEST(test_module_graph_builder_builds_module_graph_for_nested_modules);
+        CPPUNIT_TEST(test_module_graph_builder_builds_module_graph_for_self_import);
+        CPPUNIT_TEST(test_module_graph_builder_builds_module_graph_for_references);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        ModuleGraphBuilder *_M_module_graph_builder;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_module_graph_computes_components();
+        void test_module_graph_detects_cycles();
+        void test_module_graph_detects_self_dependency_as_cycle();
+        void test_module_graph_computes_components_for_long_chain();
+        void test_module_graph_schedules_components();
+        void test_module_graph_builder_builds_module_graph();
+        void test_module_graph_builder_builds_module_graph_for_nested_modules();
+        void test_module_graph_builder_builds_module_graph_for_self_import();
+        void test_module_graph_builder_builds_module_graph_for_references();
+      };
+    }
+  }
+}
+
+#endif
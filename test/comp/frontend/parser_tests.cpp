@@ -25,6 +25,28 @@ namespace lesfl
 
       void ParserTests::tearDown()
       { delete _M_parser; }
+
+      bool ParserTests::parse_and_freeze(const char *str, bool is_deferred_parsing, string &data)
+      {
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        BuiltinTypeAdder builtin_type_adder;
+        if(!builtin_type_adder.add_builtin_types(tree)) return false;
+        Parser parser(is_deferred_parsing);
+        if(!parser.parse(sources, tree, errors)) return false;
+        Resolver resolver;
+        if(!resolver.resolve(tree, errors)) return false;
+        FrozenTree frozen_tree;
+        Freezer freezer;
+        if(!freezer.freeze(tree, frozen_tree, errors)) return false;
+        ostringstream oss;
+        frozen_tree.write(oss);
+        data = oss.str();
+        return errors.empty();
+      }
       
       void ParserTests::test_parser_parses_simple_definitions()
       {
@@ -268,6 +290,59 @@ f() =\n\
         }
       }
 
+      void ParserTests::test_parser_parses_definitions_with_long_comments_and_spaces()
+      {
+        istringstream iss("\
+/****************************************************************************\n\
+ *   Copyright (C) 2021 Some Author.                                        *\n\
+ *                                                                          *\n\
+ *   This software is licensed under some license. See the LICENSE file    *\n\
+ *   for the full licensing terms. /* nested comment */ // some text        *\n\
+ ****************************************************************************/\n\
+v =                                                                  1\n\
+\n\
+f() =                                  \n\
+                                       /* some comment */          2\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("v"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), var_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), var_literal_value->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(70), var_literal_value->pos().column());
+        }
+        def_iter++;
+        {
+          FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != fun_def);
+          CPPUNIT_ASSERT_EQUAL(string("f"), fun_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), fun_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), fun_def->pos().column());
+          UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_fun);
+          Literal *literal = dynamic_cast<Literal *>(user_defined_fun->body());
+          CPPUNIT_ASSERT(nullptr != literal);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), literal->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(68), literal->pos().column());
+        }
+      }
+
       void ParserTests::test_parser_parses_definition_with_nested_comment()
       {
         istringstream iss("\
@@ -2651,6 +2726,126 @@ i() = w\"\\uabcd\\U001234ab\"\n\
         }
       }
       
+      void ParserTests::test_parser_parses_long_strings()
+      {
+        istringstream iss("a = \"" + string(100000, 'x') + "\"\n\
+\n\
+b = \"ab\\\n\
+cd\"; c = w\"" + string(100000, 'y') + "\"\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          StringValue *string_value = dynamic_cast<StringValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != string_value);
+          CPPUNIT_ASSERT(string(100000, 'x') == string_value->string());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("b"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          StringValue *string_value = dynamic_cast<StringValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != string_value);
+          CPPUNIT_ASSERT_EQUAL(string("abcd"), string_value->string());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("c"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), var_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), var_def->pos().column());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), var_literal_value->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), var_literal_value->pos().column());
+          WideStringValue *string_value = dynamic_cast<WideStringValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != string_value);
+          CPPUNIT_ASSERT(wstring(100000, L'y') == string_value->string());
+        }
+      }
+
+      void ParserTests::test_parser_parses_utf8_wide_characters_and_wide_strings()
+      {
+        istringstream iss("\
+a = w'\xc3\xa9'\n\
+c = w'\xf0\x9f\x98\x80'\n\
+b = w\"Za\xc5\xbc\xc3\xb3\xc5\x82\xc4\x87 g\xc4\x99\xc5\x9bl\xc4\x85 ja\xc5\xba\xc5\x84 0123456789 \xe2\x82\xac\xf0\x9f\x98\x80\\n\"\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          WideCharValue *wide_char_value = dynamic_cast<WideCharValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != wide_char_value);
+          CPPUNIT_ASSERT_EQUAL(L'\u00e9', wide_char_value->c());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("c"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          WideCharValue *wide_char_value = dynamic_cast<WideCharValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != wide_char_value);
+          CPPUNIT_ASSERT_EQUAL(static_cast<wchar_t>(0x1f600), wide_char_value->c());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("b"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          WideStringValue *wide_string_value = dynamic_cast<WideStringValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != wide_string_value);
+          CPPUNIT_ASSERT(wstring(L"Za\u017c\u00f3\u0142\u0107 g\u0119\u015bl\u0105 ja\u017a\u0144 0123456789 \u20ac\U0001f600\n") == wide_string_value->string());
+        }
+      }
+
       void ParserTests::test_parser_parses_imports()
       {
         istringstream iss("\
@@ -16141,14 +16336,14 @@ c = #[4, 3, 2]\n\
         }
       }
       
-      void ParserTests::test_parser_parses_tuple_values()
+      void ParserTests::test_parser_parses_packed_collection_values()
       {
         istringstream iss("\
-a = ()\n\
+a = [1i8, 2i8, 3i8, 4i8, 5i8, 6i8, 7i8, 8i8, 9i8, 10i8, 11i8, 12i8, 13i8, 14i8, 0xffi8, -127i8 - 1i8]\n\
 \n\
-b = (1, 2)\n\
+b = #['a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p']\n\
 \n\
-c = (3, 4, 5)\n\
+c = [0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5, 8.5, 9.5, 10.5, 11.5, 12.5, 13.5, 14.5, 15.5, 16.5]\n\
 ");
         vector<Source> sources;
         sources.push_back(Source("test.lesfl", iss));
@@ -16163,118 +16358,338 @@ c = (3, 4, 5)\n\
         {
           VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
           CPPUNIT_ASSERT(nullptr != var_def);
-          CPPUNIT_ASSERT_EQUAL(AccessModifier::NONE, var_def->access_modifier());
           CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_def->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
           UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
           CPPUNIT_ASSERT(nullptr != user_defined_var);
-          CPPUNIT_ASSERT_EQUAL(false, user_defined_var->is_template());
-          CPPUNIT_ASSERT(nullptr == user_defined_var->type_expr());
-          TupleValue *tuple_value1 = dynamic_cast<TupleValue *>(user_defined_var->value());
-          CPPUNIT_ASSERT(nullptr != tuple_value1);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), tuple_value1->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tuple_value1->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().column());
-          CPPUNIT_ASSERT_EQUAL(true, tuple_value1->fields().empty());
+          PackedListValue *list_value1 = dynamic_cast<PackedListValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != list_value1);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), list_value1->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), list_value1->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), list_value1->pos().column());
+          CPPUNIT_ASSERT_EQUAL(PackedElementType::INT8, list_value1->elems().elem_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(16), list_value1->elems().size());
+          for(size_t i = 0; i < 14; i++) {
+            CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(i + 1), list_value1->elems().int_elem(i));
+          }
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(-1), list_value1->elems().int_elem(14));
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(-128), list_value1->elems().int_elem(15));
         }
         def_iter++;
         {
           VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
           CPPUNIT_ASSERT(nullptr != var_def);
-          CPPUNIT_ASSERT_EQUAL(AccessModifier::NONE, var_def->access_modifier());
           CPPUNIT_ASSERT_EQUAL(string("b"), var_def->ident());
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_def->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_def->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
           UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
           CPPUNIT_ASSERT(nullptr != user_defined_var);
-          CPPUNIT_ASSERT_EQUAL(false, user_defined_var->is_template());
-          CPPUNIT_ASSERT(nullptr == user_defined_var->type_expr());
-          TupleValue *tuple_value1 = dynamic_cast<TupleValue *>(user_defined_var->value());
-          CPPUNIT_ASSERT(nullptr != tuple_value1);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), tuple_value1->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), tuple_value1->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().column());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), tuple_value1->fields().size());
-          auto field_iter1 = tuple_value1->fields().begin();
-          VariableLiteralValue *var_literal_value2 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
-          CPPUNIT_ASSERT(nullptr != var_literal_value2);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value2->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_literal_value2->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), var_literal_value2->pos().column());
-          IntValue *int_value2 = dynamic_cast<IntValue *>(var_literal_value2->literal_value());
-          CPPUNIT_ASSERT(nullptr != int_value2);
-          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value2->int_type());
-          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(1), int_value2->i());
-          field_iter1++;
-          VariableLiteralValue *var_literal_value3 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
-          CPPUNIT_ASSERT(nullptr != var_literal_value3);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value3->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_literal_value3->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), var_literal_value3->pos().column());
-          IntValue *int_value3 = dynamic_cast<IntValue *>(var_literal_value3->literal_value());
-          CPPUNIT_ASSERT(nullptr != int_value3);
-          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value3->int_type());
-          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(2), int_value3->i());
+          PackedArrayValue *array_value1 = dynamic_cast<PackedArrayValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != array_value1);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), array_value1->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), array_value1->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), array_value1->pos().column());
+          CPPUNIT_ASSERT_EQUAL(PackedElementType::CHAR, array_value1->elems().elem_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(16), array_value1->elems().size());
+          for(size_t i = 0; i < 16; i++) {
+            CPPUNIT_ASSERT_EQUAL(static_cast<char>('a' + i), array_value1->elems().char_elem(i));
+          }
         }
         def_iter++;
         {
           VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
           CPPUNIT_ASSERT(nullptr != var_def);
-          CPPUNIT_ASSERT_EQUAL(AccessModifier::NONE, var_def->access_modifier());
           CPPUNIT_ASSERT_EQUAL(string("c"), var_def->ident());
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_def->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_def->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
           UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
           CPPUNIT_ASSERT(nullptr != user_defined_var);
-          CPPUNIT_ASSERT_EQUAL(false, user_defined_var->is_template());
-          CPPUNIT_ASSERT(nullptr == user_defined_var->type_expr());
-          TupleValue *tuple_value1 = dynamic_cast<TupleValue *>(user_defined_var->value());
-          CPPUNIT_ASSERT(nullptr != tuple_value1);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), tuple_value1->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().column());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), tuple_value1->fields().size());
-          auto field_iter1 = tuple_value1->fields().begin();
-          VariableLiteralValue *var_literal_value2 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
-          CPPUNIT_ASSERT(nullptr != var_literal_value2);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value2->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_literal_value2->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), var_literal_value2->pos().column());
-          IntValue *int_value2 = dynamic_cast<IntValue *>(var_literal_value2->literal_value());
-          CPPUNIT_ASSERT(nullptr != int_value2);
-          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value2->int_type());
-          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(3), int_value2->i());
-          field_iter1++;
-          VariableLiteralValue *var_literal_value3 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
-          CPPUNIT_ASSERT(nullptr != var_literal_value2);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value3->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_literal_value3->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), var_literal_value3->pos().column());
-          IntValue *int_value3 = dynamic_cast<IntValue *>(var_literal_value3->literal_value());
-          CPPUNIT_ASSERT(nullptr != int_value3);
-          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value3->int_type());
-          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(4), int_value3->i());
-          field_iter1++;
-          VariableLiteralValue *var_literal_value4 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
-          CPPUNIT_ASSERT(nullptr != var_literal_value2);
-          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value4->pos().source().file_name());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_literal_value4->pos().line());
-          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(12), var_literal_value4->pos().column());
-          IntValue *int_value4 = dynamic_cast<IntValue *>(var_literal_value4->literal_value());
-          CPPUNIT_ASSERT(nullptr != int_value4);
-          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value4->int_type());
-          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(5), int_value4->i());
-        }        
+          PackedListValue *list_value1 = dynamic_cast<PackedListValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != list_value1);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), list_value1->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), list_value1->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), list_value1->pos().column());
+          CPPUNIT_ASSERT_EQUAL(PackedElementType::DOUBLE_FLOAT, list_value1->elems().elem_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(17), list_value1->elems().size());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(17 * sizeof(double)), list_value1->elems().data_size());
+          for(size_t i = 0; i < 17; i++) {
+            CPPUNIT_ASSERT_EQUAL(i + 0.5, list_value1->elems().float_elem(i));
+          }
+          unique_ptr<SimpleLiteralValue> literal_value2(list_value1->elems().make_literal_value(16));
+          FloatValue *float_value2 = dynamic_cast<FloatValue *>(literal_value2.get());
+          CPPUNIT_ASSERT(nullptr != float_value2);
+          CPPUNIT_ASSERT_EQUAL(FloatType::DOUBLE, float_value2->float_type());
+          CPPUNIT_ASSERT_EQUAL(16.5, float_value2->f());
+        }
       }
-      
-      void ParserTests::test_parser_parses_variable_constructor_value()
+
+      void ParserTests::test_parser_packs_single_float_elements()
       {
         istringstream iss("\
-v = (C)\n\
+a = [0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f, 8.5f, 9.5f, 10.5f, 11.5f, 12.5f, 13.5f, 14.5f, 15.5f, 16.5f]\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != var_def);
+        CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+        UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_var);
+        PackedListValue *list_value1 = dynamic_cast<PackedListValue *>(user_defined_var->value());
+        CPPUNIT_ASSERT(nullptr != list_value1);
+        CPPUNIT_ASSERT_EQUAL(PackedElementType::SINGLE_FLOAT, list_value1->elems().elem_type());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(17), list_value1->elems().size());
+        CPPUNIT_ASSERT_EQUAL(sizeof(float), PackedElements::elem_size(PackedElementType::SINGLE_FLOAT));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(17 * sizeof(float)), list_value1->elems().data_size());
+        for(size_t i = 0; i < 17; i++) {
+          CPPUNIT_ASSERT_EQUAL(i + 0.5, list_value1->elems().float_elem(i));
+        }
+        unique_ptr<SimpleLiteralValue> literal_value2(list_value1->elems().make_literal_value(16));
+        FloatValue *float_value2 = dynamic_cast<FloatValue *>(literal_value2.get());
+        CPPUNIT_ASSERT(nullptr != float_value2);
+        CPPUNIT_ASSERT_EQUAL(FloatType::SINGLE, float_value2->float_type());
+        CPPUNIT_ASSERT_EQUAL(16.5, float_value2->f());
+      }
+
+      void ParserTests::test_parser_does_not_pack_collection_values_with_different_elements()
+      {
+        istringstream iss("\
+a = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 'a']\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          ListValue *list_value1 = dynamic_cast<ListValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != list_value1);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(17), list_value1->elems().size());
+          auto elem_iter1 = list_value1->elems().begin();
+          for(size_t i = 0; i < 15; i++) elem_iter1++;
+          VariableLiteralValue *var_literal_value2 = dynamic_cast<VariableLiteralValue *>(elem_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value2);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value2->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_literal_value2->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(57), var_literal_value2->pos().column());
+          IntValue *int_value2 = dynamic_cast<IntValue *>(var_literal_value2->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value2);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value2->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(16), int_value2->i());
+          elem_iter1++;
+          VariableLiteralValue *var_literal_value3 = dynamic_cast<VariableLiteralValue *>(elem_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value3);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_literal_value3->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(61), var_literal_value3->pos().column());
+          CharValue *char_value3 = dynamic_cast<CharValue *>(var_literal_value3->literal_value());
+          CPPUNIT_ASSERT(nullptr != char_value3);
+          CPPUNIT_ASSERT_EQUAL('a', char_value3->c());
+        }
+      }
+
+      void ParserTests::test_parser_unpacks_collection_values_with_typed_element()
+      {
+        istringstream iss("\
+a = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 : Int64, -17]\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          ListValue *list_value1 = dynamic_cast<ListValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != list_value1);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(17), list_value1->elems().size());
+          auto elem_iter1 = list_value1->elems().begin();
+          for(size_t i = 0; i < 14; i++) elem_iter1++;
+          VariableLiteralValue *var_literal_value2 = dynamic_cast<VariableLiteralValue *>(elem_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value2);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value2->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_literal_value2->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(53), var_literal_value2->pos().column());
+          IntValue *int_value2 = dynamic_cast<IntValue *>(var_literal_value2->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value2);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value2->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(15), int_value2->i());
+          elem_iter1++;
+          TypedValue *typed_value3 = dynamic_cast<TypedValue *>(elem_iter1->get());
+          CPPUNIT_ASSERT(nullptr != typed_value3);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), typed_value3->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(57), typed_value3->pos().column());
+          VariableLiteralValue *var_literal_value4 = dynamic_cast<VariableLiteralValue *>(typed_value3->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value4);
+          IntValue *int_value4 = dynamic_cast<IntValue *>(var_literal_value4->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value4);
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(16), int_value4->i());
+          elem_iter1++;
+          VariableLiteralValue *var_literal_value5 = dynamic_cast<VariableLiteralValue *>(elem_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value5);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_literal_value5->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(69), var_literal_value5->pos().column());
+          IntValue *int_value5 = dynamic_cast<IntValue *>(var_literal_value5->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value5);
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(-17), int_value5->i());
+        }
+      }
+
+      void ParserTests::test_parser_parses_tuple_values()
+      {
+        istringstream iss("\
+a = ()\n\
+\n\
+b = (1, 2)\n\
+\n\
+c = (3, 4, 5)\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(AccessModifier::NONE, var_def->access_modifier());
+          CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_def->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          CPPUNIT_ASSERT_EQUAL(false, user_defined_var->is_template());
+          CPPUNIT_ASSERT(nullptr == user_defined_var->type_expr());
+          TupleValue *tuple_value1 = dynamic_cast<TupleValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != tuple_value1);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), tuple_value1->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tuple_value1->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().column());
+          CPPUNIT_ASSERT_EQUAL(true, tuple_value1->fields().empty());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(AccessModifier::NONE, var_def->access_modifier());
+          CPPUNIT_ASSERT_EQUAL(string("b"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_def->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          CPPUNIT_ASSERT_EQUAL(false, user_defined_var->is_template());
+          CPPUNIT_ASSERT(nullptr == user_defined_var->type_expr());
+          TupleValue *tuple_value1 = dynamic_cast<TupleValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != tuple_value1);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), tuple_value1->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), tuple_value1->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().column());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), tuple_value1->fields().size());
+          auto field_iter1 = tuple_value1->fields().begin();
+          VariableLiteralValue *var_literal_value2 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value2);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value2->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_literal_value2->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), var_literal_value2->pos().column());
+          IntValue *int_value2 = dynamic_cast<IntValue *>(var_literal_value2->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value2);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value2->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(1), int_value2->i());
+          field_iter1++;
+          VariableLiteralValue *var_literal_value3 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value3);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value3->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_literal_value3->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), var_literal_value3->pos().column());
+          IntValue *int_value3 = dynamic_cast<IntValue *>(var_literal_value3->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value3);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value3->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(2), int_value3->i());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(AccessModifier::NONE, var_def->access_modifier());
+          CPPUNIT_ASSERT_EQUAL(string("c"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_def->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_def->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().column());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          CPPUNIT_ASSERT_EQUAL(false, user_defined_var->is_template());
+          CPPUNIT_ASSERT(nullptr == user_defined_var->type_expr());
+          TupleValue *tuple_value1 = dynamic_cast<TupleValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != tuple_value1);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), tuple_value1->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), tuple_value1->pos().column());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), tuple_value1->fields().size());
+          auto field_iter1 = tuple_value1->fields().begin();
+          VariableLiteralValue *var_literal_value2 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value2);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value2->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_literal_value2->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), var_literal_value2->pos().column());
+          IntValue *int_value2 = dynamic_cast<IntValue *>(var_literal_value2->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value2);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value2->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(3), int_value2->i());
+          field_iter1++;
+          VariableLiteralValue *var_literal_value3 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value2);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value3->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_literal_value3->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), var_literal_value3->pos().column());
+          IntValue *int_value3 = dynamic_cast<IntValue *>(var_literal_value3->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value3);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value3->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(4), int_value3->i());
+          field_iter1++;
+          VariableLiteralValue *var_literal_value4 = dynamic_cast<VariableLiteralValue *>(field_iter1->get());
+          CPPUNIT_ASSERT(nullptr != var_literal_value2);
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), var_literal_value4->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_literal_value4->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(12), var_literal_value4->pos().column());
+          IntValue *int_value4 = dynamic_cast<IntValue *>(var_literal_value4->literal_value());
+          CPPUNIT_ASSERT(nullptr != int_value4);
+          CPPUNIT_ASSERT_EQUAL(IntType::INT64, int_value4->int_type());
+          CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(5), int_value4->i());
+        }        
+      }
+      
+      void ParserTests::test_parser_parses_variable_constructor_value()
+      {
+        istringstream iss("\
+v = (C)\n\
 ");
         vector<Source> sources;
         sources.push_back(Source("test.lesfl", iss));
@@ -20351,6 +20766,567 @@ f() =\n\
         }
       }
       
+      void ParserTests::test_parser_parses_lambda_value_in_binary_operator_expression()
+      {
+        istringstream iss("\
+f() = x + \\(y) -> y * z + 1\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_fun);
+        NonUniqueApplication *app1 = dynamic_cast<NonUniqueApplication *>(user_defined_fun->body());
+        CPPUNIT_ASSERT(nullptr != app1);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), app1->pos().column());
+        VariableExpression *var_expr1 = dynamic_cast<VariableExpression *>(app1->fun());
+        CPPUNIT_ASSERT(nullptr != var_expr1);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), var_expr1->pos().column());
+        RelativeIdentifier *rel_ident1 = dynamic_cast<RelativeIdentifier *>(var_expr1->ident());
+        CPPUNIT_ASSERT(nullptr != rel_ident1);
+        CPPUNIT_ASSERT_EQUAL(string("+"), rel_ident1->idents().back());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), app1->args().size());
+        auto arg_iter1 = app1->args().begin();
+        arg_iter1++;
+        Literal *literal = dynamic_cast<Literal *>(arg_iter1->get());
+        CPPUNIT_ASSERT(nullptr != literal);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), literal->pos().column());
+        NonUniqueLambdaValue *lambda_value = dynamic_cast<NonUniqueLambdaValue *>(literal->literal_value());
+        CPPUNIT_ASSERT(nullptr != lambda_value);
+        NonUniqueApplication *app2 = dynamic_cast<NonUniqueApplication *>(lambda_value->body());
+        CPPUNIT_ASSERT(nullptr != app2);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(19), app2->pos().column());
+        VariableExpression *var_expr2 = dynamic_cast<VariableExpression *>(app2->fun());
+        CPPUNIT_ASSERT(nullptr != var_expr2);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(25), var_expr2->pos().column());
+        RelativeIdentifier *rel_ident2 = dynamic_cast<RelativeIdentifier *>(var_expr2->ident());
+        CPPUNIT_ASSERT(nullptr != rel_ident2);
+        CPPUNIT_ASSERT_EQUAL(string("+"), rel_ident2->idents().back());
+      }
+
+      void ParserTests::test_parser_parses_long_binary_operator_expression()
+      {
+        ostringstream oss;
+        oss << "f() = x0";
+        for(size_t i = 1; i <= 1000; i++) oss << (i % 2 == 0 ? " * x" : " + x") << i;
+        oss << "\n";
+        istringstream iss(oss.str());
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        auto def_list_iter = tree.defs().begin();
+        auto def_iter = (*def_list_iter)->begin();
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_fun);
+        Expression *expr = user_defined_fun->body();
+        size_t add_count = 0;
+        while(true) {
+          NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(expr);
+          if(app == nullptr) break;
+          VariableExpression *var_expr = dynamic_cast<VariableExpression *>(app->fun());
+          CPPUNIT_ASSERT(nullptr != var_expr);
+          RelativeIdentifier *rel_ident = dynamic_cast<RelativeIdentifier *>(var_expr->ident());
+          CPPUNIT_ASSERT(nullptr != rel_ident);
+          CPPUNIT_ASSERT_EQUAL(string("+"), rel_ident->idents().back());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), app->args().size());
+          expr = app->args().front().get();
+          add_count++;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(500), add_count);
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(expr);
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        RelativeIdentifier *rel_ident = dynamic_cast<RelativeIdentifier *>(var_expr->ident());
+        CPPUNIT_ASSERT(nullptr != rel_ident);
+        CPPUNIT_ASSERT_EQUAL(string("x0"), rel_ident->idents().back());
+      }
+
+      void ParserTests::test_parser_defers_function_bodies()
+      {
+        istringstream iss("\
+f(x) = g(x, 1)\n\
+h(x) = if(x) 1\n\
+  else 2\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        Parser parser(true);
+        CPPUNIT_ASSERT_EQUAL(true, parser.parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != fun_def);
+          CPPUNIT_ASSERT_EQUAL(string("f"), fun_def->ident());
+          UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_fun);
+          CPPUNIT_ASSERT_EQUAL(true, user_defined_fun->has_deferred_body());
+          CPPUNIT_ASSERT(nullptr != dynamic_cast<DeferredExpression *>(user_defined_fun->body()));
+          list<Error> body_errors;
+          CPPUNIT_ASSERT_EQUAL(true, user_defined_fun->parse_body(body_errors));
+          CPPUNIT_ASSERT(body_errors.empty());
+          NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(user_defined_fun->body());
+          CPPUNIT_ASSERT(nullptr != app);
+          CPPUNIT_ASSERT_EQUAL(false, user_defined_fun->has_deferred_body());
+          CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), app->pos().source().file_name());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), app->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), app->pos().column());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), app->args().size());
+        }
+        def_iter++;
+        {
+          FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != fun_def);
+          CPPUNIT_ASSERT_EQUAL(string("h"), fun_def->ident());
+          UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_fun);
+          CPPUNIT_ASSERT_EQUAL(true, user_defined_fun->has_deferred_body());
+          list<Error> body_errors;
+          CPPUNIT_ASSERT_EQUAL(true, user_defined_fun->parse_body(body_errors));
+          CPPUNIT_ASSERT(body_errors.empty());
+          CPPUNIT_ASSERT_EQUAL(false, user_defined_fun->has_deferred_body());
+          CPPUNIT_ASSERT(nullptr == dynamic_cast<DeferredExpression *>(user_defined_fun->body()));
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), user_defined_fun->body()->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), user_defined_fun->body()->pos().column());
+        }
+      }
+
+      void ParserTests::test_parser_defers_lambda_bodies()
+      {
+        istringstream iss("\
+v = \\(x) -> x\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        Parser parser(true);
+        CPPUNIT_ASSERT_EQUAL(true, parser.parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != var_def);
+        UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_var);
+        VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+        CPPUNIT_ASSERT(nullptr != var_literal_value);
+        NonUniqueLambdaValue *lambda_value = dynamic_cast<NonUniqueLambdaValue *>(var_literal_value->literal_value());
+        CPPUNIT_ASSERT(nullptr != lambda_value);
+        CPPUNIT_ASSERT_EQUAL(true, lambda_value->has_deferred_body());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<DeferredExpression *>(lambda_value->body()));
+        list<Error> body_errors;
+        CPPUNIT_ASSERT_EQUAL(true, lambda_value->parse_body(body_errors));
+        CPPUNIT_ASSERT(body_errors.empty());
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(lambda_value->body());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT_EQUAL(false, lambda_value->has_deferred_body());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_expr->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(13), var_expr->pos().column());
+      }
+
+      void ParserTests::test_parser_defers_nested_lambda_bodies()
+      {
+        istringstream iss("\
+v = \\(x) -> \\(y) -> g(x, y)\n\
+w = \\(x) -> x\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        Parser parser(true);
+        CPPUNIT_ASSERT_EQUAL(true, parser.parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("v"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          NonUniqueLambdaValue *lambda_value1 = dynamic_cast<NonUniqueLambdaValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != lambda_value1);
+          CPPUNIT_ASSERT_EQUAL(true, lambda_value1->has_deferred_body());
+          list<Error> body_errors;
+          CPPUNIT_ASSERT_EQUAL(true, lambda_value1->parse_body(body_errors));
+          CPPUNIT_ASSERT(body_errors.empty());
+          Literal *literal = dynamic_cast<Literal *>(lambda_value1->body());
+          CPPUNIT_ASSERT(nullptr != literal);
+          CPPUNIT_ASSERT_EQUAL(false, lambda_value1->has_deferred_body());
+          NonUniqueLambdaValue *lambda_value2 = dynamic_cast<NonUniqueLambdaValue *>(literal->literal_value());
+          CPPUNIT_ASSERT(nullptr != lambda_value2);
+          CPPUNIT_ASSERT_EQUAL(false, lambda_value2->has_deferred_body());
+          NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(lambda_value2->body());
+          CPPUNIT_ASSERT(nullptr != app);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), app->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(21), app->pos().column());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), app->args().size());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("w"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          NonUniqueLambdaValue *lambda_value = dynamic_cast<NonUniqueLambdaValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != lambda_value);
+          CPPUNIT_ASSERT_EQUAL(true, lambda_value->has_deferred_body());
+          list<Error> body_errors;
+          CPPUNIT_ASSERT_EQUAL(true, lambda_value->parse_body(body_errors));
+          CPPUNIT_ASSERT(body_errors.empty());
+          VariableExpression *var_expr = dynamic_cast<VariableExpression *>(lambda_value->body());
+          CPPUNIT_ASSERT(nullptr != var_expr);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), var_expr->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(13), var_expr->pos().column());
+        }
+      }
+
+      void ParserTests::test_parser_defers_lambda_body_with_match_expression()
+      {
+        istringstream iss("\
+v = \\(x) -> x match {\n\
+    1 -> \\(y) -> y\n\
+    _ -> x\n\
+  }\n\
+w = 1\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        Parser parser(true);
+        CPPUNIT_ASSERT_EQUAL(true, parser.parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree.defs().size());
+        auto def_list_iter = tree.defs().begin();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), (*def_list_iter)->size());
+        auto def_iter = (*def_list_iter)->begin();
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("v"), var_def->ident());
+          UserDefinedVariable *user_defined_var = dynamic_cast<UserDefinedVariable *>(var_def->var().get());
+          CPPUNIT_ASSERT(nullptr != user_defined_var);
+          VariableLiteralValue *var_literal_value = dynamic_cast<VariableLiteralValue *>(user_defined_var->value());
+          CPPUNIT_ASSERT(nullptr != var_literal_value);
+          NonUniqueLambdaValue *lambda_value = dynamic_cast<NonUniqueLambdaValue *>(var_literal_value->literal_value());
+          CPPUNIT_ASSERT(nullptr != lambda_value);
+          CPPUNIT_ASSERT_EQUAL(true, lambda_value->has_deferred_body());
+          list<Error> body_errors;
+          CPPUNIT_ASSERT_EQUAL(true, lambda_value->parse_body(body_errors));
+          CPPUNIT_ASSERT(body_errors.empty());
+          Match *match = dynamic_cast<Match *>(lambda_value->body());
+          CPPUNIT_ASSERT(nullptr != match);
+          CPPUNIT_ASSERT_EQUAL(false, lambda_value->has_deferred_body());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), match->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(13), match->pos().column());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), match->cases().size());
+          auto case_iter = match->cases().begin();
+          Literal *literal = dynamic_cast<Literal *>((*case_iter)->expr());
+          CPPUNIT_ASSERT(nullptr != literal);
+          NonUniqueLambdaValue *lambda_value2 = dynamic_cast<NonUniqueLambdaValue *>(literal->literal_value());
+          CPPUNIT_ASSERT(nullptr != lambda_value2);
+          CPPUNIT_ASSERT_EQUAL(false, lambda_value2->has_deferred_body());
+          case_iter++;
+          VariableExpression *var_expr = dynamic_cast<VariableExpression *>((*case_iter)->expr());
+          CPPUNIT_ASSERT(nullptr != var_expr);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), var_expr->pos().line());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), var_expr->pos().column());
+        }
+        def_iter++;
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def_iter->get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("w"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), var_def->pos().line());
+        }
+      }
+
+      void ParserTests::test_parser_complains_on_syntax_error_in_deferred_function_body()
+      {
+        istringstream iss("\
+f(x) = (x +)\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        Parser parser(true);
+        CPPUNIT_ASSERT_EQUAL(true, parser.parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        auto def_list_iter = tree.defs().begin();
+        auto def_iter = (*def_list_iter)->begin();
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(def_iter->get());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_fun);
+        CPPUNIT_ASSERT_EQUAL(false, user_defined_fun->parse_body(errors));
+        CPPUNIT_ASSERT_EQUAL(true, user_defined_fun->has_deferred_body());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), errors.size());
+        auto error_iter = errors.begin();
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(12), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("syntax error"), error_iter->msg());
+      }
+
+      void ParserTests::test_parser_defers_multi_line_bodies_with_if_expressions()
+      {
+        const char *str = "\
+module stdlib {\n\
+  datatype Bool = False | True\n\
+}\n\
+\n\
+f(x) =\n\
+  if(#ieq(x, 0))\n\
+    1\n\
+  else if(#ieq(x, 1))\n\
+    #iadd(x,\n\
+      2)\n\
+  else\n\
+    if(#ilt(x, 0)) 3 else 4\n\
+\n\
+g(x) =\n\
+  if(#ieq(x, 0)) \\(y) -> y\n\
+  else \\(y) ->\n\
+    if(#ieq(y, 0))\n\
+      x\n\
+    else\n\
+      y\n\
+\n\
+h(x) = f(g(x)(1))\n\
+";
+        string eager_data, deferred_data;
+        CPPUNIT_ASSERT_EQUAL(true, parse_and_freeze(str, false, eager_data));
+        CPPUNIT_ASSERT_EQUAL(true, parse_and_freeze(str, true, deferred_data));
+        CPPUNIT_ASSERT(eager_data == deferred_data);
+      }
+
+      void ParserTests::test_parser_defers_bodies_with_nested_let_expressions()
+      {
+        const char *str = "\
+module stdlib {\n\
+  datatype Bool = False | True\n\
+}\n\
+\n\
+f(x) =\n\
+  let\n\
+    y = let z = #iadd(x, 1) in #imul(z, 2)\n\
+    w = \\(v) -> let u = v in u\n\
+  in\n\
+    let\n\
+      t = #iadd(y, w(x))\n\
+    in\n\
+      if(#ieq(t, 0))\n\
+        let s = t in s\n\
+      else\n\
+        t\n\
+\n\
+g(x) = f(x)\n\
+";
+        string eager_data, deferred_data;
+        CPPUNIT_ASSERT_EQUAL(true, parse_and_freeze(str, false, eager_data));
+        CPPUNIT_ASSERT_EQUAL(true, parse_and_freeze(str, true, deferred_data));
+        CPPUNIT_ASSERT(eager_data == deferred_data);
+      }
+
+      void ParserTests::test_parser_defers_bodies_with_match_expressions()
+      {
+        const char *str = "\
+import stdlib\n\
+\n\
+module stdlib {\n\
+  datatype Bool = False | True\n\
+}\n\
+\n\
+datatype T = C | D(Int64, T)\n\
+\n\
+f(t) =\n\
+  t match {\n\
+    C -> 0\n\
+    D(x, u) ->\n\
+      if(#ieq(x, 0))\n\
+        f(u)\n\
+      else\n\
+        (\\(y) -> #iadd(x, y))(1)\n\
+  }\n\
+\n\
+g(t) = t match { C -> 1; D(_, u) -> u match { C -> 2; D(_, _) -> 3 } }\n\
+\n\
+h(t) = \\(u) -> u match {\n\
+    C -> f(t)\n\
+    D(x, _) -> x\n\
+  }\n\
+";
+        string eager_data, deferred_data;
+        CPPUNIT_ASSERT_EQUAL(true, parse_and_freeze(str, false, eager_data));
+        CPPUNIT_ASSERT_EQUAL(true, parse_and_freeze(str, true, deferred_data));
+        CPPUNIT_ASSERT(eager_data == deferred_data);
+      }
+
+      void ParserTests::test_parser_profiles_sources()
+      {
+        istringstream iss1("\
+f(x) = \\(y) -> x + y * 2\n\
+");
+        istringstream iss2("\
+v = 1\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test1.lesfl", iss1));
+        sources.push_back(Source("test2.lesfl", iss2));
+        list<Error> errors;
+        Tree tree;
+        ParseProfile profile;
+        FrontendOptions options;
+        options.profile = &profile;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), tree.defs().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), profile.source_profiles().size());
+        auto &source_profile1 = profile.source_profiles()[0];
+        CPPUNIT_ASSERT_EQUAL(string("test1.lesfl"), source_profile1.file_name());
+        if(ParseProfile::is_available()) {
+          CPPUNIT_ASSERT(source_profile1.stack_split_count() > static_cast<size_t>(0));
+          CPPUNIT_ASSERT(source_profile1.max_stack_count() > static_cast<size_t>(1));
+          CPPUNIT_ASSERT(source_profile1.deferred_action_count() > static_cast<size_t>(0));
+          CPPUNIT_ASSERT(source_profile1.stack_split_count() >= source_profile1.stack_merge_count());
+          CPPUNIT_ASSERT_EQUAL(false, source_profile1.rule_profiles().empty());
+        } else {
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), source_profile1.stack_split_count());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), source_profile1.max_stack_count());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), source_profile1.deferred_action_count());
+          CPPUNIT_ASSERT_EQUAL(true, source_profile1.rule_profiles().empty());
+        }
+        size_t deferred_action_count = 0;
+        for(auto &pair : source_profile1.rule_profiles())
+          deferred_action_count += pair.second.deferred_action_count();
+        CPPUNIT_ASSERT_EQUAL(source_profile1.deferred_action_count(), deferred_action_count);
+        auto &source_profile2 = profile.source_profiles()[1];
+        CPPUNIT_ASSERT_EQUAL(string("test2.lesfl"), source_profile2.file_name());
+      }
+
+      void ParserTests::test_parser_writes_parse_profile_report()
+      {
+        istringstream iss("\
+f(x) = x + 1\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        ParseProfile profile;
+        FrontendOptions options;
+        options.profile = &profile;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        ostringstream oss;
+        profile.write_report(oss);
+        string report = oss.str();
+        if(ParseProfile::is_available()) {
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), report.find("parse profile:\n  test.lesfl: splits="));
+          CPPUNIT_ASSERT(report.find("\ntotal: splits=") != string::npos);
+        } else
+          CPPUNIT_ASSERT_EQUAL(string("parse profile: unavailable\n"), report);
+      }
+
+      void ParserTests::test_parser_passes_definitions_to_function()
+      {
+        istringstream iss("\
+a = 1\n\
+f(x) = x\n\
+module M {\n\
+  b = 2\n\
+  g(x) = x\n\
+}\n\
+c = 3\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        vector<unique_ptr<Definition>> defs;
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse_defs(sources, [&defs](unique_ptr<Definition> def) {
+          defs.push_back(move(def));
+        }, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), defs.size());
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(defs[0].get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("a"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_def->pos().line());
+        }
+        {
+          FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(defs[1].get());
+          CPPUNIT_ASSERT(nullptr != fun_def);
+          CPPUNIT_ASSERT_EQUAL(string("f"), fun_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), fun_def->pos().line());
+        }
+        {
+          ModuleDefinition *module_def = dynamic_cast<ModuleDefinition *>(defs[2].get());
+          CPPUNIT_ASSERT(nullptr != module_def);
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), module_def->defs().size());
+        }
+        {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(defs[3].get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          CPPUNIT_ASSERT_EQUAL(string("c"), var_def->ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), var_def->pos().line());
+        }
+      }
+
+      void ParserTests::test_parser_passes_definitions_before_syntax_error_to_function()
+      {
+        istringstream iss("\
+a = 1\n\
+b = 2\n\
+c = (\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        vector<string> idents;
+        CPPUNIT_ASSERT_EQUAL(false, _M_parser->parse_defs(sources, [&idents](unique_ptr<Definition> def) {
+          VariableDefinition *var_def = dynamic_cast<VariableDefinition *>(def.get());
+          CPPUNIT_ASSERT(nullptr != var_def);
+          idents.push_back(var_def->ident());
+        }, errors));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), errors.size());
+        CPPUNIT_ASSERT_EQUAL(string("syntax error"), errors.begin()->msg());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), idents.size());
+        CPPUNIT_ASSERT_EQUAL(string("a"), idents[0]);
+        CPPUNIT_ASSERT_EQUAL(string("b"), idents[1]);
+      }
+
       void ParserTests::test_parser_complains_on_syntax_error()
       {
         istringstream iss("\
@@ -20675,6 +21651,24 @@ f() = w\"abc\
         CPPUNIT_ASSERT_EQUAL(string("unclosed wide string literal"), error_iter->msg());
       }
       
+      void ParserTests::test_parser_complains_on_invalid_utf8_sequence_in_wide_string_literal()
+      {
+        istringstream iss("\
+f() = w\"abc\xc3(\"\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(false, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), errors.size());
+        auto error_iter = errors.begin();
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("invalid UTF-8 sequence in wide string literal"), error_iter->msg());
+      }
+      
       void ParserTests::test_parser_complains_on_incorrect_character()
       {
         istringstream iss("\
@@ -24,6 +24,7 @@ namespace lesfl
         CPPUNIT_TEST_SUITE(ParserTests);
         CPPUNIT_TEST(test_parser_parses_simple_definitions);
         CPPUNIT_TEST(test_parser_parses_definitions_with_comments);
+        CPPUNIT_TEST(test_parser_parses_definitions_with_long_comments_and_spaces);
         CPPUNIT_TEST(test_parser_parses_definition_with_nested_comment);
         CPPUNIT_TEST(test_parser_parses_definitions_which_are_separated_semicolon);
         CPPUNIT_TEST(test_parser_parses_expression_without_space_separations);
@@ -42,6 +43,8 @@ namespace lesfl
         CPPUNIT_TEST(test_parser_parses_negative_infinities_in_values);
         CPPUNIT_TEST(test_parser_parses_strings);
         CPPUNIT_TEST(test_parser_parses_wide_strings);
+        CPPUNIT_TEST(test_parser_parses_long_strings);
+        CPPUNIT_TEST(test_parser_parses_utf8_wide_characters_and_wide_strings);
         CPPUNIT_TEST(test_parser_parses_imports);
         CPPUNIT_TEST(test_parser_parses_module_definitions);
         CPPUNIT_TEST(test_parser_parses_user_defined_variable_definition);
@@ -186,6 +189,10 @@ namespace lesfl
         CPPUNIT_TEST(test_parser_parses_negative_variable_literal_value);
         CPPUNIT_TEST(test_parser_parses_list_values);
         CPPUNIT_TEST(test_parser_parses_array_values);
+        CPPUNIT_TEST(test_parser_parses_packed_collection_values);
+        CPPUNIT_TEST(test_parser_packs_single_float_elements);
+        CPPUNIT_TEST(test_parser_does_not_pack_collection_values_with_different_elements);
+        CPPUNIT_TEST(test_parser_unpacks_collection_values_with_typed_element);
         CPPUNIT_TEST(test_parser_parses_tuple_values);
         CPPUNIT_TEST(test_parser_parses_variable_constructor_value);
         CPPUNIT_TEST(test_parser_parses_function_constructor_values);
@@ -225,6 +232,20 @@ namespace lesfl
         CPPUNIT_TEST(test_parser_parses_semicolons_in_module_definition);
         CPPUNIT_TEST(test_parser_parses_semicolons_in_let_expression);
         CPPUNIT_TEST(test_parser_parses_semicolons_in_match_expression);
+        CPPUNIT_TEST(test_parser_parses_lambda_value_in_binary_operator_expression);
+        CPPUNIT_TEST(test_parser_parses_long_binary_operator_expression);
+        CPPUNIT_TEST(test_parser_defers_function_bodies);
+        CPPUNIT_TEST(test_parser_defers_lambda_bodies);
+        CPPUNIT_TEST(test_parser_defers_nested_lambda_bodies);
+        CPPUNIT_TEST(test_parser_defers_lambda_body_with_match_expression);
+        CPPUNIT_TEST(test_parser_complains_on_syntax_error_in_deferred_function_body);
+        CPPUNIT_TEST(test_parser_defers_multi_line_bodies_with_if_expressions);
+        CPPUNIT_TEST(test_parser_defers_bodies_with_nested_let_expressions);
+        CPPUNIT_TEST(test_parser_defers_bodies_with_match_expressions);
+        CPPUNIT_TEST(test_parser_profiles_sources);
+        CPPUNIT_TEST(test_parser_writes_parse_profile_report);
+        CPPUNIT_TEST(test_parser_passes_definitions_to_function);
+        CPPUNIT_TEST(test_parser_passes_definitions_before_syntax_error_to_function);
         CPPUNIT_TEST(test_parser_complains_on_syntax_error);
         CPPUNIT_TEST(test_parser_complains_on_unclosed_comment);
         CPPUNIT_TEST(test_parser_complains_on_empty_character_literal);
@@ -243,11 +264,14 @@ namespace lesfl
         CPPUNIT_TEST(test_parser_complains_on_unclosed_string_literal_for_end_of_file);
         CPPUNIT_TEST(test_parser_complains_on_unclosed_wide_string_literal);
         CPPUNIT_TEST(test_parser_complains_on_unclosed_wide_string_literal_for_end_of_file);
+        CPPUNIT_TEST(test_parser_complains_on_invalid_utf8_sequence_in_wide_string_literal);
         CPPUNIT_TEST(test_parser_complains_on_incorrect_character);
         CPPUNIT_TEST(test_parser_complains_on_incorrect_built_in_function);
         CPPUNIT_TEST_SUITE_END();
 
         Parser *_M_parser;
+
+        bool parse_and_freeze(const char *str, bool is_deferred_parsing, std::string &data);
       public:
         void setUp();
 
@@ -255,6 +279,7 @@ namespace lesfl
         
         void test_parser_parses_simple_definitions();
         void test_parser_parses_definitions_with_comments();
+        void test_parser_parses_definitions_with_long_comments_and_spaces();
         void test_parser_parses_definition_with_nested_comment();
         void test_parser_parses_definitions_which_are_separated_semicolon();
         void test_parser_parses_expression_without_space_separations();
@@ -273,6 +298,8 @@ namespace lesfl
         void test_parser_parses_negative_infinities_in_values();
         void test_parser_parses_strings();
         void test_parser_parses_wide_strings();
+        void test_parser_parses_long_strings();
+        void test_parser_parses_utf8_wide_characters_and_wide_strings();
         void test_parser_parses_imports();
         void test_parser_parses_module_definitions();
         void test_parser_parses_user_defined_variable_definition();
@@ -417,6 +444,10 @@ namespace lesfl
         void test_parser_parses_negative_variable_literal_value();
         void test_parser_parses_list_values();
         void test_parser_parses_array_values();
+        void test_parser_parses_packed_collection_values();
+        void test_parser_packs_single_float_elements();
+        void test_parser_does_not_pack_collection_values_with_different_elements();
+        void test_parser_unpacks_collection_values_with_typed_element();
         void test_parser_parses_tuple_values();
         void test_parser_parses_variable_constructor_value();
         void test_parser_parses_function_constructor_values();
@@ -456,6 +487,20 @@ namespace lesfl
         void test_parser_parses_semicolons_in_module_definition();
         void test_parser_parses_semicolons_in_let_expression();
         void test_parser_parses_semicolons_in_match_expression();
+        void test_parser_parses_lambda_value_in_binary_operator_expression();
+        void test_parser_parses_long_binary_operator_expression();
+        void test_parser_defers_function_bodies();
+        void test_parser_defers_lambda_bodies();
+        void test_parser_defers_nested_lambda_bodies();
+        void test_parser_defers_lambda_body_with_match_expression();
+        void test_parser_complains_on_syntax_error_in_deferred_function_body();
+        void test_parser_defers_multi_line_bodies_with_if_expressions();
+        void test_parser_defers_bodies_with_nested_let_expressions();
+        void test_parser_defers_bodies_with_match_expressions();
+        void test_parser_profiles_sources();
+        void test_parser_writes_parse_profile_report();
+        void test_parser_passes_definitions_to_function();
+        void test_parser_passes_definitions_before_syntax_error_to_function();
         void test_parser_complains_on_syntax_error();
         void test_parser_complains_on_unclosed_comment();
         void test_parser_complains_on_empty_character_literal();
@@ -474,6 +519,7 @@ namespace lesfl
         void test_parser_complains_on_unclosed_string_literal_for_end_of_file();
         void test_parser_complains_on_unclosed_wide_string_literal();
         void test_parser_complains_on_unclosed_wide_string_literal_for_end_of_file();
+        void test_parser_complains_on_invalid_utf8_sequence_in_wide_string_literal();
         void test_parser_complains_on_incorrect_character();
         void test_parser_complains_on_incorrect_built_in_function();
       };
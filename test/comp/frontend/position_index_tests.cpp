@@ -0,0 +1,198 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <sstream>
+#include "frontend/position_index_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(PositionIndexTests);
+
+      void PositionIndexTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+        _M_position_index_builder = new PositionIndexBuilder();
+      }
+
+      void PositionIndexTests::tearDown()
+      {
+        delete _M_position_index_builder;
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      void PositionIndexTests::test_position_index_builder_builds_position_index_for_expressions()
+      {
+        istringstream iss("\
+f(x) = g(x, 1)\n\
+\n\
+g(x, y) = y\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        PositionIndex index;
+        CPPUNIT_ASSERT_EQUAL(true, _M_position_index_builder->build_position_index(tree, index));
+        const PositionIndexEntry *entry = index.find("test.lesfl", 1, 3);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::DEF, entry->kind());
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>(entry->def());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        CPPUNIT_ASSERT_EQUAL(string("f"), fun_def->ident());
+        entry = index.find("test.lesfl", 1, 8);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(entry->expr());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_key_ident());
+        CPPUNIT_ASSERT_EQUAL(string(".g"), tree.ident_table()->ident(entry->key_ident())->to_string());
+        CPPUNIT_ASSERT_EQUAL(false, entry->has_local_var_index());
+        entry = index.find("test.lesfl", 1, 11);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        var_expr = dynamic_cast<VariableExpression *>(entry->expr());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), var_expr->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), var_expr->pos().column());
+        CPPUNIT_ASSERT_EQUAL(false, entry->has_key_ident());
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_local_var_index());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), entry->local_var_index());
+        entry = index.find("test.lesfl", 1, 14);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<Literal *>(entry->expr()));
+        entry = index.find("test.lesfl", 3, 11);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_local_var_index());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), entry->local_var_index());
+      }
+
+      void PositionIndexTests::test_position_index_builder_builds_position_index_for_patterns_and_type_expressions()
+      {
+        istringstream iss("\
+f(x: T) = x match {\n\
+    C(y) -> y\n\
+  }\n\
+\n\
+datatype T = C(T) | D\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        PositionIndex index;
+        CPPUNIT_ASSERT_EQUAL(true, _M_position_index_builder->build_position_index(tree, index));
+        const PositionIndexEntry *entry = index.find("test.lesfl", 1, 6);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::TYPE_EXPR, entry->kind());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<TypeVariableExpression *>(entry->type_expr()));
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_key_ident());
+        CPPUNIT_ASSERT_EQUAL(string(".T"), tree.ident_table()->ident(entry->key_ident())->to_string());
+        entry = index.find("test.lesfl", 2, 5);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::PATTERN, entry->kind());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<UnnamedFieldConstructorPattern *>(entry->pattern()));
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_key_ident());
+        CPPUNIT_ASSERT_EQUAL(string(".C"), tree.ident_table()->ident(entry->key_ident())->to_string());
+        entry = index.find("test.lesfl", 2, 7);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::PATTERN, entry->kind());
+        VariablePattern *var_pattern = dynamic_cast<VariablePattern *>(entry->pattern());
+        CPPUNIT_ASSERT(nullptr != var_pattern);
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_local_var_index());
+        CPPUNIT_ASSERT_EQUAL(var_pattern->index(), entry->local_var_index());
+        size_t local_var_index = entry->local_var_index();
+        entry = index.find("test.lesfl", 2, 13);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<VariableExpression *>(entry->expr()));
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_local_var_index());
+        CPPUNIT_ASSERT_EQUAL(local_var_index, entry->local_var_index());
+        entry = index.find("test.lesfl", 5, 16);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::TYPE_EXPR, entry->kind());
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_key_ident());
+        CPPUNIT_ASSERT_EQUAL(string(".T"), tree.ident_table()->ident(entry->key_ident())->to_string());
+      }
+
+      void PositionIndexTests::test_position_index_does_not_find_nodes_for_other_source()
+      {
+        istringstream iss("\
+f(x) = x\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        PositionIndex index;
+        CPPUNIT_ASSERT_EQUAL(true, _M_position_index_builder->build_position_index(tree, index));
+        CPPUNIT_ASSERT(nullptr != index.find("test.lesfl", 1, 1));
+        CPPUNIT_ASSERT(nullptr == index.find("test2.lesfl", 1, 1));
+        CPPUNIT_ASSERT(nullptr == index.entries("test2.lesfl"));
+      }
+
+      void PositionIndexTests::test_position_index_builder_builds_position_index_for_very_deep_expression()
+      {
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        PositionIndex index;
+        CPPUNIT_ASSERT_EQUAL(true, _M_position_index_builder->build_position_index(tree, index));
+        const PositionIndexEntry *entry = index.find("test.lesfl", 3, 8);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(entry->expr());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_local_var_index());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), entry->local_var_index());
+        entry = index.find("test.lesfl", 3, 8 + 100000 * 4);
+        CPPUNIT_ASSERT(nullptr != entry);
+        CPPUNIT_ASSERT_EQUAL(PositionIndexNodeKind::EXPR, entry->kind());
+        var_expr = dynamic_cast<VariableExpression *>(entry->expr());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8 + 100000 * 4), var_expr->pos().column());
+        CPPUNIT_ASSERT_EQUAL(true, entry->has_local_var_index());
+      }
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_POSITION_INDEX_TESTS_HPP
+#define _FRONTEND_POSITION_INDEX_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class PositionIndexTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(PositionIndexTests);
+        CPPUNIT_TEST(test_position_index_builder_builds_position_index_for_expressions);
+        CPPUNIT_TEST(test_position_index_builder_builds_position_index_for_patterns_and_type_expressions);
+        CPPUNIT_TEST(test_position_index_does_not_find_nodes_for_other_source);
+        CPPUNIT_TEST(test_position_index_builder_builds_position_index_for_very_deep_expression);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+        PositionIndexBuilder *_M_position_index_builder;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_position_index_builder_builds_position_index_for_expressions();
+        void test_position_index_builder_builds_position_index_for_patterns_and_type_expressions();
+        void test_position_index_does_not_find_nodes_for_other_source();
+        void test_position_index_builder_builds_position_index_for_very_deep_expression();
+      };
+    }
+  }
+}
+
+#endif
@@ -20829,6 +20829,402 @@ f() = C3 { field1 = 1, field2 = 2 }\n\
         CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), error_iter->pos().column());
         CPPUNIT_ASSERT_EQUAL(string("alias variable .C3 refers to alias cycle"), error_iter->msg());
       }
+
+      void ResolverTests::test_resolver_resolves_identifiers_for_very_deep_expression()
+      {
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        istringstream iss(str);
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier f_abs_ident(list<string> { "f" });
+        CPPUNIT_ASSERT_EQUAL(true, f_abs_ident.set_key_ident(*(tree.ident_table())));
+        VariableInfo *var_info = tree.var_info(f_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != var_info);
+        FunctionVariable *fun_var = dynamic_cast<FunctionVariable *>(var_info->var().get());
+        CPPUNIT_ASSERT(nullptr != fun_var);
+        UserDefinedFunction *user_defined_fun = dynamic_cast<UserDefinedFunction *>(fun_var->fun().get());
+        CPPUNIT_ASSERT(nullptr != user_defined_fun);
+        Expression *expr = user_defined_fun->body();
+        size_t depth = 0;
+        for(NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(expr); app != nullptr; app = dynamic_cast<NonUniqueApplication *>(expr)) {
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), app->args().size());
+          VariableExpression *var_expr1 = dynamic_cast<VariableExpression *>(app->fun());
+          CPPUNIT_ASSERT(nullptr != var_expr1);
+          RelativeIdentifier *rel_ident1 = dynamic_cast<RelativeIdentifier *>(var_expr1->ident());
+          CPPUNIT_ASSERT(nullptr != rel_ident1);
+          CPPUNIT_ASSERT_EQUAL(true, rel_ident1->has_key_ident());
+          VariableExpression *var_expr2 = dynamic_cast<VariableExpression *>(app->args().back().get());
+          CPPUNIT_ASSERT(nullptr != var_expr2);
+          RelativeIdentifier *rel_ident2 = dynamic_cast<RelativeIdentifier *>(var_expr2->ident());
+          CPPUNIT_ASSERT(nullptr != rel_ident2);
+          CPPUNIT_ASSERT_EQUAL(false, rel_ident2->has_key_ident());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), rel_ident2->index());
+          expr = app->args().front().get();
+          depth++;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100000), depth);
+        VariableExpression *var_expr3 = dynamic_cast<VariableExpression *>(expr);
+        CPPUNIT_ASSERT(nullptr != var_expr3);
+        RelativeIdentifier *rel_ident3 = dynamic_cast<RelativeIdentifier *>(var_expr3->ident());
+        CPPUNIT_ASSERT(nullptr != rel_ident3);
+        CPPUNIT_ASSERT_EQUAL(false, rel_ident3->has_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), rel_ident3->index());
+      }
+
+      void ResolverTests::test_resolver_resolves_alias_targets_for_alias_chains()
+      {
+        istringstream iss("\
+import stdlib\n\
+\n\
+datatype T = C(Int64, Int64)\n\
+\n\
+C2 = C\n\
+\n\
+C3 = C2\n\
+\n\
+C4 = C3\n\
+\n\
+C5 = C4\n\
+\n\
+D = D2\n\
+\n\
+D2 = D\n\
+\n\
+v = C5(1, 2)\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier c_abs_ident(list<string> { "C" });
+        CPPUNIT_ASSERT_EQUAL(true, c_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier c3_abs_ident(list<string> { "C3" });
+        CPPUNIT_ASSERT_EQUAL(true, c3_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier c5_abs_ident(list<string> { "C5" });
+        CPPUNIT_ASSERT_EQUAL(true, c5_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier d_abs_ident(list<string> { "D" });
+        CPPUNIT_ASSERT_EQUAL(true, d_abs_ident.set_key_ident(*(tree.ident_table())));
+        VariableInfo *c_var_info = tree.var_info(c_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != c_var_info);
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<DefinedConstructorVariable *>(c_var_info->var().get()));
+        CPPUNIT_ASSERT(AliasTargetState::RESOLVED == c_var_info->alias_target_state());
+        CPPUNIT_ASSERT(c_var_info->var() == c_var_info->non_alias_var());
+        VariableInfo *c3_var_info = tree.var_info(c3_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != c3_var_info);
+        CPPUNIT_ASSERT(AliasTargetState::RESOLVED == c3_var_info->alias_target_state());
+        CPPUNIT_ASSERT(c_var_info->var() == c3_var_info->non_alias_var());
+        VariableInfo *c5_var_info = tree.var_info(c5_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != c5_var_info);
+        CPPUNIT_ASSERT(AliasTargetState::RESOLVED == c5_var_info->alias_target_state());
+        CPPUNIT_ASSERT(c_var_info->var() == c5_var_info->non_alias_var());
+        VariableInfo *d_var_info = tree.var_info(d_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != d_var_info);
+        CPPUNIT_ASSERT(AliasTargetState::CYCLE == d_var_info->alias_target_state());
+      }
+
+      void ResolverTests::test_resolver_adds_diagnostics()
+      {
+        istringstream iss("\
+f() = v\n\
+\n\
+g() = w\n\
+\n\
+f() = 1\n\
+\n\
+g() = 2\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        DiagnosticList diags;
+        CPPUNIT_ASSERT_EQUAL(false, _M_resolver->resolve(tree, diags));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), diags.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), diags.omitted_count());
+        auto diag_iter = diags.diags().begin();
+        CPPUNIT_ASSERT(DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED == diag_iter->code());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), diag_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(string("variable .f is already defined"), diag_iter->msg(*(tree.ident_table())));
+        diag_iter++;
+        CPPUNIT_ASSERT(DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED == diag_iter->code());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), diag_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(string("variable .g is already defined"), diag_iter->msg(*(tree.ident_table())));
+        diag_iter++;
+        CPPUNIT_ASSERT(DiagnosticCode::VARIABLE_IS_UNDEFINED == diag_iter->code());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), diag_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(string("variable v is undefined"), diag_iter->msg(*(tree.ident_table())));
+        diag_iter++;
+        CPPUNIT_ASSERT(DiagnosticCode::VARIABLE_IS_UNDEFINED == diag_iter->code());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), diag_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(string("variable w is undefined"), diag_iter->msg(*(tree.ident_table())));
+      }
+
+      void ResolverTests::test_resolver_adds_diagnostics_up_to_maximal_count()
+      {
+        istringstream iss("\
+f() = v\n\
+\n\
+g() = w\n\
+\n\
+f() = 1\n\
+\n\
+g() = 2\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        DiagnosticList diags(3);
+        CPPUNIT_ASSERT_EQUAL(false, _M_resolver->resolve(tree, diags));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), diags.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), diags.omitted_count());
+        diags.append_errors(errors, *(tree.ident_table()));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), errors.size());
+        auto error_iter = errors.begin();
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable .f is already defined"), error_iter->msg());
+        error_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable .g is already defined"), error_iter->msg());
+        error_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable v is undefined"), error_iter->msg());
+      }
+
+      void ResolverTests::test_resolver_stops_after_maximal_count_of_diagnostics_in_first_n_mode()
+      {
+        istringstream iss("\
+f() = v\n\
+\n\
+g() = w\n\
+\n\
+f() = 1\n\
+\n\
+g() = 2\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        DiagnosticList diags(2, true);
+        CPPUNIT_ASSERT_EQUAL(false, _M_resolver->resolve(tree, diags));
+        CPPUNIT_ASSERT_EQUAL(true, diags.must_stop());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), diags.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), diags.omitted_count());
+        diags.append_errors(errors, *(tree.ident_table()));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), errors.size());
+        auto error_iter = errors.begin();
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable .f is already defined"), error_iter->msg());
+        error_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable .g is already defined"), error_iter->msg());
+      }
+
+      void ResolverTests::test_resolver_adds_diagnostics_which_outlive_tree()
+      {
+        istringstream iss("\
+f() = v\n\
+\n\
+f() = 1\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        DiagnosticList diags;
+        shared_ptr<AbsoluteIdentifierTable> ident_table;
+        {
+          Tree tree;
+          CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+          CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+          CPPUNIT_ASSERT(errors.empty());
+          CPPUNIT_ASSERT_EQUAL(false, _M_resolver->resolve(tree, diags));
+          ident_table = tree.ident_table();
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), diags.size());
+        auto diag_iter = diags.diags().begin();
+        CPPUNIT_ASSERT(DiagnosticCode::VARIABLE_IS_ALREADY_DEFINED == diag_iter->code());
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), diag_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), diag_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(string("variable .f is already defined"), diag_iter->msg(*ident_table));
+        diag_iter++;
+        CPPUNIT_ASSERT(DiagnosticCode::VARIABLE_IS_UNDEFINED == diag_iter->code());
+        CPPUNIT_ASSERT_EQUAL(string("test.lesfl"), diag_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), diag_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), diag_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable v is undefined"), diag_iter->msg(*ident_table));
+      }
+
+      void ResolverTests::test_resolver_adds_references_to_reference_index()
+      {
+        istringstream iss("\
+f(x: T) = g(x, h)\n\
+\n\
+g(y, z) = y match {\n\
+    C(w) -> w\n\
+  }\n\
+\n\
+h = C(D)\n\
+\n\
+datatype T = C(T) | D\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        ReferenceIndex ref_index;
+        FrontendOptions options;
+        options.ref_index = &ref_index;
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), ref_index.refs().size());
+        AbsoluteIdentifier f_abs_ident(list<string> { "f" });
+        CPPUNIT_ASSERT_EQUAL(true, f_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT_EQUAL(false, ref_index.has_refs(f_abs_ident.key_ident()));
+        AbsoluteIdentifier g_abs_ident(list<string> { "g" });
+        CPPUNIT_ASSERT_EQUAL(true, g_abs_ident.set_key_ident(*(tree.ident_table())));
+        const vector<Reference> *refs = ref_index.refs(g_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), refs->size());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<const FunctionDefinition *>((*refs)[0].def()));
+        CPPUNIT_ASSERT_EQUAL(true, (*refs)[0].has_def_key_ident());
+        CPPUNIT_ASSERT(f_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(11), (*refs)[0].pos().column());
+        AbsoluteIdentifier h_abs_ident(list<string> { "h" });
+        CPPUNIT_ASSERT_EQUAL(true, h_abs_ident.set_key_ident(*(tree.ident_table())));
+        refs = ref_index.refs(h_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), refs->size());
+        CPPUNIT_ASSERT(f_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(16), (*refs)[0].pos().column());
+        AbsoluteIdentifier c_abs_ident(list<string> { "C" });
+        CPPUNIT_ASSERT_EQUAL(true, c_abs_ident.set_key_ident(*(tree.ident_table())));
+        refs = ref_index.refs(c_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), refs->size());
+        CPPUNIT_ASSERT(g_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), (*refs)[0].pos().column());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<const VariableDefinition *>((*refs)[1].def()));
+        CPPUNIT_ASSERT(h_abs_ident.key_ident() == (*refs)[1].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), (*refs)[1].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), (*refs)[1].pos().column());
+        AbsoluteIdentifier d_abs_ident(list<string> { "D" });
+        CPPUNIT_ASSERT_EQUAL(true, d_abs_ident.set_key_ident(*(tree.ident_table())));
+        refs = ref_index.refs(d_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), refs->size());
+        CPPUNIT_ASSERT(h_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), (*refs)[0].pos().column());
+        AbsoluteIdentifier t_abs_ident(list<string> { "T" });
+        CPPUNIT_ASSERT_EQUAL(true, t_abs_ident.set_key_ident(*(tree.ident_table())));
+        refs = ref_index.refs(t_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), refs->size());
+        CPPUNIT_ASSERT(f_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), (*refs)[0].pos().column());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<const TypeVariableDefinition *>((*refs)[1].def()));
+        CPPUNIT_ASSERT(t_abs_ident.key_ident() == (*refs)[1].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(9), (*refs)[1].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(16), (*refs)[1].pos().column());
+      }
+
+      void ResolverTests::test_resolver_adds_references_from_alias_variables_to_reference_index()
+      {
+        istringstream iss("\
+C2 = C\n\
+\n\
+v: T = a\n\
+\n\
+a = C\n\
+\n\
+datatype T = C\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        ReferenceIndex ref_index;
+        FrontendOptions options;
+        options.ref_index = &ref_index;
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), ref_index.refs().size());
+        AbsoluteIdentifier c2_abs_ident(list<string> { "C2" });
+        CPPUNIT_ASSERT_EQUAL(true, c2_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier c_abs_ident(list<string> { "C" });
+        CPPUNIT_ASSERT_EQUAL(true, c_abs_ident.set_key_ident(*(tree.ident_table())));
+        const vector<Reference> *refs = ref_index.refs(c_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), refs->size());
+        CPPUNIT_ASSERT(nullptr != dynamic_cast<const VariableDefinition *>((*refs)[0].def()));
+        CPPUNIT_ASSERT_EQUAL(true, (*refs)[0].has_def_key_ident());
+        CPPUNIT_ASSERT(c2_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), (*refs)[0].pos().column());
+        AbsoluteIdentifier v_abs_ident(list<string> { "v" });
+        CPPUNIT_ASSERT_EQUAL(true, v_abs_ident.set_key_ident(*(tree.ident_table())));
+        AbsoluteIdentifier a_abs_ident(list<string> { "a" });
+        CPPUNIT_ASSERT_EQUAL(true, a_abs_ident.set_key_ident(*(tree.ident_table())));
+        CPPUNIT_ASSERT(a_abs_ident.key_ident() == (*refs)[1].def_key_ident());
+        refs = ref_index.refs(a_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), refs->size());
+        CPPUNIT_ASSERT(v_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), (*refs)[0].pos().column());
+        AbsoluteIdentifier t_abs_ident(list<string> { "T" });
+        CPPUNIT_ASSERT_EQUAL(true, t_abs_ident.set_key_ident(*(tree.ident_table())));
+        refs = ref_index.refs(t_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != refs);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), refs->size());
+        CPPUNIT_ASSERT(v_abs_ident.key_ident() == (*refs)[0].def_key_ident());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), (*refs)[0].pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), (*refs)[0].pos().column());
+      }
     }
   }
 }
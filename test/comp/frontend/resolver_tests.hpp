@@ -294,6 +294,14 @@ namespace lesfl
         CPPUNIT_TEST(test_resolver_complains_on_already_defined_field_at_constructor);
         CPPUNIT_TEST(test_resolver_complains_on_alias_variable_reference_to_undefined_variable);
         CPPUNIT_TEST(test_resolver_complains_on_alias_variable_reference_to_alias_cycle);
+        CPPUNIT_TEST(test_resolver_resolves_identifiers_for_very_deep_expression);
+        CPPUNIT_TEST(test_resolver_resolves_alias_targets_for_alias_chains);
+        CPPUNIT_TEST(test_resolver_adds_diagnostics);
+        CPPUNIT_TEST(test_resolver_adds_diagnostics_up_to_maximal_count);
+        CPPUNIT_TEST(test_resolver_stops_after_maximal_count_of_diagnostics_in_first_n_mode);
+        CPPUNIT_TEST(test_resolver_adds_diagnostics_which_outlive_tree);
+        CPPUNIT_TEST(test_resolver_adds_references_to_reference_index);
+        CPPUNIT_TEST(test_resolver_adds_references_from_alias_variables_to_reference_index);
         CPPUNIT_TEST_SUITE_END();
 
         BuiltinTypeAdder *_M_builtin_type_adder;
@@ -576,6 +584,14 @@ namespace lesfl
         void test_resolver_complains_on_already_defined_field_at_constructor();
         void test_resolver_complains_on_alias_variable_reference_to_undefined_variable();
         void test_resolver_complains_on_alias_variable_reference_to_alias_cycle();
+        void test_resolver_resolves_identifiers_for_very_deep_expression();
+        void test_resolver_resolves_alias_targets_for_alias_chains();
+        void test_resolver_adds_diagnostics();
+        void test_resolver_adds_diagnostics_up_to_maximal_count();
+        void test_resolver_stops_after_maximal_count_of_diagnostics_in_first_n_mode();
+        void test_resolver_adds_diagnostics_which_outlive_tree();
+        void test_resolver_adds_references_to_reference_index();
+        void test_resolver_adds_references_from_alias_variables_to_reference_index();
       };
     }
   }
@@ -0,0 +1,158 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <sstream>
+#include "frontend/stats_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(StatsTests);
+
+      void StatsTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+      }
+
+      void StatsTests::tearDown()
+      {
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      void StatsTests::test_frontend_collects_stats_for_phases()
+      {
+        istringstream iss1("\
+f(x) = g(x)\n\
+");
+        istringstream iss2("\
+g(x) = x\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test1.lesfl", iss1));
+        sources.push_back(Source("test2.lesfl", iss2));
+        list<Error> errors;
+        Tree tree;
+        FrontendStats stats;
+        FrontendOptions options;
+        options.stats = &stats;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree, options));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), stats.phase_stats().size());
+        auto phase_stats_iter = stats.phase_stats().begin();
+        CPPUNIT_ASSERT_EQUAL(string("add builtin types"), phase_stats_iter->name());
+        phase_stats_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("parse test1.lesfl"), phase_stats_iter->name());
+        phase_stats_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("parse test2.lesfl"), phase_stats_iter->name());
+        phase_stats_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("add definitions"), phase_stats_iter->name());
+        phase_stats_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("resolve aliases"), phase_stats_iter->name());
+        phase_stats_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("resolve definitions"), phase_stats_iter->name());
+        CPPUNIT_ASSERT(stats.interned_ident_count() > 0);
+        CPPUNIT_ASSERT(stats.ident_table_probe_count() >= stats.interned_ident_count());
+        CPPUNIT_ASSERT(stats.ident_lookup_miss_count() <= stats.ident_table_probe_count());
+      }
+
+      void StatsTests::test_frontend_stats_writes_json()
+      {
+        FrontendStats stats;
+        stats.add_phase_stats(PhaseStats("parse \"a\".lesfl", 1500, 3));
+        stats.add_phase_stats(PhaseStats("add definitions", 200, 0));
+        stats.increase_interned_ident_count();
+        stats.increase_ident_table_probe_count();
+        stats.increase_ident_table_probe_count();
+        stats.increase_ident_lookup_miss_count();
+        ostringstream oss;
+        stats.write_json(oss);
+        CPPUNIT_ASSERT_EQUAL(string("\
+{\n\
+  \"phases\": [\n\
+    {\"name\": \"parse \\\"a\\\".lesfl\", \"nanoseconds\": 1500, \"allocations\": 3},\n\
+    {\"name\": \"add definitions\", \"nanoseconds\": 200, \"allocations\": 0}\n\
+  ],\n\
+  \"interned_idents\": 1,\n\
+  \"ident_table_probes\": 2,\n\
+  \"ident_lookup_misses\": 1\n\
+}\n\
+"), oss.str());
+      }
+
+      void StatsTests::test_frontend_records_trace_events()
+      {
+        istringstream iss("\
+f(x) = x\n\
+\n\
+module m {\n\
+  g(x) = .f(x)\n\
+}\n\
+");
+        vector<Source> sources;
+        sources.push_back(Source("test.lesfl", iss));
+        list<Error> errors;
+        Tree tree;
+        FrontendStats stats;
+        Trace trace(0);
+        stats.set_trace(&trace);
+        FrontendOptions options;
+        options.stats = &stats;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree, options));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources, tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree, errors, options));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), trace.thread_count());
+        vector<pair<string, string>> expected_events {
+          make_pair(string("add builtin types"), string("phase")),
+          make_pair(string("parse test.lesfl"), string("phase")),
+          make_pair(string(".m"), string("add module")),
+          make_pair(string("add definitions"), string("phase")),
+          make_pair(string("resolve aliases"), string("phase")),
+          make_pair(string(".f"), string("resolve definition")),
+          make_pair(string(".m.g"), string("resolve definition")),
+          make_pair(string(".m"), string("resolve module")),
+          make_pair(string("resolve definitions"), string("phase"))
+        };
+        CPPUNIT_ASSERT_EQUAL(expected_events.size(), trace.events().size());
+        for(size_t i = 0; i < expected_events.size(); i++) {
+          CPPUNIT_ASSERT_EQUAL(expected_events[i].first, trace.events()[i].name());
+          CPPUNIT_ASSERT_EQUAL(expected_events[i].second, trace.events()[i].category());
+          CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), trace.events()[i].thread_index());
+        }
+      }
+
+      void StatsTests::test_trace_writes_json()
+      {
+        Trace trace;
+        trace.add_event("parse test.lesfl", "phase", 1500, 250000);
+        trace.add_event(".m", "resolve module", 260000, 1001);
+        ostringstream oss;
+        trace.write_json(oss);
+        CPPUNIT_ASSERT_EQUAL(string("\
+{\"traceEvents\": [\n\
+  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"thread 0\"}},\n\
+  {\"name\": \"parse test.lesfl\", \"cat\": \"phase\", \"ph\": \"X\", \"ts\": 1.500, \"dur\": 250.000, \"pid\": 1, \"tid\": 0},\n\
+  {\"name\": \".m\", \"cat\": \"resolve module\", \"ph\": \"X\", \"ts\": 260.000, \"dur\": 1.001, \"pid\": 1, \"tid\": 0}\n\
+]}\n\
+"), oss.str());
+      }
+    }
+  }
+}
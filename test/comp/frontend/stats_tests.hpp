@@ -0,0 +1,48 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_STATS_TESTS_HPP
+#define _FRONTEND_STATS_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class StatsTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(StatsTests);
+        CPPUNIT_TEST(test_frontend_collects_stats_for_phases);
+        CPPUNIT_TEST(test_frontend_stats_writes_json);
+        CPPUNIT_TEST(test_frontend_records_trace_events);
+        CPPUNIT_TEST(test_trace_writes_json);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_frontend_collects_stats_for_phases();
+        void test_frontend_stats_writes_json();
+        void test_frontend_records_trace_events();
+        void test_trace_writes_json();
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,306 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#include <map>
+#include <sstream>
+#include "frontend/tree_tests.hpp"
+
+using namespace std;
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      CPPUNIT_TEST_SUITE_REGISTRATION(TreeTests);
+
+      static map<string, size_t> key_idents_from_ident_table(const AbsoluteIdentifierTable &table)
+      {
+        map<string, size_t> key_idents;
+        for(auto &pair : table.ident_map()) key_idents.insert(make_pair(pair.second->to_string(), pair.first.key()));
+        return key_idents;
+      }
+
+      static Expression *new_var_expr(size_t i)
+      { return new VariableExpression(new RelativeIdentifier("x" + to_string(i)), Position(Source(), 1, i + 1)); }
+
+      static string var_expr_ident_string(const unique_ptr<Expression> &expr)
+      {
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(expr.get());
+        return var_expr != nullptr ? var_expr->ident()->to_string() : string();
+      }
+
+      void TreeTests::setUp()
+      {
+        _M_builtin_type_adder = new BuiltinTypeAdder();
+        _M_parser = new Parser();
+        _M_resolver = new Resolver();
+        _M_key_ident_renumberer = new KeyIdentifierRenumberer();
+      }
+
+      void TreeTests::tearDown()
+      {
+        delete _M_key_ident_renumberer;
+        delete _M_resolver;
+        delete _M_parser;
+        delete _M_builtin_type_adder;
+      }
+
+      void TreeTests::test_tree_merges_tree_with_other_identifier_table()
+      {
+        istringstream iss1("\
+datatype T = C(T, T) | E\n\
+\n\
+f(x: T) = g(x)\n\
+\n\
+g(x) = x\n\
+");
+        istringstream iss2("\
+h(x: U) = k(x)\n\
+\n\
+k(x) = x\n\
+\n\
+datatype U = D\n\
+");
+        vector<Source> sources1;
+        sources1.push_back(Source("test1.lesfl", iss1));
+        vector<Source> sources2;
+        sources2.push_back(Source("test2.lesfl", iss2));
+        list<Error> errors;
+        Tree tree1;
+        Tree tree2;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree1));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources1, tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree2));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources2, tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, tree1.merge(move(tree2), errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT(tree2.defs().empty());
+        CPPUNIT_ASSERT(tree2.var_infos().empty());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), tree1.defs().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), tree1.module_key_idents().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), tree1.var_infos().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), tree1.uncompiled_var_key_idents().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), tree1.uncompiled_type_var_key_idents().size());
+        AbsoluteIdentifier k_abs_ident(list<string> { "k" });
+        CPPUNIT_ASSERT_EQUAL(true, k_abs_ident.set_key_ident(*(tree1.ident_table())));
+        AbsoluteIdentifier u_abs_ident(list<string> { "U" });
+        CPPUNIT_ASSERT_EQUAL(true, u_abs_ident.set_key_ident(*(tree1.ident_table())));
+        CPPUNIT_ASSERT(nullptr != tree1.var_info(k_abs_ident.key_ident()));
+        CPPUNIT_ASSERT(nullptr != tree1.type_var_info(u_abs_ident.key_ident()));
+        auto defs_iter = tree1.defs().begin();
+        defs_iter++;
+        FunctionDefinition *fun_def = dynamic_cast<FunctionDefinition *>((*defs_iter)->front().get());
+        CPPUNIT_ASSERT(nullptr != fun_def);
+        CPPUNIT_ASSERT_EQUAL(string("h"), fun_def->ident());
+        UserDefinedFunction *fun = dynamic_cast<UserDefinedFunction *>(fun_def->fun().get());
+        CPPUNIT_ASSERT(nullptr != fun);
+        TypeVariableExpression *type_var_expr = dynamic_cast<TypeVariableExpression *>(fun->args()[0]->type_expr());
+        CPPUNIT_ASSERT(nullptr != type_var_expr);
+        CPPUNIT_ASSERT(u_abs_ident.key_ident() == type_var_expr->ident()->key_ident());
+        NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(fun->body());
+        CPPUNIT_ASSERT(nullptr != app);
+        VariableExpression *var_expr = dynamic_cast<VariableExpression *>(app->fun());
+        CPPUNIT_ASSERT(nullptr != var_expr);
+        CPPUNIT_ASSERT(k_abs_ident.key_ident() == var_expr->ident()->key_ident());
+        istringstream iss3("\
+datatype T = C(T, T) | E\n\
+\n\
+f(x: T) = g(x)\n\
+\n\
+g(x) = x\n\
+\n\
+h(x: U) = k(x)\n\
+\n\
+k(x) = x\n\
+\n\
+datatype U = D\n\
+");
+        vector<Source> sources3;
+        sources3.push_back(Source("test3.lesfl", iss3));
+        Tree tree3;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree3));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources3, tree3, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree3, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_key_ident_renumberer->renumber(tree1));
+        CPPUNIT_ASSERT_EQUAL(true, _M_key_ident_renumberer->renumber(tree3));
+        CPPUNIT_ASSERT(key_idents_from_ident_table(*(tree1.ident_table())) == key_idents_from_ident_table(*(tree3.ident_table())));
+        CPPUNIT_ASSERT(tree1.uncompiled_var_key_idents() == tree3.uncompiled_var_key_idents());
+        CPPUNIT_ASSERT(tree1.uncompiled_type_var_key_idents() == tree3.uncompiled_type_var_key_idents());
+      }
+
+      void TreeTests::test_tree_complains_on_already_defined_definitions_for_merging()
+      {
+        istringstream iss1("\
+datatype T = C(T, T) | E\n\
+\n\
+f(x: T) = x\n\
+");
+        istringstream iss2("\
+g(x) = x\n\
+\n\
+f(x) = x\n\
+\n\
+datatype T = E\n\
+");
+        vector<Source> sources1;
+        sources1.push_back(Source("test1.lesfl", iss1));
+        vector<Source> sources2;
+        sources2.push_back(Source("test2.lesfl", iss2));
+        list<Error> errors;
+        Tree tree1;
+        Tree tree2;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree1));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources1, tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree2));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources2, tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        size_t var_info_count1 = tree1.var_infos().size();
+        size_t var_info_count2 = tree2.var_infos().size();
+        size_t ident_count1 = tree1.ident_table()->ident_map().size();
+        CPPUNIT_ASSERT_EQUAL(false, tree1.merge(move(tree2), errors));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree1.defs().size());
+        CPPUNIT_ASSERT_EQUAL(var_info_count1, tree1.var_infos().size());
+        CPPUNIT_ASSERT_EQUAL(ident_count1, tree1.ident_table()->ident_map().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tree2.defs().size());
+        CPPUNIT_ASSERT_EQUAL(var_info_count2, tree2.var_infos().size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), errors.size());
+        auto error_iter = errors.begin();
+        CPPUNIT_ASSERT_EQUAL(string("test2.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(14), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable .E is already defined"), error_iter->msg());
+        error_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("test2.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("variable .f is already defined"), error_iter->msg());
+        error_iter++;
+        CPPUNIT_ASSERT_EQUAL(string("test2.lesfl"), error_iter->pos().source().file_name());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), error_iter->pos().line());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), error_iter->pos().column());
+        CPPUNIT_ASSERT_EQUAL(string("type .T is already defined"), error_iter->msg());
+      }
+
+      void TreeTests::test_tree_merges_tree_with_very_deep_expression()
+      {
+        istringstream iss1("\
+g(x) = x\n\
+");
+        string str = "x + y = #iadd(x, y)\n\nf(x) = x";
+        for(size_t i = 0; i < 100000; i++) str += " + x";
+        str += "\n";
+        istringstream iss2(str);
+        vector<Source> sources1;
+        sources1.push_back(Source("test1.lesfl", iss1));
+        vector<Source> sources2;
+        sources2.push_back(Source("test2.lesfl", iss2));
+        list<Error> errors;
+        Tree tree1;
+        Tree tree2;
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree1));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources1, tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree1, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_builtin_type_adder->add_builtin_types(tree2));
+        CPPUNIT_ASSERT_EQUAL(true, _M_parser->parse(sources2, tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, _M_resolver->resolve(tree2, errors));
+        CPPUNIT_ASSERT(errors.empty());
+        CPPUNIT_ASSERT_EQUAL(true, tree1.merge(move(tree2), errors));
+        CPPUNIT_ASSERT(errors.empty());
+        AbsoluteIdentifier f_abs_ident(list<string> { "f" });
+        CPPUNIT_ASSERT_EQUAL(true, f_abs_ident.set_key_ident(*(tree1.ident_table())));
+        AbsoluteIdentifier plus_abs_ident(list<string> { "+" });
+        CPPUNIT_ASSERT_EQUAL(true, plus_abs_ident.set_key_ident(*(tree1.ident_table())));
+        VariableInfo *var_info = tree1.var_info(f_abs_ident.key_ident());
+        CPPUNIT_ASSERT(nullptr != var_info);
+        FunctionVariable *fun_var = dynamic_cast<FunctionVariable *>(var_info->var().get());
+        CPPUNIT_ASSERT(nullptr != fun_var);
+        UserDefinedFunction *fun = dynamic_cast<UserDefinedFunction *>(fun_var->fun().get());
+        CPPUNIT_ASSERT(nullptr != fun);
+        Expression *expr = fun->body();
+        size_t depth = 0;
+        for(NonUniqueApplication *app = dynamic_cast<NonUniqueApplication *>(expr); app != nullptr; app = dynamic_cast<NonUniqueApplication *>(expr)) {
+          VariableExpression *var_expr = dynamic_cast<VariableExpression *>(app->fun());
+          CPPUNIT_ASSERT(nullptr != var_expr);
+          CPPUNIT_ASSERT(plus_abs_ident.key_ident() == var_expr->ident()->key_ident());
+          expr = app->args().front().get();
+          depth++;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(100000), depth);
+      }
+
+      void TreeTests::test_node_list_grows_past_inline_elements()
+      {
+        NodeList<Expression> exprs;
+        for(size_t i = 0; i < 10; i++) exprs.push_back(unique_ptr<Expression>(new_var_expr(i)));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), exprs.size());
+        CPPUNIT_ASSERT(exprs.capacity() >= 10);
+        for(size_t i = 0; i < 10; i++) CPPUNIT_ASSERT_EQUAL("x" + to_string(i), var_expr_ident_string(exprs[i]));
+        size_t i = 0;
+        for(auto &expr : exprs) {
+          CPPUNIT_ASSERT_EQUAL("x" + to_string(i), var_expr_ident_string(expr));
+          i++;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), i);
+      }
+
+      void TreeTests::test_node_list_pushes_elements_to_front()
+      {
+        NodeList<Expression> exprs;
+        for(size_t i = 0; i < 10; i++) exprs.push_front(unique_ptr<Expression>(new_var_expr(i)));
+        exprs.push_back(unique_ptr<Expression>(new_var_expr(10)));
+        exprs.push_front(unique_ptr<Expression>(new_var_expr(11)));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(12), exprs.size());
+        CPPUNIT_ASSERT_EQUAL(string("x11"), var_expr_ident_string(exprs.front()));
+        for(size_t i = 0; i < 10; i++) CPPUNIT_ASSERT_EQUAL("x" + to_string(9 - i), var_expr_ident_string(exprs[i + 1]));
+        CPPUNIT_ASSERT_EQUAL(string("x10"), var_expr_ident_string(exprs.back()));
+      }
+
+      void TreeTests::test_node_list_clears_elements()
+      {
+        NodeList<Expression> exprs;
+        for(size_t i = 0; i < 10; i++) exprs.push_front(unique_ptr<Expression>(new_var_expr(i)));
+        exprs.clear();
+        CPPUNIT_ASSERT_EQUAL(true, exprs.empty());
+        CPPUNIT_ASSERT(exprs.begin() == exprs.end());
+        for(size_t i = 0; i < 3; i++) exprs.push_back(unique_ptr<Expression>(new_var_expr(i)));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), exprs.size());
+        for(size_t i = 0; i < 3; i++) CPPUNIT_ASSERT_EQUAL("x" + to_string(i), var_expr_ident_string(exprs[i]));
+      }
+
+      void TreeTests::test_node_list_clears_very_deep_tree()
+      {
+        NodeList<Expression> exprs;
+        exprs.push_back(unique_ptr<Expression>(new_var_expr(0)));
+        for(size_t i = 1; i <= 1000000; i++) {
+          NodeList<Expression> *args = new NodeList<Expression>();
+          args->push_back(unique_ptr<Expression>(exprs.front().release()));
+          exprs.front().reset(new NonUniqueApplication(new_var_expr(i), FunctionModifier::NONE, args, Position(Source(), 1, 1)));
+        }
+        exprs.clear();
+        CPPUNIT_ASSERT_EQUAL(true, exprs.empty());
+      }
+    }
+  }
+}
@@ -0,0 +1,55 @@
+/****************************************************************************
+ *   Copyright (C) 2021 Łukasz Szpakowski.                                  *
+ *                                                                          *
+ *   This software is licensed under the GNU Lesser General Public          *
+ *   License v3 or later. See the LICENSE file and the GPL file for         *
+ *   the full licensing terms.                                              *
+ ****************************************************************************/
+#ifndef _FRONTEND_TREE_TESTS_HPP
+#define _FRONTEND_TREE_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <lesfl/frontend.hpp>
+
+namespace lesfl
+{
+  namespace frontend
+  {
+    namespace test
+    {
+      class TreeTests : public CppUnit::TestFixture
+      {
+        CPPUNIT_TEST_SUITE(TreeTests);
+        CPPUNIT_TEST(test_tree_merges_tree_with_other_identifier_table);
+        CPPUNIT_TEST(test_tree_complains_on_already_defined_definitions_for_merging);
+        CPPUNIT_TEST(test_tree_merges_tree_with_very_deep_expression);
+        CPPUNIT_TEST(test_node_list_grows_past_inline_elements);
+        CPPUNIT_TEST(test_node_list_pushes_elements_to_front);
+        CPPUNIT_TEST(test_node_list_clears_elements);
+        CPPUNIT_TEST(test_node_list_clears_very_deep_tree);
+        CPPUNIT_TEST_SUITE_END();
+
+        BuiltinTypeAdder *_M_builtin_type_adder;
+        Parser *_M_parser;
+        Resolver *_M_resolver;
+        KeyIdentifierRenumberer *_M_key_ident_renumberer;
+      public:
+        void setUp();
+
+        void tearDown();
+
+        void test_tree_merges_tree_with_other_identifier_table();
+        void test_tree_complains_on_already_defined_definitions_for_merging();
+        void test_tree_merges_tree_with_very_deep_expression();
+        void test_node_list_grows_past_inline_elements();
+        void test_node_list_pushes_elements_to_front();
+        void test_node_list_clears_elements();
+        void test_node_list_clears_very_deep_tree();
+      };
+    }
+  }
+}
+
+#endif